@@ -37,6 +37,14 @@
   #define UART_MODULE
   #define RS485_MODULE
 
+  /* Storage ------------------------------------------------------------ */
+  #define TS_LOG_MODULE          // Sensor history on LittleFS
+  #define TELEMETRY_QUEUE_MODULE // Telemetry kept on LittleFS while offline, replayed after reconnect
+
+  /* Uplink encoding ---------------------------------------------------- */
+  // #define TELEMETRY_MSGPACK_MODULE // MsgPack telemetry with integer keys, needs the decoding bridge
+  #define TELEMETRY_WINDOW_MODULE // Oversampled channels also send the mean, min and max of the interval
+
 // Peripherals
 
 // Sensors
@@ -87,6 +95,17 @@
   #define SERVO_PIN        A1
   #define LIGHT_SENSOR_PIN A9
 
+// I2C buses: fast sensors stay on Wire (D4/D5), the LCD and HuskyLens move to Wire1 so their long
+// transfers no longer hold up sensor reads
+  #define I2C1_SDA_PIN      D3
+  #define I2C1_SCL_PIN      D10
+  #define SENSOR_I2C_BUS    BSP_I2C_BUS_0
+  #define LCD_I2C_BUS       BSP_I2C_BUS_1
+  #define HUSKYLENS_I2C_BUS BSP_I2C_BUS_1
+
+// RS-485 soil probes: Modbus slave address of every ES soil 7 in 1 probe on rs485Serial1, comma separated
+  #define ES_SOIL_SLAVE_IDS 0x03
+
   /* Includes ----------------------------------------------------------- */
   #if ARDUINO >= 100
     #include "Arduino.h"
@@ -143,7 +162,9 @@ extern SoilMoisture soilMoisture;
 
   #ifdef ES_SOIL_RS485_MODULE
     #include "es_soil_7n1.h"
-extern EsSoil7n1 esSoil;
+constexpr uint8_t ES_SOIL_PROBE_SLAVES[] = {ES_SOIL_SLAVE_IDS};
+constexpr uint8_t ES_SOIL_PROBE_COUNT    = sizeof(ES_SOIL_PROBE_SLAVES);
+extern EsSoil7n1  esSoil[ES_SOIL_PROBE_COUNT];
   #endif // ES_SOIL_RS485_MODULE
 
   #ifdef ULTRASONIC_MODULE
@@ -204,6 +225,7 @@ extern UsbSwitch usbSwitch(D7, D6);
   #include "../src/tasks/lcd_task.h"
   #include "../src/tasks/rs485_sensors_task.h"
   #include "../src/tasks/sensors_task.h"
+  #include "../src/tasks/storage_task.h"
   #include "../src/tasks/uart_task.h"
   #include "../src/tasks/wifi_task.h"
 
@@ -60,7 +60,8 @@ public:
    * @param[in]   i2c     Boolean flag to initialize I2C interface.
    *
    * @attention  Ensure that hardware peripherals associated with UART, RS-485, and I2C are correctly
-   *             connected and powered on before calling this function. I2C will call Wire.begin().
+   *             connected and powered on before calling this function. I2C will call bspI2CBegin() and
+   *             start the bus owner task of both buses, each serializing the drivers wired to it.
    *
    * @return     None
    */
@@ -122,7 +123,9 @@ public:
    * @brief  Initializes all enabled devices.
    *
    * This function iterates through the list of devices and initializes only those devices
-   * that have been marked as enabled in the internal status array.
+   * that have been marked as enabled in the internal status array, then starts the sensor scheduler
+   * task that runs the periodic jobs they registered and, with `TS_LOG_MODULE`, the storage task that
+   * records their samples on LittleFS.
    *
    * @param[in]   None
    *
@@ -15,6 +15,7 @@
 #include "Arduino.h"
 #include "HuskyLensProtocolCore.h"
 #include "Wire.h"
+#include "bsp_i2c.h"
 
 #ifndef _HUSKYLENS_H
   #define _HUSKYLENS_H
@@ -194,6 +195,7 @@ class HUSKYLENS
 {
 private:
   TwoWire        *wire;
+  bsp_i2c_bus_t   i2cBus = BSP_I2C_BUS_0;
   Stream         *stream;
   unsigned long   timeOutDuration = 100;
   unsigned long   timeOutTimer;
@@ -201,15 +203,17 @@ private:
   Protocol_t      protocolCache;
   HUSKYLENSResult result;
   // custom
-  bool status = false;
+  bool    status = false;
+  uint8_t i2cBuffer[16]; // Last I2C chunk, consumed byte by byte by the protocol parser
+  uint8_t i2cBufferLength = 0;
+  uint8_t i2cBufferIndex  = 0;
 
   void protocolWrite(uint8_t *buffer, int length)
   {
     if (wire)
     {
-      wire->beginTransmission(0x32);
-      wire->write(buffer, length);
-      wire->endTransmission();
+      // Goes through the bus owner so it cannot interleave with the LCD or sensors
+      bspI2CWriteBytes(i2cBus, 0x32, buffer, length);
     }
     else if (stream)
     {
@@ -225,13 +229,18 @@ private:
   {
     if (wire)
     {
-      if (!wire->available())
+      if (i2cBufferIndex >= i2cBufferLength)
       {
-        wire->requestFrom(0x32, 16);
+        i2cBufferIndex  = 0;
+        i2cBufferLength = 0;
+        if (bspI2CReadBytes(i2cBus, 0x32, i2cBuffer, sizeof(i2cBuffer)) == BSP_I2C_OK)
+        {
+          i2cBufferLength = sizeof(i2cBuffer);
+        }
       }
-      while (wire->available())
+      while (i2cBufferIndex < i2cBufferLength)
       {
-        int result = wire->read();
+        int result = i2cBuffer[i2cBufferIndex++];
         if (husky_lens_protocol_receive(result))
         {
           return true;
@@ -367,16 +376,30 @@ public:
    *
    * Attempts to establish a connection with the HuskyLens at I2C address 0x32 and verifies communication.
    *
-   * @param[in] streamInput The `TwoWire` object for I2C communication.
+   * @param[in] streamInput The `TwoWire` object for I2C communication, `Wire1` selects `BSP_I2C_BUS_1`.
    *
    * @attention Ensure the HuskyLens is connected to the I2C bus before calling.
    *
    * @return bool `true` if connection and communication are successful, `false` otherwise.
    */
-  bool begin(TwoWire &streamInput)
+  bool begin(TwoWire &streamInput) { return begin((&streamInput == &Wire1) ? BSP_I2C_BUS_1 : BSP_I2C_BUS_0); }
+
+  /**
+   * @brief Initializes communication with the HuskyLens over a BSP I2C bus.
+   *
+   * Attempts to establish a connection with the HuskyLens at I2C address 0x32 and verifies communication.
+   *
+   * @param[in] bus I2C bus the HuskyLens is wired to.
+   *
+   * @attention The bus must already be initialized with `bspI2CBegin()`.
+   *
+   * @return bool `true` if connection and communication are successful, `false` otherwise.
+   */
+  bool begin(bsp_i2c_bus_t bus)
   {
     stream = NULL;
-    wire   = &streamInput;
+    i2cBus = bus;
+    wire   = (bus == BSP_I2C_BUS_1) ? &Wire1 : &Wire;
     return readKnock();
   }
 
@@ -19,6 +19,9 @@
 /* Private enumerate/structure ---------------------------------------- */
 
 /* Private macros ----------------------------------------------------- */
+#define AC_MEASURE_LE16(p) ((uint16_t) ((p)[0] | ((p)[1] << 8)))
+#define AC_MEASURE_LE32(p)                                                                               \
+  ((uint32_t) (p)[0] | ((uint32_t) (p)[1] << 8) | ((uint32_t) (p)[2] << 16) | ((uint32_t) (p)[3] << 24))
 
 /* Public variables --------------------------------------------------- */
 
@@ -26,9 +29,10 @@
 
 /* Class method definitions-------------------------------------------- */
 
-ac_measure_error_t AcMeasure::begin(void)
+ac_measure_error_t AcMeasure::begin(bsp_i2c_bus_t bus)
 {
-  if (!bspI2CExist(_addr))
+  _bus = bus;
+  if (!bspI2CExist(_bus, _addr))
   {
     return UNIT_AC_MEASURE_ERR_I2C;
   }
@@ -38,7 +42,7 @@ uint8_t AcMeasure::getFirmwareVersion(void)
 {
   uint8_t firmwareVersion;
 
-  bspI2CReadByte(_addr, UNIT_ACMEASURE_FIRMWARE_VERSION_REG, firmwareVersion);
+  bspI2CReadByte(_bus, _addr, UNIT_ACMEASURE_FIRMWARE_VERSION_REG, firmwareVersion);
 
   return firmwareVersion;
 }
@@ -47,7 +51,7 @@ uint8_t AcMeasure::getReady(void)
 {
   char readBuffer[7] = {0};
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_GET_READY_REG, (uint8_t *) readBuffer, 1);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_GET_READY_REG, (uint8_t *) readBuffer, 1);
 
   return readBuffer[0];
 }
@@ -56,7 +60,7 @@ uint16_t AcMeasure::getRawVoltage(void)
 {
   uint8_t data[4];
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_VOLTAGE_REG, data, 2);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_VOLTAGE_REG, data, 2);
   uint16_t value = data[0] | (data[1] << 8);
 
   return value;
@@ -73,7 +77,7 @@ uint16_t AcMeasure::getRawCurrent(void)
 {
   uint8_t data[4];
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_CURRENT_REG, data, 2);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_CURRENT_REG, data, 2);
   uint16_t value = data[0] | (data[1] << 8);
 
   return value;
@@ -90,7 +94,7 @@ uint32_t AcMeasure::getRawPower(void)
 {
   uint8_t data[4];
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_POWER_REG, data, 4);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_POWER_REG, data, 4);
   uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
 
   return value;
@@ -107,7 +111,7 @@ uint32_t AcMeasure::getRawApparentPower(void)
 {
   uint8_t data[4];
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_APPARENT_POWER_REG, data, 4);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_APPARENT_POWER_REG, data, 4);
   uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
 
   return value;
@@ -124,7 +128,7 @@ uint8_t AcMeasure::getRawPowerFactor(void)
 {
   uint8_t data[4];
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_POWER_FACTOR_REG, data, 1);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_POWER_FACTOR_REG, data, 1);
 
   return data[0];
 }
@@ -140,7 +144,7 @@ uint32_t AcMeasure::getRawKWH(void)
 {
   uint8_t data[4];
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_KWH_REG, data, 4);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_KWH_REG, data, 4);
   uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
 
   return value;
@@ -152,11 +156,49 @@ float AcMeasure::getKWH(void)
   return (float) (value / 100.0f);
 }
 
+ac_measure_error_t AcMeasure::readSnapshot(ac_measure_snapshot_t *snapshot)
+{
+  uint8_t ready;
+  uint8_t data[UNIT_ACMEASURE_SNAPSHOT_LENGTH];
+
+  if (bspI2CReadByte(_bus, _addr, UNIT_ACMEASURE_GET_READY_REG, ready) != BSP_I2C_OK)
+  {
+    return UNIT_AC_MEASURE_ERR_I2C;
+  }
+  if (!ready)
+  {
+    return UNIT_AC_MEASURE_ERR;
+  }
+
+  if (bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_SNAPSHOT_REG, data, sizeof(data)) != BSP_I2C_OK)
+  {
+    return UNIT_AC_MEASURE_ERR_I2C;
+  }
+
+  // Register offsets inside the burst, values are little-endian and scaled by 100
+  const uint8_t *voltage       = &data[UNIT_ACMEASURE_VOLTAGE_REG - UNIT_ACMEASURE_SNAPSHOT_REG];
+  const uint8_t *current       = &data[UNIT_ACMEASURE_CURRENT_REG - UNIT_ACMEASURE_SNAPSHOT_REG];
+  const uint8_t *power         = &data[UNIT_ACMEASURE_POWER_REG - UNIT_ACMEASURE_SNAPSHOT_REG];
+  const uint8_t *apparentPower = &data[UNIT_ACMEASURE_APPARENT_POWER_REG - UNIT_ACMEASURE_SNAPSHOT_REG];
+  const uint8_t *powerFactor   = &data[UNIT_ACMEASURE_POWER_FACTOR_REG - UNIT_ACMEASURE_SNAPSHOT_REG];
+  const uint8_t *kwh           = &data[UNIT_ACMEASURE_KWH_REG - UNIT_ACMEASURE_SNAPSHOT_REG];
+
+  snapshot->timestamp     = millis();
+  snapshot->voltage       = AC_MEASURE_LE16(voltage) / 100.0f;
+  snapshot->current       = AC_MEASURE_LE16(current) / 100.0f;
+  snapshot->power         = AC_MEASURE_LE32(power) / 100.0f;
+  snapshot->apparentPower = AC_MEASURE_LE32(apparentPower) / 100.0f;
+  snapshot->powerFactor   = powerFactor[0] / 100.0f;
+  snapshot->kwh           = AC_MEASURE_LE32(kwh) / 100.0f;
+
+  return UNIT_AC_MEASURE_OK;
+}
+
 ac_measure_error_t AcMeasure::getVoltageString(char *str)
 {
   char readBuffer[7] = {0};
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_VOLTAGE_STRING_REG, (uint8_t *) readBuffer, 7);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_VOLTAGE_STRING_REG, (uint8_t *) readBuffer, 7);
   memcpy(str, readBuffer, sizeof(readBuffer));
 
   return UNIT_AC_MEASURE_OK;
@@ -166,7 +208,7 @@ ac_measure_error_t AcMeasure::getCurrentString(char *str)
 {
   char readBuffer[7] = {0};
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_CURRENT_STRING_REG, (uint8_t *) readBuffer, 7);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_CURRENT_STRING_REG, (uint8_t *) readBuffer, 7);
   memcpy(str, readBuffer, sizeof(readBuffer));
 
   return UNIT_AC_MEASURE_OK;
@@ -176,7 +218,7 @@ ac_measure_error_t AcMeasure::getPowerString(char *str)
 {
   char readBuffer[7] = {0};
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_POWER_STRING_REG, (uint8_t *) readBuffer, 7);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_POWER_STRING_REG, (uint8_t *) readBuffer, 7);
   memcpy(str, readBuffer, sizeof(readBuffer));
 
   return UNIT_AC_MEASURE_OK;
@@ -186,7 +228,7 @@ ac_measure_error_t AcMeasure::getApparentPowerString(char *str)
 {
   char readBuffer[7] = {0};
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_APPARENT_POWER_STRING_REG, (uint8_t *) readBuffer, 7);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_APPARENT_POWER_STRING_REG, (uint8_t *) readBuffer, 7);
   memcpy(str, readBuffer, sizeof(readBuffer));
 
   return UNIT_AC_MEASURE_OK;
@@ -196,7 +238,7 @@ ac_measure_error_t AcMeasure::getPowerFactorString(char *str)
 {
   char readBuffer[7] = {0};
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_POWER_FACTOR_STRING_REG, (uint8_t *) readBuffer, 4);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_POWER_FACTOR_STRING_REG, (uint8_t *) readBuffer, 4);
   memcpy(str, readBuffer, sizeof(readBuffer));
 
   return UNIT_AC_MEASURE_OK;
@@ -206,7 +248,7 @@ ac_measure_error_t AcMeasure::getKWHString(char *str)
 {
   char readBuffer[11] = {0};
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_KWH_STRING_REG, (uint8_t *) readBuffer, 11);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_KWH_STRING_REG, (uint8_t *) readBuffer, 11);
   memcpy(str, readBuffer, sizeof(readBuffer));
 
   return UNIT_AC_MEASURE_OK;
@@ -214,7 +256,7 @@ ac_measure_error_t AcMeasure::getKWHString(char *str)
 
 ac_measure_error_t AcMeasure::setKWH(uint32_t value)
 {
-  bspI2CWriteBytes(_addr, UNIT_ACMEASURE_KWH_REG, (uint8_t *) &value, 4);
+  bspI2CWriteBytes(_bus, _addr, UNIT_ACMEASURE_KWH_REG, (uint8_t *) &value, 4);
 
   return UNIT_AC_MEASURE_OK;
 }
@@ -223,7 +265,7 @@ uint8_t AcMeasure::getVoltageFactor(void)
 {
   uint8_t data[4] = {0};
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_VOLTAGE_FACTOR_REG, data, 1);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_VOLTAGE_FACTOR_REG, data, 1);
 
   return data[0];
 }
@@ -232,21 +274,21 @@ uint8_t AcMeasure::getCurrentFactor(void)
 {
   uint8_t data[4] = {0};
 
-  bspI2CReadBytes(_addr, UNIT_ACMEASURE_CURRENT_FACTOR_REG, data, 1);
+  bspI2CReadBytes(_bus, _addr, UNIT_ACMEASURE_CURRENT_FACTOR_REG, data, 1);
 
   return data[0];
 }
 
 ac_measure_error_t AcMeasure::setVoltageFactor(uint8_t value)
 {
-  bspI2CWriteBytes(_addr, UNIT_ACMEASURE_VOLTAGE_FACTOR_REG, (uint8_t *) &value, 1);
+  bspI2CWriteBytes(_bus, _addr, UNIT_ACMEASURE_VOLTAGE_FACTOR_REG, (uint8_t *) &value, 1);
 
   return UNIT_AC_MEASURE_OK;
 }
 
 ac_measure_error_t AcMeasure::setCurrentFactor(uint8_t value)
 {
-  bspI2CWriteBytes(_addr, UNIT_ACMEASURE_CURRENT_FACTOR_REG, (uint8_t *) &value, 1);
+  bspI2CWriteBytes(_bus, _addr, UNIT_ACMEASURE_CURRENT_FACTOR_REG, (uint8_t *) &value, 1);
 
   return UNIT_AC_MEASURE_OK;
 }
@@ -255,7 +297,7 @@ ac_measure_error_t AcMeasure::saveVoltageCurrentFactor(void)
 {
   uint8_t value = 1;
 
-  bspI2CWriteBytes(_addr, UNIT_ACMEASURE_SAVE_FACTOR_REG, (uint8_t *) &value, 1);
+  bspI2CWriteBytes(_bus, _addr, UNIT_ACMEASURE_SAVE_FACTOR_REG, (uint8_t *) &value, 1);
 
   return UNIT_AC_MEASURE_OK;
 }
@@ -264,14 +306,14 @@ ac_measure_error_t AcMeasure::jumpBootloader(void)
 {
   uint8_t value = 1;
 
-  bspI2CWriteBytes(_addr, UNIT_ACMEASURE_JUMP_TO_BOOTLOADER_REG, (uint8_t *) &value, 1);
+  bspI2CWriteBytes(_bus, _addr, UNIT_ACMEASURE_JUMP_TO_BOOTLOADER_REG, (uint8_t *) &value, 1);
 
   return UNIT_AC_MEASURE_OK;
 }
 
 uint8_t AcMeasure::setI2CAddress(uint8_t addr)
 {
-  bspI2CWriteByte(_addr, UNIT_ACMEASURE_I2C_ADDRESS_REG, addr);
+  bspI2CWriteByte(_bus, _addr, UNIT_ACMEASURE_I2C_ADDRESS_REG, addr);
   _addr = addr;
   return _addr;
 }
@@ -279,7 +321,7 @@ uint8_t AcMeasure::getI2CAddress(void)
 {
   uint8_t currentI2CAddress;
 
-  bspI2CReadByte(_addr, UNIT_ACMEASURE_I2C_ADDRESS_REG, currentI2CAddress);
+  bspI2CReadByte(_bus, _addr, UNIT_ACMEASURE_I2C_ADDRESS_REG, currentI2CAddress);
 
   return currentI2CAddress;
 }
@@ -18,6 +18,7 @@
   #else
     #include "WProgram.h"
   #endif
+  #include "bsp_i2c.h"
 
   /* Public defines ----------------------------------------------------- */
   #define AC_MEASURE_LIB_VERSION                   (F("0.1.0"))
@@ -43,6 +44,10 @@
   #define UNIT_ACMEASURE_FIRMWARE_VERSION_REG      0xFE
   #define UNIT_ACMEASURE_I2C_ADDRESS_REG           0xFF
 
+  // Voltage (0x60) through kWh (0xB0..0xB3) in one burst, the ready flag (0xFC) would overflow Wire's buffer
+  #define UNIT_ACMEASURE_SNAPSHOT_REG              UNIT_ACMEASURE_VOLTAGE_REG
+  #define UNIT_ACMEASURE_SNAPSHOT_LENGTH           (UNIT_ACMEASURE_KWH_REG + 4 - UNIT_ACMEASURE_SNAPSHOT_REG)
+
 /* Public enumerate/structure ----------------------------------------- */
 
 typedef enum
@@ -54,6 +59,18 @@ typedef enum
   UNIT_AC_MEASURE_ERR_I2C,  /* I2C error */
 } ac_measure_error_t;
 
+// Measurements taken from a single burst read
+typedef struct
+{
+  uint32_t timestamp;     /**< `millis()` when the burst completed */
+  float    voltage;       /**< Voltage in volts */
+  float    current;       /**< Current in amperes */
+  float    power;         /**< Active power in watts */
+  float    apparentPower; /**< Apparent power in volt-amperes */
+  float    powerFactor;   /**< Power factor, 0 to 1 */
+  float    kwh;           /**< Energy in kilowatt-hours */
+} ac_measure_snapshot_t;
+
 /* Public macros ------------------------------------------------------ */
 
 /* Public variables --------------------------------------------------- */
@@ -98,7 +115,8 @@ typedef enum
 class AcMeasure
 {
 private:
-  uint8_t _addr = UNIT_ACMEASURE_DEFAULT_ADDR;
+  uint8_t       _addr = UNIT_ACMEASURE_DEFAULT_ADDR;
+  bsp_i2c_bus_t _bus  = BSP_I2C_BUS_0;
 
 public:
   /**
@@ -107,7 +125,7 @@ public:
    * This function verifies the presence of the device at the specified I2C address.
    * It must be called before any other operations to ensure proper communication.
    *
-   * @param[in] None
+   * @param[in] bus I2C bus the device is wired to (default: `BSP_I2C_BUS_0`).
    *
    * @attention Ensure the device is powered and correctly connected to the I2C bus.
    *
@@ -116,7 +134,7 @@ public:
    *
    *  - `UNIT_AC_MEASURE_ERR_I2C`: I2C communication failure
    */
-  ac_measure_error_t begin(void);
+  ac_measure_error_t begin(bsp_i2c_bus_t bus = BSP_I2C_BUS_0);
 
   /**
    * @brief Retrieves the firmware version of the AC measurement device.
@@ -300,6 +318,26 @@ public:
    */
   float getKWH(void);
 
+  /**
+   * @brief Reads every measurement register in one burst.
+   *
+   * Checks the ready flag, then fetches voltage, current, power, apparent power, power factor and energy
+   * with a single transaction so all values come from the same instant. This takes two bus transactions
+   * where the individual getters take one per value.
+   *
+   * @param[out] snapshot Measurements and the time they were read.
+   *
+   * @attention Requires successful initialization via `begin()`. `snapshot` is left untouched on failure.
+   *
+   * @return
+   *  - `UNIT_AC_MEASURE_OK`: Success
+   *
+   *  - `UNIT_AC_MEASURE_ERR`: Device has no new data yet
+   *
+   *  - `UNIT_AC_MEASURE_ERR_I2C`: I2C communication failure
+   */
+  ac_measure_error_t readSnapshot(ac_measure_snapshot_t *snapshot);
+
   /**
    * @brief Retrieves the voltage as a formatted string.
    *
@@ -13,7 +13,7 @@
 #include "bmp280.h"
 #include "bsp_i2c.h"
 #include "config.h"
-#include "utility.h"
+#include "fast_math.h"
 
 /* Private defines ---------------------------------------------------- */
 
@@ -26,13 +26,17 @@
 /* Private variables -------------------------------------------------- */
 
 /* Class method definitions ------------------------------------------- */
-bmp280_error_t BMP280::begin()
+bmp280_error_t BMP280::begin(bsp_i2c_bus_t bus)
 {
-  if (!bspI2CExist(BMP280_I2C_ADDR))
+  _bus = bus;
+  if (!bspI2CExist(_bus, BMP280_I2C_ADDR))
+  {
+    return BMP280_ERR_I2C;
+  }
+  if (readCoefficients() != BMP280_OK)
   {
     return BMP280_ERR_I2C;
   }
-  readCoefficients();
   setSampling();
 
   return BMP280_OK;
@@ -40,34 +44,81 @@ bmp280_error_t BMP280::begin()
 
 bmp280_error_t BMP280::update()
 {
-  readTemperature();
-  readPressure();
-  readAltitude();
-  return BMP280_OK;
+  uint8_t buffer[BMP280_DATA_LENGTH];
+
+  // In forced mode every update consumes one started conversion, a conversion still running would leave
+  // the previous values in the data registers
+  if (_measReg.mode == MODE_FORCED)
+  {
+    if (!_forcedPending)
+    {
+      return BMP280_ERR_NO_DATA;
+    }
+    if (getStatus() & BMP280_STATUS_MEASURING)
+    {
+      return BMP280_ERR_BUSY;
+    }
+    _forcedPending = false;
+  }
+
+  // One burst: the sensor keeps the data registers of a conversion together until the read ends, so the
+  // pressure and the temperature it is compensated with come from the same conversion
+  if (bspI2CReadBytes(_bus, BMP280_I2C_ADDR, BMP280_REGISTER_PRESSUREDATA, buffer, BMP280_DATA_LENGTH) !=
+      BSP_I2C_OK)
+  {
+    return BMP280_ERR_I2C;
+  }
+  int32_t adc_P = (int32_t) (uint32_t(buffer[0]) << 12 | uint32_t(buffer[1]) << 4 | buffer[2] >> 4);
+  int32_t adc_T = (int32_t) (uint32_t(buffer[3]) << 12 | uint32_t(buffer[4]) << 4 | buffer[5] >> 4);
+  if (adc_P == BMP280_ADC_SKIPPED || adc_T == BMP280_ADC_SKIPPED)
+  {
+    return BMP280_ERR_NO_DATA;
+  }
+
+  compensateTemperature(adc_T);
+  bmp280_error_t status = compensatePressure(adc_P);
+  if (status != BMP280_OK)
+  {
+    return status;
+  }
+  return readAltitude();
 }
 
 bmp280_error_t BMP280::reset(void)
 {
-  bspI2CWriteByte(BMP280_I2C_ADDR, BMP280_REGISTER_SOFTRESET, MODE_SOFT_RESET_CODE);
+  bspI2CWriteByte(_bus, BMP280_I2C_ADDR, BMP280_REGISTER_SOFTRESET, MODE_SOFT_RESET_CODE);
   return BMP280_OK;
 }
 
 uint8_t BMP280::getStatus(void)
 {
   uint8_t byte = 0;
-  bspI2CReadByte(BMP280_I2C_ADDR, BMP280_REGISTER_STATUS, byte);
+  bspI2CReadByte(_bus, BMP280_I2C_ADDR, BMP280_REGISTER_STATUS, byte);
   return byte;
 }
 
 bmp280_error_t BMP280::readPressure()
 {
-  int64_t var1, var2, p;
-
-  // Must be done first to get the t_fine variable set up
-
+  // readTemperature() must be done first to get the t_fine variable set up
   int32_t adc_P = read24(BMP280_REGISTER_PRESSUREDATA);
   adc_P >>= 4;
 
+  return compensatePressure(adc_P);
+}
+
+bmp280_error_t BMP280::readTemperature()
+{
+  int32_t adc_T = read24(BMP280_REGISTER_TEMPDATA);
+  adc_T >>= 4;
+
+  compensateTemperature(adc_T);
+  return BMP280_OK;
+}
+
+bmp280_error_t BMP280::compensatePressure(int32_t adc_P)
+{
+  int64_t var1, var2, p;
+
   var1 = ((int64_t) t_fine) - 128000;
   var2 = var1 * var1 * (int64_t) _bmp280_calib.dig_P6;
   var2 = var2 + ((var1 * (int64_t) _bmp280_calib.dig_P5) << 17);
@@ -86,18 +137,15 @@ bmp280_error_t BMP280::readPressure()
   var2 = (((int64_t) _bmp280_calib.dig_P8) * p) >> 19;
 
   p              = ((p + var1 + var2) >> 8) + (((int64_t) _bmp280_calib.dig_P7) << 4);
-  sensorValue[0] = p / 256;
+  sensorValue[0] = p / 256.0f; // Q24.8 Pa, keep the fraction
 
   return BMP280_OK;
 }
 
-bmp280_error_t BMP280::readTemperature()
+void BMP280::compensateTemperature(int32_t adc_T)
 {
   int32_t var1, var2;
 
-  int32_t adc_T = read24(BMP280_REGISTER_TEMPDATA);
-  adc_T >>= 4;
-
   var1 = ((((adc_T >> 3) - ((int32_t) _bmp280_calib.dig_T1 << 1))) * ((int32_t) _bmp280_calib.dig_T2)) >> 11;
 
   var2 =
@@ -110,14 +158,12 @@ bmp280_error_t BMP280::readTemperature()
 
   float T        = (t_fine * 5 + 128) >> 8;
   sensorValue[1] = T / 100;
-  return BMP280_OK;
 }
 
 bmp280_error_t BMP280::readAltitude()
 {
-  float pressure = getPressure(); // in SI units for Pascal
-  pressure /= 100;
-  sensorValue[2] = 44330 * (1.0 - pow(pressure / _seaLevelhPa, 0.1903));
+  // Single precision table lookups, pow() on doubles runs in software on the ESP32-S3
+  sensorValue[2] = fastPressureAltitude(getPressure(), _seaLevelhPa);
   return BMP280_OK;
 }
 
@@ -129,29 +175,57 @@ float BMP280::getAltitude() { return sensorValue[2]; }
 
 float BMP280::seaLevelForAltitude(float altitude, float atmospheric)
 {
-  return atmospheric / pow(1.0 - (altitude / 44330.0), 5.255);
+  return atmospheric / fastPowf(1.0f - (altitude / 44330.0f), 5.255f);
 }
 
 void BMP280::setSeaLevelPressure(float pressure) { _seaLevelhPa = pressure; }
 
 float BMP280::waterBoilingPoint(float pressure)
 {
-  return (234.175 * log(pressure / 6.1078)) / (17.08085 - log(pressure / 6.1078));
+  float lnRatio = fastLnf(pressure / 6.1078f);
+  return (234.175f * lnRatio) / (17.08085f - lnRatio);
 }
 
 bool BMP280::takeForcedMeasurement()
 {
-  if (_measReg.mode == MODE_FORCED)
+  if (startForcedMeasurement() != BMP280_OK)
+  {
+    return false;
+  }
+  while (getStatus() & BMP280_STATUS_MEASURING)
   {
-    bspI2CWriteByte(BMP280_I2C_ADDR, BMP280_REGISTER_CONTROL, _measReg.get());
+    DELAY(1);
+  }
+  return true;
+}
 
-    while (getStatus() & 0x08)
-    {
-      DELAY(1);
-    }
-    return true;
+bmp280_error_t BMP280::startForcedMeasurement()
+{
+  if (_measReg.mode != MODE_FORCED)
+  {
+    return BMP280_ERR;
+  }
+  // Writing ctrl_meas with the forced mode bits starts a conversion, the sensor sleeps again after it
+  if (bspI2CWriteByte(_bus, BMP280_I2C_ADDR, BMP280_REGISTER_CONTROL, _measReg.get()) != BSP_I2C_OK)
+  {
+    return BMP280_ERR_I2C;
+  }
+  _forcedPending = true;
+  return BMP280_OK;
+}
+
+uint32_t BMP280::measurementTimeMs()
+{
+  // Oversampling setting n takes 2^(n - 1) samples, 0 skips the measurement
+  uint32_t temperatureSamples = (_measReg.osrs_t == SAMPLING_NONE) ? 0 : 1U << (_measReg.osrs_t - 1);
+  uint32_t pressureSamples    = (_measReg.osrs_p == SAMPLING_NONE) ? 0 : 1U << (_measReg.osrs_p - 1);
+  uint32_t timeUs             = 1250 + 2300 * temperatureSamples;
+
+  if (pressureSamples > 0)
+  {
+    timeUs += 2300 * pressureSamples + 575;
   }
-  return false;
+  return (timeUs + 999) / 1000;
 }
 
 bmp280_error_t BMP280::setSampling(bmp280_mode_t mode, bmp280_sampling_t tempSampling,
@@ -165,27 +239,37 @@ bmp280_error_t BMP280::setSampling(bmp280_mode_t mode, bmp280_sampling_t tempSam
   _configReg.filter = filter;
   _configReg.t_sb   = duration;
 
-  bspI2CWriteByte(BMP280_I2C_ADDR, BMP280_REGISTER_CONTROL, _measReg.get());
-  bspI2CWriteByte(BMP280_I2C_ADDR, BMP280_REGISTER_CONFIG, _configReg.get());
+  // The control register goes last: in forced mode writing it starts a conversion
+  bspI2CWriteByte(_bus, BMP280_I2C_ADDR, BMP280_REGISTER_CONFIG, _configReg.get());
+  bspI2CWriteByte(_bus, BMP280_I2C_ADDR, BMP280_REGISTER_CONTROL, _measReg.get());
+  _forcedPending = (mode == MODE_FORCED);
 
   return BMP280_OK;
 }
 
 bmp280_error_t BMP280::readCoefficients()
 {
-  _bmp280_calib.dig_T1 = read16_LE(BMP280_REGISTER_DIG_T1);
-  _bmp280_calib.dig_T2 = readS16_LE(BMP280_REGISTER_DIG_T2);
-  _bmp280_calib.dig_T3 = readS16_LE(BMP280_REGISTER_DIG_T3);
+  // dig_T1..dig_P9 are 12 consecutive little-endian words, fetch them in one burst
+  uint8_t buffer[BMP280_CALIB_LENGTH];
+  if (bspI2CReadBytes(_bus, BMP280_I2C_ADDR, BMP280_REGISTER_DIG_T1, buffer, BMP280_CALIB_LENGTH) !=
+      BSP_I2C_OK)
+  {
+    return BMP280_ERR_I2C;
+  }
+
+  _bmp280_calib.dig_T1 = uint16_t(buffer[1]) << 8 | buffer[0];
+  _bmp280_calib.dig_T2 = (int16_t) (uint16_t(buffer[3]) << 8 | buffer[2]);
+  _bmp280_calib.dig_T3 = (int16_t) (uint16_t(buffer[5]) << 8 | buffer[4]);
 
-  _bmp280_calib.dig_P1 = read16_LE(BMP280_REGISTER_DIG_P1);
-  _bmp280_calib.dig_P2 = readS16_LE(BMP280_REGISTER_DIG_P2);
-  _bmp280_calib.dig_P3 = readS16_LE(BMP280_REGISTER_DIG_P3);
-  _bmp280_calib.dig_P4 = readS16_LE(BMP280_REGISTER_DIG_P4);
-  _bmp280_calib.dig_P5 = readS16_LE(BMP280_REGISTER_DIG_P5);
-  _bmp280_calib.dig_P6 = readS16_LE(BMP280_REGISTER_DIG_P6);
-  _bmp280_calib.dig_P7 = readS16_LE(BMP280_REGISTER_DIG_P7);
-  _bmp280_calib.dig_P8 = readS16_LE(BMP280_REGISTER_DIG_P8);
-  _bmp280_calib.dig_P9 = readS16_LE(BMP280_REGISTER_DIG_P9);
+  _bmp280_calib.dig_P1 = uint16_t(buffer[7]) << 8 | buffer[6];
+  _bmp280_calib.dig_P2 = (int16_t) (uint16_t(buffer[9]) << 8 | buffer[8]);
+  _bmp280_calib.dig_P3 = (int16_t) (uint16_t(buffer[11]) << 8 | buffer[10]);
+  _bmp280_calib.dig_P4 = (int16_t) (uint16_t(buffer[13]) << 8 | buffer[12]);
+  _bmp280_calib.dig_P5 = (int16_t) (uint16_t(buffer[15]) << 8 | buffer[14]);
+  _bmp280_calib.dig_P6 = (int16_t) (uint16_t(buffer[17]) << 8 | buffer[16]);
+  _bmp280_calib.dig_P7 = (int16_t) (uint16_t(buffer[19]) << 8 | buffer[18]);
+  _bmp280_calib.dig_P8 = (int16_t) (uint16_t(buffer[21]) << 8 | buffer[20]);
+  _bmp280_calib.dig_P9 = (int16_t) (uint16_t(buffer[23]) << 8 | buffer[22]);
 
   return BMP280_OK;
 }
@@ -196,7 +280,7 @@ bmp280_error_t BMP280::readCoefficients()
 uint16_t BMP280::read16(byte reg)
 {
   uint8_t buffer[2];
-  bspI2CReadBytes(BMP280_I2C_ADDR, reg, buffer, 2);
+  bspI2CReadBytes(_bus, BMP280_I2C_ADDR, reg, buffer, 2);
   return uint16_t(buffer[0]) << 8 | uint16_t(buffer[1]);
 }
 
@@ -219,7 +303,7 @@ int16_t BMP280::readS16_LE(byte reg) { return (int16_t) read16_LE(reg); }
 uint32_t BMP280::read24(byte reg)
 {
   uint8_t buffer[3];
-  bspI2CReadBytes(BMP280_I2C_ADDR, reg, buffer, 3);
+  bspI2CReadBytes(_bus, BMP280_I2C_ADDR, reg, buffer, 3);
   return uint32_t(buffer[0]) << 16 | uint32_t(buffer[1]) << 8 | uint32_t(buffer[2]);
 }
 /* Private function prototypes ---------------------------------------- */
@@ -19,11 +19,16 @@
   #else
     #include "WProgram.h"
   #endif
+  #include "bsp_i2c.h"
 
   /* Public defines ----------------------------------------------------- */
-  #define BMP280_LIB_VERSION (F("0.1.0"))
+  #define BMP280_LIB_VERSION      (F("0.1.0"))
 
-  #define BMP280_I2C_ADDR    0x76
+  #define BMP280_I2C_ADDR         0x76
+  #define BMP280_CALIB_LENGTH     24      // dig_T1 (0x88) .. dig_P9 (0x9F)
+  #define BMP280_DATA_LENGTH      6       // press_msb (0xF7) .. temp_xlsb (0xFC)
+  #define BMP280_STATUS_MEASURING 0x08    // Conversion running, set until the data registers are updated
+  #define BMP280_ADC_SKIPPED      0x80000 // Data register value of a skipped or not yet run conversion
 /* Public enumerate/structure ----------------------------------------- */
 typedef enum
 {
@@ -34,7 +39,9 @@ typedef enum
   BMP280_TIMEOUT,      /* Timeout error*/
   BMP280_ERR_I2C,      /* I2C error */
   BMP280_ERR_DIV_ZERO, /* Divide by 0 error */
-  BMP280_ERR_CHECKSUM  /* Checksum error */
+  BMP280_ERR_CHECKSUM, /* Checksum error */
+  BMP280_ERR_BUSY,     /* Forced conversion still running */
+  BMP280_ERR_NO_DATA   /* No new conversion to read, or the measurement is skipped */
 } bmp280_error_t;
 
 /** Oversampling rate for the sensor. */
@@ -171,7 +178,7 @@ public:
    *
    * Verifies I2C connectivity, reads calibration coefficients, and sets default sampling parameters.
    *
-   * @param[in] None
+   * @param[in] bus I2C bus the sensor is wired to (default: `BSP_I2C_BUS_0`).
    *
    * @attention Ensure the sensor is powered and connected to the I2C bus before calling.
    *
@@ -180,19 +187,31 @@ public:
    *
    *  - `BMP280_ERR_I2C`: I2C communication failure
    */
-  bmp280_error_t begin();
+  bmp280_error_t begin(bsp_i2c_bus_t bus = BSP_I2C_BUS_0);
 
   /**
    * @brief Updates all sensor measurements.
    *
-   * Reads temperature, pressure, and altitude in sequence, storing results in the internal sensor array.
+   * Reads the pressure and temperature data registers (0xF7..0xFC) in one 6-byte burst, so both values
+   * come from the same conversion, compensates them and computes the altitude, storing results in the
+   * internal sensor array.
    *
    * @param[in] None
    *
-   * @attention Requires successful initialization via `begin()`.
+   * @attention Requires successful initialization via `begin()`. In forced mode, call
+   * `startForcedMeasurement()` at least `measurementTimeMs()` before.
    *
    * @return
    *  - `BMP280_OK`: Success
+   *
+   *  - `BMP280_ERR_I2C`: I2C communication failure
+   *
+   *  - `BMP280_ERR_BUSY`: Forced mode, the conversion has not finished, values unchanged
+   *
+   *  - `BMP280_ERR_NO_DATA`: No conversion has run yet, or in forced mode none was started since the last
+   *    update, values unchanged
+   *
+   *  - `BMP280_ERR_DIV_ZERO`: Invalid calibration
    */
   bmp280_error_t update();
 
@@ -366,6 +385,37 @@ public:
    */
   bool takeForcedMeasurement();
 
+  /**
+   * @brief Starts one conversion in forced mode without waiting for it.
+   *
+   * Writes the control register once, the sensor converts and goes back to sleep. The scheduler calls it
+   * `measurementTimeMs()` ahead of `update()`, so the sensor only measures when a value is consumed and the
+   * bus is never held while it converts.
+   *
+   * @param[in] None
+   *
+   * @attention Only works if the sensor is in forced mode (`MODE_FORCED`).
+   *
+   * @return
+   *  - `BMP280_OK`: Conversion started
+   *
+   *  - `BMP280_ERR`: Sensor not in forced mode
+   *
+   *  - `BMP280_ERR_I2C`: I2C communication failure
+   */
+  bmp280_error_t startForcedMeasurement();
+
+  /**
+   * @brief Returns the longest conversion time for the configured oversampling.
+   *
+   * Datasheet appendix B: 1.25 ms + 2.3 ms per temperature sample + 2.3 ms per pressure sample + 0.575 ms.
+   *
+   * @param[in] None
+   *
+   * @return uint32_t Conversion time in milliseconds, rounded up.
+   */
+  uint32_t measurementTimeMs();
+
   /**
    * @brief Configures the sensor’s sampling and operating parameters.
    *
@@ -388,12 +438,16 @@ public:
                              bmp280_standby_duration_t duration      = STANDBY_MS_1);
 
 private:
+  bsp_i2c_bus_t _bus = BSP_I2C_BUS_0;
+
   float sensorValue[3] = {0.f}; // Index 0: Pressure
                                 // Index 1: Temperature
                                 // Index 2: Altitude
 
   float _seaLevelhPa = 1013.25f;
 
+  bool _forcedPending = false; // Forced conversion started and not read yet
+
   /** Encapsulates the config register */
   struct config
   {
@@ -427,6 +481,8 @@ private:
   };
 
   bmp280_error_t readCoefficients(void);
+  void           compensateTemperature(int32_t adc_T);
+  bmp280_error_t compensatePressure(int32_t adc_P);
   uint16_t       read16(byte reg);
   uint32_t       read24(byte reg);
   int16_t        readS16(byte reg);
@@ -15,211 +15,692 @@
 #include "bsp_i2c.h"
 #include "config.h" // Global config file
 #include <Wire.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef BSP_I2C_VIRTUAL
+  #include "bsp_i2c_virtual.h"
+#endif
 
 /* Private defines ---------------------------------------------------- */
+#define BSP_I2C_STATS_NONE 0xFF // Free profiler slot
 
 /* Private enumerate/structure ---------------------------------------- */
 
+// Cached output register
+typedef struct
+{
+  bool    used;
+  bool    dirty; // Holds updates not written to the device yet
+  uint8_t address;
+  uint8_t reg;
+  uint8_t value;
+} bsp_i2c_shadow_t;
+
+// Everything owned by one I2C controller
+typedef struct
+{
+  TwoWire          *wire;
+  const char       *taskName;
+  QueueHandle_t     queue;
+  TaskHandle_t      ownerTask;
+  bsp_i2c_backend_t backend; // NULL selects the TwoWire backend
+  bsp_i2c_stats_t   stats[BSP_I2C_STATS_ADDRESSES];
+  bool              statsReady;
+  bsp_i2c_shadow_t  shadows[BSP_I2C_SHADOW_REGISTERS];
+} bsp_i2c_bus_context_t;
+
 /* Private macros ----------------------------------------------------- */
 
 /* Public variables --------------------------------------------------- */
-static TwoWire *i2cWire = &Wire;
 
 /* Private variables -------------------------------------------------- */
+// Controller, owner task name, then no queue, owner, backend, counters or shadows until first used
+static bsp_i2c_bus_context_t i2cBuses[BSP_I2C_BUS_COUNT] = {
+{&Wire, "I2C Bus 0 Task", NULL, NULL, NULL, {}, false, {}},
+{&Wire1, "I2C Bus 1 Task", NULL, NULL, NULL, {}, false, {}},
+};
+
+// Upper bound of every latency bucket but the last, in microseconds
+static const uint32_t i2cLatencyBounds[BSP_I2C_LATENCY_BUCKETS - 1] = {100,  200,  500, 1000,
+                                                                      2000, 5000, 10000};
 
 /* Private function prototypes ---------------------------------------- */
+static SemaphoreHandle_t bspI2CLock(bsp_i2c_bus_t bus);
+static bsp_i2c_error_t   bspI2CRun(bsp_i2c_bus_t bus, bsp_i2c_xfer_type_t type, int address, int16_t reg,
+                                   const uint8_t *txBuffer, size_t txLength, uint8_t *rxBuffer,
+                                   size_t rxLength);
+static bsp_i2c_error_t   bspI2CMapError(uint8_t status);
+static bsp_i2c_error_t   bspI2CWireBackend(bsp_i2c_transaction_t *transaction);
+static void              bspI2CExecute(bsp_i2c_transaction_t *transaction);
+static void              bspI2CResetBusStats(bsp_i2c_bus_context_t *context);
+static void              bspI2CRecord(const bsp_i2c_transaction_t *transaction, uint32_t latencyUs);
+static bsp_i2c_shadow_t *bspI2CShadowFind(bsp_i2c_bus_t bus, uint8_t address, uint8_t reg);
+static void              bspI2CShadowSync(const bsp_i2c_transaction_t *transaction);
+static void              bspI2CComplete(bsp_i2c_transaction_t *transaction);
+static void              bspI2CBusOwnerTask(void *pvParameters);
 
 /* Function definitions ----------------------------------------------- */
-bsp_i2c_error_t bspI2CBegin()
+bsp_i2c_error_t bspI2CBegin(bsp_i2c_bus_t bus, int sda, int scl)
 {
-  i2cWire->begin();
+  if (bus >= BSP_I2C_BUS_COUNT)
+  {
+    return BSP_I2C_ERR;
+  }
+
+#ifdef BSP_I2C_VIRTUAL
+  // Hardware-less build, serve every transaction from the device models
+  static bool virtualStarted = false;
+  if (!virtualStarted)
+  {
+    bspI2CVirtualBegin();
+    virtualStarted = true;
+  }
+  bspI2CSetBackend(bus, bspI2CVirtualBackend);
+#endif
+
+  TwoWire *wire = i2cBuses[bus].wire;
+  if (!wire->begin(sda, scl))
+  {
+    return BSP_I2C_ERR;
+  }
+  wire->setTimeOut(BSP_I2C_BUS_TIMEOUT_MS);
   return BSP_I2C_OK;
 }
 
-bsp_i2c_error_t bspI2CBegin(uint8_t address)
+bsp_i2c_error_t bspI2CSetClock(bsp_i2c_bus_t bus, uint32_t frequency)
 {
-  i2cWire->begin(address);
+  if (bus >= BSP_I2C_BUS_COUNT)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  xSemaphoreTakeRecursive(bspI2CLock(bus), portMAX_DELAY);
+  bool ok = i2cBuses[bus].wire->setClock(frequency);
+  xSemaphoreGiveRecursive(bspI2CLock(bus));
+
+  return ok ? BSP_I2C_OK : BSP_I2C_ERR;
+}
+
+bsp_i2c_error_t bspI2CSetBackend(bsp_i2c_bus_t bus, bsp_i2c_backend_t backend)
+{
+  if (bus >= BSP_I2C_BUS_COUNT)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  xSemaphoreTakeRecursive(bspI2CLock(bus), portMAX_DELAY);
+  i2cBuses[bus].backend = backend;
+  xSemaphoreGiveRecursive(bspI2CLock(bus));
+
   return BSP_I2C_OK;
 }
 
-bsp_i2c_error_t bspI2CBeginTransmission(uint16_t address)
+bsp_i2c_error_t bspI2CBusStart(bsp_i2c_bus_t bus)
 {
-  i2cWire->beginTransmission(address);
+  if (bus >= BSP_I2C_BUS_COUNT)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  bsp_i2c_bus_context_t *context = &i2cBuses[bus];
+  if (context->queue != NULL)
+  {
+    return BSP_I2C_OK;
+  }
+
+  QueueHandle_t queue = xQueueCreate(BSP_I2C_QUEUE_LENGTH, sizeof(bsp_i2c_transaction_t *));
+  if (queue == NULL)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  // Publish the queue only once the owner task exists so early callers keep running inline
+  if (xTaskCreate(bspI2CBusOwnerTask, context->taskName, BSP_I2C_TASK_STACK_SIZE, queue,
+                  BSP_I2C_TASK_PRIORITY, &context->ownerTask) != pdPASS)
+  {
+    vQueueDelete(queue);
+    return BSP_I2C_ERR;
+  }
+  context->queue = queue;
+
   return BSP_I2C_OK;
 }
 
-bsp_i2c_error_t bspI2CBeginTransmission(uint8_t address)
+bsp_i2c_error_t bspI2CSubmit(bsp_i2c_transaction_t *transaction)
 {
-  i2cWire->beginTransmission(address);
+  if (transaction->bus >= BSP_I2C_BUS_COUNT)
+  {
+    transaction->result = BSP_I2C_ERR;
+    return BSP_I2C_ERR;
+  }
+
+  bsp_i2c_bus_context_t *context = &i2cBuses[transaction->bus];
+  if (context->queue == NULL || xTaskGetCurrentTaskHandle() == context->ownerTask)
+  {
+    bspI2CExecute(transaction);
+    bspI2CComplete(transaction);
+    return BSP_I2C_OK;
+  }
+
+  if (xQueueSend(context->queue, &transaction, pdMS_TO_TICKS(BSP_I2C_QUEUE_TIMEOUT_MS)) != pdTRUE)
+  {
+    transaction->result = BSP_I2C_TIMEOUT;
+    xSemaphoreTakeRecursive(bspI2CLock(transaction->bus), portMAX_DELAY);
+    bspI2CRecord(transaction, 0);
+    xSemaphoreGiveRecursive(bspI2CLock(transaction->bus));
+    return BSP_I2C_TIMEOUT;
+  }
   return BSP_I2C_OK;
 }
 
-bsp_i2c_error_t bspI2CBeginTransmission(int address)
+bsp_i2c_error_t bspI2CTransfer(bsp_i2c_transaction_t *transaction)
 {
-  i2cWire->beginTransmission(address);
+  if (transaction->bus >= BSP_I2C_BUS_COUNT)
+  {
+    transaction->result = BSP_I2C_ERR;
+    return BSP_I2C_ERR;
+  }
+
+  bsp_i2c_bus_context_t *context = &i2cBuses[transaction->bus];
+  if (context->queue == NULL || xTaskGetCurrentTaskHandle() == context->ownerTask)
+  {
+    bspI2CExecute(transaction);
+    return transaction->result;
+  }
+
+  // The notification belongs to I2C completions alone (BspRs485 frame ends use a semaphore), a count left
+  // by a completion that nobody waited for must not end this wait before the owner ran the transaction
+  ulTaskNotifyTake(pdTRUE, 0);
+  transaction->notifyTask = xTaskGetCurrentTaskHandle();
+  if (bspI2CSubmit(transaction) != BSP_I2C_OK)
+  {
+    return BSP_I2C_TIMEOUT;
+  }
+
+  // The owner always completes a queued transaction (Wire applies its own bus timeout), and the
+  // descriptor lives on our stack, so wait for the notification rather than giving up early.
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  return transaction->result;
+}
+
+bsp_i2c_error_t bspI2CGetStats(bsp_i2c_bus_t bus, uint8_t address, bsp_i2c_stats_t *stats)
+{
+  bsp_i2c_error_t result = BSP_I2C_ERR;
+
+  if (bus >= BSP_I2C_BUS_COUNT)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  bsp_i2c_bus_context_t *context = &i2cBuses[bus];
+  xSemaphoreTakeRecursive(bspI2CLock(bus), portMAX_DELAY);
+  for (uint8_t i = 0; context->statsReady && i < BSP_I2C_STATS_ADDRESSES; i++)
+  {
+    if (context->stats[i].address == address)
+    {
+      *stats = context->stats[i];
+      result = BSP_I2C_OK;
+      break;
+    }
+  }
+  xSemaphoreGiveRecursive(bspI2CLock(bus));
+
+  return result;
+}
+
+bsp_i2c_error_t bspI2CGetStatsAt(bsp_i2c_bus_t bus, uint8_t index, bsp_i2c_stats_t *stats)
+{
+  bsp_i2c_error_t result = BSP_I2C_ERR;
+
+  if (bus >= BSP_I2C_BUS_COUNT)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  bsp_i2c_bus_context_t *context = &i2cBuses[bus];
+  xSemaphoreTakeRecursive(bspI2CLock(bus), portMAX_DELAY);
+  if (context->statsReady && index < BSP_I2C_STATS_ADDRESSES &&
+      context->stats[index].address != BSP_I2C_STATS_NONE)
+  {
+    *stats = context->stats[index];
+    result = BSP_I2C_OK;
+  }
+  xSemaphoreGiveRecursive(bspI2CLock(bus));
+
+  return result;
+}
+
+size_t bspI2CStatsToJson(const bsp_i2c_stats_t *stats, char *buffer, size_t size)
+{
+  uint32_t average = (stats->transactions > 0) ? (uint32_t) (stats->latencyTotalUs / stats->transactions) : 0;
+  int      len     = snprintf(buffer, size,
+                              "{\"tx\":%lu,\"wr\":%lu,\"rd\":%lu,\"nack\":%lu,\"short\":%lu,\"to\":%lu,"
+                              "\"avg\":%lu,\"max\":%lu,\"hist\":[",
+                              (unsigned long) stats->transactions, (unsigned long) stats->bytesWritten,
+                              (unsigned long) stats->bytesRead, (unsigned long) stats->nacks,
+                              (unsigned long) stats->shortReads, (unsigned long) stats->timeouts,
+                              (unsigned long) average,
+                              (unsigned long) stats->latencyMaxUs);
+
+  for (uint8_t i = 0; i < BSP_I2C_LATENCY_BUCKETS && len >= 0; i++)
+  {
+    size_t used = ((size_t) len < size) ? (size_t) len : size;
+    len += snprintf(buffer + used, size - used, (i == 0) ? "%lu" : ",%lu", (unsigned long) stats->latency[i]);
+  }
+  if (len >= 0)
+  {
+    size_t used = ((size_t) len < size) ? (size_t) len : size;
+    len += snprintf(buffer + used, size - used, "]}");
+  }
+
+  return (len < 0) ? 0 : (size_t) len;
+}
+
+void bspI2CResetStats(void)
+{
+  for (uint8_t bus = 0; bus < BSP_I2C_BUS_COUNT; bus++)
+  {
+    xSemaphoreTakeRecursive(bspI2CLock((bsp_i2c_bus_t) bus), portMAX_DELAY);
+    bspI2CResetBusStats(&i2cBuses[bus]);
+    xSemaphoreGiveRecursive(bspI2CLock((bsp_i2c_bus_t) bus));
+  }
+}
+
+bsp_i2c_error_t bspI2CShadowAttach(bsp_i2c_bus_t bus, uint8_t address, uint8_t reg)
+{
+  bsp_i2c_shadow_t *shadow = NULL;
+  uint8_t           value  = 0;
+
+  if (bus >= BSP_I2C_BUS_COUNT)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  xSemaphoreTakeRecursive(bspI2CLock(bus), portMAX_DELAY);
+  bool attached = (bspI2CShadowFind(bus, address, reg) != NULL);
+  xSemaphoreGiveRecursive(bspI2CLock(bus));
+  if (attached)
+  {
+    return BSP_I2C_OK;
+  }
+
+  // Read outside the lock, the bus owner takes it to run the transaction
+  if (bspI2CReadByte(bus, address, reg, value) != BSP_I2C_OK)
+  {
+    return BSP_I2C_ERR_READ;
+  }
+
+  xSemaphoreTakeRecursive(bspI2CLock(bus), portMAX_DELAY);
+  for (uint8_t i = 0; i < BSP_I2C_SHADOW_REGISTERS && shadow == NULL; i++)
+  {
+    if (!i2cBuses[bus].shadows[i].used)
+    {
+      shadow          = &i2cBuses[bus].shadows[i];
+      shadow->used    = true;
+      shadow->dirty   = false;
+      shadow->address = address;
+      shadow->reg     = reg;
+      shadow->value   = value;
+    }
+  }
+  xSemaphoreGiveRecursive(bspI2CLock(bus));
+
+  return (shadow != NULL) ? BSP_I2C_OK : BSP_I2C_ERR;
+}
+
+bsp_i2c_error_t bspI2CShadowUpdate(bsp_i2c_bus_t bus, uint8_t address, uint8_t reg, uint8_t mask,
+                                   uint8_t value)
+{
+  bsp_i2c_error_t result = BSP_I2C_ERR;
+
+  if (bus >= BSP_I2C_BUS_COUNT)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  xSemaphoreTakeRecursive(bspI2CLock(bus), portMAX_DELAY);
+  bsp_i2c_shadow_t *shadow = bspI2CShadowFind(bus, address, reg);
+  if (shadow != NULL)
+  {
+    uint8_t merged = (shadow->value & ~mask) | (value & mask);
+    if (merged != shadow->value)
+    {
+      shadow->value = merged;
+      shadow->dirty = true;
+    }
+    result = BSP_I2C_OK;
+  }
+  xSemaphoreGiveRecursive(bspI2CLock(bus));
+
+  return result;
+}
+
+bsp_i2c_error_t bspI2CShadowFlush(bsp_i2c_bus_t bus, uint8_t address, uint8_t reg)
+{
+  uint8_t value;
+
+  if (bus >= BSP_I2C_BUS_COUNT)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  xSemaphoreTakeRecursive(bspI2CLock(bus), portMAX_DELAY);
+  bsp_i2c_shadow_t *shadow = bspI2CShadowFind(bus, address, reg);
+  if (shadow == NULL || !shadow->dirty)
+  {
+    xSemaphoreGiveRecursive(bspI2CLock(bus));
+    return (shadow != NULL) ? BSP_I2C_OK : BSP_I2C_ERR;
+  }
+  value         = shadow->value;
+  shadow->dirty = false;
+  // Release the lock before queuing, the bus owner takes it to run the write
+  xSemaphoreGiveRecursive(bspI2CLock(bus));
+
+  bsp_i2c_error_t result = bspI2CWriteByte(bus, address, reg, value);
+  if (result != BSP_I2C_OK)
+  {
+    xSemaphoreTakeRecursive(bspI2CLock(bus), portMAX_DELAY);
+    shadow->dirty = true;
+    xSemaphoreGiveRecursive(bspI2CLock(bus));
+    return BSP_I2C_ERR_WRITE;
+  }
+
   return BSP_I2C_OK;
 }
 
-uint8_t bspI2CEndTransmission(bool sendStop) { return i2cWire->endTransmission(sendStop); }
+bsp_i2c_error_t bspI2CShadowGet(bsp_i2c_bus_t bus, uint8_t address, uint8_t reg, uint8_t &value)
+{
+  bsp_i2c_error_t result = BSP_I2C_ERR;
 
-uint8_t bspI2CEndTransmission(void) { return i2cWire->endTransmission(); }
+  if (bus >= BSP_I2C_BUS_COUNT)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  xSemaphoreTakeRecursive(bspI2CLock(bus), portMAX_DELAY);
+  bsp_i2c_shadow_t *shadow = bspI2CShadowFind(bus, address, reg);
+  if (shadow != NULL)
+  {
+    value  = shadow->value;
+    result = BSP_I2C_OK;
+  }
+  xSemaphoreGiveRecursive(bspI2CLock(bus));
+
+  return result;
+}
 
-size_t bspI2CRequestFrom(uint16_t address, size_t size, bool sendStop)
+bsp_i2c_error_t bspI2CReadByte(bsp_i2c_bus_t bus, int address, uint8_t reg, uint8_t &byte)
 {
-  return i2cWire->requestFrom(address, size, sendStop);
+  return bspI2CRun(bus, BSP_I2C_XFER_WRITE_READ, address, reg, NULL, 0, &byte, 1);
 }
 
-uint8_t bspI2CRequestFrom(uint16_t address, uint8_t size, bool sendStop)
+bsp_i2c_error_t bspI2CReadByte(bsp_i2c_bus_t bus, int address, uint8_t &byte)
 {
-  return i2cWire->requestFrom(address, size, sendStop);
+  return bspI2CRun(bus, BSP_I2C_XFER_READ, address, BSP_I2C_NO_REG, NULL, 0, &byte, 1);
 }
 
-uint8_t bspI2CRequestFrom(uint16_t address, uint8_t size, uint8_t sendStop)
+bsp_i2c_error_t bspI2CReadBytes(bsp_i2c_bus_t bus, int address, uint8_t reg, uint8_t *bytes, uint32_t len)
 {
-  return i2cWire->requestFrom(address, size, sendStop);
+  return bspI2CRun(bus, BSP_I2C_XFER_WRITE_READ, address, reg, NULL, 0, bytes, len);
 }
-size_t bspI2CRequestFrom(uint8_t address, size_t len, bool stopBit)
+
+bsp_i2c_error_t bspI2CReadBytes(bsp_i2c_bus_t bus, int address, uint8_t *bytes, uint32_t len)
 {
-  return i2cWire->requestFrom(address, len, stopBit);
+  return bspI2CRun(bus, BSP_I2C_XFER_READ, address, BSP_I2C_NO_REG, NULL, 0, bytes, len);
 }
-uint8_t bspI2CRequestFrom(uint16_t address, uint8_t size) { return i2cWire->requestFrom(address, size); }
 
-uint8_t bspI2CRequestFrom(uint8_t address, uint8_t size, uint8_t sendStop)
+bsp_i2c_error_t bspI2CWriteRead(bsp_i2c_bus_t bus, int address, const uint8_t *txBytes, uint32_t txLen,
+                                uint8_t *rxBytes, uint32_t rxLen)
 {
-  return i2cWire->requestFrom(address, size, sendStop);
+  return bspI2CRun(bus, BSP_I2C_XFER_WRITE_READ, address, BSP_I2C_NO_REG, txBytes, txLen, rxBytes, rxLen);
 }
-uint8_t bspI2CRequestFrom(uint8_t address, uint8_t size) { return i2cWire->requestFrom(address, size); }
 
-uint8_t bspI2CRequestFrom(int address, int size, int sendStop)
+bsp_i2c_error_t bspI2CWriteByte(bsp_i2c_bus_t bus, int address, uint8_t reg, uint8_t byte)
 {
-  return i2cWire->requestFrom(address, size, sendStop);
+  return bspI2CRun(bus, BSP_I2C_XFER_WRITE, address, reg, &byte, 1, NULL, 0);
 }
-uint8_t bspI2CRequestFrom(int address, int size) { return i2cWire->requestFrom(address, size); }
 
-size_t bspI2CWrite(uint8_t data) { return i2cWire->write(data); }
+bsp_i2c_error_t bspI2CWriteBytes(bsp_i2c_bus_t bus, int address, uint8_t reg, uint8_t *bytes, uint32_t len)
+{
+  return bspI2CRun(bus, BSP_I2C_XFER_WRITE, address, reg, bytes, len, NULL, 0);
+}
 
-size_t bspI2CWrite(const uint8_t *data, size_t quantity) { return i2cWire->write(data, quantity); }
+bsp_i2c_error_t bspI2CWriteBytes(bsp_i2c_bus_t bus, int address, const uint8_t *bytes, uint32_t len)
+{
+  return bspI2CRun(bus, BSP_I2C_XFER_WRITE, address, BSP_I2C_NO_REG, bytes, len, NULL, 0);
+}
 
-int bspI2CAvailable(void) { return i2cWire->available(); }
+bool bspI2CExist(bsp_i2c_bus_t bus, uint8_t address)
+{
+  return bspI2CRun(bus, BSP_I2C_XFER_WRITE, address, BSP_I2C_NO_REG, NULL, 0, NULL, 0) == BSP_I2C_OK;
+}
 
-int bspI2CRead(void) { return i2cWire->read(); }
+/* Private definitions ------------------------------------------------ */
+static SemaphoreHandle_t bspI2CLock(bsp_i2c_bus_t bus)
+{
+  static SemaphoreHandle_t locks[BSP_I2C_BUS_COUNT] = {xSemaphoreCreateRecursiveMutex(),
+                                                       xSemaphoreCreateRecursiveMutex()};
+  return locks[bus];
+}
 
-int bspI2CPeek(void) { return i2cWire->peek(); }
+static bsp_i2c_error_t bspI2CRun(bsp_i2c_bus_t bus, bsp_i2c_xfer_type_t type, int address, int16_t reg,
+                                 const uint8_t *txBuffer, size_t txLength, uint8_t *rxBuffer,
+                                 size_t rxLength)
+{
+  bsp_i2c_transaction_t transaction = {};
+
+  transaction.bus      = bus;
+  transaction.type     = type;
+  transaction.address  = address;
+  transaction.reg      = reg;
+  transaction.txBuffer = txBuffer;
+  transaction.txLength = txLength;
+  transaction.rxBuffer = rxBuffer;
+  transaction.rxLength = rxLength;
+
+  return bspI2CTransfer(&transaction);
+}
 
-bsp_i2c_error_t bspI2CFlush(void)
+static bsp_i2c_error_t bspI2CMapError(uint8_t status)
 {
-  i2cWire->flush();
-  return BSP_I2C_OK;
+  // endTransmission() status codes, see TwoWire::endTransmission()
+  switch (status)
+  {
+    case 0:
+      return BSP_I2C_OK;
+    case 2: // Address NACK
+    case 3: // Data NACK
+      return BSP_I2C_ERR_WRITE;
+    case 5: // Bus held longer than the configured timeout
+      return BSP_I2C_TIMEOUT;
+    default:
+      return BSP_I2C_ERR;
+  }
 }
 
-bsp_i2c_error_t bspI2CReadByte(int address, uint8_t reg, uint8_t &byte)
+static bsp_i2c_error_t bspI2CWireBackend(bsp_i2c_transaction_t *transaction)
 {
-  i2cWire->beginTransmission(address);
-  i2cWire->write(reg);
-  i2cWire->endTransmission();
+  TwoWire        *wire   = i2cBuses[transaction->bus].wire;
+  bsp_i2c_error_t result = BSP_I2C_OK;
 
-  int cnt = 0;
-  i2cWire->requestFrom(address, 1);
+  if (transaction->type != BSP_I2C_XFER_READ)
+  {
+    wire->beginTransmission(transaction->address);
+    if (transaction->reg != BSP_I2C_NO_REG)
+    {
+      wire->write((uint8_t) transaction->reg);
+    }
+    if (transaction->txLength > 0)
+    {
+      wire->write(transaction->txBuffer, transaction->txLength);
+    }
+    // Keep the bus for a repeated start when a read phase follows
+    result = bspI2CMapError(wire->endTransmission(transaction->type == BSP_I2C_XFER_WRITE));
+  }
 
-  while (1 != i2cWire->available())
+  if (result == BSP_I2C_OK && transaction->type != BSP_I2C_XFER_WRITE)
   {
-    cnt++;
-    if (cnt >= 10)
+    // requestFrom() only returns once the read has finished, so its count is final
+    size_t received = wire->requestFrom(transaction->address, transaction->rxLength, true);
+    for (size_t i = 0; i < received && i < transaction->rxLength; i++)
+    {
+      transaction->rxBuffer[i] = wire->read();
+    }
+    if (received != transaction->rxLength)
     {
-      return BSP_I2C_ERR_READ;
+      result = BSP_I2C_ERR_READ;
     }
-    DELAY(1);
   }
-  byte = i2cWire->read();
-  return BSP_I2C_OK;
+
+  return result;
 }
 
-bsp_i2c_error_t bspI2CReadByte(int address, uint8_t &byte)
+static void bspI2CExecute(bsp_i2c_transaction_t *transaction)
 {
-  int cnt = 0;
-  i2cWire->requestFrom(address, 1);
-  while (1 != i2cWire->available())
+  xSemaphoreTakeRecursive(bspI2CLock(transaction->bus), portMAX_DELAY);
+  // Read under the lock that bspI2CSetBackend() takes, a swap never lands between a transfer's two halves
+  bsp_i2c_backend_t backend = i2cBuses[transaction->bus].backend;
+  uint32_t          start   = micros();
+  transaction->result       = (backend != NULL) ? backend(transaction) : bspI2CWireBackend(transaction);
+  bspI2CRecord(transaction, micros() - start);
+  bspI2CShadowSync(transaction);
+  xSemaphoreGiveRecursive(bspI2CLock(transaction->bus));
+}
+
+// Called with the bus lock held
+static void bspI2CResetBusStats(bsp_i2c_bus_context_t *context)
+{
+  memset(context->stats, 0, sizeof(context->stats));
+  for (uint8_t i = 0; i < BSP_I2C_STATS_ADDRESSES; i++)
   {
-    cnt++;
-    if (cnt >= 10)
-    {
-      return BSP_I2C_ERR_READ;
-    }
-    DELAY(1);
+    context->stats[i].address = BSP_I2C_STATS_NONE;
   }
-  byte = i2cWire->read();
-  return BSP_I2C_OK;
+  context->statsReady = true;
 }
 
-bsp_i2c_error_t bspI2CReadBytes(int address, uint8_t reg, uint8_t *bytes, uint32_t len)
+// Called with the bus lock held
+static void bspI2CRecord(const bsp_i2c_transaction_t *transaction, uint32_t latencyUs)
 {
-  i2cWire->beginTransmission(address);
-  i2cWire->write(reg);
-  i2cWire->endTransmission();
+  bsp_i2c_bus_context_t *context = &i2cBuses[transaction->bus];
+  bsp_i2c_stats_t       *stats   = NULL;
 
-  int cnt = 0;
-  i2cWire->requestFrom(address, len);
+  if (!context->statsReady)
+  {
+    bspI2CResetBusStats(context);
+  }
 
-  while (len != i2cWire->available())
+  for (uint8_t i = 0; i < BSP_I2C_STATS_ADDRESSES && stats == NULL; i++)
   {
-    cnt++;
-    if (cnt >= 10)
+    if (context->stats[i].address == transaction->address)
+    {
+      stats = &context->stats[i];
+    }
+    else if (context->stats[i].address == BSP_I2C_STATS_NONE)
     {
-      return BSP_I2C_ERR_READ;
+      // Slots fill in order, the first free one means the address is new
+      stats          = &context->stats[i];
+      stats->address = transaction->address;
     }
-    DELAY(1);
   }
-  for (int i = 0; i < len; i++)
+  if (stats == NULL)
   {
-    bytes[i] = i2cWire->read();
+    return;
   }
-  return BSP_I2C_OK;
+
+  stats->transactions++;
+  switch (transaction->result)
+  {
+    case BSP_I2C_OK:
+      stats->bytesWritten += transaction->txLength + ((transaction->reg != BSP_I2C_NO_REG) ? 1 : 0);
+      stats->bytesRead += transaction->rxLength;
+      break;
+    case BSP_I2C_ERR_WRITE:
+      stats->nacks++;
+      break;
+    case BSP_I2C_ERR_READ:
+      // requestFrom() came back short, a pure read to an absent address returns 0 bytes and lands here too
+      stats->shortReads++;
+      break;
+    case BSP_I2C_TIMEOUT:
+      stats->timeouts++;
+      break;
+    default:
+      break;
+  }
+
+  stats->latencyTotalUs += latencyUs;
+  if (latencyUs > stats->latencyMaxUs)
+  {
+    stats->latencyMaxUs = latencyUs;
+  }
+
+  uint8_t bucket = 0;
+  while (bucket < BSP_I2C_LATENCY_BUCKETS - 1 && latencyUs >= i2cLatencyBounds[bucket])
+  {
+    bucket++;
+  }
+  stats->latency[bucket]++;
 }
 
-bsp_i2c_error_t bspI2CReadBytes(int address, uint8_t *bytes, uint32_t len)
+// Called with the bus lock held
+static bsp_i2c_shadow_t *bspI2CShadowFind(bsp_i2c_bus_t bus, uint8_t address, uint8_t reg)
 {
-  int cnt = 0;
-  i2cWire->requestFrom(address, len);
-  while (len != i2cWire->available())
+  bsp_i2c_shadow_t *shadows = i2cBuses[bus].shadows;
+
+  for (uint8_t i = 0; i < BSP_I2C_SHADOW_REGISTERS; i++)
   {
-    cnt++;
-    if (cnt >= 10)
+    if (shadows[i].used && shadows[i].address == address && shadows[i].reg == reg)
     {
-      return BSP_I2C_ERR_READ;
+      return &shadows[i];
     }
-    DELAY(1);
-  }
-  for (int i = 0; i < len; i++)
-  {
-    bytes[i] = i2cWire->read();
   }
-  return BSP_I2C_OK;
+  return NULL;
 }
 
-bsp_i2c_error_t bspI2CWriteByte(int address, uint8_t reg, uint8_t byte)
+// Called with the bus lock held, mirrors a plain register write into its shadow
+static void bspI2CShadowSync(const bsp_i2c_transaction_t *transaction)
 {
-  i2cWire->beginTransmission(address);
-  i2cWire->write(reg);
-  i2cWire->write(byte);
-  return (i2cWire->endTransmission() == 0) ? BSP_I2C_OK : BSP_I2C_ERR_WRITE;
+  if (transaction->result != BSP_I2C_OK || transaction->type != BSP_I2C_XFER_WRITE ||
+      transaction->reg == BSP_I2C_NO_REG || transaction->txLength == 0)
+  {
+    return;
+  }
+
+  bsp_i2c_shadow_t *shadow =
+  bspI2CShadowFind(transaction->bus, transaction->address, (uint8_t) transaction->reg);
+  // A pending update is newer than what went out on the bus, keep it for the next flush
+  if (shadow != NULL && !shadow->dirty)
+  {
+    shadow->value = transaction->txBuffer[0];
+  }
 }
 
-bsp_i2c_error_t bspI2CWriteBytes(int address, uint8_t reg, uint8_t *bytes, uint32_t len)
+static void bspI2CComplete(bsp_i2c_transaction_t *transaction)
 {
-  i2cWire->beginTransmission(address);
-  i2cWire->write(reg);
-  for (int i = 0; i < len; i++)
+  if (transaction->callback != NULL)
+  {
+    transaction->callback(transaction);
+  }
+  if (transaction->notifyTask != NULL)
   {
-    i2cWire->write(bytes[i]);
+    xTaskNotifyGive(transaction->notifyTask);
   }
-  return (i2cWire->endTransmission() == 0) ? BSP_I2C_OK : BSP_I2C_ERR_WRITE;
 }
 
-bool bspI2CExist(uint8_t address)
+static void bspI2CBusOwnerTask(void *pvParameters)
 {
-  i2cWire->beginTransmission(address);
-  return (i2cWire->endTransmission() == 0) ? true : false;
+  QueueHandle_t          queue = (QueueHandle_t) pvParameters;
+  bsp_i2c_transaction_t *transaction;
+
+  for (;;)
+  {
+    if (xQueueReceive(queue, &transaction, portMAX_DELAY) == pdTRUE)
+    {
+      bspI2CExecute(transaction);
+      bspI2CComplete(transaction);
+    }
+  }
 }
 
-/* Private definitions ------------------------------------------------ */
 /* End of file -------------------------------------------------------- */
@@ -23,6 +23,19 @@
   #endif
 
 /* Public defines ----------------------------------------------------- */
+  #define BSP_I2C_QUEUE_LENGTH     16   // Transactions that can wait for the bus owner
+  #define BSP_I2C_TASK_STACK_SIZE  4096 // Bus owner task stack size
+  #define BSP_I2C_TASK_PRIORITY    3    // Above every driver task so the queue drains first
+  #define BSP_I2C_QUEUE_TIMEOUT_MS 100  // Max wait for a free queue slot
+  #define BSP_I2C_BUS_TIMEOUT_MS   20   // Max bus time of one transaction, clock stretching included
+
+  #define BSP_I2C_NO_REG           (-1) // Transaction without a register byte
+
+  #define BSP_I2C_STATS_ADDRESSES  16 // Addresses tracked by the bus profiler
+  #define BSP_I2C_LATENCY_BUCKETS  8  // <100us, <200us, <500us, <1ms, <2ms, <5ms, <10ms, >=10ms
+  #define BSP_I2C_STATS_JSON_SIZE  240 // bspI2CStatsToJson() with every counter at 10 digits, NUL included
+
+  #define BSP_I2C_SHADOW_REGISTERS 8 // Output registers that can be shadowed
 
 /* Public enumerate/structure ----------------------------------------- */
 
@@ -36,57 +49,274 @@ typedef enum
   BSP_I2C_TIMEOUT
 } bsp_i2c_error_t;
 
-/* Public macros ------------------------------------------------------ */
-
-/* Public variables --------------------------------------------------- */
-
-/* Public function prototypes ----------------------------------------- */
-bsp_i2c_error_t bspI2CBegin();
-bsp_i2c_error_t bspI2CBegin(uint8_t address);
+// I2C controllers, each one has its own bus owner task, queue, lock, profiler and shadow registers
+typedef enum
+{
+  BSP_I2C_BUS_0 = 0, /**< `Wire` */
+  BSP_I2C_BUS_1,     /**< `Wire1` */
+  BSP_I2C_BUS_COUNT
+} bsp_i2c_bus_t;
 
-// beginTransmission
-bsp_i2c_error_t bspI2CBeginTransmission(uint16_t address);
+// Kind of bus transaction
+typedef enum
+{
+  BSP_I2C_XFER_WRITE = 0,  /**< START, address+W, [reg], tx bytes, STOP */
+  BSP_I2C_XFER_WRITE_READ, /**< START, address+W, [reg], tx bytes, Sr, address+R, rx bytes, STOP */
+  BSP_I2C_XFER_READ        /**< START, address+R, rx bytes, STOP */
+} bsp_i2c_xfer_type_t;
 
-bsp_i2c_error_t bspI2CBeginTransmission(uint8_t address);
+struct bsp_i2c_transaction;
 
-bsp_i2c_error_t bspI2CBeginTransmission(int address);
+// Completion callback, runs in the bus owner task context
+typedef void (*bsp_i2c_callback_t)(struct bsp_i2c_transaction *transaction);
 
-// endTransmission
-uint8_t bspI2CEndTransmission(bool sendStop);
+// Transaction descriptor, zero-initialize unused fields and keep it valid until the transaction completes
+typedef struct bsp_i2c_transaction
+{
+  bsp_i2c_bus_t       bus;        /**< Bus the transaction runs on */
+  bsp_i2c_xfer_type_t type;       /**< Transaction kind */
+  uint8_t             address;    /**< 7-bit device address */
+  int16_t             reg;        /**< Register byte sent first, or `BSP_I2C_NO_REG` */
+  const uint8_t      *txBuffer;   /**< Bytes written after the register byte */
+  size_t              txLength;   /**< Number of bytes in `txBuffer` */
+  uint8_t            *rxBuffer;   /**< Destination of the read phase */
+  size_t              rxLength;   /**< Number of bytes to read */
+  bsp_i2c_callback_t  callback;   /**< Optional completion callback */
+  void               *context;    /**< User pointer for the callback */
+  bsp_i2c_error_t     result;     /**< Completion status, set by the bus owner */
+  TaskHandle_t        notifyTask; /**< Task notified on completion, set by `bspI2CTransfer()` */
+} bsp_i2c_transaction_t;
+
+// Per-address bus counters, latency is the time the transaction held the bus
+typedef struct
+{
+  uint8_t  address;                          /**< 7-bit device address */
+  uint32_t transactions;                     /**< Completed or failed transactions */
+  uint32_t bytesWritten;                     /**< Bytes written, register byte included */
+  uint32_t bytesRead;                        /**< Bytes read */
+  uint32_t nacks;                            /**< Address or data NACKed in the write phase */
+  uint32_t shortReads;                       /**< Read phase returned fewer bytes than requested */
+  uint32_t timeouts;                         /**< Bus or queue timeouts */
+  uint32_t latencyMaxUs;                     /**< Longest transaction */
+  uint64_t latencyTotalUs;                   /**< Sum of all transaction latencies */
+  uint32_t latency[BSP_I2C_LATENCY_BUCKETS]; /**< Latency histogram, see `BSP_I2C_LATENCY_BUCKETS` */
+} bsp_i2c_stats_t;
+
+// Bus backend, executes one transaction on the wire (or a model of it) and returns its status
+typedef bsp_i2c_error_t (*bsp_i2c_backend_t)(bsp_i2c_transaction_t *transaction);
 
-uint8_t bspI2CEndTransmission(void);
+/* Public macros ------------------------------------------------------ */
 
-// requestFrom
-size_t bspI2CRequestFrom(uint16_t address, size_t size, bool sendStop);
+/* Public variables --------------------------------------------------- */
 
-uint8_t bspI2CRequestFrom(uint16_t address, uint8_t size, bool sendStop);
+/* Public function prototypes ----------------------------------------- */
+/**
+ * @brief  Initializes an I2C controller as bus master.
+ *
+ * @param[in]     bus Bus to start
+ * @param[in]     sda SDA pin, `-1` keeps the board default
+ * @param[in]     scl SCL pin, `-1` keeps the board default
+ *
+ * @attention  With `BSP_I2C_VIRTUAL` defined, the bus is served by the virtual device models instead.
+ *
+ * @return
+ *  - `BSP_I2C_OK` : Success
+ *  - `BSP_I2C_ERR`: Invalid bus or the controller could not start
+ */
+bsp_i2c_error_t bspI2CBegin(bsp_i2c_bus_t bus = BSP_I2C_BUS_0, int sda = -1, int scl = -1);
 
-uint8_t bspI2CRequestFrom(uint16_t address, uint8_t size, uint8_t sendStop);
+/**
+ * @brief  Sets the I2C bus clock.
+ *
+ * @param[in]     bus     I2C bus
+ * @param[in]     frequency Bus clock in Hz (e.g. 100000 or 400000).
+ *
+ * @attention  Every device on the bus must support the selected clock.
+ *
+ * @return
+ *  - `BSP_I2C_OK` : Success
+ *  - `BSP_I2C_ERR`: The driver rejected the frequency
+ */
+bsp_i2c_error_t bspI2CSetClock(bsp_i2c_bus_t bus, uint32_t frequency);
 
-size_t bspI2CRequestFrom(uint8_t address, size_t len, bool stopBit);
+/**
+ * @brief  Replaces the backend that executes bus transactions.
+ *
+ * The default backend drives the bus's `TwoWire` instance. A replacement (e.g. the virtual bus from
+ * `bsp_i2c_virtual.h`) receives every transaction issued on that bus through `bspI2CSubmit()`,
+ * `bspI2CTransfer()` and the register helpers.
+ *
+ * @param[in]     bus     I2C bus
+ * @param[in]     backend Backend to install, `NULL` restores the `TwoWire` backend.
+ *
+ * @return
+ *  - `BSP_I2C_OK`: Success
+ */
+bsp_i2c_error_t bspI2CSetBackend(bsp_i2c_bus_t bus, bsp_i2c_backend_t backend);
 
-uint8_t bspI2CRequestFrom(uint16_t address, uint8_t size);
+/**
+ * @brief  Starts the owner task of an I2C bus.
+ *
+ * Creates the transaction queue and the task that owns the bus. Once started, every transaction submitted
+ * through `bspI2CSubmit()`, `bspI2CTransfer()` or the register helpers below is executed back to back by the
+ * owner task, so drivers running in different tasks can no longer interleave on the bus. Each bus has its
+ * own owner, so transactions on different buses run in parallel.
+ *
+ * @param[in]     bus     I2C bus
+ *
+ * @attention  Call after `bspI2CBegin()`. Calling it again once started has no effect. Before the owner is
+ *             started, transactions run inline in the caller's task under a bus lock.
+ *
+ * @return
+ *  - `BSP_I2C_OK` : Success
+ *  - `BSP_I2C_ERR`: Queue or task could not be created
+ */
+bsp_i2c_error_t bspI2CBusStart(bsp_i2c_bus_t bus);
 
-uint8_t bspI2CRequestFrom(uint8_t address, uint8_t size, uint8_t sendStop);
+/**
+ * @brief  Queues a transaction without waiting for it.
+ *
+ * The bus owner runs the transaction, stores the status in `transaction->result` and then calls
+ * `transaction->callback` (if set) from its own task context.
+ *
+ * @param[in,out] transaction Transaction descriptor.
+ *
+ * @attention  The descriptor and its buffers must stay valid until completion. Keep callbacks short, they
+ *             block the bus while they run.
+ *
+ * @return
+ *  - `BSP_I2C_OK`     : Transaction queued (or executed inline when the owner is not running)
+ *  - `BSP_I2C_TIMEOUT`: Queue stayed full for `BSP_I2C_QUEUE_TIMEOUT_MS`
+ */
+bsp_i2c_error_t bspI2CSubmit(bsp_i2c_transaction_t *transaction);
 
-uint8_t bspI2CRequestFrom(uint8_t address, uint8_t size);
+/**
+ * @brief  Runs a transaction and blocks until it completes.
+ *
+ * Queues the transaction to the bus owner and sleeps on a task notification until it is done, so the caller
+ * does not poll the bus. Called from the owner task itself (e.g. inside a completion callback) or before
+ * `bspI2CBusStart()`, the transaction runs inline.
+ *
+ * @param[in,out] transaction Transaction descriptor.
+ *
+ * @return
+ *  - `BSP_I2C_OK`       : Success
+ *  - `BSP_I2C_ERR_WRITE`: Address or data not acknowledged during the write phase
+ *  - `BSP_I2C_ERR_READ` : Device returned fewer bytes than requested
+ *  - `BSP_I2C_TIMEOUT`  : Queue stayed full for `BSP_I2C_QUEUE_TIMEOUT_MS`, or the bus was held longer than
+ *                         `BSP_I2C_BUS_TIMEOUT_MS`
+ */
+bsp_i2c_error_t bspI2CTransfer(bsp_i2c_transaction_t *transaction);
 
-uint8_t bspI2CRequestFrom(int address, int size, int sendStop);
+/**
+ * @brief  Reads the bus profiler counters of one device.
+ *
+ * @param[in]     bus     I2C bus
+ * @param[in]     address 7-bit device address
+ * @param[out]    stats   Counters
+ *
+ * @return
+ *  - `BSP_I2C_OK` : Success
+ *  - `BSP_I2C_ERR`: No transaction was recorded for `address`
+ */
+bsp_i2c_error_t bspI2CGetStats(bsp_i2c_bus_t bus, uint8_t address, bsp_i2c_stats_t *stats);
 
-uint8_t bspI2CRequestFrom(int address, int size);
+/**
+ * @brief  Reads the bus profiler counters by slot, to walk every recorded address.
+ *
+ * @param[in]     bus     I2C bus
+ * @param[in]     index Slot, 0 to `BSP_I2C_STATS_ADDRESSES - 1`
+ * @param[out]    stats Counters
+ *
+ * @return
+ *  - `BSP_I2C_OK` : Success
+ *  - `BSP_I2C_ERR`: Slot unused or out of range
+ */
+bsp_i2c_error_t bspI2CGetStatsAt(bsp_i2c_bus_t bus, uint8_t index, bsp_i2c_stats_t *stats);
 
-// write
-size_t bspI2CWrite(uint8_t data);
+/**
+ * @brief  Formats the counters of one device as a compact JSON object.
+ *
+ * Output looks like `{"tx":120,"wr":240,"rd":720,"nack":0,"short":0,"to":0,"avg":412,"max":980,
+ * "hist":[0,0,3,...]}`, latencies in microseconds. `BSP_I2C_STATS_JSON_SIZE` always holds it.
+ *
+ * @param[in]     stats  Counters from `bspI2CGetStats()` or `bspI2CGetStatsAt()`
+ * @param[out]    buffer Destination
+ * @param[in]     size   Size of `buffer`
+ *
+ * @return  Length of the JSON text, `size` or more means it was truncated.
+ */
+size_t bspI2CStatsToJson(const bsp_i2c_stats_t *stats, char *buffer, size_t size);
 
-size_t bspI2CWrite(const uint8_t *data, size_t quantity);
+/**
+ * @brief  Clears the bus profiler counters of every bus.
+ */
+void bspI2CResetStats(void);
 
-int bspI2CAvailable(void);
+/**
+ * @brief  Starts shadowing an 8-bit output register.
+ *
+ * Reads the register once and keeps its value locally, so bit updates can be merged without reading the
+ * device back. Successful writes to the register through the bsp_i2c helpers keep the shadow in sync.
+ *
+ * @param[in]     bus     I2C bus
+ * @param[in]     address Device's I2C address
+ * @param[in]     reg     Register to shadow
+ *
+ * @attention  Only for registers that read back what was last written (output latches, config registers).
+ *
+ * @return
+ *  - `BSP_I2C_OK`      : Success, also when the register is already shadowed
+ *  - `BSP_I2C_ERR`     : No free shadow slot
+ *  - `BSP_I2C_ERR_READ`: Initial read failed
+ */
+bsp_i2c_error_t bspI2CShadowAttach(bsp_i2c_bus_t bus, uint8_t address, uint8_t reg);
 
-int bspI2CRead(void);
+/**
+ * @brief  Merges a bit update into a shadowed register without touching the bus.
+ *
+ * @param[in]     bus     I2C bus
+ * @param[in]     address Device's I2C address
+ * @param[in]     reg     Shadowed register
+ * @param[in]     mask    Bits to update
+ * @param[in]     value   New value of the bits selected by `mask`
+ *
+ * @attention  Call `bspI2CShadowFlush()` to write the result.
+ *
+ * @return
+ *  - `BSP_I2C_OK` : Success
+ *  - `BSP_I2C_ERR`: Register not shadowed
+ */
+bsp_i2c_error_t bspI2CShadowUpdate(bsp_i2c_bus_t bus, uint8_t address, uint8_t reg, uint8_t mask,
+                                   uint8_t value);
 
-int bspI2CPeek(void);
+/**
+ * @brief  Writes a shadowed register if it has pending updates.
+ *
+ * @param[in]     bus     I2C bus
+ * @param[in]     address Device's I2C address
+ * @param[in]     reg     Shadowed register
+ *
+ * @return
+ *  - `BSP_I2C_OK`       : Success, or nothing to write
+ *  - `BSP_I2C_ERR`      : Register not shadowed
+ *  - `BSP_I2C_ERR_WRITE`: Write failed, the update stays pending
+ */
+bsp_i2c_error_t bspI2CShadowFlush(bsp_i2c_bus_t bus, uint8_t address, uint8_t reg);
 
-bsp_i2c_error_t bspI2CFlush(void);
+/**
+ * @brief  Reads the cached value of a shadowed register, pending updates included.
+ *
+ * @param[in]     bus     I2C bus
+ * @param[in]     address Device's I2C address
+ * @param[in]     reg     Shadowed register
+ * @param[out]    value   Cached value
+ *
+ * @return
+ *  - `BSP_I2C_OK` : Success
+ *  - `BSP_I2C_ERR`: Register not shadowed
+ */
+bsp_i2c_error_t bspI2CShadowGet(bsp_i2c_bus_t bus, uint8_t address, uint8_t reg, uint8_t &value);
 
 /**
  * @brief  Reads a single byte using I2C from a register.
@@ -94,19 +324,19 @@ bsp_i2c_error_t bspI2CFlush(void);
  * This function read a single byte over the I2C interface from a register
  * and stores it in the provided reference variable.
  *
+ * @param[in]     bus     I2C bus
  * @param[in]     address Device's I2C address
  * @param[in]     reg     The register to read from
  * @param[out]    byte    Reference to a variable where the read byte will be stored.
  *
  * @attention  Ensure that the device is correctly connected and that I2C communication is functioning.
- *             The function includes a loop with retries and delays to handle cases where the byte is not
- * immediately available.
+ *             The register write and the read are issued as one transaction with a repeated start.
  *
  * @return
  *  - `BSP_I2C_OK`      : Success
  *  - `BSP_I2C_ERR_READ`: Error reading from the I2C bus.
  */
-bsp_i2c_error_t bspI2CReadByte(int address, uint8_t reg, uint8_t &byte);
+bsp_i2c_error_t bspI2CReadByte(bsp_i2c_bus_t bus, int address, uint8_t reg, uint8_t &byte);
 
 /**
  * @brief  Reads a single byte using I2C
@@ -114,18 +344,17 @@ bsp_i2c_error_t bspI2CReadByte(int address, uint8_t reg, uint8_t &byte);
  * This function request a single byte over the I2C interface
  * and stores it in the provided reference variable.
  *
+ * @param[in]     bus     I2C bus
  * @param[in]     address Device's I2C address
  * @param[out]    byte    Reference to a variable where the read byte will be stored.
  *
  * @attention  Ensure that the device is correctly connected and that I2C communication is functioning.
- *             The function includes a loop with retries and delays to handle cases where the byte is not
- * immediately available.
  *
  * @return
  *  - `BSP_I2C_OK`      : Success
  *  - `BSP_I2C_ERR_READ`: Error reading from the I2C bus.
  */
-bsp_i2c_error_t bspI2CReadByte(int address, uint8_t &byte);
+bsp_i2c_error_t bspI2CReadByte(bsp_i2c_bus_t bus, int address, uint8_t &byte);
 
 /**
  * @brief  Reads multiple bytes using I2C from a register.
@@ -133,20 +362,44 @@ bsp_i2c_error_t bspI2CReadByte(int address, uint8_t &byte);
  * This function requests multiple bytes over the I2C interface from a register
  * and stores them in the provided buffer.
  *
+ * @param[in]     bus     I2C bus
  * @param[in]     address Device's I2C address
  * @param[in]     reg     The register to read from
  * @param[out]    bytes   Pointer to a buffer where the read bytes will be stored.
  * @param[in]     len     The number of bytes to read.
  *
  * @attention  Ensure that the sensor is correctly connected and that I2C communication is functioning.
- *             The function includes a loop with retries and delays to handle cases where the bytes are not
- * immediately available.
+ *             The register write and the read are issued as one transaction with a repeated start.
  *
  * @return
  *  - `BSP_I2C_OK`: Success
  *  - `BSP_I2C_ERR_READ`: Error reading from the I2C bus.
  */
-bsp_i2c_error_t bspI2CReadBytes(int address, uint8_t reg, uint8_t *bytes, uint32_t len);
+bsp_i2c_error_t bspI2CReadBytes(bsp_i2c_bus_t bus, int address, uint8_t reg, uint8_t *bytes, uint32_t len);
+
+/**
+ * @brief  Writes a byte sequence and reads the response with a repeated start.
+ *
+ * Generic form of the register read for devices that take a multi-byte command or a 16-bit register
+ * address. The write and the read phases are one bus transaction, the bus is never released in between.
+ *
+ * @param[in]     bus     I2C bus
+ * @param[in]     address Device's I2C address
+ * @param[in]     txBytes Bytes written before the repeated start (command, register address, ...)
+ * @param[in]     txLen   Number of bytes to write
+ * @param[out]    rxBytes Buffer that receives the response
+ * @param[in]     rxLen   Number of bytes to read
+ *
+ * @attention  The call returns as soon as the driver signals completion, it never sleeps on the success path.
+ *
+ * @return
+ *  - `BSP_I2C_OK`       : Success
+ *  - `BSP_I2C_ERR_WRITE`: Address or data not acknowledged during the write phase
+ *  - `BSP_I2C_ERR_READ` : Device returned fewer bytes than requested
+ *  - `BSP_I2C_TIMEOUT`  : The transaction did not finish within `BSP_I2C_BUS_TIMEOUT_MS`
+ */
+bsp_i2c_error_t bspI2CWriteRead(bsp_i2c_bus_t bus, int address, const uint8_t *txBytes, uint32_t txLen,
+                                uint8_t *rxBytes, uint32_t rxLen);
 
 /**
  * @brief  Reads multiple bytes using I2C.
@@ -154,25 +407,25 @@ bsp_i2c_error_t bspI2CReadBytes(int address, uint8_t reg, uint8_t *bytes, uint32
  * This function requests multiple bytes over the I2C interface
  * and stores them in the provided buffer.
  *
+ * @param[in]     bus     I2C bus
  * @param[in]     address Device's I2C address
  * @param[out]    bytes   Pointer to a buffer where the read bytes will be stored.
  * @param[in]     len     The number of bytes to read.
  *
  * @attention  Ensure that the sensor is correctly connected and that I2C communication is functioning.
- *             The function includes a loop with retries and delays to handle cases where the bytes are not
- * immediately available.
  *
  * @return
  *  - `BSP_I2C_OK`: Success
  *  - `BSP_I2C_ERR_READ`: Error reading from the I2C bus.
  */
-bsp_i2c_error_t bspI2CReadBytes(int address, uint8_t *bytes, uint32_t len);
+bsp_i2c_error_t bspI2CReadBytes(bsp_i2c_bus_t bus, int address, uint8_t *bytes, uint32_t len);
 
 /**
  * @brief  Writes a single byte to a register using I2C.
  *
  * This function writes a single byte to a register over the I2C interface.
  *
+ * @param[in]     bus     I2C bus
  * @param[in]     address Device's I2C address
  * @param[in]     reg     The register to read from
  * @param[in]     byte    The byte to write.
@@ -183,13 +436,14 @@ bsp_i2c_error_t bspI2CReadBytes(int address, uint8_t *bytes, uint32_t len);
  *  - `BSP_I2C_OK`: Success
  *  - `BSP_I2C_ERR_WRITE`: Error writing to the I2C bus.
  */
-bsp_i2c_error_t bspI2CWriteByte(int address, uint8_t reg, uint8_t byte);
+bsp_i2c_error_t bspI2CWriteByte(bsp_i2c_bus_t bus, int address, uint8_t reg, uint8_t byte);
 
 /**
  * @brief  Writes multiple bytes to a register using I2C.
  *
  * This function writes multiple bytes to a register over the I2C interface.
  *
+ * @param[in]     bus     I2C bus
  * @param[in]     address Device's I2C address
  * @param[in]     reg     The register to read from
  * @param[in]     bytes   Pointer to a buffer containing the bytes to write.
@@ -201,7 +455,26 @@ bsp_i2c_error_t bspI2CWriteByte(int address, uint8_t reg, uint8_t byte);
  *  - `BSP_I2C_OK`: Success
  *  - `BSP_I2C_ERR_WRITE`: Error writing to the I2C bus.
  */
-bsp_i2c_error_t bspI2CWriteBytes(int address, uint8_t reg, uint8_t *bytes, uint32_t len);
+bsp_i2c_error_t bspI2CWriteBytes(bsp_i2c_bus_t bus, int address, uint8_t reg, uint8_t *bytes, uint32_t len);
+
+/**
+ * @brief  Writes multiple bytes using I2C without a register byte.
+ *
+ * This function writes the buffer as-is in a single transaction, for devices such as I/O expanders that
+ * have no register map.
+ *
+ * @param[in]     bus     I2C bus
+ * @param[in]     address Device's I2C address
+ * @param[in]     bytes   Pointer to a buffer containing the bytes to write.
+ * @param[in]     len     The number of bytes to write.
+ *
+ * @attention  Ensure that the device is correctly connected and that I2C communication is functioning.
+ *
+ * @return
+ *  - `BSP_I2C_OK`: Success
+ *  - `BSP_I2C_ERR_WRITE`: Error writing to the I2C bus.
+ */
+bsp_i2c_error_t bspI2CWriteBytes(bsp_i2c_bus_t bus, int address, const uint8_t *bytes, uint32_t len);
 
 /**
  * @brief  Checks if an I2C device is present on the bus.
@@ -209,6 +482,7 @@ bsp_i2c_error_t bspI2CWriteBytes(int address, uint8_t reg, uint8_t *bytes, uint3
  * This function verifies the presence of an I2C device by initiating a transmission
  * and checking for an acknowledgment.
  *
+ * @param[in]     bus     I2C bus
  * @param[in]     address Device's I2C address.
  *
  * @attention  Ensure that the I2C bus is initialized before calling this function.
@@ -218,7 +492,7 @@ bsp_i2c_error_t bspI2CWriteBytes(int address, uint8_t reg, uint8_t *bytes, uint3
  *
  *  - `false`:  Device is not responding.
  */
-bool bspI2CExist(uint8_t address);
+bool bspI2CExist(bsp_i2c_bus_t bus, uint8_t address);
 
 #endif /* BSP_I2C_H */
 
@@ -0,0 +1,419 @@
+/**
+ * @file       bsp_i2c_virtual.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-02
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the virtual I2C bus backend
+ *
+ * @note       None
+ * @example    None
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "bsp_i2c_virtual.h"
+#include "checksum.h"
+#include <string.h>
+
+/* Private defines ---------------------------------------------------- */
+#define SHT40_CMD_SOFT_RESET    0x94
+#define SHT40_CMD_SERIAL_NUMBER 0x89
+
+#define LCD_RS_BIT              0x01
+#define LCD_EN_BIT              0x04
+#define LCD_DDRAM_SIZE          0x80 // 7-bit DDRAM address space, row 1 starts at 0x40
+#define LCD_ROW_1_OFFSET        0x40
+#define LCD_CMD_CLEAR           0x01
+#define LCD_CMD_HOME            0x02
+#define LCD_CMD_SET_DDRAM       0x80
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef struct
+{
+  uint16_t rawTemperature;
+  uint16_t rawHumidity;
+} sht40_model_t;
+
+typedef struct
+{
+  bool    fourBitMode;                               // Set once the 4-bit function set is latched
+  bool    highNibblePending;                         // First half of a 4-bit transfer received
+  uint8_t highNibble;                                // Upper half waiting for its lower half
+  uint8_t lastOutput;                                // Last byte latched by the PCF8574
+  uint8_t address;                                   // DDRAM address counter
+  char    ddram[LCD_DDRAM_SIZE];                     // Display memory
+  char    row[2][BSP_I2C_VIRTUAL_LCD_COLUMNS + 1];   // Text returned by bspI2CVirtualLcdRow()
+} lcd_model_t;
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+
+/* Private variables -------------------------------------------------- */
+static bsp_i2c_virtual_device_t *virtualDevices[BSP_I2C_VIRTUAL_MAX_DEVICES];
+static bsp_i2c_virtual_stats_t   virtualBusStats[BSP_I2C_BUS_COUNT];
+
+static bsp_i2c_virtual_device_t sht40Device;
+static bsp_i2c_virtual_device_t bmp280Device;
+static bsp_i2c_virtual_device_t acDevice;
+static bsp_i2c_virtual_device_t relayDevice;
+static bsp_i2c_virtual_device_t lcdDevice;
+
+static sht40_model_t sht40Model;
+static lcd_model_t   lcdModel;
+
+// BMP280 compensation words 0x88..0x9F, the worked example from the datasheet (section 8.2)
+static const uint8_t bmp280Calibration[24] = {0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC, 0x7D, 0x8E,
+                                              0x43, 0xD6, 0xD0, 0x0B, 0x27, 0x0B, 0x8C, 0x00,
+                                              0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17};
+// adc_P = 415148, adc_T = 519888, i.e. 25.08 degC and 1006.53 hPa
+static const uint8_t bmp280Data[6] = {0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00};
+
+/* Private function prototypes ---------------------------------------- */
+static void bspI2CVirtualInitDevice(bsp_i2c_virtual_device_t *device, bsp_i2c_bus_t bus, uint8_t address);
+static void bspI2CVirtualDefaultWrite(bsp_i2c_virtual_device_t *device, const uint8_t *bytes, size_t len);
+static void bspI2CVirtualDefaultRead(bsp_i2c_virtual_device_t *device, uint8_t *bytes, size_t len);
+static void bspI2CVirtualSht40Write(bsp_i2c_virtual_device_t *device, const uint8_t *bytes, size_t len);
+static void bspI2CVirtualLcdWrite(bsp_i2c_virtual_device_t *device, const uint8_t *bytes, size_t len);
+static void bspI2CVirtualLcdLatch(lcd_model_t *lcd, bool rs, uint8_t nibble);
+static void bspI2CVirtualPutWord(uint8_t *dest, uint16_t word);
+static void bspI2CVirtualPutLE(uint8_t *dest, uint32_t value, uint8_t len);
+
+/* Function definitions ----------------------------------------------- */
+bsp_i2c_error_t bspI2CVirtualBegin(void)
+{
+  memset(virtualDevices, 0, sizeof(virtualDevices));
+  memset(virtualBusStats, 0, sizeof(virtualBusStats));
+
+  // SHT40: command driven, the measurement lands in regs[0..5]
+  bspI2CVirtualInitDevice(&sht40Device, BSP_I2C_VIRTUAL_SENSOR_BUS, BSP_I2C_VIRTUAL_SHT40_ADDR);
+  sht40Device.onWrite = bspI2CVirtualSht40Write;
+  sht40Device.context = &sht40Model;
+  bspI2CVirtualSetSht40(25.0f, 50.0f);
+  bspI2CVirtualAttach(&sht40Device);
+
+  // BMP280: plain register map
+  bspI2CVirtualInitDevice(&bmp280Device, BSP_I2C_VIRTUAL_SENSOR_BUS, BSP_I2C_VIRTUAL_BMP280_ADDR);
+  memcpy(&bmp280Device.regs[0x88], bmp280Calibration, sizeof(bmp280Calibration));
+  memcpy(&bmp280Device.regs[0xF7], bmp280Data, sizeof(bmp280Data));
+  bmp280Device.regs[0xD0] = 0x58; // Chip id
+  bspI2CVirtualAttach(&bmp280Device);
+
+  // AC measure unit: little-endian values scaled by 100, plus their string forms
+  bspI2CVirtualInitDevice(&acDevice, BSP_I2C_VIRTUAL_SENSOR_BUS, BSP_I2C_VIRTUAL_AC_ADDR);
+  bspI2CVirtualPutLE(&acDevice.regs[0x60], 23012, 2);  // 230.12 V
+  bspI2CVirtualPutLE(&acDevice.regs[0x70], 152, 2);    // 1.52 A
+  bspI2CVirtualPutLE(&acDevice.regs[0x80], 33245, 4);  // 332.45 W
+  bspI2CVirtualPutLE(&acDevice.regs[0x90], 34978, 4);  // 349.78 VA
+  acDevice.regs[0xA0] = 95;                            // 0.95
+  bspI2CVirtualPutLE(&acDevice.regs[0xB0], 123456, 4); // 1234.56 kWh
+  memcpy(&acDevice.regs[0x00], "230.12", 7);
+  memcpy(&acDevice.regs[0x10], "1.52", 5);
+  memcpy(&acDevice.regs[0x20], "332.45", 7);
+  memcpy(&acDevice.regs[0x30], "349.78", 7);
+  memcpy(&acDevice.regs[0x40], "0.95", 4);
+  memcpy(&acDevice.regs[0x50], "1234.56", 8);
+  acDevice.regs[0xC0] = 100;  // Voltage factor
+  acDevice.regs[0xD0] = 100;  // Current factor
+  acDevice.regs[0xFC] = 1;    // Data ready
+  acDevice.regs[0xFE] = 0x01; // Firmware version
+  acDevice.regs[0xFF] = BSP_I2C_VIRTUAL_AC_ADDR;
+  bspI2CVirtualAttach(&acDevice);
+
+  // 4-relay unit: mode (0x10) and relay/led state (0x11)
+  bspI2CVirtualInitDevice(&relayDevice, BSP_I2C_VIRTUAL_SENSOR_BUS, BSP_I2C_VIRTUAL_RELAY_ADDR);
+  bspI2CVirtualAttach(&relayDevice);
+
+  // HD44780 behind a PCF8574 backpack
+  bspI2CVirtualInitDevice(&lcdDevice, BSP_I2C_VIRTUAL_LCD_BUS, BSP_I2C_VIRTUAL_LCD_ADDR);
+  memset(&lcdModel, 0, sizeof(lcdModel));
+  memset(lcdModel.ddram, ' ', sizeof(lcdModel.ddram));
+  lcdDevice.onWrite = bspI2CVirtualLcdWrite;
+  lcdDevice.context = &lcdModel;
+  bspI2CVirtualAttach(&lcdDevice);
+
+  return BSP_I2C_OK;
+}
+
+bsp_i2c_error_t bspI2CVirtualAttach(bsp_i2c_virtual_device_t *device)
+{
+  if (bspI2CVirtualFind(device->address) != NULL)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  for (uint8_t i = 0; i < BSP_I2C_VIRTUAL_MAX_DEVICES; i++)
+  {
+    if (virtualDevices[i] == NULL)
+    {
+      virtualDevices[i] = device;
+      return BSP_I2C_OK;
+    }
+  }
+  return BSP_I2C_ERR;
+}
+
+bsp_i2c_virtual_device_t *bspI2CVirtualFind(uint8_t address)
+{
+  for (uint8_t i = 0; i < BSP_I2C_VIRTUAL_MAX_DEVICES; i++)
+  {
+    if (virtualDevices[i] != NULL && virtualDevices[i]->address == address)
+    {
+      return virtualDevices[i];
+    }
+  }
+  return NULL;
+}
+
+bsp_i2c_error_t bspI2CVirtualBackend(bsp_i2c_transaction_t *transaction)
+{
+  bsp_i2c_virtual_device_t *device = bspI2CVirtualFind(transaction->address);
+  bsp_i2c_virtual_stats_t  *bus    = &virtualBusStats[transaction->bus];
+
+  bus->transactions++;
+  // A model wired to the other bus does not answer here
+  if (device == NULL || device->bus != transaction->bus)
+  {
+    bus->nacks++;
+    return (transaction->type == BSP_I2C_XFER_READ) ? BSP_I2C_ERR_READ : BSP_I2C_ERR_WRITE;
+  }
+  device->stats.transactions++;
+
+  if (transaction->type != BSP_I2C_XFER_READ)
+  {
+    // Hand the model the write phase exactly as it appears on the wire
+    uint8_t buffer[BSP_I2C_VIRTUAL_REG_SIZE + 1];
+    size_t  len = 0;
+
+    if (transaction->reg != BSP_I2C_NO_REG)
+    {
+      buffer[len++] = (uint8_t) transaction->reg;
+    }
+    for (size_t i = 0; i < transaction->txLength && len < sizeof(buffer); i++)
+    {
+      buffer[len++] = transaction->txBuffer[i];
+    }
+
+    if (len > 0)
+    {
+      if (device->onWrite != NULL)
+      {
+        device->onWrite(device, buffer, len);
+      }
+      else
+      {
+        bspI2CVirtualDefaultWrite(device, buffer, len);
+      }
+    }
+    device->stats.bytesWritten += len;
+    bus->bytesWritten += len;
+  }
+
+  if (transaction->type != BSP_I2C_XFER_WRITE && transaction->rxLength > 0)
+  {
+    if (device->onRead != NULL)
+    {
+      device->onRead(device, transaction->rxBuffer, transaction->rxLength);
+    }
+    else
+    {
+      bspI2CVirtualDefaultRead(device, transaction->rxBuffer, transaction->rxLength);
+    }
+    device->stats.bytesRead += transaction->rxLength;
+    bus->bytesRead += transaction->rxLength;
+  }
+
+  return BSP_I2C_OK;
+}
+
+bsp_i2c_error_t bspI2CVirtualSetRegisters(uint8_t address, uint8_t reg, const uint8_t *bytes, size_t len)
+{
+  bsp_i2c_virtual_device_t *device = bspI2CVirtualFind(address);
+  if (device == NULL)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  for (size_t i = 0; i < len; i++)
+  {
+    device->regs[(uint8_t) (reg + i)] = bytes[i];
+  }
+  return BSP_I2C_OK;
+}
+
+void bspI2CVirtualSetSht40(float temperature, float humidity)
+{
+  // Inverse of the conversion formulas in the SHT4x datasheet, section 4.6
+  sht40Model.rawTemperature = (uint16_t) ((temperature + 45.0f) * 65535.0f / 175.0f);
+  sht40Model.rawHumidity    = (uint16_t) ((humidity + 6.0f) * 65535.0f / 125.0f);
+}
+
+const char *bspI2CVirtualLcdRow(uint8_t row)
+{
+  uint8_t index  = (row > 0) ? 1 : 0;
+  uint8_t offset = (row > 0) ? LCD_ROW_1_OFFSET : 0;
+
+  memcpy(lcdModel.row[index], &lcdModel.ddram[offset], BSP_I2C_VIRTUAL_LCD_COLUMNS);
+  lcdModel.row[index][BSP_I2C_VIRTUAL_LCD_COLUMNS] = '\0';
+  return lcdModel.row[index];
+}
+
+bsp_i2c_error_t bspI2CVirtualGetStats(uint8_t address, bsp_i2c_virtual_stats_t *stats)
+{
+  bsp_i2c_virtual_device_t *device = bspI2CVirtualFind(address);
+  if (device == NULL)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  *stats = device->stats;
+  return BSP_I2C_OK;
+}
+
+bsp_i2c_error_t bspI2CVirtualGetBusStats(bsp_i2c_bus_t bus, bsp_i2c_virtual_stats_t *stats)
+{
+  if (bus >= BSP_I2C_BUS_COUNT)
+  {
+    return BSP_I2C_ERR;
+  }
+
+  *stats = virtualBusStats[bus];
+  return BSP_I2C_OK;
+}
+
+void bspI2CVirtualResetStats(void)
+{
+  memset(virtualBusStats, 0, sizeof(virtualBusStats));
+  for (uint8_t i = 0; i < BSP_I2C_VIRTUAL_MAX_DEVICES; i++)
+  {
+    if (virtualDevices[i] != NULL)
+    {
+      memset(&virtualDevices[i]->stats, 0, sizeof(virtualDevices[i]->stats));
+    }
+  }
+}
+
+/* Private definitions ------------------------------------------------ */
+static void bspI2CVirtualInitDevice(bsp_i2c_virtual_device_t *device, bsp_i2c_bus_t bus, uint8_t address)
+{
+  memset(device, 0, sizeof(*device));
+  device->bus     = bus;
+  device->address = address;
+}
+
+static void bspI2CVirtualDefaultWrite(bsp_i2c_virtual_device_t *device, const uint8_t *bytes, size_t len)
+{
+  // First byte moves the register pointer, the rest are stored with auto-increment
+  device->pointer = bytes[0];
+  for (size_t i = 1; i < len; i++)
+  {
+    device->regs[device->pointer++] = bytes[i];
+  }
+}
+
+static void bspI2CVirtualDefaultRead(bsp_i2c_virtual_device_t *device, uint8_t *bytes, size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    bytes[i] = device->regs[device->pointer++];
+  }
+}
+
+static void bspI2CVirtualSht40Write(bsp_i2c_virtual_device_t *device, const uint8_t *bytes, size_t len)
+{
+  sht40_model_t *sht40 = (sht40_model_t *) device->context;
+
+  (void) len;
+  switch (bytes[0])
+  {
+    case SHT40_CMD_SOFT_RESET:
+      break;
+    case SHT40_CMD_SERIAL_NUMBER:
+      bspI2CVirtualPutWord(&device->regs[0], 0x1234);
+      bspI2CVirtualPutWord(&device->regs[3], 0x5678);
+      break;
+    default:
+      // Every other command is a measurement, with or without the heater
+      bspI2CVirtualPutWord(&device->regs[0], sht40->rawTemperature);
+      bspI2CVirtualPutWord(&device->regs[3], sht40->rawHumidity);
+      break;
+  }
+  device->pointer = 0;
+}
+
+static void bspI2CVirtualLcdWrite(bsp_i2c_virtual_device_t *device, const uint8_t *bytes, size_t len)
+{
+  lcd_model_t *lcd = (lcd_model_t *) device->context;
+
+  // The HD44780 samples D4..D7 and RS on the falling edge of EN
+  for (size_t i = 0; i < len; i++)
+  {
+    if ((lcd->lastOutput & LCD_EN_BIT) && !(bytes[i] & LCD_EN_BIT))
+    {
+      bspI2CVirtualLcdLatch(lcd, lcd->lastOutput & LCD_RS_BIT, lcd->lastOutput >> 4);
+    }
+    lcd->lastOutput = bytes[i];
+  }
+}
+
+static void bspI2CVirtualLcdLatch(lcd_model_t *lcd, bool rs, uint8_t nibble)
+{
+  uint8_t value;
+
+  if (!lcd->fourBitMode)
+  {
+    // 8-bit mode during the init sequence, only the function set to 4-bit matters
+    if (nibble == 0x02)
+    {
+      lcd->fourBitMode = true;
+    }
+    return;
+  }
+
+  if (!lcd->highNibblePending)
+  {
+    lcd->highNibble        = nibble;
+    lcd->highNibblePending = true;
+    return;
+  }
+  lcd->highNibblePending = false;
+  value                  = (lcd->highNibble << 4) | nibble;
+
+  if (rs)
+  {
+    lcd->ddram[lcd->address] = (char) value;
+    lcd->address             = (lcd->address + 1) % LCD_DDRAM_SIZE;
+  }
+  else if (value & LCD_CMD_SET_DDRAM)
+  {
+    lcd->address = value & (LCD_DDRAM_SIZE - 1);
+  }
+  else if (value == LCD_CMD_CLEAR)
+  {
+    memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+    lcd->address = 0;
+  }
+  else if ((value & ~0x01) == LCD_CMD_HOME)
+  {
+    lcd->address = 0;
+  }
+}
+
+static void bspI2CVirtualPutWord(uint8_t *dest, uint16_t word)
+{
+  // Sensirion framing: MSB, LSB, CRC
+  dest[0] = word >> 8;
+  dest[1] = word & 0xFF;
+  dest[2] = crc8(dest, 2);
+}
+
+static void bspI2CVirtualPutLE(uint8_t *dest, uint32_t value, uint8_t len)
+{
+  for (uint8_t i = 0; i < len; i++)
+  {
+    dest[i] = (value >> (8 * i)) & 0xFF;
+  }
+}
+
+/* End of file -------------------------------------------------------- */
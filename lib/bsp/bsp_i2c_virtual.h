@@ -0,0 +1,190 @@
+/**
+ * @file       bsp_i2c_virtual.h
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-02
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the virtual I2C bus backend
+ *
+ * @note       Register-map models of the devices on the kit's I2C buses, used to run the drivers without
+ *             hardware and to count bus traffic per operation.
+ * @example    Build with `-DBSP_I2C_VIRTUAL`, or call `bspI2CVirtualBegin()` followed by
+ *             `bspI2CSetBackend(bus, bspI2CVirtualBackend)` for every bus.
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef BSP_I2C_VIRTUAL_H
+  #define BSP_I2C_VIRTUAL_H
+
+  /* Includes --------------------------------------------------------- */
+  #include "bsp_i2c.h"
+
+/* Public defines ----------------------------------------------------- */
+  #define BSP_I2C_VIRTUAL_MAX_DEVICES 8   // Models that can be attached at once
+  #define BSP_I2C_VIRTUAL_REG_SIZE    256 // Size of every model's register map
+
+  #define BSP_I2C_VIRTUAL_SHT40_ADDR  0x44
+  #define BSP_I2C_VIRTUAL_BMP280_ADDR 0x76
+  #define BSP_I2C_VIRTUAL_AC_ADDR     0x42
+  #define BSP_I2C_VIRTUAL_RELAY_ADDR  0x26
+  #define BSP_I2C_VIRTUAL_LCD_ADDR    0x21
+
+  #define BSP_I2C_VIRTUAL_LCD_COLUMNS 16
+
+  // Bus every default model answers on, mirrors the board layout (slow peripherals on Wire1)
+  #ifndef BSP_I2C_VIRTUAL_SENSOR_BUS
+    #define BSP_I2C_VIRTUAL_SENSOR_BUS BSP_I2C_BUS_0
+  #endif
+  #ifndef BSP_I2C_VIRTUAL_LCD_BUS
+    #define BSP_I2C_VIRTUAL_LCD_BUS BSP_I2C_BUS_1
+  #endif
+
+/* Public enumerate/structure ----------------------------------------- */
+
+// Bus traffic counters
+typedef struct
+{
+  uint32_t transactions; /**< Transactions addressed to the device (or the whole bus) */
+  uint32_t bytesWritten; /**< Bytes written, register byte included */
+  uint32_t bytesRead;    /**< Bytes read */
+  uint32_t nacks;        /**< Transactions to an address with no model attached to the bus */
+} bsp_i2c_virtual_stats_t;
+
+struct bsp_i2c_virtual_device;
+
+// Model hooks, `bytes` holds the whole write phase (register byte first) or the read destination
+typedef void (*bsp_i2c_virtual_write_t)(struct bsp_i2c_virtual_device *device, const uint8_t *bytes,
+                                        size_t len);
+typedef void (*bsp_i2c_virtual_read_t)(struct bsp_i2c_virtual_device *device, uint8_t *bytes, size_t len);
+
+// Device model
+typedef struct bsp_i2c_virtual_device
+{
+  bsp_i2c_bus_t           bus;                            /**< Bus the model answers on */
+  uint8_t                 address;                        /**< 7-bit device address */
+  uint8_t                 regs[BSP_I2C_VIRTUAL_REG_SIZE]; /**< Register map */
+  uint8_t                 pointer;                        /**< Register pointer, auto-increments */
+  bsp_i2c_virtual_write_t onWrite; /**< Write hook, `NULL` sets the pointer then stores the data bytes */
+  bsp_i2c_virtual_read_t  onRead;  /**< Read hook, `NULL` serves bytes from the register map */
+  void                   *context; /**< Model private state */
+  bsp_i2c_virtual_stats_t stats;   /**< Traffic addressed to this device */
+} bsp_i2c_virtual_device_t;
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Public function prototypes ----------------------------------------- */
+
+/**
+ * @brief  Resets the virtual buses and attaches the default device models.
+ *
+ * Attaches SHT40 (0x44), BMP280 (0x76), AC measure unit (0x42) and 4-relay unit (0x26) on
+ * `BSP_I2C_VIRTUAL_SENSOR_BUS` and the HD44780 backpack (0x21) on `BSP_I2C_VIRTUAL_LCD_BUS`, with
+ * plausible readings, and clears every counter.
+ *
+ * @return
+ *  - `BSP_I2C_OK`: Success
+ */
+bsp_i2c_error_t bspI2CVirtualBegin(void);
+
+/**
+ * @brief  Attaches a custom device model to the virtual buses.
+ *
+ * @param[in]     device Model to attach, must stay valid while attached.
+ *
+ * @attention  Addresses are unique across buses so the helpers below can look models up by address.
+ *
+ * @return
+ *  - `BSP_I2C_OK` : Success
+ *  - `BSP_I2C_ERR`: Address already taken or model table full
+ */
+bsp_i2c_error_t bspI2CVirtualAttach(bsp_i2c_virtual_device_t *device);
+
+/**
+ * @brief  Finds the model answering at an address.
+ *
+ * @param[in]     address 7-bit device address
+ *
+ * @return  The model, or `NULL` when nothing answers at `address`.
+ */
+bsp_i2c_virtual_device_t *bspI2CVirtualFind(uint8_t address);
+
+/**
+ * @brief  Backend entry point, install it with `bspI2CSetBackend()`.
+ *
+ * @param[in,out] transaction Transaction descriptor.
+ *
+ * @return
+ *  - `BSP_I2C_OK`       : Success
+ *  - `BSP_I2C_ERR_WRITE`: No model at the address on the transaction's bus (address NACK)
+ *  - `BSP_I2C_ERR_READ` : No model at the address on a plain read
+ */
+bsp_i2c_error_t bspI2CVirtualBackend(bsp_i2c_transaction_t *transaction);
+
+/**
+ * @brief  Overwrites part of a model's register map, e.g. to script a new reading.
+ *
+ * @param[in]     address 7-bit device address
+ * @param[in]     reg     First register to write
+ * @param[in]     bytes   New register contents
+ * @param[in]     len     Number of bytes
+ *
+ * @attention  Does not count as bus traffic.
+ *
+ * @return
+ *  - `BSP_I2C_OK` : Success
+ *  - `BSP_I2C_ERR`: No model at the address
+ */
+bsp_i2c_error_t bspI2CVirtualSetRegisters(uint8_t address, uint8_t reg, const uint8_t *bytes, size_t len);
+
+/**
+ * @brief  Sets the values returned by the SHT40 model on its next measurement.
+ *
+ * @param[in]     temperature Temperature in degree Celsius
+ * @param[in]     humidity    Relative humidity in percent
+ */
+void bspI2CVirtualSetSht40(float temperature, float humidity);
+
+/**
+ * @brief  Returns the text currently shown on a row of the HD44780 model.
+ *
+ * @param[in]     row Display row, 0 or 1
+ *
+ * @return  NUL-terminated string of `BSP_I2C_VIRTUAL_LCD_COLUMNS` characters.
+ */
+const char *bspI2CVirtualLcdRow(uint8_t row);
+
+/**
+ * @brief  Reads the traffic counters of one device.
+ *
+ * @param[in]     address 7-bit device address
+ * @param[out]    stats   Counters
+ *
+ * @return
+ *  - `BSP_I2C_OK` : Success
+ *  - `BSP_I2C_ERR`: No model at the address
+ */
+bsp_i2c_error_t bspI2CVirtualGetStats(uint8_t address, bsp_i2c_virtual_stats_t *stats);
+
+/**
+ * @brief  Reads the traffic counters of a whole bus, NACKed transactions included.
+ *
+ * @param[in]     bus   I2C bus
+ * @param[out]    stats Counters
+ *
+ * @return
+ *  - `BSP_I2C_OK` : Success
+ *  - `BSP_I2C_ERR`: Invalid bus
+ */
+bsp_i2c_error_t bspI2CVirtualGetBusStats(bsp_i2c_bus_t bus, bsp_i2c_virtual_stats_t *stats);
+
+/**
+ * @brief  Clears the bus and device counters of every bus, register contents are kept.
+ */
+void bspI2CVirtualResetStats(void);
+
+#endif /* BSP_I2C_VIRTUAL_H */
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,313 @@
+/**
+ * @file       bsp_modbus.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-04
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the Modbus RTU master
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "bsp_modbus.h"
+#include "checksum.h"
+#include "config.h"
+
+/* Private defines ---------------------------------------------------- */
+#define BSP_MODBUS_MAX_SLAVE       247
+#define BSP_MODBUS_EXCEPTION_FLAG  0x80
+#define BSP_MODBUS_EXCEPTION_FRAME 5  // Slave, function | 0x80, code, CRC
+#define BSP_MODBUS_ECHO_FRAME      8  // Slave, function, address, value, CRC
+#define BSP_MODBUS_CHAR_BITS       11 // Start, 8 data, parity or second stop, stop
+
+/* Private enumerate/structure ---------------------------------------- */
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+BspModbusMaster modbusMaster1(rs485Serial1);
+
+/* Private variables -------------------------------------------------- */
+
+/* Class method definitions-------------------------------------------- */
+BspModbusMaster::BspModbusMaster(BspRs485 &port) : _port(&port) {}
+
+void BspModbusMaster::setResponseTimeout(uint32_t timeoutMs) { _responseTimeoutMs = timeoutMs; }
+
+bsp_modbus_error_t BspModbusMaster::readHoldingRegisters(uint8_t slave, uint16_t address, uint16_t count,
+                                                         uint16_t *values)
+{
+  return readRegisters(slave, BSP_MODBUS_READ_HOLDING_REGISTERS, address, count, values);
+}
+
+bsp_modbus_error_t BspModbusMaster::readInputRegisters(uint8_t slave, uint16_t address, uint16_t count,
+                                                       uint16_t *values)
+{
+  return readRegisters(slave, BSP_MODBUS_READ_INPUT_REGISTERS, address, count, values);
+}
+
+bsp_modbus_error_t BspModbusMaster::writeSingleRegister(uint8_t slave, uint16_t address, uint16_t value)
+{
+  uint8_t request[4] = {(uint8_t) (address >> 8), (uint8_t) address, (uint8_t) (value >> 8), (uint8_t) value};
+  uint8_t response[4];
+  size_t  responseLength;
+
+  bsp_modbus_error_t result = transact(slave, BSP_MODBUS_WRITE_SINGLE_REGISTER, request, sizeof(request),
+                                       response, sizeof(response), responseLength);
+  if (result != BSP_MODBUS_OK)
+  {
+    return result;
+  }
+
+  // The slave echoes the request on success
+  if (responseLength != sizeof(request) || memcmp(request, response, sizeof(request)) != 0)
+  {
+    return BSP_MODBUS_ERR_FRAME;
+  }
+  return BSP_MODBUS_OK;
+}
+
+bsp_modbus_error_t BspModbusMaster::transact(uint8_t slave, uint8_t function, const uint8_t *data,
+                                             size_t dataLength, uint8_t *response, size_t responseSize,
+                                             size_t &responseLength)
+{
+  size_t length = 0;
+
+  responseLength = 0;
+  _exception     = BSP_MODBUS_EXCEPTION_NONE;
+  if (slave == 0 || slave > BSP_MODBUS_MAX_SLAVE || dataLength + 4 > sizeof(_frame))
+  {
+    return BSP_MODBUS_ERR;
+  }
+
+  // Slave, function, data, CRC low byte first
+  _frame[length++] = slave;
+  _frame[length++] = function;
+  memcpy(&_frame[length], data, dataLength);
+  length += dataLength;
+  uint16_t crc     = crc16Modbus(_frame, length);
+  _frame[length++] = crc & 0xFF;
+  _frame[length++] = crc >> 8;
+
+  // Keep the 3.5 character silence the slaves need to see the start of a new frame
+  uint32_t gapUs     = frameGapUs();
+  uint32_t elapsedUs = micros() - _lastActivityUs;
+  if (elapsedUs < gapUs)
+  {
+    delayMicroseconds(gapUs - elapsedUs);
+  }
+
+  // Drop late bytes of a previous exchange so they cannot be taken for this response
+  while (_port->available() > 0)
+  {
+    _port->read();
+  }
+
+  // Arm before sending so a reply ending right after the request still wakes this task
+  bool notify = _port->frameNotifyEnabled();
+  if (notify)
+  {
+    _port->armFrameNotify();
+  }
+
+  _timing         = {};
+  uint32_t sentUs = micros();
+  if (_port->write(_frame, length) != length)
+  {
+    if (notify)
+    {
+      _port->disarmFrameNotify();
+    }
+    return BSP_MODBUS_ERR_WRITE;
+  }
+  _port->flush();
+  _lastActivityUs = micros();
+  _timing.txUs    = _lastActivityUs - sentUs;
+  _timing.txBytes = length;
+  sentUs          = _lastActivityUs;
+
+  bool   timedOut;
+  size_t received = receive(gapUs, timedOut);
+  _lastActivityUs = micros();
+  if (notify)
+  {
+    _port->disarmFrameNotify();
+  }
+  _timing.responseUs = (_timing.notified ? _port->lastFrameUs() : _lastActivityUs) - sentUs;
+  _timing.rxBytes    = received;
+  _timing.wireUs     = wireTimeUs(received);
+  if (timedOut)
+  {
+    return BSP_MODBUS_TIMEOUT;
+  }
+
+  size_t expected = expectedLength(received);
+  if (received < BSP_MODBUS_EXCEPTION_FRAME || (expected > 0 && received < expected))
+  {
+    return BSP_MODBUS_ERR_FRAME;
+  }
+  crc = crc16Modbus(_frame, received - 2);
+  if (_frame[received - 2] != (crc & 0xFF) || _frame[received - 1] != (crc >> 8))
+  {
+    return BSP_MODBUS_ERR_CRC;
+  }
+  if (_frame[0] != slave)
+  {
+    return BSP_MODBUS_ERR_FRAME;
+  }
+  if (_frame[1] == (function | BSP_MODBUS_EXCEPTION_FLAG))
+  {
+    _exception = (bsp_modbus_exception_t) _frame[2];
+    return BSP_MODBUS_ERR_EXCEPTION;
+  }
+  if (_frame[1] != function || received - 4 > responseSize)
+  {
+    return BSP_MODBUS_ERR_FRAME;
+  }
+
+  responseLength = received - 4;
+  memcpy(response, &_frame[2], responseLength);
+  return BSP_MODBUS_OK;
+}
+
+bsp_modbus_exception_t BspModbusMaster::lastException() { return _exception; }
+
+bsp_modbus_timing_t BspModbusMaster::lastTiming() { return _timing; }
+
+bsp_modbus_error_t BspModbusMaster::readRegisters(uint8_t slave, uint8_t function, uint16_t address,
+                                                  uint16_t count, uint16_t *values)
+{
+  uint8_t request[4] = {(uint8_t) (address >> 8), (uint8_t) address, (uint8_t) (count >> 8), (uint8_t) count};
+  uint8_t response[1 + 2 * BSP_MODBUS_MAX_REGISTERS];
+  size_t  responseLength;
+
+  if (count == 0 || count > BSP_MODBUS_MAX_REGISTERS)
+  {
+    return BSP_MODBUS_ERR;
+  }
+
+  bsp_modbus_error_t result =
+  transact(slave, function, request, sizeof(request), response, sizeof(response), responseLength);
+  if (result != BSP_MODBUS_OK)
+  {
+    return result;
+  }
+
+  // Byte count, then the registers high byte first
+  if (response[0] != 2 * count || responseLength != 1 + 2 * (size_t) count)
+  {
+    return BSP_MODBUS_ERR_FRAME;
+  }
+  for (uint16_t i = 0; i < count; i++)
+  {
+    values[i] = (response[1 + 2 * i] << 8) | response[2 + 2 * i];
+  }
+  return BSP_MODBUS_OK;
+}
+
+uint32_t BspModbusMaster::frameGapUs()
+{
+  uint32_t baud = _port->baudRate();
+
+  if (baud == 0 || baud > 19200)
+  {
+    return BSP_MODBUS_FAST_FRAME_GAP_US;
+  }
+  // 3.5 characters, rounded up
+  return (35UL * BSP_MODBUS_CHAR_BITS * 1000000UL / baud + 9) / 10;
+}
+
+uint32_t BspModbusMaster::wireTimeUs(size_t bytes)
+{
+  uint32_t baud = _port->baudRate();
+
+  return (baud == 0) ? 0 : (uint32_t) ((uint64_t) bytes * BSP_MODBUS_CHAR_BITS * 1000000ULL / baud);
+}
+
+size_t BspModbusMaster::receive(uint32_t gapUs, bool &timedOut)
+{
+  bool     notify   = _port->frameNotifyEnabled();
+  bool     ended    = false;
+  uint32_t startMs  = millis();
+  uint32_t lastUs   = micros();
+  size_t   received = 0;
+
+  // Collect the response until the announced length arrived or the line stays silent for t3.5
+  timedOut = false;
+  for (;;)
+  {
+    while (_port->available() > 0 && received < sizeof(_frame))
+    {
+      _frame[received++] = _port->read();
+      lastUs             = micros();
+    }
+
+    if (received > 0)
+    {
+      size_t expected = expectedLength(received);
+      if ((expected > 0 && received >= expected) || received >= sizeof(_frame) || ended ||
+          (!notify && micros() - lastUs >= gapUs))
+      {
+        return received;
+      }
+    }
+    else if (millis() - startMs >= _responseTimeoutMs)
+    {
+      timedOut = true;
+      return 0;
+    }
+
+    if (!notify)
+    {
+      DELAY(1);
+      continue;
+    }
+
+    // Sleep until the UART reports the end of the reply. A reply that stops short gets the time the rest of a
+    // maximum frame would take, so a missed event cannot hang the exchange.
+    uint32_t elapsedMs = millis() - startMs;
+    uint32_t waitMs    = (elapsedMs < _responseTimeoutMs) ? _responseTimeoutMs - elapsedMs : 0;
+    if (received > 0)
+    {
+      waitMs = (wireTimeUs(sizeof(_frame) - received) + gapUs) / 1000 + 1;
+    }
+    if (_port->waitFrame(waitMs) == BSP_RS485_OK)
+    {
+      _timing.notified = true;
+      ended            = true;
+    }
+    else
+    {
+      ended = (received > 0);
+    }
+  }
+}
+
+size_t BspModbusMaster::expectedLength(size_t received)
+{
+  if (received < 2)
+  {
+    return 0;
+  }
+  if (_frame[1] & BSP_MODBUS_EXCEPTION_FLAG)
+  {
+    return BSP_MODBUS_EXCEPTION_FRAME;
+  }
+
+  switch (_frame[1])
+  {
+    case BSP_MODBUS_READ_HOLDING_REGISTERS:
+    case BSP_MODBUS_READ_INPUT_REGISTERS:
+      // Slave, function, byte count, data, CRC
+      return (received < 3) ? 0 : 5 + _frame[2];
+    case BSP_MODBUS_WRITE_SINGLE_REGISTER:
+      return BSP_MODBUS_ECHO_FRAME;
+    default:
+      // Unknown layout, rely on the silent interval
+      return 0;
+  }
+}
+/* Private function prototypes ---------------------------------------- */
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,211 @@
+/**
+ * @file       bsp_modbus.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-04
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the Modbus RTU master
+ *
+ * @note       Builds request frames with a computed CRC16, ends response frames on the 3.5 character silent
+ *             interval of the port's baud rate (or as soon as the announced length has arrived), and checks
+ *             the CRC, the echoed slave and function, and exception responses. When the port reports frame
+ *             ends (`BspRs485::enableFrameNotify()`), the calling task sleeps until the UART RX-timeout event
+ *             instead of polling the port.
+ * @example    `modbusMaster1.readHoldingRegisters(0x03, 0x0006, 1, &value);`
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef BSP_MODBUS_H
+  #define BSP_MODBUS_H
+
+  /* Includes ----------------------------------------------------------- */
+  #if ARDUINO >= 100
+    #include "Arduino.h"
+  #else
+    #include "WProgram.h"
+  #endif
+
+  #include "bsp_rs485.h"
+
+  /* Public defines ----------------------------------------------------- */
+  #define BSP_MODBUS_LIB_VERSION            (F("0.1.0"))
+
+  #define BSP_MODBUS_MAX_FRAME              256  // RTU ADU size limit
+  #define BSP_MODBUS_MAX_REGISTERS          125  // Registers per read request
+  #define BSP_MODBUS_RESPONSE_TIMEOUT_MS    200  // Default wait for the first response byte
+  #define BSP_MODBUS_FAST_FRAME_GAP_US      1750 // Fixed t3.5 above 19200 baud (serial line spec 2.5.1.1)
+
+  #define BSP_MODBUS_READ_HOLDING_REGISTERS 0x03
+  #define BSP_MODBUS_READ_INPUT_REGISTERS   0x04
+  #define BSP_MODBUS_WRITE_SINGLE_REGISTER  0x06
+
+/* Public enumerate/structure ----------------------------------------- */
+
+// Error codes for Modbus
+typedef enum
+{
+  BSP_MODBUS_OK = 0,
+  BSP_MODBUS_ERR,           /**< Invalid request */
+  BSP_MODBUS_ERR_WRITE,     /**< Request could not be sent */
+  BSP_MODBUS_ERR_CRC,       /**< Response CRC mismatch */
+  BSP_MODBUS_ERR_FRAME,     /**< Truncated response, or wrong slave, function or byte count */
+  BSP_MODBUS_ERR_EXCEPTION, /**< Slave answered with an exception, see `lastException()` */
+  BSP_MODBUS_TIMEOUT        /**< No response within the response timeout */
+} bsp_modbus_error_t;
+
+// Exception codes returned by a slave
+typedef enum
+{
+  BSP_MODBUS_EXCEPTION_NONE                 = 0x00,
+  BSP_MODBUS_EXCEPTION_ILLEGAL_FUNCTION     = 0x01,
+  BSP_MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS = 0x02,
+  BSP_MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE   = 0x03,
+  BSP_MODBUS_EXCEPTION_SLAVE_DEVICE_FAILURE = 0x04,
+  BSP_MODBUS_EXCEPTION_ACKNOWLEDGE          = 0x05,
+  BSP_MODBUS_EXCEPTION_SLAVE_DEVICE_BUSY    = 0x06
+} bsp_modbus_exception_t;
+
+// Contiguous register range read in one request
+typedef struct
+{
+  uint16_t address; /**< First register */
+  uint16_t count;   /**< Number of registers */
+} bsp_modbus_range_t;
+
+// Timing of one exchange
+typedef struct
+{
+  uint32_t txUs;       /**< Request handed to the UART until its last bit left the line */
+  uint32_t responseUs; /**< End of the request until the response was complete */
+  uint32_t wireUs;     /**< Time the response bytes occupy the line at the port's baud rate */
+  uint16_t txBytes;    /**< Request frame length */
+  uint16_t rxBytes;    /**< Response bytes received */
+  bool     notified;   /**< Response ended by the UART RX-timeout event rather than by polling */
+} bsp_modbus_timing_t;
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/**
+ * @brief Modbus RTU master bound to one RS-485 port.
+ *
+ * The port must already be opened with `BspRs485::begin()`, the frame timing follows its baud rate.
+ *
+ * @attention Transactions are not serialized, use one master from a single task.
+ */
+class BspModbusMaster
+{
+public:
+  BspModbusMaster(BspRs485 &port);
+
+  /**
+   * @brief  Sets how long to wait for the first byte of a response.
+   *
+   * @param[in]     timeoutMs Response timeout in milliseconds
+   */
+  void setResponseTimeout(uint32_t timeoutMs);
+
+  /**
+   * @brief  Reads holding registers (function 0x03).
+   *
+   * @param[in]     slave   Slave address, 1 to 247
+   * @param[in]     address First register
+   * @param[in]     count   Number of registers, 1 to `BSP_MODBUS_MAX_REGISTERS`
+   * @param[out]    values  Register values, `count` entries
+   *
+   * @attention  `values` is left untouched on failure.
+   *
+   * @return
+   *  - `BSP_MODBUS_OK`           : Success
+   *  - `BSP_MODBUS_ERR`          : Invalid slave or count
+   *  - `BSP_MODBUS_ERR_WRITE`    : Request could not be sent
+   *  - `BSP_MODBUS_ERR_CRC`      : Corrupted response
+   *  - `BSP_MODBUS_ERR_FRAME`    : Malformed response
+   *  - `BSP_MODBUS_ERR_EXCEPTION`: Exception response
+   *  - `BSP_MODBUS_TIMEOUT`      : No response
+   */
+  bsp_modbus_error_t readHoldingRegisters(uint8_t slave, uint16_t address, uint16_t count, uint16_t *values);
+
+  /**
+   * @brief  Reads input registers (function 0x04).
+   *
+   * @param[in]     slave   Slave address, 1 to 247
+   * @param[in]     address First register
+   * @param[in]     count   Number of registers, 1 to `BSP_MODBUS_MAX_REGISTERS`
+   * @param[out]    values  Register values, `count` entries
+   *
+   * @return  Same as `readHoldingRegisters()`.
+   */
+  bsp_modbus_error_t readInputRegisters(uint8_t slave, uint16_t address, uint16_t count, uint16_t *values);
+
+  /**
+   * @brief  Writes one holding register (function 0x06).
+   *
+   * @param[in]     slave   Slave address, 1 to 247
+   * @param[in]     address Register
+   * @param[in]     value   Value to write
+   *
+   * @return  Same as `readHoldingRegisters()`, a response that does not echo the request is
+   *          `BSP_MODBUS_ERR_FRAME`.
+   */
+  bsp_modbus_error_t writeSingleRegister(uint8_t slave, uint16_t address, uint16_t value);
+
+  /**
+   * @brief  Runs one request/response exchange with an arbitrary function.
+   *
+   * @param[in]     slave          Slave address, 1 to 247
+   * @param[in]     function       Function code
+   * @param[in]     data           Request data following the function code
+   * @param[in]     dataLength     Length of `data`
+   * @param[out]    response       Response data following the function code, CRC stripped
+   * @param[in]     responseSize   Size of `response`
+   * @param[out]    responseLength Length written to `response`
+   *
+   * @return  Same as `readHoldingRegisters()`.
+   */
+  bsp_modbus_error_t transact(uint8_t slave, uint8_t function, const uint8_t *data, size_t dataLength,
+                              uint8_t *response, size_t responseSize, size_t &responseLength);
+
+  /**
+   * @brief  Returns the exception code of the last exchange.
+   *
+   * @return  The slave's exception code, `BSP_MODBUS_EXCEPTION_NONE` unless the last exchange ended with
+   *          `BSP_MODBUS_ERR_EXCEPTION`.
+   */
+  bsp_modbus_exception_t lastException();
+
+  /**
+   * @brief  Returns the timing of the last exchange.
+   *
+   * @attention  `responseUs` minus `wireUs` is the slave's turnaround plus the end-of-frame detection, a
+   *             timeout leaves `responseUs` at the response timeout and `rxBytes` at 0.
+   *
+   * @return  Timing of the last exchange that sent a request.
+   */
+  bsp_modbus_timing_t lastTiming();
+
+private:
+  BspRs485              *_port;
+  uint32_t               _responseTimeoutMs = BSP_MODBUS_RESPONSE_TIMEOUT_MS;
+  uint32_t               _lastActivityUs    = 0;
+  bsp_modbus_exception_t _exception         = BSP_MODBUS_EXCEPTION_NONE;
+  bsp_modbus_timing_t    _timing            = {};
+  uint8_t                _frame[BSP_MODBUS_MAX_FRAME];
+
+  bsp_modbus_error_t readRegisters(uint8_t slave, uint8_t function, uint16_t address, uint16_t count,
+                                   uint16_t *values);
+  uint32_t           frameGapUs();
+  uint32_t           wireTimeUs(size_t bytes);
+  size_t             receive(uint32_t gapUs, bool &timedOut);
+  size_t             expectedLength(size_t received);
+};
+
+extern BspModbusMaster modbusMaster1;
+
+#endif // BSP_MODBUS_H
+
+/* End of file -------------------------------------------------------- */
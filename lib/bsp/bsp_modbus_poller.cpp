@@ -0,0 +1,278 @@
+/**
+ * @file       bsp_modbus_poller.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-05
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the Modbus RTU polling scheduler
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "bsp_modbus_poller.h"
+
+/* Private defines ---------------------------------------------------- */
+
+/* Private enumerate/structure ---------------------------------------- */
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+BspModbusPoller modbusPoller1(modbusMaster1);
+
+/* Private variables -------------------------------------------------- */
+
+/* Class method definitions-------------------------------------------- */
+BspModbusPoller::BspModbusPoller(BspModbusMaster &master) : _master(&master), _lock(xSemaphoreCreateMutex())
+{}
+
+int BspModbusPoller::addBlock(uint8_t slave, uint8_t function, uint16_t address, uint16_t count,
+                              uint32_t periodMs, uint16_t *values, bsp_modbus_poll_callback_t callback,
+                              void *context)
+{
+  if (_blockCount >= BSP_MODBUS_POLLER_MAX_BLOCKS || count == 0 || count > BSP_MODBUS_MAX_REGISTERS ||
+      periodMs == 0 || values == NULL ||
+      (function != BSP_MODBUS_READ_HOLDING_REGISTERS && function != BSP_MODBUS_READ_INPUT_REGISTERS))
+  {
+    return -1;
+  }
+
+  block_t *block = &_blocks[_blockCount];
+  memset(block, 0, sizeof(*block));
+  block->slave     = slave;
+  block->function  = function;
+  block->address   = address;
+  block->count     = count;
+  block->periodMs  = periodMs;
+  block->nextDueMs = millis(); // Every block is due on the first scan
+  block->values    = values;
+  block->callback  = callback;
+  block->context   = context;
+
+  block->ranges[0].address = address;
+  block->ranges[0].count   = count;
+  block->rangeCount        = 1;
+
+  return _blockCount++;
+}
+
+bsp_modbus_error_t BspModbusPoller::splitBlock(uint8_t index, const bsp_modbus_range_t *ranges, uint8_t count)
+{
+  if (index >= _blockCount || ranges == NULL || count == 0 || count > BSP_MODBUS_POLLER_MAX_RANGES)
+  {
+    return BSP_MODBUS_ERR;
+  }
+
+  block_t *block = &_blocks[index];
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (ranges[i].count == 0 || ranges[i].count > BSP_MODBUS_MAX_REGISTERS ||
+        ranges[i].address < block->address ||
+        ranges[i].address + ranges[i].count > block->address + block->count)
+    {
+      return BSP_MODBUS_ERR;
+    }
+  }
+
+  memcpy(block->ranges, ranges, count * sizeof(ranges[0]));
+  block->rangeCount = count;
+  // The poll that was rejected is not lost, the new requests go out on the next scan
+  block->nextDueMs  = millis();
+
+  return BSP_MODBUS_OK;
+}
+
+uint32_t BspModbusPoller::poll()
+{
+  // One scan serves each block at most once so a table that is always due still returns to the caller
+  for (uint8_t served = 0;; served++)
+  {
+    // Most overdue block first, table order on ties, wrap-safe through the signed difference
+    uint32_t now     = millis();
+    block_t *due     = NULL;
+    int32_t  lateMax = 0;
+    uint32_t waitMs  = BSP_MODBUS_POLLER_MAX_IDLE_MS;
+    for (uint8_t i = 0; i < _blockCount; i++)
+    {
+      int32_t late = (int32_t) (now - _blocks[i].nextDueMs);
+      if (late > lateMax || (due == NULL && late == lateMax))
+      {
+        due     = &_blocks[i];
+        lateMax = late;
+      }
+      else if ((uint32_t) -late < waitMs)
+      {
+        waitMs = (uint32_t) -late;
+      }
+    }
+    if (due == NULL)
+    {
+      return waitMs;
+    }
+    if (served >= _blockCount)
+    {
+      return 0;
+    }
+
+    // A split block sends its requests back to back and stops at the first failing one
+    bsp_modbus_error_t result = BSP_MODBUS_OK;
+    for (uint8_t r = 0; r < due->rangeCount && result == BSP_MODBUS_OK; r++)
+    {
+      const bsp_modbus_range_t *range   = &due->ranges[r];
+      uint16_t                 *values  = due->values + (range->address - due->address);
+      uint32_t                  startUs = micros();
+      if (due->function == BSP_MODBUS_READ_INPUT_REGISTERS)
+      {
+        result = _master->readInputRegisters(due->slave, range->address, range->count, values);
+      }
+      else
+      {
+        result = _master->readHoldingRegisters(due->slave, range->address, range->count, values);
+      }
+      record(due, result, micros() - startUs);
+    }
+
+    // Keep the period grid, but do not replay polls missed while the line was busy
+    due->nextDueMs += due->periodMs;
+    if ((int32_t) (due->lastPollMs - due->nextDueMs) > 0)
+    {
+      due->nextDueMs = due->lastPollMs + due->periodMs;
+    }
+
+    if (due->callback != NULL)
+    {
+      due->callback(due->slave, due->address, due->values, due->count, result, due->context);
+    }
+  }
+}
+
+void BspModbusPoller::record(block_t *block, bsp_modbus_error_t result, uint32_t latency)
+{
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  bsp_modbus_poll_stats_t *stats = &block->stats;
+  stats->requests++;
+  stats->lastResult    = result;
+  stats->latencyLastUs = latency;
+  stats->lastTiming    = _master->lastTiming();
+  if (result == BSP_MODBUS_TIMEOUT)
+  {
+    stats->timeouts++;
+  }
+  else
+  {
+    // Timeouts only measure the response timeout, keep them out of the latency figures
+    stats->latencyTotalUs += latency;
+    if (latency > stats->latencyMaxUs)
+    {
+      stats->latencyMaxUs = latency;
+    }
+    if (result != BSP_MODBUS_OK)
+    {
+      stats->errors++;
+    }
+  }
+  block->lastPollMs = millis();
+  xSemaphoreGive(_lock);
+}
+
+bsp_modbus_error_t BspModbusPoller::start()
+{
+  if (xTaskCreate(task, "Modbus Poller Task", BSP_MODBUS_POLLER_TASK_STACK, this,
+                  BSP_MODBUS_POLLER_TASK_PRIORITY, NULL) != pdPASS)
+  {
+    return BSP_MODBUS_ERR;
+  }
+  return BSP_MODBUS_OK;
+}
+
+uint8_t BspModbusPoller::blockCount() { return _blockCount; }
+
+bsp_modbus_error_t BspModbusPoller::getBlockStats(uint8_t index, bsp_modbus_poll_stats_t *stats)
+{
+  if (index >= _blockCount || stats == NULL)
+  {
+    return BSP_MODBUS_ERR;
+  }
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  *stats = _blocks[index].stats;
+  xSemaphoreGive(_lock);
+
+  return BSP_MODBUS_OK;
+}
+
+bsp_modbus_error_t BspModbusPoller::getSlaveStats(uint8_t slave, bsp_modbus_poll_stats_t *stats)
+{
+  bool     found      = false;
+  uint32_t lastPollMs = 0;
+
+  if (stats == NULL)
+  {
+    return BSP_MODBUS_ERR;
+  }
+  memset(stats, 0, sizeof(*stats));
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  for (uint8_t i = 0; i < _blockCount; i++)
+  {
+    const block_t *block = &_blocks[i];
+    if (block->slave != slave)
+    {
+      continue;
+    }
+
+    stats->requests       += block->stats.requests;
+    stats->timeouts       += block->stats.timeouts;
+    stats->errors         += block->stats.errors;
+    stats->latencyTotalUs += block->stats.latencyTotalUs;
+    if (block->stats.latencyMaxUs > stats->latencyMaxUs)
+    {
+      stats->latencyMaxUs = block->stats.latencyMaxUs;
+    }
+    if (!found || (int32_t) (block->lastPollMs - lastPollMs) > 0)
+    {
+      stats->latencyLastUs = block->stats.latencyLastUs;
+      stats->lastResult    = block->stats.lastResult;
+      stats->lastTiming    = block->stats.lastTiming;
+      lastPollMs           = block->lastPollMs;
+    }
+    found = true;
+  }
+  xSemaphoreGive(_lock);
+
+  return found ? BSP_MODBUS_OK : BSP_MODBUS_ERR;
+}
+
+size_t BspModbusPoller::statsToJson(const bsp_modbus_poll_stats_t *stats, char *buffer, size_t size)
+{
+  // Timeouts are excluded from the latency sum
+  uint32_t answered = stats->requests - stats->timeouts;
+  uint32_t average  = (answered > 0) ? (uint32_t) (stats->latencyTotalUs / answered) : 0;
+  int      len      = snprintf(buffer, size,
+                               "{\"req\":%lu,\"to\":%lu,\"err\":%lu,\"last\":%lu,\"avg\":%lu,\"max\":%lu,"
+                               "\"res\":%d,\"tx\":%lu,\"rx\":%lu,\"wire\":%lu,\"irq\":%d}",
+                               (unsigned long) stats->requests, (unsigned long) stats->timeouts,
+                               (unsigned long) stats->errors, (unsigned long) stats->latencyLastUs,
+                               (unsigned long) average, (unsigned long) stats->latencyMaxUs,
+                               (int) stats->lastResult, (unsigned long) stats->lastTiming.txUs,
+                               (unsigned long) stats->lastTiming.responseUs,
+                               (unsigned long) stats->lastTiming.wireUs, stats->lastTiming.notified ? 1 : 0);
+
+  return (len < 0) ? 0 : (size_t) len;
+}
+
+void BspModbusPoller::task(void *pvParameters)
+{
+  BspModbusPoller *poller = (BspModbusPoller *) pvParameters;
+
+  for (;;)
+  {
+    uint32_t waitMs = poller->poll();
+    vTaskDelay(pdMS_TO_TICKS(waitMs > 0 ? waitMs : 1));
+  }
+}
+
+/* Private function prototypes ---------------------------------------- */
+
+/* End of file -------------------------------------------------------- */
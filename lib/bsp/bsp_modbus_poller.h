@@ -0,0 +1,215 @@
+/**
+ * @file       bsp_modbus_poller.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-05
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the Modbus RTU polling scheduler
+ *
+ * @note       Keeps a table of register blocks (slave, function, first register, count, period) and reads
+ *             every due block back to back from one task, so a line with tens of slaves runs at line rate
+ *             instead of paying a fixed sleep per request. Latency, timeouts and errors are tracked per block
+ *             and can be summed per slave.
+ * @example    `modbusPoller1.addBlock(0x03, BSP_MODBUS_READ_HOLDING_REGISTERS, 0x06, 27, 60000, r, cb, p);`
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef BSP_MODBUS_POLLER_H
+  #define BSP_MODBUS_POLLER_H
+
+  /* Includes ----------------------------------------------------------- */
+  #if ARDUINO >= 100
+    #include "Arduino.h"
+  #else
+    #include "WProgram.h"
+  #endif
+
+  #include "bsp_modbus.h"
+
+  /* Public defines ----------------------------------------------------- */
+  #define BSP_MODBUS_POLLER_MAX_BLOCKS     32   // Register blocks in the polling table
+  #define BSP_MODBUS_POLLER_MAX_RANGES     4    // Requests one block can be split into
+  #define BSP_MODBUS_POLLER_TASK_STACK     4096 // Poller task stack size
+  #define BSP_MODBUS_POLLER_TASK_PRIORITY  2    // Above the sensor tasks so requests go out on time
+  #define BSP_MODBUS_POLLER_MAX_IDLE_MS    1000 // Longest sleep between two table scans
+
+/* Public enumerate/structure ----------------------------------------- */
+
+// Traffic counters of one block, or of every block of a slave
+typedef struct
+{
+  uint32_t            requests;       /**< Requests sent, every request of a split block counts */
+  uint32_t            timeouts;       /**< Requests left unanswered */
+  uint32_t            errors;         /**< CRC, frame and exception responses */
+  uint32_t            latencyLastUs;  /**< Request to end of response, last exchange */
+  uint32_t            latencyMaxUs;   /**< Slowest exchange */
+  uint64_t            latencyTotalUs; /**< Sum over every exchange, for the average */
+  bsp_modbus_error_t  lastResult;     /**< Result of the last exchange */
+  bsp_modbus_timing_t lastTiming;     /**< Wire timing of the last exchange */
+} bsp_modbus_poll_stats_t;
+
+/**
+ * @brief  Called from the poller task after every exchange of a block.
+ *
+ * @param[in]     slave   Slave address
+ * @param[in]     address First register of the block
+ * @param[in]     values  Register values, only valid when `result` is `BSP_MODBUS_OK`
+ * @param[in]     count   Number of registers
+ * @param[in]     result  Exchange result
+ * @param[in]     context Pointer given to `addBlock()`
+ */
+typedef void (*bsp_modbus_poll_callback_t)(uint8_t slave, uint16_t address, const uint16_t *values,
+                                           uint16_t count, bsp_modbus_error_t result, void *context);
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/**
+ * @brief Polls a table of Modbus register blocks through one master.
+ *
+ * Blocks are added before `start()`. The poller task then always serves the most overdue block first and
+ * sleeps only when nothing is due, so requests follow each other separated by the t3.5 gap alone.
+ */
+class BspModbusPoller
+{
+public:
+  BspModbusPoller(BspModbusMaster &master);
+
+  /**
+   * @brief  Adds a register block to the polling table.
+   *
+   * @param[in]     slave    Slave address, 1 to 247
+   * @param[in]     function `BSP_MODBUS_READ_HOLDING_REGISTERS` or `BSP_MODBUS_READ_INPUT_REGISTERS`
+   * @param[in]     address  First register
+   * @param[in]     count    Number of registers, 1 to `BSP_MODBUS_MAX_REGISTERS`
+   * @param[in]     periodMs Polling period in milliseconds
+   * @param[out]    values   Destination of the register values, `count` entries, must stay valid
+   * @param[in]     callback Called after every exchange, may be `NULL`
+   * @param[in]     context  Passed to `callback`
+   *
+   * @attention  Call before `start()`, the table is not locked against the poller task.
+   *
+   * @return  Block index, or -1 when the table is full or the block is invalid.
+   */
+  int addBlock(uint8_t slave, uint8_t function, uint16_t address, uint16_t count, uint32_t periodMs,
+               uint16_t *values, bsp_modbus_poll_callback_t callback, void *context);
+
+  /**
+   * @brief  Replaces the single request of a block by smaller requests inside its register range.
+   *
+   * For slaves that reject the block with an exception response, e.g. for unmapped registers inside it.
+   * The requests then run back to back on every poll and count in the block's counters, the callback
+   * runs once per poll with the whole block, after the last request or the first failing one. Registers
+   * between the ranges keep their previous values. The block is due again at once.
+   *
+   * @param[in]     index  Block index returned by `addBlock()`
+   * @param[in]     ranges Requests, each inside the block's register range
+   * @param[in]     count  Number of requests, 1 to `BSP_MODBUS_POLLER_MAX_RANGES`
+   *
+   * @attention  Call before `start()` or from the block's callback, which runs in the poller task.
+   *
+   * @return
+   *  - `BSP_MODBUS_OK` : Success
+   *  - `BSP_MODBUS_ERR`: No block at `index`, or invalid ranges
+   */
+  bsp_modbus_error_t splitBlock(uint8_t index, const bsp_modbus_range_t *ranges, uint8_t count);
+
+  /**
+   * @brief  Reads the blocks that are due, most overdue first, at most one exchange per block.
+   *
+   * @param[in]     None
+   *
+   * @attention  Called by the poller task, only call it directly when the task is not started.
+   *
+   * @return  Milliseconds until the next block is due, 0 when blocks are still due.
+   */
+  uint32_t poll();
+
+  /**
+   * @brief  Starts the poller task.
+   *
+   * @param[in]     None
+   *
+   * @return
+   *  - `BSP_MODBUS_OK` : Task running
+   *  - `BSP_MODBUS_ERR`: Task could not be created
+   */
+  bsp_modbus_error_t start();
+
+  /**
+   * @brief  Returns the number of blocks in the table.
+   */
+  uint8_t blockCount();
+
+  /**
+   * @brief  Reads the counters of one block.
+   *
+   * @param[in]     index Block index returned by `addBlock()`
+   * @param[out]    stats Counters
+   *
+   * @return
+   *  - `BSP_MODBUS_OK` : Success
+   *  - `BSP_MODBUS_ERR`: No block at `index`
+   */
+  bsp_modbus_error_t getBlockStats(uint8_t index, bsp_modbus_poll_stats_t *stats);
+
+  /**
+   * @brief  Sums the counters of every block of a slave.
+   *
+   * @param[in]     slave Slave address
+   * @param[out]    stats Counters, `latencyLastUs`, `lastResult` and `lastTiming` come from the slave's last
+   *                      exchange
+   *
+   * @return
+   *  - `BSP_MODBUS_OK` : Success
+   *  - `BSP_MODBUS_ERR`: No block polls `slave`
+   */
+  bsp_modbus_error_t getSlaveStats(uint8_t slave, bsp_modbus_poll_stats_t *stats);
+
+  /**
+   * @brief  Formats counters as a compact JSON object.
+   *
+   * @param[in]     stats Counters to format
+   * @param[out]    buffer Destination string
+   * @param[in]     size   Size of `buffer`
+   *
+   * @return  Number of characters that would have been written, as `snprintf()`.
+   */
+  static size_t statsToJson(const bsp_modbus_poll_stats_t *stats, char *buffer, size_t size);
+
+private:
+  typedef struct
+  {
+    uint8_t                    slave;
+    uint8_t                    function;
+    uint16_t                   address;
+    uint16_t                   count;
+    uint32_t                   periodMs;
+    uint32_t                   nextDueMs;
+    uint32_t                   lastPollMs;
+    uint16_t                  *values;
+    bsp_modbus_range_t         ranges[BSP_MODBUS_POLLER_MAX_RANGES]; // Requests of one poll
+    uint8_t                    rangeCount;
+    bsp_modbus_poll_callback_t callback;
+    void                      *context;
+    bsp_modbus_poll_stats_t    stats;
+  } block_t;
+
+  BspModbusMaster  *_master;
+  SemaphoreHandle_t _lock;
+  block_t           _blocks[BSP_MODBUS_POLLER_MAX_BLOCKS];
+  uint8_t           _blockCount = 0;
+
+  void        record(block_t *block, bsp_modbus_error_t result, uint32_t latency);
+  static void task(void *pvParameters);
+};
+
+extern BspModbusPoller modbusPoller1;
+
+#endif // BSP_MODBUS_POLLER_H
+
+/* End of file -------------------------------------------------------- */
@@ -57,9 +57,49 @@ bsp_rs485_error_t BspRs485::begin(unsigned long baud, uint32_t config, int8_t rx
 bsp_rs485_error_t BspRs485::end()
 {
   _uart->end();
+  _frameNotify = false;
   return BSP_RS485_OK;
 }
 
+bsp_rs485_error_t BspRs485::enableFrameNotify(uint8_t symbols)
+{
+  if (_frameDone == NULL)
+  {
+    _frameDone = xSemaphoreCreateBinary();
+  }
+  if (_frameDone == NULL || !_uart->setRxTimeout(symbols))
+  {
+    return BSP_RS485_ERR;
+  }
+
+  // Only the RX timeout marks the end of a frame, FIFO-full events arrive mid-frame
+  _uart->onReceive([this]() { onFrameEnd(); }, true);
+  _frameNotify = true;
+  return BSP_RS485_OK;
+}
+
+bool BspRs485::frameNotifyEnabled() { return _frameNotify; }
+
+void BspRs485::armFrameNotify()
+{
+  xSemaphoreTake(_frameDone, 0);
+  _frameArmed = true;
+}
+
+void BspRs485::disarmFrameNotify()
+{
+  _frameArmed = false;
+  // A frame that ended meanwhile must not end the next exchange's wait
+  xSemaphoreTake(_frameDone, 0);
+}
+
+bsp_rs485_error_t BspRs485::waitFrame(uint32_t timeoutMs)
+{
+  return (xSemaphoreTake(_frameDone, pdMS_TO_TICKS(timeoutMs)) == pdTRUE) ? BSP_RS485_OK : BSP_RS485_TIMEOUT;
+}
+
+uint32_t BspRs485::lastFrameUs() { return _frameEndUs; }
+
 int BspRs485::available(void) { return _uart->available(); }
 
 int BspRs485::peek(void) { return _uart->peek(); }
@@ -70,14 +110,17 @@ void BspRs485::flush() { _uart->flush(); }
 
 size_t BspRs485::write(uint8_t c) { return _uart->write(c); }
 
-void BspRs485::sendModbusCommand(byte *command, uint32_t cmdLen, byte *response, uint32_t resLen)
+size_t BspRs485::write(const uint8_t *buffer, size_t size) { return _uart->write(buffer, size); }
+
+uint32_t BspRs485::baudRate() { return _uart->baudRate(); }
+
+void BspRs485::onFrameEnd()
 {
-  _uart->write(command, cmdLen);
-  _uart->flush();
-  DELAY(100);
-  if (_uart->available() >= resLen)
+  // Runs in the UART event task, the received bytes are already in the RX buffer
+  _frameEndUs = micros();
+  if (_frameArmed)
   {
-    _uart->readBytes(response, resLen);
+    xSemaphoreGive(_frameDone);
   }
 }
 /* Private function prototypes ---------------------------------------- */
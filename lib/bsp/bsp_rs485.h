@@ -21,7 +21,9 @@
 
   #include "bsp_uart.h"
   /* Public defines ----------------------------------------------------- */
-  #define BSP_RS485_LIB_VERSION (F("0.1.0"))
+  #define BSP_RS485_LIB_VERSION        (F("0.1.0"))
+
+  #define BSP_RS485_RX_TIMEOUT_SYMBOLS 4 // Idle characters that end a frame, t3.5 rounded up for Modbus RTU
 
 /* Public enumerate/structure ----------------------------------------- */
 
@@ -45,6 +47,57 @@ class BspRs485 : public Stream
 public:
   BspRs485(uint8_t uart_nr);
 
+  /**
+   * @brief  Wakes the armed task as soon as the UART detects the end of a received frame.
+   *
+   * Programs the UART RX timeout to `symbols` idle characters and installs a receive callback that only
+   * fires on that timeout, so the end of a reply is reported by the UART instead of being found by polling.
+   *
+   * @param[in]     symbols Idle characters after the last received byte that end a frame
+   *
+   * @attention  Call after `begin()`, the RX timeout needs the UART driver to be installed.
+   *
+   * @return
+   *  - `BSP_RS485_OK` : Success
+   *  - `BSP_RS485_ERR`: The UART refused the RX timeout
+   */
+  bsp_rs485_error_t enableFrameNotify(uint8_t symbols = BSP_RS485_RX_TIMEOUT_SYMBOLS);
+
+  /**
+   * @brief  Returns whether `enableFrameNotify()` succeeded, i.e. whether `waitFrame()` can be used.
+   */
+  bool frameNotifyEnabled();
+
+  /**
+   * @brief  Makes the calling task the one woken at the end of the next received frames.
+   *
+   * Clears a frame end left over from an earlier exchange. Call it before sending the request so a fast
+   * reply cannot be missed. Frame ends are signalled on a semaphore of the port, the task notification stays
+   * free for `bspI2CTransfer()` completions of the same task.
+   */
+  void armFrameNotify();
+
+  /**
+   * @brief  Stops waking the armed task and drops a frame end it has not taken yet.
+   */
+  void disarmFrameNotify();
+
+  /**
+   * @brief  Blocks the armed task until the end of a received frame.
+   *
+   * @param[in]     timeoutMs Longest wait in milliseconds
+   *
+   * @return
+   *  - `BSP_RS485_OK`     : A frame ended, its bytes are `available()`
+   *  - `BSP_RS485_TIMEOUT`: No frame ended within `timeoutMs`
+   */
+  bsp_rs485_error_t waitFrame(uint32_t timeoutMs);
+
+  /**
+   * @brief  Returns `micros()` at the last end-of-frame event.
+   */
+  uint32_t lastFrameUs();
+
 public:
   bsp_rs485_error_t begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1,
                           int8_t txPin = -1, bool invert = false, unsigned long timeout_ms = 20000UL,
@@ -55,10 +108,17 @@ public:
   int               read(void) override;
   void              flush() override;
   size_t            write(uint8_t);
-  void              sendModbusCommand(byte *command, uint32_t cmdLen, byte *response, uint32_t resLen);
+  size_t            write(const uint8_t *buffer, size_t size);
+  uint32_t          baudRate();
 
 private:
-  BspUart *_uart;
+  BspUart              *_uart;
+  bool              _frameNotify = false;
+  SemaphoreHandle_t _frameDone   = NULL; // Given at a frame end while armed, not a task notification
+  volatile bool     _frameArmed  = false;
+  volatile uint32_t _frameEndUs  = 0;
+
+  void onFrameEnd();
 };
 
 extern BspRs485 rs485Serial0;
@@ -0,0 +1,164 @@
+/**
+ * @file       checksum.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-08
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for Checksum library
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "checksum.h"
+
+/* Private defines ---------------------------------------------------- */
+#define CRC8_POLYNOMIAL         0x31
+#define CRC16_MODBUS_POLYNOMIAL 0xA001
+#define CRC32_POLYNOMIAL        0xEDB88320UL
+#define CRC_TABLE_SIZE          256
+#define CRC32_SLICES            4
+
+/* Private enumerate/structure ---------------------------------------- */
+// Wrappers so constexpr functions can return whole tables
+typedef struct
+{
+  uint8_t entry[CRC_TABLE_SIZE];
+} crc8_table_t;
+
+typedef struct
+{
+  uint16_t entry[CRC_TABLE_SIZE];
+} crc16_table_t;
+
+typedef struct
+{
+  uint32_t entry[CRC32_SLICES][CRC_TABLE_SIZE];
+} crc32_table_t;
+
+// Compile-time list 0..N-1 to expand one table entry per index (std::index_sequence is C++14)
+template <size_t... I> struct crc_index_list
+{
+};
+
+template <size_t N, size_t... I> struct crc_make_index_list : crc_make_index_list<N - 1, N - 1, I...>
+{
+};
+
+template <size_t... I> struct crc_make_index_list<0, I...>
+{
+  typedef crc_index_list<I...> type;
+};
+
+/* Private function prototypes ---------------------------------------- */
+// C++11 constexpr functions are a single return statement, the eight bit steps recurse instead of looping
+static constexpr uint8_t crc8Step(uint8_t crc)
+{
+  return (crc & 0x80) ? (uint8_t) ((crc << 1) ^ CRC8_POLYNOMIAL) : (uint8_t) (crc << 1);
+}
+
+static constexpr uint8_t crc8Entry(uint8_t crc, int bits)
+{
+  return (bits == 0) ? crc : crc8Entry(crc8Step(crc), bits - 1);
+}
+
+static constexpr uint16_t crc16Step(uint16_t crc)
+{
+  return (crc & 0x0001) ? (uint16_t) ((crc >> 1) ^ CRC16_MODBUS_POLYNOMIAL) : (uint16_t) (crc >> 1);
+}
+
+static constexpr uint16_t crc16Entry(uint16_t crc, int bits)
+{
+  return (bits == 0) ? crc : crc16Entry(crc16Step(crc), bits - 1);
+}
+
+static constexpr uint32_t crc32Step(uint32_t crc)
+{
+  return (crc & 1) ? (crc >> 1) ^ CRC32_POLYNOMIAL : (crc >> 1);
+}
+
+static constexpr uint32_t crc32Entry(uint32_t crc, int bits)
+{
+  return (bits == 0) ? crc : crc32Entry(crc32Step(crc), bits - 1);
+}
+
+// Slice k is the CRC of a byte followed by k zero bytes
+static constexpr uint32_t crc32SliceEntry(size_t slice, uint32_t index)
+{
+  return (slice == 0) ? crc32Entry(index, 8)
+                      : (crc32SliceEntry(slice - 1, index) >> 8) ^
+                        crc32Entry(crc32SliceEntry(slice - 1, index) & 0xFF, 8);
+}
+
+template <size_t... I> static constexpr crc8_table_t crc8MakeTable(crc_index_list<I...>)
+{
+  return {{crc8Entry(I, 8)...}};
+}
+
+template <size_t... I> static constexpr crc16_table_t crc16MakeTable(crc_index_list<I...>)
+{
+  return {{crc16Entry(I, 8)...}};
+}
+
+template <size_t... I> static constexpr crc32_table_t crc32MakeTable(crc_index_list<I...>)
+{
+  return {{{crc32SliceEntry(0, I)...},
+           {crc32SliceEntry(1, I)...},
+           {crc32SliceEntry(2, I)...},
+           {crc32SliceEntry(3, I)...}}};
+}
+
+/* Private variables -------------------------------------------------- */
+static constexpr crc8_table_t  crc8Table  = crc8MakeTable(crc_make_index_list<CRC_TABLE_SIZE>::type());
+static constexpr crc16_table_t crc16Table = crc16MakeTable(crc_make_index_list<CRC_TABLE_SIZE>::type());
+static constexpr crc32_table_t crc32Table = crc32MakeTable(crc_make_index_list<CRC_TABLE_SIZE>::type());
+
+// Datasheet and catalogue check values, a wrong table fails the build instead of the sensor reads
+static_assert(crc8Table.entry[0x01] == 0x31 && crc8Table.entry[0xFF] == 0xAC, "CRC8 table");
+static_assert(crc16Table.entry[0x01] == 0xC0C1 && crc16Table.entry[0xFF] == 0x4040, "CRC16 table");
+static_assert(crc32Table.entry[0][0x01] == 0x77073096UL && crc32Table.entry[0][0xFF] == 0x2D02EF8DUL,
+              "CRC32 table");
+
+/* Function definitions ----------------------------------------------- */
+uint8_t crc8(const uint8_t *data, int len)
+{
+  uint8_t crc = CHECKSUM_CRC8_INIT;
+
+  for (int i = 0; i < len; i++)
+  {
+    crc = crc8Table.entry[crc ^ data[i]];
+  }
+  return crc;
+}
+
+uint16_t crc16Modbus(const uint8_t *data, size_t length, uint16_t crc)
+{
+  for (size_t i = 0; i < length; i++)
+  {
+    crc = (crc >> 8) ^ crc16Table.entry[(crc ^ data[i]) & 0xFF];
+  }
+  return crc;
+}
+
+uint32_t crc32(const uint8_t *data, size_t length, uint32_t crc)
+{
+  crc = ~crc;
+
+  // Four bytes per step, assembled bytewise so unaligned buffers are fine
+  while (length >= CRC32_SLICES)
+  {
+    crc ^= (uint32_t) data[0] | ((uint32_t) data[1] << 8) | ((uint32_t) data[2] << 16) |
+           ((uint32_t) data[3] << 24);
+    crc = crc32Table.entry[3][crc & 0xFF] ^ crc32Table.entry[2][(crc >> 8) & 0xFF] ^
+          crc32Table.entry[1][(crc >> 16) & 0xFF] ^ crc32Table.entry[0][crc >> 24];
+    data += CRC32_SLICES;
+    length -= CRC32_SLICES;
+  }
+  while (length-- > 0)
+  {
+    crc = (crc >> 8) ^ crc32Table.entry[0][(crc ^ *data++) & 0xFF];
+  }
+  return ~crc;
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,95 @@
+/**
+ * @file       checksum.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-08
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for Checksum library. Table-driven CRC8 (Sensirion), CRC16 (Modbus) and CRC32
+ * (IEEE 802.3, as zlib) shared by the sensor drivers, the Modbus master, OTA and storage.
+ *
+ * @note       The lookup tables are generated by constexpr functions at compile time and live in flash, no
+ *             table is built at boot. CRC32 processes four bytes per step (slice-by-4, 4 KB of tables),
+ *             CRC8 and CRC16 checksum frames of a few bytes and use one 256-entry table each.
+ *             Check values over the ASCII bytes "123456789": CRC8 0xF7, CRC16 0x4B37, CRC32 0xCBF43926.
+ * @example    uint8_t  sensirion = crc8(readBuffer, 2);
+ *             uint16_t modbus    = crc16Modbus(frame, length);
+ *             uint32_t image     = crc32(chunk, chunkLength, image); // Start from 0, chain chunk by chunk
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef CHECKSUM_H
+  #define CHECKSUM_H
+
+  /* Includes ----------------------------------------------------------- */
+  #include <stddef.h>
+  #include <stdint.h>
+
+  /* Public defines ----------------------------------------------------- */
+  #define CHECKSUM_CRC8_INIT         0xFF   // Sensirion: polynomial 0x31, no reflection, no final XOR
+  #define CHECKSUM_CRC16_MODBUS_INIT 0xFFFF // Modbus: polynomial 0xA001 reflected, no final XOR
+  #define CHECKSUM_CRC32_INIT        0x0    // IEEE 802.3: polynomial 0xEDB88320 reflected, final XOR inside
+
+/* Public enumerate/structure ----------------------------------------- */
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/* Public function prototypes ----------------------------------------- */
+
+/**
+ * @brief  Calculates the Sensirion CRC-8 (SHT3x, SHT4x, DHT20 words).
+ *
+ * The CRC-8 parameters are:
+ *   - Initialization value: 0xFF
+ *   - Polynomial: 0x31 (x⁸ + x⁵ + x⁴ + 1)
+ *   - No final XOR (0x00)
+ *
+ * Example from the SHT40 datasheet: For data bytes {0xBE, 0xEF}, the CRC result is 0x92.
+ *
+ * @param[in]     data  Pointer to the input data buffer.
+ * @param[in]     len   Length of the data buffer in bytes.
+ *
+ * @attention  Ensure that `data` points to a valid memory location of at least `len` bytes.
+ *             This function does not perform bounds checking.
+ *
+ * @return
+ *  - CRC-8 checksum as an 8-bit unsigned integer.
+ */
+uint8_t crc8(const uint8_t *data, int len);
+
+/**
+ * @brief  Calculates the Modbus RTU CRC16.
+ *
+ * @param[in]     data   Frame bytes
+ * @param[in]     length Number of bytes
+ * @param[in]     crc    Running value, `CHECKSUM_CRC16_MODBUS_INIT` for a new frame or the result of the
+ *                       previous call to continue a frame
+ *
+ * @return
+ *  - CRC, transmitted low byte first.
+ */
+uint16_t crc16Modbus(const uint8_t *data, size_t length, uint16_t crc = CHECKSUM_CRC16_MODBUS_INIT);
+
+/**
+ * @brief  Calculates the CRC32 used by zlib, PNG and Ethernet, four bytes per table step.
+ *
+ * @param[in]     data   Data bytes
+ * @param[in]     length Number of bytes
+ * @param[in]     crc    `CHECKSUM_CRC32_INIT` for new data or the result of the previous call, so an OTA
+ *                       image or a log record can be checked chunk by chunk
+ *
+ * @attention  The pre and post inversion are applied on every call, the chained result equals the CRC of
+ *             the whole data, e.g. `crc32(b, nb, crc32(a, na))` is the CRC of `a` followed by `b`.
+ *
+ * @return
+ *  - CRC32 of the data.
+ */
+uint32_t crc32(const uint8_t *data, size_t length, uint32_t crc = CHECKSUM_CRC32_INIT);
+
+#endif // CHECKSUM_H
+
+/* End of file -------------------------------------------------------- */
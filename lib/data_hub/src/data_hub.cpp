@@ -0,0 +1,158 @@
+/**
+ * @file       data_hub.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-10
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the sensor data hub
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "data_hub.h"
+
+/* Private defines ---------------------------------------------------- */
+
+/* Private enumerate/structure ---------------------------------------- */
+// History ring of one channel, no storage at all when its depth is 0
+template <uint16_t DEPTH>
+struct ChannelHistory
+{
+  SampleRingBuffer<DEPTH> ring;
+
+  SampleRing *get() { return &ring; }
+};
+
+template <>
+struct ChannelHistory<0>
+{
+  SampleRing *get() { return NULL; }
+};
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+DataHub dataHub;
+
+/* Private variables -------------------------------------------------- */
+static ChannelHistory<DATA_HUB_HISTORY_TEMPERATURE>   temperatureHistory;
+static ChannelHistory<DATA_HUB_HISTORY_HUMIDITY>      humidityHistory;
+static ChannelHistory<DATA_HUB_HISTORY_PRESSURE>      pressureHistory;
+static ChannelHistory<DATA_HUB_HISTORY_ALTITUDE>      altitudeHistory;
+static ChannelHistory<DATA_HUB_HISTORY_LIGHT>         lightHistory;
+static ChannelHistory<DATA_HUB_HISTORY_MOTION>        motionHistory;
+static ChannelHistory<DATA_HUB_HISTORY_DISTANCE>      distanceHistory;
+static ChannelHistory<DATA_HUB_HISTORY_SOIL_MOISTURE> soilMoistureHistory;
+static ChannelHistory<DATA_HUB_HISTORY_SOIL_PERCENT>  soilMoisturePercentHistory;
+static ChannelHistory<DATA_HUB_HISTORY_AC>            acVoltageHistory;
+static ChannelHistory<DATA_HUB_HISTORY_AC>            acCurrentHistory;
+static ChannelHistory<DATA_HUB_HISTORY_AC>            acPowerHistory;
+static ChannelHistory<DATA_HUB_HISTORY_AC>            acPowerFactorHistory;
+
+// Indexed by channel, NULL for the channels without history
+static SampleRing *const channelHistory[DATA_HUB_CHANNEL_COUNT] = {
+  temperatureHistory.get(), humidityHistory.get(),     pressureHistory.get(),     altitudeHistory.get(),
+  lightHistory.get(),       motionHistory.get(),       distanceHistory.get(),     soilMoistureHistory.get(),
+  soilMoisturePercentHistory.get(),                    acVoltageHistory.get(),    acCurrentHistory.get(),
+  acPowerHistory.get(),     acPowerFactorHistory.get()};
+
+static_assert(DATA_HUB_CHANNEL_COUNT <= WINDOW_AGG_MAX_CHANNELS, "Data hub channels exceed the window count");
+
+/* Class method definitions-------------------------------------------- */
+data_hub_error_t DataHub::publish(data_hub_channel_t channel, float value)
+{
+  if ((unsigned) channel >= DATA_HUB_CHANNEL_COUNT)
+  {
+    return DATA_HUB_ERR;
+  }
+
+  uint32_t now = millis();
+
+  write(&_slots[channel], &value, now, DATA_HUB_QUALITY_GOOD);
+  if (channelHistory[channel] != NULL)
+  {
+    channelHistory[channel]->push(now, value);
+  }
+  _windows.add(channel, value);
+  return DATA_HUB_OK;
+}
+
+data_hub_error_t DataHub::publishError(data_hub_channel_t channel)
+{
+  if ((unsigned) channel >= DATA_HUB_CHANNEL_COUNT)
+  {
+    return DATA_HUB_ERR;
+  }
+
+  write(&_slots[channel], NULL, 0, DATA_HUB_QUALITY_ERROR);
+  return DATA_HUB_OK;
+}
+
+data_hub_error_t DataHub::read(data_hub_channel_t channel, data_hub_sample_t *sample)
+{
+  if ((unsigned) channel >= DATA_HUB_CHANNEL_COUNT || sample == NULL)
+  {
+    return DATA_HUB_ERR;
+  }
+
+  const slot_t *slot = &_slots[channel];
+  uint32_t      before;
+  uint32_t      after;
+  do
+  {
+    // Wait out a write in progress, the writer cannot be preempted so this is a few stores long
+    while ((before = slot->sequence.load(std::memory_order_acquire)) & 1)
+    {
+    }
+    sample->value       = slot->value;
+    sample->timestampMs = slot->timestampMs;
+    sample->quality     = slot->quality;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = slot->sequence.load(std::memory_order_relaxed);
+  } while (before != after);
+
+  sample->version = before >> 1;
+  return (sample->quality == DATA_HUB_QUALITY_NONE) ? DATA_HUB_ERR_NO_DATA : DATA_HUB_OK;
+}
+
+bool DataHub::isFresh(const data_hub_sample_t *sample, uint32_t maxAgeMs)
+{
+  return sample->quality == DATA_HUB_QUALITY_GOOD && millis() - sample->timestampMs <= maxAgeMs;
+}
+
+const SampleRing *DataHub::history(data_hub_channel_t channel)
+{
+  return ((unsigned) channel < DATA_HUB_CHANNEL_COUNT) ? channelHistory[channel] : NULL;
+}
+
+data_hub_error_t DataHub::takeWindow(data_hub_channel_t channel, window_agg_t *window)
+{
+  if ((unsigned) channel >= DATA_HUB_CHANNEL_COUNT || window == NULL)
+  {
+    return DATA_HUB_ERR;
+  }
+
+  return (_windows.take(channel, window) == WINDOW_AGG_OK) ? DATA_HUB_OK : DATA_HUB_ERR_NO_DATA;
+}
+
+void DataHub::write(slot_t *slot, const float *value, uint32_t timestampMs, data_hub_quality_t quality)
+{
+  uint32_t sequence = slot->sequence.load(std::memory_order_relaxed);
+
+  vTaskSuspendAll();
+  slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  if (value != NULL)
+  {
+    slot->value       = *value;
+    slot->timestampMs = timestampMs;
+  }
+  slot->quality = quality;
+  slot->sequence.store(sequence + 2, std::memory_order_release);
+  xTaskResumeAll();
+}
+
+/* Private function prototypes ---------------------------------------- */
+
+/* End of file -------------------------------------------------------- */
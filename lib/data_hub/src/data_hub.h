@@ -0,0 +1,214 @@
+/**
+ * @file       data_hub.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-10
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the sensor data hub
+ *
+ * @note       The sampling jobs publish every measurement (value, timestamp, quality) into a channel slot.
+ *             Telemetry, the LCD and the automation rules read snapshots of those slots instead of calling
+ *             the drivers, so a consumer never starts a bus transfer and never sees a half-updated value.
+ *             Each slot is a seqlock: the single writer bumps a sequence counter around the update, readers
+ *             copy the slot and retry when the counter moved. Reads take no lock and never block the writer.
+ *             Every good sample is also folded into the channel window, the min/max/mean/last the telemetry
+ *             sends for the interval since its last send, and appended to the channel history, a `SampleRing`
+ *             kept only for the channels that enable one.
+ * @example    `dataHub.publish(DATA_HUB_TEMPERATURE, sht40.getTemperature());`
+ *             `if (dataHub.read(DATA_HUB_TEMPERATURE, &sample) == DATA_HUB_OK) { ... sample.value ... }`
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef DATA_HUB_H
+  #define DATA_HUB_H
+
+  /* Includes ----------------------------------------------------------- */
+  #if ARDUINO >= 100
+    #include "Arduino.h"
+  #else
+    #include "WProgram.h"
+  #endif
+
+  #include "sample_ring.h"
+  #include "window_agg.h"
+  #include <atomic>
+
+  /* Public defines ----------------------------------------------------- */
+  // History depth of every channel in samples, a power of two, 0 keeps no history. The storage task reads
+  // it once, to log the samples taken before the clock was set, so only the channels it logs at a useful
+  // resolution keep one. 8 bytes per sample.
+  #ifndef DATA_HUB_HISTORY_TEMPERATURE
+    #define DATA_HUB_HISTORY_TEMPERATURE    64 // 32 min at 30 s
+  #endif
+  #ifndef DATA_HUB_HISTORY_HUMIDITY
+    #define DATA_HUB_HISTORY_HUMIDITY       64
+  #endif
+  #ifndef DATA_HUB_HISTORY_PRESSURE
+    #define DATA_HUB_HISTORY_PRESSURE       64
+  #endif
+  #ifndef DATA_HUB_HISTORY_ALTITUDE
+    #define DATA_HUB_HISTORY_ALTITUDE       0 // Follows from the pressure
+  #endif
+  #ifndef DATA_HUB_HISTORY_LIGHT
+    #define DATA_HUB_HISTORY_LIGHT          0 // 2 s samples, the log keeps one a minute
+  #endif
+  #ifndef DATA_HUB_HISTORY_MOTION
+    #define DATA_HUB_HISTORY_MOTION         0
+  #endif
+  #ifndef DATA_HUB_HISTORY_DISTANCE
+    #define DATA_HUB_HISTORY_DISTANCE       0
+  #endif
+  #ifndef DATA_HUB_HISTORY_SOIL_MOISTURE
+    #define DATA_HUB_HISTORY_SOIL_MOISTURE  32 // 32 min at 60 s
+  #endif
+  #ifndef DATA_HUB_HISTORY_SOIL_PERCENT
+    #define DATA_HUB_HISTORY_SOIL_PERCENT   0 // Follows from the raw moisture
+  #endif
+  #ifndef DATA_HUB_HISTORY_AC
+    #define DATA_HUB_HISTORY_AC             0 // Voltage, current, power, power factor: 2 s samples
+  #endif
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef enum
+{
+  DATA_HUB_OK = 0,     /* No error */
+  DATA_HUB_ERR,        /* Generic error */
+  DATA_HUB_ERR_NO_DATA /* Nothing published on the channel yet */
+} data_hub_error_t;
+
+// One channel per measured quantity, whichever driver provides it
+typedef enum
+{
+  DATA_HUB_TEMPERATURE = 0,       /**< °C, SHT4x or DHT20 */
+  DATA_HUB_HUMIDITY,              /**< %RH, SHT4x or DHT20 */
+  DATA_HUB_PRESSURE,              /**< BMP280 */
+  DATA_HUB_ALTITUDE,              /**< m, BMP280 */
+  DATA_HUB_LIGHT,                 /**< %, light sensor */
+  DATA_HUB_MOTION,                /**< 1 when the PIR sensor reports motion */
+  DATA_HUB_DISTANCE,              /**< cm, ultrasonic sensor */
+  DATA_HUB_SOIL_MOISTURE,         /**< Raw ADC value, soil moisture sensor */
+  DATA_HUB_SOIL_MOISTURE_PERCENT, /**< %, soil moisture sensor */
+  DATA_HUB_AC_VOLTAGE,            /**< V, AC measure unit */
+  DATA_HUB_AC_CURRENT,            /**< A, AC measure unit */
+  DATA_HUB_AC_POWER,              /**< W, AC measure unit */
+  DATA_HUB_AC_POWER_FACTOR        /**< 0 to 1, AC measure unit */
+} data_hub_channel_t;
+
+  #define DATA_HUB_CHANNEL_COUNT (DATA_HUB_AC_POWER_FACTOR + 1)
+
+typedef enum
+{
+  DATA_HUB_QUALITY_NONE = 0, /**< Nothing published yet */
+  DATA_HUB_QUALITY_GOOD,     /**< Value from the last read */
+  DATA_HUB_QUALITY_ERROR     /**< Last read failed, value and timestamp are from the last good read */
+} data_hub_quality_t;
+
+typedef struct
+{
+  float              value;       /**< Measurement */
+  uint32_t           timestampMs; /**< `millis()` when the value was read */
+  data_hub_quality_t quality;     /**< State of the last read */
+  uint32_t           version;     /**< Incremented by every publish, tells a new sample from a re-read */
+} data_hub_sample_t;
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/**
+ * @brief Latest sample of every sensor channel, written by one producer and read lock-free by any task.
+ */
+class DataHub
+{
+public:
+  /**
+   * @brief  Publishes a new good sample, timestamped now.
+   *
+   * @param[in]     channel Channel to update
+   * @param[in]     value   Measurement
+   *
+   * @attention  One writer per channel. The write runs with the scheduler of the calling core suspended,
+   *             so a reader on that core can never spin on a writer it preempted.
+   *
+   * @return
+   *  - `DATA_HUB_OK` : Success
+   *  - `DATA_HUB_ERR`: Invalid channel
+   */
+  data_hub_error_t publish(data_hub_channel_t channel, float value);
+
+  /**
+   * @brief  Marks the last read of a channel as failed, keeping the last good value and its timestamp.
+   *
+   * @param[in]     channel Channel to update
+   *
+   * @return
+   *  - `DATA_HUB_OK` : Success
+   *  - `DATA_HUB_ERR`: Invalid channel
+   */
+  data_hub_error_t publishError(data_hub_channel_t channel);
+
+  /**
+   * @brief  Copies a consistent snapshot of a channel.
+   *
+   * @param[in]     channel Channel to read
+   * @param[out]    sample  Snapshot
+   *
+   * @return
+   *  - `DATA_HUB_OK`         : Snapshot copied, check `sample->quality`
+   *  - `DATA_HUB_ERR`        : Invalid channel or `NULL` sample
+   *  - `DATA_HUB_ERR_NO_DATA`: Nothing published yet
+   */
+  data_hub_error_t read(data_hub_channel_t channel, data_hub_sample_t *sample);
+
+  /**
+   * @brief  Tells whether a sample is good and not older than `maxAgeMs`.
+   */
+  static bool isFresh(const data_hub_sample_t *sample, uint32_t maxAgeMs);
+
+  /**
+   * @brief  Returns the recent good samples of a channel, or `NULL` for an invalid channel or a channel
+   *         whose `DATA_HUB_HISTORY_*` depth is 0.
+   *
+   * @attention  Read through `view()` and check with `trim()`, the sampling job keeps pushing meanwhile.
+   */
+  const SampleRing *history(data_hub_channel_t channel);
+
+  /**
+   * @brief  Copies the min/max/mean/last of the good samples published since the last call, and starts a
+   *         new window.
+   *
+   * @param[in]     channel Channel to read
+   * @param[out]    window  Aggregate of the window
+   *
+   * @attention  One consumer, the telemetry task: a call ends the window for every reader.
+   *
+   * @return
+   *  - `DATA_HUB_OK`         : Window copied
+   *  - `DATA_HUB_ERR`        : Invalid channel or `NULL` window
+   *  - `DATA_HUB_ERR_NO_DATA`: No good sample since the last call
+   */
+  data_hub_error_t takeWindow(data_hub_channel_t channel, window_agg_t *window);
+
+private:
+  typedef struct
+  {
+    std::atomic<uint32_t> sequence; // Odd while the writer updates the slot
+    float                 value;
+    uint32_t              timestampMs;
+    data_hub_quality_t    quality;
+  } slot_t;
+
+  slot_t           _slots[DATA_HUB_CHANNEL_COUNT] = {};
+  WindowAggregator _windows;
+
+  void write(slot_t *slot, const float *value, uint32_t timestampMs, data_hub_quality_t quality);
+};
+
+extern DataHub dataHub;
+
+#endif // DATA_HUB_H
+
+/* End of file -------------------------------------------------------- */
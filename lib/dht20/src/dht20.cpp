@@ -29,8 +29,9 @@
 // Constructor
 DHT20::DHT20() {}
 
-dht20_error_t DHT20::begin()
+dht20_error_t DHT20::begin(bsp_i2c_bus_t bus)
 {
+  _bus = bus;
   DELAY(100); // Wait 100ms after power-on
   reset();
   return DHT20_OK;
@@ -63,19 +64,19 @@ bool DHT20::_resetRegister(uint8_t reg)
 {
   uint8_t values[3]    = {0};
   uint8_t resetParam[] = {0x00, 0x00};
-  if (bspI2CWriteBytes(DHT20_I2C_ADDR, reg, resetParam, sizeof(resetParam)) != BSP_I2C_OK)
+  if (bspI2CWriteBytes(_bus, DHT20_I2C_ADDR, reg, resetParam, sizeof(resetParam)) != BSP_I2C_OK)
   {
     return false;
   }
 
   DELAY(5);
 
-  bspI2CReadBytes(DHT20_I2C_ADDR, values, sizeof(values));
+  bspI2CReadBytes(_bus, DHT20_I2C_ADDR, values, sizeof(values));
 
   DELAY(10);
 
   uint8_t retVal[2] = {values[1], values[2]};
-  bspI2CWriteBytes(DHT20_I2C_ADDR, (0xB0 | reg), retVal, sizeof(retVal));
+  bspI2CWriteBytes(_bus, DHT20_I2C_ADDR, (0xB0 | reg), retVal, sizeof(retVal));
 
   DELAY(5);
 
@@ -88,7 +89,7 @@ int DHT20::readStatus(void)
   bsp_i2c_error_t returnVal;
   uint8_t         status = 0;
 
-  returnVal = bspI2CReadByte(DHT20_I2C_ADDR, 0x71, status);
+  returnVal = bspI2CReadByte(_bus, DHT20_I2C_ADDR, 0x71, status);
   if (returnVal == BSP_I2C_ERR_READ)
   {
 #ifdef DEBUG_PRINT
@@ -111,7 +112,7 @@ dht20_error_t DHT20::readTargetData(uint32_t *data)
   uint8_t configParams[] = {0x33, 0x00}; // Command to start measurement
 
   // Send the measurement command
-  if (bspI2CWriteBytes(DHT20_I2C_ADDR, 0xAC, configParams, sizeof(configParams)) != BSP_I2C_OK)
+  if (bspI2CWriteBytes(_bus, DHT20_I2C_ADDR, 0xAC, configParams, sizeof(configParams)) != BSP_I2C_OK)
   {
     return DHT20_ERR_I2C_WRITE; // Write failed
   }
@@ -121,7 +122,7 @@ dht20_error_t DHT20::readTargetData(uint32_t *data)
 
   // Read 6 bytes from the sensor
 
-  if (bspI2CReadBytes(DHT20_I2C_ADDR, bytes, sizeof(bytes)) != BSP_I2C_OK)
+  if (bspI2CReadBytes(_bus, DHT20_I2C_ADDR, bytes, sizeof(bytes)) != BSP_I2C_OK)
   {
     return DHT20_ERR_I2C_READ; // Read failed
   }
@@ -151,7 +152,7 @@ dht20_error_t DHT20::readTempAndHumidity()
   uint32_t cnt           = 0;
   while (readStatus() == 0)
   {
-    begin();
+    begin(_bus);
     DELAY(30);
 
     cnt++;
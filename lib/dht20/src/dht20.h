@@ -19,6 +19,7 @@
   #else
     #include "WProgram.h"
   #endif
+  #include "bsp_i2c.h"
 
   /* Public defines ----------------------------------------------------- */
   #define DHT20_LIB_VERSION       (F("0.1.0"))
@@ -91,7 +92,7 @@ public:
    * @return
    *  - `DHT20_OK`: Initialization success.
    */
-  dht20_error_t begin();
+  dht20_error_t begin(bsp_i2c_bus_t bus = BSP_I2C_BUS_0);
 
   /**
    * @brief  Reads temperature and humidity data from the DHT20 sensor.
@@ -134,7 +135,8 @@ public:
   float getTemperature();
 
 private:
-  float sensorValue[2];
+  float         sensorValue[2];
+  bsp_i2c_bus_t _bus = BSP_I2C_BUS_0;
 
   /**
    * @brief  Reads temperature and humidity data from the DHT20 sensor.
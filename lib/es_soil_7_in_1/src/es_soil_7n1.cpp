@@ -11,47 +11,53 @@
 
 /* Includes ----------------------------------------------------------- */
 #include "es_soil_7n1.h"
-#include "bsp_rs485.h"
 #include "config.h"
 /* Private defines ---------------------------------------------------- */
 
 /* Private enumerate/structure ---------------------------------------- */
+// Ways to cover the seven values, from one request down to one request per value
+typedef struct
+{
+  const bsp_modbus_range_t *ranges;
+  uint8_t                   count;
+} es_soil_plan_t;
 
 /* Private macros ----------------------------------------------------- */
 
 /* Public variables --------------------------------------------------- */
 
 /* Private variables -------------------------------------------------- */
+static const bsp_modbus_range_t spanRanges[]  = {{ES_SOIL_FIRST_REG, ES_SOIL_SPAN_LENGTH}};
+static const bsp_modbus_range_t groupRanges[] = {
+{ES_SOIL_PH_REG, 1}, {ES_SOIL_MOISTURE_REG, 4}, {ES_SOIL_NITROGEN_REG, 3}};
+static const bsp_modbus_range_t valueRanges[] = {
+{ES_SOIL_PH_REG, 1}, {ES_SOIL_MOISTURE_REG, 2}, {ES_SOIL_CONDUCTIVITY_REG, 1}, {ES_SOIL_NITROGEN_REG, 3}};
+
+static const es_soil_plan_t readPlans[] = {
+{spanRanges, sizeof(spanRanges) / sizeof(spanRanges[0])},
+{groupRanges, sizeof(groupRanges) / sizeof(groupRanges[0])},
+{valueRanges, sizeof(valueRanges) / sizeof(valueRanges[0])}};
+static const uint8_t readPlanCount = sizeof(readPlans) / sizeof(readPlans[0]);
 
 /* Class method definitions-------------------------------------------- */
+void EsSoil7n1::begin(uint8_t slaveId, BspModbusMaster &master)
+{
+  this->slaveId = slaveId;
+  this->master  = &master;
+  readPlan      = 0;
+}
 
 es_soil_7n1_error_t EsSoil7n1::readSoilPh()
 {
-  byte command[8] = {ES_SOIL_SLAVE_ID, 0x03, 0x00, 0x06, 0x00, 0x01, 0x64, 0x0B}; // Reading pH
-  byte response[7];
-
-  rs485Serial1.sendModbusCommand(command, sizeof(command), response, sizeof(response));
-
-#ifdef DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-  Serial.print("Raw response SoilPh: ");
-  for (int i = 0; i < 7; i++)
-  {
-    Serial.print(response[i], HEX);
-    Serial.print(" ");
-  }
-#endif // DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
+  uint16_t rawPh;
 
-  if (response[0] != ES_SOIL_SLAVE_ID || response[1] != 0x03 || response[2] != 0x02)
+  es_soil_7n1_error_t result = readRegisters(ES_SOIL_PH_REG, 1, &rawPh, "SoilPh");
+  if (result != ES_SOIL_7N1_OK)
   {
-#ifdef DEBUG_PRINT
-    Serial.println("Error: Invalid response format");
-#endif // DEBUG_PRINT
-
-    return ES_SOIL_7N1_ERR;
+    return result;
   }
 
   // Extract pH
-  uint16_t rawPh  = (response[3] << 8) | response[4];
   sensorValues[0] = rawPh * 0.01;
 
   return ES_SOIL_7N1_OK;
@@ -59,269 +65,201 @@ es_soil_7n1_error_t EsSoil7n1::readSoilPh()
 
 es_soil_7n1_error_t EsSoil7n1::readSoilMoisture()
 {
-  byte command[8] = {ES_SOIL_SLAVE_ID, 0x03, 0x00, 0x12, 0x00, 0x01, 0x24, 0x0F}; // Reading Moisture
-  byte response[7];
-
-  rs485Serial1.sendModbusCommand(command, sizeof(command), response, sizeof(response));
+  uint16_t rawMoisture;
 
-#ifdef DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-  Serial.print("Raw response SoilMoisture: ");
-  for (int i = 0; i < 7; i++)
+  es_soil_7n1_error_t result = readRegisters(ES_SOIL_MOISTURE_REG, 1, &rawMoisture, "SoilMoisture");
+  if (result != ES_SOIL_7N1_OK)
   {
-    Serial.print(response[i], HEX);
-    Serial.print(" ");
-  }
-#endif // DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-
-  if (response[0] != ES_SOIL_SLAVE_ID || response[1] != 0x03 || response[2] != 0x02)
-  {
-#ifdef DEBUG_PRINT
-    Serial.println("Error: Invalid response format");
-#endif // DEBUG_PRINT
-
-    return ES_SOIL_7N1_ERR;
+    return result;
   }
 
   // Extract moisture
-  uint16_t rawMoisture = (response[3] << 8) | response[4];
-  sensorValues[1]      = rawMoisture * 0.1;
+  sensorValues[1] = rawMoisture * 0.1;
 
   return ES_SOIL_7N1_OK;
 }
 
 es_soil_7n1_error_t EsSoil7n1::readSoilTemperature()
 {
-  byte command[8] = {ES_SOIL_SLAVE_ID, 0x03, 0x00, 0x13, 0x00, 0x01, 0x75, 0xCF}; // Reading Temperature
-  byte response[7];
-
-  rs485Serial1.sendModbusCommand(command, sizeof(command), response, sizeof(response));
+  uint16_t rawTemperature;
 
-#ifdef DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-  Serial.print("Raw response SoilTemperature: ");
-  for (int i = 0; i < 7; i++)
+  es_soil_7n1_error_t result = readRegisters(ES_SOIL_TEMPERATURE_REG, 1, &rawTemperature, "SoilTemperature");
+  if (result != ES_SOIL_7N1_OK)
   {
-    Serial.print(response[i], HEX);
-    Serial.print(" ");
-  }
-#endif // DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-
-  if (response[0] != ES_SOIL_SLAVE_ID || response[1] != 0x03 || response[2] != 0x02)
-  {
-#ifdef DEBUG_PRINT
-    Serial.println("Error: Invalid response format");
-#endif // DEBUG_PRINT
-
-    return ES_SOIL_7N1_ERR;
+    return result;
   }
 
   // Extract temperature
-  uint16_t rawTemperature = (response[3] << 8) | response[4];
-  sensorValues[2]         = rawTemperature * 0.1;
+  sensorValues[2] = rawTemperature * 0.1;
 
   return ES_SOIL_7N1_OK;
 }
 
 es_soil_7n1_error_t EsSoil7n1::readSoilConductivity()
 {
-  byte command[8] = {ES_SOIL_SLAVE_ID, 0x03, 0x00, 0x15, 0x00, 0x01, 0x95, 0xCE}; // Reading Conductivity
-  byte response[7];
-
-  rs485Serial1.sendModbusCommand(command, sizeof(command), response, sizeof(response));
-
-#ifdef DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-  Serial.print("Raw response SoilConductivity: ");
-  for (int i = 0; i < 7; i++)
-  {
-    Serial.print(response[i], HEX);
-    Serial.print(" ");
-  }
-#endif // DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
+  uint16_t rawConductivity;
 
-  if (response[0] != ES_SOIL_SLAVE_ID || response[1] != 0x03 || response[2] != 0x02)
+  es_soil_7n1_error_t result =
+  readRegisters(ES_SOIL_CONDUCTIVITY_REG, 1, &rawConductivity, "SoilConductivity");
+  if (result != ES_SOIL_7N1_OK)
   {
-#ifdef DEBUG_PRINT
-    Serial.println("Error: Invalid response format");
-#endif // DEBUG_PRINT
-
-    return ES_SOIL_7N1_ERR;
+    return result;
   }
 
   // Extract conductivity
-  uint16_t rawConductivity = (response[3] << 8) | response[4];
-  sensorValues[3]          = rawConductivity;
+  sensorValues[3] = rawConductivity;
 
   return ES_SOIL_7N1_OK;
 }
 
 es_soil_7n1_error_t EsSoil7n1::readSoilNitrogen()
 {
-  byte command[8] = {ES_SOIL_SLAVE_ID, 0x03, 0x00, 0x1e, 0x00, 0x01, 0xE4, 0x0C}; // Reading Nitrogen
-  byte response[7];
+  uint16_t rawNitrogen;
 
-  rs485Serial1.sendModbusCommand(command, sizeof(command), response, sizeof(response));
-
-#ifdef DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-  Serial.print("Raw response SoilNitrogen: ");
-  for (int i = 0; i < 7; i++)
+  es_soil_7n1_error_t result = readRegisters(ES_SOIL_NITROGEN_REG, 1, &rawNitrogen, "SoilNitrogen");
+  if (result != ES_SOIL_7N1_OK)
   {
-    Serial.print(response[i], HEX);
-    Serial.print(" ");
-  }
-#endif // DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-
-  if (response[0] != ES_SOIL_SLAVE_ID || response[1] != 0x03 || response[2] != 0x02)
-  {
-#ifdef DEBUG_PRINT
-    Serial.println("Error: Invalid response format");
-#endif // DEBUG_PRINT
-
-    return ES_SOIL_7N1_ERR;
+    return result;
   }
 
   // Extract nitrogen
-  uint16_t rawNitrogen = (response[3] << 8) | response[4];
-  sensorValues[4]      = rawNitrogen;
+  sensorValues[4] = rawNitrogen;
 
   return ES_SOIL_7N1_OK;
 }
 
 es_soil_7n1_error_t EsSoil7n1::readSoilPhosphorus()
 {
-  byte command[8] = {ES_SOIL_SLAVE_ID, 0x03, 0x00, 0x1f, 0x00, 0x01, 0xB5, 0xCC}; // Reading Phosphorus
-  byte response[7];
+  uint16_t rawPhosphorus;
 
-  rs485Serial1.sendModbusCommand(command, sizeof(command), response, sizeof(response));
-
-#ifdef DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-  Serial.print("Raw response SoilPhosphorus: ");
-  for (int i = 0; i < 7; i++)
+  es_soil_7n1_error_t result = readRegisters(ES_SOIL_PHOSPHORUS_REG, 1, &rawPhosphorus, "SoilPhosphorus");
+  if (result != ES_SOIL_7N1_OK)
   {
-    Serial.print(response[i], HEX);
-    Serial.print(" ");
-  }
-#endif // DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-
-  if (response[0] != ES_SOIL_SLAVE_ID || response[1] != 0x03 || response[2] != 0x02)
-  {
-#ifdef DEBUG_PRINT
-    Serial.println("Error: Invalid response format");
-#endif // DEBUG_PRINT
-
-    return ES_SOIL_7N1_ERR;
+    return result;
   }
 
   // Extract phosphorus
-  uint16_t rawPhosphorus = (response[3] << 8) | response[4];
-  sensorValues[5]        = rawPhosphorus;
+  sensorValues[5] = rawPhosphorus;
 
   return ES_SOIL_7N1_OK;
 }
 
 es_soil_7n1_error_t EsSoil7n1::readSoilPotassium()
 {
-  byte command[8] = {ES_SOIL_SLAVE_ID, 0x03, 0x00, 0x20, 0x00, 0x01, 0x85, 0xC0}; // Reading Potassium
-  byte response[7];
-
-  rs485Serial1.sendModbusCommand(command, sizeof(command), response, sizeof(response));
-
-#ifdef DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-  Serial.print("Raw response SoilPotassium: ");
-  for (int i = 0; i < 7; i++)
-  {
-    Serial.print(response[i], HEX);
-    Serial.print(" ");
-  }
-#endif // DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
+  uint16_t rawPotassium;
 
-  if (response[0] != ES_SOIL_SLAVE_ID || response[1] != 0x03 || response[2] != 0x02)
+  es_soil_7n1_error_t result = readRegisters(ES_SOIL_POTASSIUM_REG, 1, &rawPotassium, "SoilPotassium");
+  if (result != ES_SOIL_7N1_OK)
   {
-#ifdef DEBUG_PRINT
-    Serial.println("Error: Invalid response format");
-#endif // DEBUG_PRINT
-
-    return ES_SOIL_7N1_ERR;
+    return result;
   }
 
   // Extract potassium
-  uint16_t rawPotassium = (response[3] << 8) | response[4];
-  sensorValues[6]       = rawPotassium;
+  sensorValues[6] = rawPotassium;
 
   return ES_SOIL_7N1_OK;
 }
 
 es_soil_7n1_error_t EsSoil7n1::readSoilTempAndMoisture()
 {
-  byte command[8] = {
-  ES_SOIL_SLAVE_ID, 0x03, 0x00, 0x12, 0x00, 0x02, 0x64, 0x0E}; // Reading Temperature and Moisture
-  byte response[9];
-
-  rs485Serial1.sendModbusCommand(command, sizeof(command), response, sizeof(response));
+  uint16_t raw[2];
 
-#ifdef DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-  Serial.print("Raw response SoilTempAndMoisture: ");
-  for (int i = 0; i < 9; i++)
+  // Moisture (0x12) then temperature (0x13)
+  es_soil_7n1_error_t result = readRegisters(ES_SOIL_MOISTURE_REG, 2, raw, "SoilTempAndMoisture");
+  if (result != ES_SOIL_7N1_OK)
   {
-    Serial.print(response[i], HEX);
-    Serial.print(" ");
+    return result;
   }
-#endif // DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
 
-  // Verify the response format
-  if (response[0] != ES_SOIL_SLAVE_ID || response[1] != 0x03 || response[2] != 0x04)
-  {
-#ifdef DEBUG_PRINT
-    Serial.println("Error: Invalid response format");
-#endif // DEBUG_PRINT
+  // Convert to physical units
+  sensorValues[1] = raw[0] * 0.1; // Unit: 0.1% RH, e.g. 01F4H = 500 -> 50.0% RH
+  sensorValues[2] = raw[1] * 0.1; // Unit: 0.1°C, e.g. 00C8H = 200 -> 20.0°C
 
-    return ES_SOIL_7N1_ERR;
-  }
+  return ES_SOIL_7N1_OK;
+}
 
-  // Extract moisture and temperature (high byte first)
-  uint16_t soilHumidityRaw    = (response[3] << 8) | response[4]; // e.g., 01F4H = 500
-  uint16_t soilTemperatureRaw = (response[5] << 8) | response[6]; // e.g., 00C8H = 200
+es_soil_7n1_error_t EsSoil7n1::readSoilNPK()
+{
+  uint16_t raw[3];
+
+  // Nitrogen (0x1E), phosphorus (0x1F) then potassium (0x20)
+  es_soil_7n1_error_t result = readRegisters(ES_SOIL_NITROGEN_REG, 3, raw, "SoilNPK");
+  if (result != ES_SOIL_7N1_OK)
+  {
+    return result;
+  }
 
   // Convert to physical units
-  sensorValues[1] = soilHumidityRaw * 0.1;    // Unit: 0.1% RH → 50.0% RH
-  sensorValues[2] = soilTemperatureRaw * 0.1; // Unit: 0.1°C → 20.0°C
+  sensorValues[4] = raw[0]; // Unit: mg/kg, e.g. 0020H = 32 mg/kg
+  sensorValues[5] = raw[1]; // Unit: mg/kg, e.g. 0025H = 37 mg/kg
+  sensorValues[6] = raw[2]; // Unit: mg/kg, e.g. 0030H = 48 mg/kg
 
   return ES_SOIL_7N1_OK;
 }
 
-es_soil_7n1_error_t EsSoil7n1::readSoilNPK()
+es_soil_7n1_error_t EsSoil7n1::readAll()
 {
-  byte command[8] = {ES_SOIL_SLAVE_ID, 0x03, 0x00, 0x1E, 0x00, 0x03, 0x65, 0xCD}; // Reading N-P-K
-  byte response[11];
+  uint16_t            regs[ES_SOIL_SPAN_LENGTH];
+  es_soil_7n1_error_t result = ES_SOIL_7N1_OK;
 
-  rs485Serial1.sendModbusCommand(command, sizeof(command), response, sizeof(response));
+  while (readPlan < readPlanCount)
+  {
+    const es_soil_plan_t *plan = &readPlans[readPlan];
+
+    for (uint8_t i = 0; i < plan->count && result == ES_SOIL_7N1_OK; i++)
+    {
+      const bsp_modbus_range_t *range = &plan->ranges[i];
+      result = readRegisters(range->address, range->count, &regs[range->address - ES_SOIL_FIRST_REG],
+                             "SoilAll");
+    }
+
+    // Only a rejected request means the plan does not fit this sensor, anything else is a bus error
+    if (result == ES_SOIL_7N1_OK || master->lastException() == BSP_MODBUS_EXCEPTION_NONE ||
+        readPlan + 1 >= readPlanCount)
+    {
+      break;
+    }
+    readPlan++;
+    result = ES_SOIL_7N1_OK;
+  }
 
-#ifdef DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
-  Serial.print("Raw response SoilNPK: ");
-  for (int i = 0; i < 11; i++)
+  if (result != ES_SOIL_7N1_OK)
   {
-    Serial.print(response[i], HEX);
-    Serial.print(" ");
+    return result;
   }
-#endif // DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
 
-  // Verify the response format
-  if (response[0] != ES_SOIL_SLAVE_ID || response[1] != 0x03 || response[2] != 0x06)
+  return decodeSpan(regs);
+}
+
+uint8_t EsSoil7n1::nextReadPlan(bsp_modbus_range_t *ranges)
+{
+  if (ranges == NULL || readPlan + 1 >= readPlanCount)
   {
-#ifdef DEBUG_PRINT
-    Serial.println("Error: Invalid response format");
-#endif // DEBUG_PRINT
+    return 0;
+  }
+
+  const es_soil_plan_t *plan = &readPlans[++readPlan];
+  memcpy(ranges, plan->ranges, plan->count * sizeof(plan->ranges[0]));
 
+  return plan->count;
+}
+
+es_soil_7n1_error_t EsSoil7n1::decodeSpan(const uint16_t *regs)
+{
+  if (regs == NULL)
+  {
     return ES_SOIL_7N1_ERR;
   }
 
-  // Extract nitrogen, phosphorus and potassium (high byte first)
-  uint16_t soilNitrogenRaw   = (response[3] << 8) | response[4]; // e.g., 0020H = 32
-  uint16_t soilPhosphorusRaw = (response[5] << 8) | response[6]; // e.g., 0025H = 37
-  uint16_t soilPotassiumRaw  = (response[7] << 8) | response[8]; // e.g., 0030H = 48
-
   // Convert to physical units
-  sensorValues[4] = soilNitrogenRaw;   // Unit: 32 mg/kg
-  sensorValues[5] = soilPhosphorusRaw; // Unit: 37 mg/kg
-  sensorValues[6] = soilPotassiumRaw;  // Unit: 48 mg/kg
+  sensorValues[0] = regs[ES_SOIL_PH_REG - ES_SOIL_FIRST_REG] * 0.01;
+  sensorValues[1] = regs[ES_SOIL_MOISTURE_REG - ES_SOIL_FIRST_REG] * 0.1;
+  sensorValues[2] = regs[ES_SOIL_TEMPERATURE_REG - ES_SOIL_FIRST_REG] * 0.1;
+  sensorValues[3] = regs[ES_SOIL_CONDUCTIVITY_REG - ES_SOIL_FIRST_REG];
+  sensorValues[4] = regs[ES_SOIL_NITROGEN_REG - ES_SOIL_FIRST_REG];
+  sensorValues[5] = regs[ES_SOIL_PHOSPHORUS_REG - ES_SOIL_FIRST_REG];
+  sensorValues[6] = regs[ES_SOIL_POTASSIUM_REG - ES_SOIL_FIRST_REG];
+  lastUpdate      = millis();
 
   return ES_SOIL_7N1_OK;
 }
@@ -340,6 +278,35 @@ float EsSoil7n1::getSoilPhosphorus() { return sensorValues[5]; }
 
 float EsSoil7n1::getSoilPotassium() { return sensorValues[6]; }
 
+uint8_t EsSoil7n1::getSlaveId() { return slaveId; }
+
+uint32_t EsSoil7n1::getLastUpdate() { return lastUpdate; }
+
+es_soil_7n1_error_t EsSoil7n1::readRegisters(uint16_t reg, uint16_t count, uint16_t *values, const char *name)
+{
+  bsp_modbus_error_t result = master->readHoldingRegisters(slaveId, reg, count, values);
+
+  if (result != BSP_MODBUS_OK)
+  {
+#ifdef DEBUG_PRINT
+    Serial.printf("Error: %s Modbus read failed (%d)\n", name, result);
+#endif // DEBUG_PRINT
+
+    return (result == BSP_MODBUS_TIMEOUT) ? ES_SOIL_7N1_TIMEOUT : ES_SOIL_7N1_ERR_READ;
+  }
+
+#ifdef DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
+  Serial.printf("Raw response %s:", name);
+  for (uint16_t i = 0; i < count; i++)
+  {
+    Serial.printf(" %04X", values[i]);
+  }
+  Serial.println();
+#endif // DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
+
+  return ES_SOIL_7N1_OK;
+}
+
 /* Private function prototypes ---------------------------------------- */
 
 /* End of file -------------------------------------------------------- */
\ No newline at end of file
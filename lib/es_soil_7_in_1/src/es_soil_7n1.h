@@ -19,9 +19,23 @@
     #include "WProgram.h"
   #endif
 
+  #include "bsp_modbus.h"
+
   /* Public defines ----------------------------------------------------- */
-  #define ES_SOIL_7N1_LIB_VERSION (F("0.1.0"))
-  #define ES_SOIL_SLAVE_ID        0x03
+  #define ES_SOIL_7N1_LIB_VERSION  (F("0.1.0"))
+  #define ES_SOIL_SLAVE_ID         0x03
+
+  #define ES_SOIL_PH_REG           0x0006
+  #define ES_SOIL_MOISTURE_REG     0x0012
+  #define ES_SOIL_TEMPERATURE_REG  0x0013
+  #define ES_SOIL_CONDUCTIVITY_REG 0x0015
+  #define ES_SOIL_NITROGEN_REG     0x001E
+  #define ES_SOIL_PHOSPHORUS_REG   0x001F
+  #define ES_SOIL_POTASSIUM_REG    0x0020
+
+  #define ES_SOIL_FIRST_REG        ES_SOIL_PH_REG
+  #define ES_SOIL_SPAN_LENGTH      (ES_SOIL_POTASSIUM_REG - ES_SOIL_FIRST_REG + 1) // 0x06..0x20, 27 registers
+  #define ES_SOIL_MAX_PLAN_RANGES  4 // Requests of the smallest read plan
 
   #define DEBUG_PRINT_ES_SOIL_RAW_RESPONSE
 
@@ -64,13 +78,15 @@ typedef enum
  *
  * ### Usage:
  *
- * Instantiate the class and initialize the RS485 serial interface. Call the appropriate `read` methods (e.g.,
+ * Instantiate the class, call `begin()` with the sensor's slave address and initialize the RS485 serial
+ * interface. Call the appropriate `read` methods (e.g.,
  * `readSoilPh()`, `readSoilNPK()`) to retrieve sensor data, then use getter methods (e.g., `getSoilPh()`) to
  * access the converted values. Ensure the sensor is powered and connected properly before reading.
  *
  * ### Dependencies:
  *
- * - Requires an RS485 serial interface (`rs485Serial1`) with Modbus command support.
+ * - Requires a Modbus RTU master, `modbusMaster1` on `rs485Serial1` unless another one is given to
+ * `begin()`.
  *
  * - Sensor must be connected to a valid RS485 bus.
  *
@@ -80,6 +96,16 @@ typedef enum
 class EsSoil7n1
 {
 public:
+  /**
+   * @brief  Binds the sensor to a slave address and a Modbus master.
+   *
+   * @param[in]     slaveId Modbus slave address of the sensor
+   * @param[in]     master  Master of the RS485 line the sensor is wired to
+   *
+   * @attention  Without a call the sensor is polled at `ES_SOIL_SLAVE_ID` through `modbusMaster1`.
+   */
+  void begin(uint8_t slaveId = ES_SOIL_SLAVE_ID, BspModbusMaster &master = modbusMaster1);
+
   /* Read methods ------------------------------------------------------ */
 
   /**
@@ -96,7 +122,9 @@ public:
    * @return
    *  - `ES_SOIL_7N1_OK`: pH reading was successful.
    *
-   *  - `ES_SOIL_7N1_ERR`: Error occurred during communication or response validation.
+   *  - `ES_SOIL_7N1_ERR_READ`: Modbus error or invalid response.
+   *
+   *  - `ES_SOIL_7N1_TIMEOUT`: The sensor did not answer.
    */
   es_soil_7n1_error_t readSoilPh();
 
@@ -114,7 +142,9 @@ public:
    * @return
    *  - `ES_SOIL_7N1_OK`: Moisture reading was successful.
    *
-   *  - `ES_SOIL_7N1_ERR`: Error occurred during communication or response validation.
+   *  - `ES_SOIL_7N1_ERR_READ`: Modbus error or invalid response.
+   *
+   *  - `ES_SOIL_7N1_TIMEOUT`: The sensor did not answer.
    */
   es_soil_7n1_error_t readSoilMoisture();
 
@@ -132,7 +162,9 @@ public:
    * @return
    *  - `ES_SOIL_7N1_OK`: Temperature reading was successful.
    *
-   *  - `ES_SOIL_7N1_ERR`: Error occurred during communication or response validation.
+   *  - `ES_SOIL_7N1_ERR_READ`: Modbus error or invalid response.
+   *
+   *  - `ES_SOIL_7N1_TIMEOUT`: The sensor did not answer.
    */
   es_soil_7n1_error_t readSoilTemperature();
 
@@ -150,7 +182,9 @@ public:
    * @return
    *  - `ES_SOIL_7N1_OK`: Conductivity reading was successful.
    *
-   *  - `ES_SOIL_7N1_ERR`: Error occurred during communication or response validation.
+   *  - `ES_SOIL_7N1_ERR_READ`: Modbus error or invalid response.
+   *
+   *  - `ES_SOIL_7N1_TIMEOUT`: The sensor did not answer.
    */
   es_soil_7n1_error_t readSoilConductivity();
 
@@ -168,7 +202,9 @@ public:
    * @return
    *  - `ES_SOIL_7N1_OK`: Nitrogen reading was successful.
    *
-   *  - `ES_SOIL_7N1_ERR`: Error occurred during communication or response validation.
+   *  - `ES_SOIL_7N1_ERR_READ`: Modbus error or invalid response.
+   *
+   *  - `ES_SOIL_7N1_TIMEOUT`: The sensor did not answer.
    */
   es_soil_7n1_error_t readSoilNitrogen();
 
@@ -186,7 +222,9 @@ public:
    * @return
    *  - `ES_SOIL_7N1_OK`: Phosphorus reading was successful.
    *
-   *  - `ES_SOIL_7N1_ERR`: Error occurred during communication or response validation.
+   *  - `ES_SOIL_7N1_ERR_READ`: Modbus error or invalid response.
+   *
+   *  - `ES_SOIL_7N1_TIMEOUT`: The sensor did not answer.
    */
   es_soil_7n1_error_t readSoilPhosphorus();
 
@@ -204,7 +242,9 @@ public:
    * @return
    *  - `ES_SOIL_7N1_OK`: Potassium reading was successful.
    *
-   *  - `ES_SOIL_7N1_ERR`: Error occurred during communication or response validation.
+   *  - `ES_SOIL_7N1_ERR_READ`: Modbus error or invalid response.
+   *
+   *  - `ES_SOIL_7N1_TIMEOUT`: The sensor did not answer.
    */
   es_soil_7n1_error_t readSoilPotassium();
 
@@ -223,7 +263,9 @@ public:
    * @return
    *  - `ES_SOIL_7N1_OK`: Temperature and moisture readings were successful.
    *
-   *  - `ES_SOIL_7N1_ERR`: Error occurred during communication or response validation.
+   *  - `ES_SOIL_7N1_ERR_READ`: Modbus error or invalid response.
+   *
+   *  - `ES_SOIL_7N1_TIMEOUT`: The sensor did not answer.
    */
   es_soil_7n1_error_t readSoilTempAndMoisture();
 
@@ -242,10 +284,61 @@ public:
    * @return
    *  - `ES_SOIL_7N1_OK`: NPK readings were successful.
    *
-   *  - `ES_SOIL_7N1_ERR`: Error occurred during communication or response validation.
+   *  - `ES_SOIL_7N1_ERR_READ`: Modbus error or invalid response.
+   *
+   *  - `ES_SOIL_7N1_TIMEOUT`: The sensor did not answer.
    */
   es_soil_7n1_error_t readSoilNPK();
 
+  /**
+   * @brief  Reads all seven soil values with as few Modbus requests as the sensor accepts.
+   *
+   * The first poll asks for the whole 0x06..0x20 span in one request. If the sensor rejects it with an
+   * exception (e.g. for the unused registers in between), the poll falls back to the three register
+   * groups, then to one request per value, and the accepted plan is kept for the next polls.
+   *
+   * @param[in]     None
+   *
+   * @attention  The stored values are only updated when every request of the plan succeeded, so the seven
+   *             values always come from the same poll.
+   *
+   * @return
+   *  - `ES_SOIL_7N1_OK`: All readings were successful.
+   *
+   *  - `ES_SOIL_7N1_ERR_READ`: Modbus error or invalid response.
+   *
+   *  - `ES_SOIL_7N1_TIMEOUT`: The sensor did not answer.
+   */
+  es_soil_7n1_error_t readAll();
+
+  /**
+   * @brief  Converts the registers of one 0x06..0x20 span into the stored values.
+   *
+   * Used by `readAll()` and by callers that read the span themselves, e.g. through the Modbus polling
+   * scheduler of `bsp_modbus_poller.h`.
+   *
+   * @param[in]     regs `ES_SOIL_SPAN_LENGTH` registers starting at `ES_SOIL_FIRST_REG`
+   *
+   * @return
+   *  - `ES_SOIL_7N1_OK`: Values updated.
+   *
+   *  - `ES_SOIL_7N1_ERR`: `regs` is `NULL`.
+   */
+  es_soil_7n1_error_t decodeSpan(const uint16_t *regs);
+
+  /**
+   * @brief  Moves to the next smaller read plan after the sensor rejected the current one.
+   *
+   * For callers that read the span themselves and got an exception response, `readAll()` takes the same
+   * step on its own. The requests of the new plan are returned so the caller can poll them instead, the
+   * registers they leave out are not used by `decodeSpan()`.
+   *
+   * @param[out]    ranges Requests of the new plan, room for `ES_SOIL_MAX_PLAN_RANGES`
+   *
+   * @return  Number of requests of the new plan, 0 when the sensor is already on the smallest plan.
+   */
+  uint8_t nextReadPlan(bsp_modbus_range_t *ranges);
+
   /* Getter methods ------------------------------------------------------ */
 
   /**
@@ -346,15 +439,36 @@ public:
    */
   float getSoilPotassium();
 
+  /**
+   * @brief Retrieves the Modbus slave address of the sensor.
+   *
+   * @return uint8_t The slave address given to `begin()`.
+   */
+  uint8_t getSlaveId();
+
+  /**
+   * @brief Retrieves when all seven values were last updated together.
+   *
+   * @param[in] None
+   *
+   * @return uint32_t `millis()` of the last successful `readAll()` or `decodeSpan()`, 0 before the first one.
+   */
+  uint32_t getLastUpdate();
+
 private:
-  uint8_t address         = 0x01;
-  float   sensorValues[7] = {0.0}; // index 0 - pH
-                                   // index 1 - Moisture
-                                   // index 2 - Temperature
-                                   // index 3 - Conductivity
-                                   // index 4 - Nitrogen
-                                   // index 5 - Phosphorus
-                                   // index 6 - Potassium
+  BspModbusMaster *master          = &modbusMaster1;
+  uint8_t          slaveId         = ES_SOIL_SLAVE_ID;
+  uint8_t          readPlan        = 0;     // Index of the first read plan the sensor accepted
+  uint32_t         lastUpdate      = 0;     // millis() of the last complete update
+  float            sensorValues[7] = {0.0}; // index 0 - pH
+                                            // index 1 - Moisture
+                                            // index 2 - Temperature
+                                            // index 3 - Conductivity
+                                            // index 4 - Nitrogen
+                                            // index 5 - Phosphorus
+                                            // index 6 - Potassium
+
+  es_soil_7n1_error_t readRegisters(uint16_t reg, uint16_t count, uint16_t *values, const char *name);
 };
 
 #endif // ES_SOIL_7N1_H
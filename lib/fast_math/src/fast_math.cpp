@@ -0,0 +1,179 @@
+/**
+ * @file       fast_math.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-20
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for Fast Math library
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "fast_math.h"
+
+#include <float.h>
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Private defines ---------------------------------------------------- */
+#define FAST_MATH_TABLE_SIZE    ((1 << FAST_MATH_TABLE_BITS) + 1) // Both ends of every segment
+#define FAST_MATH_FRACTION_BITS (23 - FAST_MATH_TABLE_BITS)       // Mantissa bits below the table index
+#define FAST_MATH_LN2           0.69314718055994530942
+#define FAST_MATH_SERIES_TERMS  16 // Terms of the compile-time series, far below float precision
+#define ALTITUDE_SCALE          44330.0f
+#define ALTITUDE_EXPONENT       0.1903f
+
+/* Private enumerate/structure ---------------------------------------- */
+// Wrapper so constexpr functions can return whole tables
+typedef struct
+{
+  float entry[FAST_MATH_TABLE_SIZE];
+} fast_math_table_t;
+
+// Compile-time list 0..N-1 to expand one table entry per index (std::index_sequence is C++14)
+template <size_t... I> struct fast_math_index_list
+{
+};
+
+template <size_t N, size_t... I>
+struct fast_math_make_index_list : fast_math_make_index_list<N - 1, N - 1, I...>
+{
+};
+
+template <size_t... I> struct fast_math_make_index_list<0, I...>
+{
+  typedef fast_math_index_list<I...> type;
+};
+
+/* Private function prototypes ---------------------------------------- */
+// C++11 constexpr functions are a single return statement, the series recurse instead of looping.
+// ln(m) = 2 * atanh((m - 1) / (m + 1)), the odd powers of z <= 1/3 for m in [1, 2]
+static constexpr double lnSeries(double z2, double power, int term)
+{
+  return (term == FAST_MATH_SERIES_TERMS) ? 0.0
+                                          : power / (2 * term + 1) + lnSeries(z2, power * z2, term + 1);
+}
+
+static constexpr double lnOfZ(double z) { return 2.0 * lnSeries(z * z, z, 0); }
+
+static constexpr double lnEntry(double m) { return lnOfZ((m - 1) / (m + 1)); }
+
+// Taylor series of e^x, x <= ln(2)
+static constexpr double expSeries(double x, double power, int term)
+{
+  return (term == FAST_MATH_SERIES_TERMS) ? 0.0 : power + expSeries(x, power * x / (term + 1), term + 1);
+}
+
+template <size_t... I> static constexpr fast_math_table_t log2MakeTable(fast_math_index_list<I...>)
+{
+  return {{(float) (lnEntry(1.0 + (double) I / (1 << FAST_MATH_TABLE_BITS)) / FAST_MATH_LN2)...}};
+}
+
+template <size_t... I> static constexpr fast_math_table_t exp2MakeTable(fast_math_index_list<I...>)
+{
+  return {{(float) expSeries((double) I / (1 << FAST_MATH_TABLE_BITS) * FAST_MATH_LN2, 1.0, 0)...}};
+}
+
+static inline float interpolate(const float *table, uint32_t index, float fraction);
+
+/* Private variables -------------------------------------------------- */
+// log2(1 + i / 256) and 2^(i / 256), i = 0..256
+static constexpr fast_math_table_t log2Table =
+log2MakeTable(fast_math_make_index_list<FAST_MATH_TABLE_SIZE>::type());
+static constexpr fast_math_table_t exp2Table =
+exp2MakeTable(fast_math_make_index_list<FAST_MATH_TABLE_SIZE>::type());
+
+// Both ends and the midpoint, a wrong series fails the build instead of the altitude
+static_assert(log2Table.entry[0] == 0.0f && log2Table.entry[FAST_MATH_TABLE_SIZE - 1] == 1.0f, "log2 table");
+static_assert(log2Table.entry[FAST_MATH_TABLE_SIZE / 2] > 0.584962f &&
+              log2Table.entry[FAST_MATH_TABLE_SIZE / 2] < 0.584963f,
+              "log2 table");
+static_assert(exp2Table.entry[0] == 1.0f && exp2Table.entry[FAST_MATH_TABLE_SIZE - 1] == 2.0f, "exp2 table");
+static_assert(exp2Table.entry[FAST_MATH_TABLE_SIZE / 2] > 1.414213f &&
+              exp2Table.entry[FAST_MATH_TABLE_SIZE / 2] < 1.414214f,
+              "exp2 table");
+
+/* Function definitions ----------------------------------------------- */
+float fastLog2f(float x)
+{
+  uint32_t bits;
+  int32_t  exponent = 0;
+
+  if (!(x > 0.0f))
+  {
+    return (x == 0.0f) ? -INFINITY : NAN;
+  }
+  if (isinf(x))
+  {
+    return INFINITY;
+  }
+  if (x < FLT_MIN)
+  {
+    // Subnormal, scaled into the normal range first
+    x        *= 16777216.0f;
+    exponent  = -24;
+  }
+
+  memcpy(&bits, &x, sizeof(bits));
+  exponent          += (int32_t) (bits >> 23) - 127;
+  uint32_t mantissa  = bits & 0x7FFFFF;
+  float    fraction  = (mantissa & ((1UL << FAST_MATH_FRACTION_BITS) - 1)) *
+                   (1.0f / (1UL << FAST_MATH_FRACTION_BITS));
+
+  return exponent + interpolate(log2Table.entry, mantissa >> FAST_MATH_FRACTION_BITS, fraction);
+}
+
+float fastLnf(float x) { return fastLog2f(x) * (float) FAST_MATH_LN2; }
+
+float fastExp2f(float y)
+{
+  if (isnan(y))
+  {
+    return NAN;
+  }
+  if (y >= 128.0f)
+  {
+    return INFINITY;
+  }
+  if (y < -126.0f)
+  {
+    return 0.0f;
+  }
+
+  // Integer part into the float exponent, fraction [0, 1) through the table
+  float    whole    = floorf(y);
+  float    scaled   = (y - whole) * (1 << FAST_MATH_TABLE_BITS);
+  uint32_t index    = (uint32_t) scaled;
+  float    result   = interpolate(exp2Table.entry, index, scaled - index);
+  uint32_t bits;
+
+  memcpy(&bits, &result, sizeof(bits));
+  bits += (uint32_t) (int32_t) whole << 23; // Wraps for negative exponents
+  memcpy(&result, &bits, sizeof(result));
+
+  return result;
+}
+
+float fastPowf(float x, float y)
+{
+  if (x == 0.0f)
+  {
+    return 0.0f;
+  }
+  return fastExp2f(y * fastLog2f(x));
+}
+
+float fastPressureAltitude(float pressure, float seaLevelhPa)
+{
+  return ALTITUDE_SCALE * (1.0f - fastPowf(pressure / (seaLevelhPa * 100.0f), ALTITUDE_EXPONENT));
+}
+
+/* Private definitions ------------------------------------------------ */
+static inline float interpolate(const float *table, uint32_t index, float fraction)
+{
+  return table[index] + (table[index + 1] - table[index]) * fraction;
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,104 @@
+/**
+ * @file       fast_math.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-20
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for Fast Math library. Table-driven logarithm, power and pressure altitude in
+ * single precision for the sensor drivers.
+ *
+ * @note       The ESP32-S3 FPU is single precision only: `pow()` and `log()` on doubles run in software and
+ *             take tens of microseconds. Here log2 and exp2 split the float into exponent and mantissa and
+ *             interpolate the mantissa in a 257-entry table (1 KB each), generated by constexpr functions at
+ *             compile time and kept in flash.
+ *
+ *             Error bounds, checked by tools/fast_math_bench against libm in double precision:
+ *               - `fastLog2f`, `fastLnf`: absolute error below 3e-6, plus the float rounding of the result
+ *                 (2^-24 of it) beyond |log2(x)| = 8
+ *               - `fastExp2f`: relative error below 1.5e-6
+ *               - `fastPowf`: relative error below 1.5e-6 + 2e-6 * |y|
+ *               - `fastPressureAltitude`: below 0.05 m from 300 hPa to 1100 hPa
+ * @example    float altitude = fastPressureAltitude(pressure, 1013.25f);
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef FAST_MATH_H
+  #define FAST_MATH_H
+
+  /* Includes ----------------------------------------------------------- */
+  #include <stdint.h>
+
+  /* Public defines ----------------------------------------------------- */
+  #define FAST_MATH_TABLE_BITS 8 // Mantissa bits that index the tables, 2^8 segments
+
+/* Public enumerate/structure ----------------------------------------- */
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/* Public function prototypes ----------------------------------------- */
+
+/**
+ * @brief  Calculates the base-2 logarithm.
+ *
+ * @param[in]     x Input value
+ *
+ * @return
+ *  - log2(x), absolute error below 3e-6 for |log2(x)| <= 8.
+ *  - `-INFINITY` for 0, `NAN` for negative or `NAN` input, `INFINITY` for `INFINITY`.
+ */
+float fastLog2f(float x);
+
+/**
+ * @brief  Calculates the natural logarithm, `fastLog2f(x) * ln(2)`.
+ *
+ * @param[in]     x Input value
+ *
+ * @return
+ *  - ln(x), absolute error below 3e-6 for |log2(x)| <= 8, special values as `fastLog2f`.
+ */
+float fastLnf(float x);
+
+/**
+ * @brief  Calculates 2 raised to `y`.
+ *
+ * @param[in]     y Exponent
+ *
+ * @return
+ *  - 2^y, relative error below 1.5e-6.
+ *  - 0 below -126 (no subnormal results), `INFINITY` from 128, `NAN` for `NAN`.
+ */
+float fastExp2f(float y);
+
+/**
+ * @brief  Calculates `x` raised to `y` as `fastExp2f(y * fastLog2f(x))`.
+ *
+ * @param[in]     x Base, positive
+ * @param[in]     y Exponent
+ *
+ * @attention  The error of the logarithm is multiplied by `y`, keep `|log2(x)| <= 8`.
+ *
+ * @return
+ *  - x^y, relative error below 1.5e-6 + 2e-6 * |y|, 0 for `x == 0`, `NAN` for negative `x`.
+ */
+float fastPowf(float x, float y);
+
+/**
+ * @brief  Calculates the altitude of a pressure with the international barometric formula,
+ *         44330 * (1 - (p / p0)^0.1903).
+ *
+ * @param[in]     pressure    Measured pressure in Pa
+ * @param[in]     seaLevelhPa Sea level pressure in hPa
+ *
+ * @return
+ *  - Altitude in meters, within 0.05 m of the double precision formula from 300 hPa to 1100 hPa.
+ */
+float fastPressureAltitude(float pressure, float seaLevelhPa);
+
+#endif // FAST_MATH_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,278 @@
+/**
+ * @file       gorilla.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-18
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the Gorilla time-series codec
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "gorilla.h"
+
+/* Private defines ---------------------------------------------------- */
+#define WINDOW_NONE UINT8_MAX // No `11` value yet, `10` cannot be used
+
+/* Private enumerate/structure ---------------------------------------- */
+// Delta-of-delta classes after the `0` of an unchanged delta: prefix, its length, bits of the zigzag value
+typedef struct
+{
+  uint8_t prefix;
+  uint8_t prefixBits;
+  uint8_t valueBits;
+} dod_class_t;
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+
+/* Private variables -------------------------------------------------- */
+static const dod_class_t DOD_CLASSES[] = {{0x2, 2, 7}, {0x6, 3, 9}, {0xE, 4, 12}, {0xF, 4, 32}};
+
+/* Private function prototypes ---------------------------------------- */
+static uint32_t floatBits(float value);
+static float    bitsFloat(uint32_t bits);
+
+/* Class method definitions-------------------------------------------- */
+void GorillaEncoder::begin(uint8_t *buffer, size_t size)
+{
+  _data     = buffer;
+  _size     = size;
+  _bits     = 0;
+  _count    = 0;
+  _time     = 0;
+  _delta    = 0;
+  _value    = 0;
+  _leading  = WINDOW_NONE;
+  _trailing = 0;
+}
+
+bool GorillaEncoder::append(uint32_t time, float value)
+{
+  if (_count == UINT16_MAX || length() + GORILLA_SAMPLE_MAX_LENGTH > _size)
+  {
+    return false;
+  }
+
+  uint32_t bits = floatBits(value);
+  if (_count == 0)
+  {
+    writeBits(time, 32);
+    writeBits(bits, 32);
+  }
+  else
+  {
+    // Unsigned arithmetic, deltas wrap instead of overflowing
+    uint32_t delta  = time - _time;
+    uint32_t dod    = delta - _delta;
+    uint32_t zigzag = (dod << 1) ^ (uint32_t) ((int32_t) dod >> 31);
+    if (zigzag == 0)
+    {
+      writeBits(0, 1);
+    }
+    else
+    {
+      const dod_class_t *cls = &DOD_CLASSES[0];
+      while (cls->valueBits < 32 && zigzag >= (1UL << cls->valueBits))
+      {
+        cls++;
+      }
+      writeBits(cls->prefix, cls->prefixBits);
+      writeBits(zigzag, cls->valueBits);
+    }
+    _delta = delta;
+
+    uint32_t xored = bits ^ _value;
+    if (xored == 0)
+    {
+      writeBits(0, 1);
+    }
+    else
+    {
+      uint8_t leading  = (uint8_t) __builtin_clz(xored);
+      uint8_t trailing = (uint8_t) __builtin_ctz(xored);
+      if (_leading != WINDOW_NONE && leading >= _leading && trailing >= _trailing)
+      {
+        writeBits(0x2, 2);
+        writeBits(xored >> _trailing, 32 - _leading - _trailing);
+      }
+      else
+      {
+        uint8_t meaningful = 32 - leading - trailing;
+        writeBits(0x3, 2);
+        writeBits(leading, 5);
+        writeBits(meaningful - 1, 5);
+        writeBits(xored >> trailing, meaningful);
+        _leading  = leading;
+        _trailing = trailing;
+      }
+    }
+  }
+  _time  = time;
+  _value = bits;
+  _count++;
+
+  return true;
+}
+
+size_t GorillaEncoder::length() const { return (_bits + 7) / 8; }
+
+uint16_t GorillaEncoder::count() const { return _count; }
+
+void GorillaEncoder::writeBits(uint32_t bits, uint8_t count)
+{
+  // Top bits first, as many as the current byte takes at a time
+  while (count > 0)
+  {
+    uint8_t used = _bits & 7;
+    uint8_t room = 8 - used;
+    uint8_t take = (count < room) ? count : room;
+    uint8_t part = (uint8_t) ((bits >> (count - take)) & ((1U << take) - 1));
+
+    if (used == 0)
+    {
+      _data[_bits >> 3] = 0;
+    }
+    _data[_bits >> 3] |= part << (room - take);
+    _bits             += take;
+    count             -= take;
+  }
+}
+
+void GorillaDecoder::begin(const uint8_t *buffer, size_t length, uint16_t count)
+{
+  _data     = buffer;
+  _length   = length;
+  _bits     = 0;
+  _count    = count;
+  _first    = true;
+  _time     = 0;
+  _delta    = 0;
+  _value    = 0;
+  _leading  = 0;
+  _trailing = 0;
+}
+
+bool GorillaDecoder::next(uint32_t *time, float *value)
+{
+  if (_count == 0)
+  {
+    return false;
+  }
+  if (!decodeSample())
+  {
+    // Cut short or corrupt, nothing after it can be trusted
+    _count = 0;
+    return false;
+  }
+
+  *time  = _time;
+  *value = bitsFloat(_value);
+  _count--;
+
+  return true;
+}
+
+bool GorillaDecoder::decodeSample()
+{
+  uint32_t bits;
+
+  if (_first)
+  {
+    _first = false;
+    return readBits(32, &_time) && readBits(32, &_value);
+  }
+
+  // The timestamp prefix is its number of leading ones, up to four
+  uint8_t ones = 0;
+  while (ones < 4 && readBits(1, &bits) && bits == 1)
+  {
+    ones++;
+  }
+  uint32_t zigzag = 0;
+  if (_bits > _length * 8 || (ones > 0 && !readBits(DOD_CLASSES[ones - 1].valueBits, &zigzag)))
+  {
+    return false;
+  }
+  _delta += (zigzag >> 1) ^ (uint32_t) -(int32_t) (zigzag & 1);
+  _time  += _delta;
+
+  if (!readBits(1, &bits))
+  {
+    return false;
+  }
+  if (bits == 0)
+  {
+    return true;
+  }
+  if (!readBits(1, &bits))
+  {
+    return false;
+  }
+  if (bits == 1)
+  {
+    uint32_t leading, meaningful;
+    if (!readBits(5, &leading) || !readBits(5, &meaningful) || leading + meaningful + 1 > 32)
+    {
+      return false;
+    }
+    _leading  = (uint8_t) leading;
+    _trailing = (uint8_t) (32 - leading - (meaningful + 1));
+  }
+
+  uint32_t xored;
+  if (!readBits(32 - _leading - _trailing, &xored))
+  {
+    return false;
+  }
+  _value ^= xored << _trailing;
+
+  return true;
+}
+
+bool GorillaDecoder::readBits(uint8_t count, uint32_t *bits)
+{
+  if (_bits + count > _length * 8)
+  {
+    // Past the end, remembered so a prefix read bit by bit can tell
+    _bits = _length * 8 + 1;
+    return false;
+  }
+
+  uint32_t result = 0;
+  while (count > 0)
+  {
+    uint8_t used = _bits & 7;
+    uint8_t room = 8 - used;
+    uint8_t take = (count < room) ? count : room;
+    uint8_t part = (_data[_bits >> 3] >> (room - take)) & ((1U << take) - 1);
+
+    result  = (result << take) | part;
+    _bits  += take;
+    count  -= take;
+  }
+  *bits = result;
+
+  return true;
+}
+
+/* Private definitions ------------------------------------------------ */
+static uint32_t floatBits(float value)
+{
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  return bits;
+}
+
+static float bitsFloat(uint32_t bits)
+{
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+
+  return value;
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,151 @@
+/**
+ * @file       gorilla.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-18
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the Gorilla time-series codec
+ *
+ * @note       Streaming compression of the samples of one channel, after the Gorilla paper (Pelkonen et
+ *             al., VLDB 2015): the first sample is stored whole, then every timestamp as the change of its
+ *             delta to the one before and every value as the XOR of its float bits with the previous value.
+ *             A steady sampling period codes as a single bit, an unchanged value as another one, and a
+ *             value that moved by a few sensor steps as its few changing bits. Bits are packed MSB first.
+ *
+ *             Timestamp, delta-of-delta `d` zigzag coded to `z`:
+ *               - `0`                  d = 0
+ *               - `10`   + 7 bits of z  z < 2^7
+ *               - `110`  + 9 bits of z  z < 2^9
+ *               - `1110` + 12 bits of z z < 2^12
+ *               - `1111` + 32 bits of z
+ *             Value, `x` = float bits XOR previous float bits:
+ *               - `0`                                              x = 0
+ *               - `10` + the bits of x in the window of the last `11`, when x has no bits outside it
+ *               - `11` + 5 bits leading zeros, 5 bits length - 1, then the meaningful bits of x
+ *
+ *             A block has no end marker, the decoder is told how many samples it holds.
+ * @example    GorillaEncoder encoder;
+ *             encoder.begin(buffer, sizeof(buffer));
+ *             while (encoder.append(time, value)) { ... }
+ *             GorillaDecoder decoder;
+ *             decoder.begin(buffer, encoder.length(), encoder.count());
+ *             while (decoder.next(&time, &value)) { ... }
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef GORILLA_H
+  #define GORILLA_H
+
+  /* Includes ----------------------------------------------------------- */
+  #if ARDUINO >= 100
+    #include "Arduino.h"
+  #else
+    #include "WProgram.h"
+  #endif
+
+  /* Public defines ----------------------------------------------------- */
+  #define GORILLA_SAMPLE_MAX_LENGTH 10 // Worst-case bytes of a sample, 36 bits of time and 44 of value
+
+/* Public enumerate/structure ----------------------------------------- */
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/**
+ * @brief Packs the samples of one channel into a caller buffer.
+ */
+class GorillaEncoder
+{
+public:
+  /**
+   * @brief  Starts a block in `buffer`.
+   *
+   * @param[in]     buffer Output bytes, written as samples are appended
+   * @param[in]     size   Size of `buffer`
+   */
+  void begin(uint8_t *buffer, size_t size);
+
+  /**
+   * @brief  Appends a sample to the block.
+   *
+   * @param[in]     time  Timestamp, any unit, seconds in the time-series log
+   * @param[in]     value Sample value
+   *
+   * @attention  Timestamps may go backwards and wrap, deltas are taken modulo 2^32.
+   *
+   * @return  `false` when the worst case of a sample no longer fits, the block is full and unchanged.
+   */
+  bool append(uint32_t time, float value);
+
+  /**
+   * @brief  Returns the bytes used, the last one padded with zero bits.
+   */
+  size_t length() const;
+
+  /**
+   * @brief  Returns the number of samples appended.
+   */
+  uint16_t count() const;
+
+private:
+  uint8_t *_data;
+  size_t   _size;
+  size_t   _bits;     // Bits written
+  uint16_t _count;    // Samples appended
+  uint32_t _time;     // Last timestamp
+  uint32_t _delta;    // Last timestamp delta, modulo 2^32
+  uint32_t _value;    // Bits of the last value
+  uint8_t  _leading;  // Window of the last `11` value, leading zeros, `UINT8_MAX` before the first
+  uint8_t  _trailing; // and trailing zeros
+
+  void writeBits(uint32_t bits, uint8_t count);
+};
+
+/**
+ * @brief Unpacks a block written by `GorillaEncoder`, one sample at a time.
+ */
+class GorillaDecoder
+{
+public:
+  /**
+   * @brief  Starts reading `count` samples from `buffer`.
+   *
+   * @param[in]     buffer Block bytes, must stay valid while decoding
+   * @param[in]     length Bytes in `buffer`
+   * @param[in]     count  Samples in the block
+   */
+  void begin(const uint8_t *buffer, size_t length, uint16_t count);
+
+  /**
+   * @brief  Decodes the next sample.
+   *
+   * @param[out]    time  Timestamp
+   * @param[out]    value Sample value
+   *
+   * @return  `false` after the last sample, or when the block is cut short.
+   */
+  bool next(uint32_t *time, float *value);
+
+private:
+  const uint8_t *_data;
+  size_t         _length;
+  size_t         _bits;  // Bits read
+  uint16_t       _count; // Samples left
+  bool           _first; // Next sample is the first of the block
+  uint32_t       _time;
+  uint32_t       _delta;
+  uint32_t       _value;
+  uint8_t        _leading;
+  uint8_t        _trailing;
+
+  bool decodeSample();
+  bool readBits(uint8_t count, uint32_t *bits);
+};
+
+#endif // GORILLA_H
+
+/* End of file -------------------------------------------------------- */
@@ -1,16 +1,15 @@
 #include "lcd_16x2.h"
+#include "bsp_i2c.h"
 
 #include <lcd_16x2_constants.h>
 
 /**
  * @brief function begin
  *
- * @param beginWire if true start I²C wire
+ * The bus given to the constructor must already be initialized with bspI2CBegin().
  */
-void LCD_I2C::begin(TwoWire *wire)
+void LCD_I2C::begin()
 {
-  _wire = wire;
-
   // Clear i2c adapter
   I2C_Write(0b00000000);
   // Wait more than 40 ms after powerOn
@@ -384,12 +383,7 @@ void LCD_I2C::writeCharCode(uint8_t code)
  *
  * @param output data to write
  */
-void LCD_I2C::I2C_Write(uint8_t output)
-{
-  _wire->beginTransmission(_address);
-  _wire->write(output);
-  _wire->endTransmission();
-}
+void LCD_I2C::I2C_Write(uint8_t output) { bspI2CWriteBytes(_bus, _address, &output, 1); }
 
 /**
  * @brief LCD_Write function
@@ -399,30 +393,29 @@ void LCD_I2C::I2C_Write(uint8_t output)
  */
 void LCD_I2C::LCD_Write(uint8_t output, bool initialization)
 {
-  _output.data = output;
+  // The backpack latches every byte it receives, so the enable pulses of both nibbles go out as one bus
+  // transaction. Each byte takes ~90 us at 100 kHz, which already covers the > 450 ns enable width and the
+  // 37 us gap between half byte writes.
+  uint8_t frame[4];
+  uint8_t len = 0;
 
-  _output.en = true;
-  I2C_Write(_output.GetHighData());
-  // High part of enable should be > 450 ns
-  delayMicroseconds(1);
+  _output.data = output;
 
-  _output.en = false;
-  I2C_Write(_output.GetHighData());
+  _output.en   = true;
+  frame[len++] = _output.GetHighData();
+  _output.en   = false;
+  frame[len++] = _output.GetHighData();
 
   // During initialization we only send half a byte
   if (!initialization)
   {
-    // I think we need a delay between half byte writes, but no sure how long it needs to be.
-    delayMicroseconds(37);
-
-    _output.en = true;
-    I2C_Write(_output.GetLowData());
-    // High part of enable should be > 450 ns
-    delayMicroseconds(1);
-
-    _output.en = false;
-    I2C_Write(_output.GetLowData());
+    _output.en   = true;
+    frame[len++] = _output.GetLowData();
+    _output.en   = false;
+    frame[len++] = _output.GetLowData();
   }
+
+  bspI2CWriteBytes(_bus, _address, frame, len);
 }
 
 void LCD_I2C::progressBar(uint8_t row, uint8_t progress)
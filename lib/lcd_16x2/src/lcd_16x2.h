@@ -2,7 +2,7 @@
 #define _LCD_I2C_H_
 
 #include "Arduino.h"
-#include "Wire.h"
+#include "bsp_i2c.h"
 
 /*
    This struct helps us constructing the I2C output based on data and control outputs.
@@ -65,12 +65,12 @@ typedef enum
 class LCD_I2C : public Print
 {
 public:
-  LCD_I2C(uint8_t address, uint8_t columns = 16, uint8_t rows = 2)
-      : _address(address), _columnMax(--columns), _rowMax(--rows)
+  LCD_I2C(uint8_t address, uint8_t columns = 16, uint8_t rows = 2, bsp_i2c_bus_t bus = BSP_I2C_BUS_0)
+      : _address(address), _columnMax(--columns), _rowMax(--rows), _bus(bus)
   {
   }
 
-  void begin(TwoWire *wire);
+  void begin();
   void backlight();
   void backlightOff();
 
@@ -100,10 +100,10 @@ public:
   virtual size_t write(uint8_t character);
 
 private:
-  TwoWire           *_wire{nullptr};
   uint8_t            _address;
   uint8_t            _columnMax;
   uint8_t            _rowMax;
+  bsp_i2c_bus_t      _bus;
   OutputState        _output;
   uint8_t            _displayState  = 0x00;
   uint8_t            _entryState    = 0x00;
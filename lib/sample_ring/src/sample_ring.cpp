@@ -0,0 +1,125 @@
+/**
+ * @file       sample_ring.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-11
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the timestamped sample ring buffer
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "sample_ring.h"
+
+/* Private defines ---------------------------------------------------- */
+
+/* Private enumerate/structure ---------------------------------------- */
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+
+/* Private variables -------------------------------------------------- */
+
+/* Class method definitions-------------------------------------------- */
+SampleRing::SampleRing(sample_ring_sample_t *buffer, uint16_t capacity)
+    : _buffer(buffer), _mask(capacity - 1), _claimed(0), _head(0)
+{
+}
+
+void SampleRing::push(uint32_t timestampMs, float value)
+{
+  uint32_t index = _claimed.load(std::memory_order_relaxed);
+
+  // Announce the slot before changing it, a reader that sees the new sample also sees the claim
+  _claimed.store(index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  sample_ring_sample_t *sample = &_buffer[index & _mask];
+  sample->timestampMs          = timestampMs;
+  sample->value                = value;
+
+  _head.store(index + 1, std::memory_order_release);
+}
+
+sample_ring_view_t SampleRing::view(uint16_t maxCount) const
+{
+  uint32_t head  = _head.load(std::memory_order_acquire);
+  uint32_t count = (head < capacity()) ? head : capacity();
+
+  return makeView(head, (count < maxCount) ? count : maxCount);
+}
+
+sample_ring_view_t SampleRing::viewSince(uint32_t sinceMs) const
+{
+  sample_ring_view_t all  = view();
+  uint16_t           low  = 0;
+  uint16_t           high = length(&all);
+  uint32_t           head = all.start + high;
+
+  // First sample not older than `sinceMs`, timestamps increase along the view
+  while (low < high)
+  {
+    uint16_t middle = low + (high - low) / 2;
+    if ((int32_t) (at(&all, middle)->timestampMs - sinceMs) < 0)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+
+  return makeView(head, length(&all) - low);
+}
+
+uint16_t SampleRing::trim(sample_ring_view_t *view) const
+{
+  uint16_t count = length(view);
+
+  // Push n rewrites the slot of sample n - capacity, so samples older than this may have changed
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint32_t oldest = _claimed.load(std::memory_order_relaxed) - capacity();
+  int32_t  lost   = (int32_t) (oldest - view->start);
+
+  if (lost > 0)
+  {
+    uint16_t drop = ((uint32_t) lost < count) ? (uint16_t) lost : count;
+    *view         = makeView(view->start + count, count - drop);
+  }
+
+  return length(view);
+}
+
+uint16_t SampleRing::size() const
+{
+  uint32_t head = _head.load(std::memory_order_acquire);
+
+  return (head < capacity()) ? (uint16_t) head : capacity();
+}
+
+uint16_t SampleRing::capacity() const { return _mask + 1; }
+
+uint32_t SampleRing::pushed() const { return _head.load(std::memory_order_acquire); }
+
+sample_ring_view_t SampleRing::makeView(uint32_t head, uint16_t count) const
+{
+  sample_ring_view_t view;
+  uint32_t           start = head - count;
+  uint16_t           index = start & _mask;
+  uint16_t           tail  = capacity() - index; // Samples before the end of the array
+
+  view.start        = start;
+  view.first        = &_buffer[index];
+  view.firstLength  = (count < tail) ? count : tail;
+  view.second       = _buffer;
+  view.secondLength = count - view.firstLength;
+
+  return view;
+}
+
+/* Private function prototypes ---------------------------------------- */
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,174 @@
+/**
+ * @file       sample_ring.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-11
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the timestamped sample ring buffer
+ *
+ * @note       Keeps the most recent (timestamp, value) samples of one sensor channel in a fixed power of two
+ *             array. One producer pushes, any number of readers iterate the samples in place through a view
+ *             of at most two contiguous spans, without a lock and without copying. The producer never waits:
+ *             when the ring is full the oldest sample is overwritten, and a reader that was slower than the
+ *             producer finds out with `trim()` after it used the view.
+ * @example    SampleRingBuffer<128> history;
+ *             history.push(millis(), temperature);
+ *             sample_ring_view_t view  = history.view(60);
+ *             uint16_t           count = SampleRing::length(&view);
+ *             for (uint16_t i = 0; i < count; i++) { sum += SampleRing::at(&view, i)->value; }
+ *             if (history.trim(&view) < count) { ... oldest samples changed while summing, read again ... }
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef SAMPLE_RING_H
+  #define SAMPLE_RING_H
+
+  /* Includes ----------------------------------------------------------- */
+  #include <atomic>
+  #include <stddef.h>
+  #include <stdint.h>
+
+/* Public defines ----------------------------------------------------- */
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef struct
+{
+  uint32_t timestampMs; /**< `millis()` when the value was read */
+  float    value;       /**< Measurement */
+} sample_ring_sample_t;
+
+// Samples of a ring, oldest first: `first` then `second`, which wraps to the start of the array
+typedef struct
+{
+  const sample_ring_sample_t *first;
+  const sample_ring_sample_t *second;
+  uint16_t                    firstLength;
+  uint16_t                    secondLength;
+  uint32_t                    start; /**< Push count of `first[0]`, used by `trim()` */
+} sample_ring_view_t;
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/**
+ * @brief Single-producer ring of timestamped samples over a caller-provided array.
+ *
+ * Two counters order the producer against the readers: `_claimed` moves before a slot is written and
+ * `_head` after it. A reader takes its samples below `_head`, and after using them compares their push
+ * count with `_claimed` to know which ones a newer push may have overwritten in the meantime.
+ */
+class SampleRing
+{
+public:
+  /**
+   * @brief  Uses `buffer` as the storage of the ring.
+   *
+   * @param[in]     buffer   Array of `capacity` samples, must outlive the ring
+   * @param[in]     capacity Number of samples, a power of two
+   */
+  SampleRing(sample_ring_sample_t *buffer, uint16_t capacity);
+
+  /**
+   * @brief  Appends a sample, overwriting the oldest one when the ring is full.
+   *
+   * @param[in]     timestampMs Time of the measurement
+   * @param[in]     value       Measurement
+   *
+   * @attention  Only one task may push to a ring.
+   */
+  void push(uint32_t timestampMs, float value);
+
+  /**
+   * @brief  Returns a view of the newest samples, oldest first.
+   *
+   * @param[in]     maxCount Largest number of samples in the view
+   *
+   * @return  View of `min(maxCount, size())` samples.
+   */
+  sample_ring_view_t view(uint16_t maxCount = UINT16_MAX) const;
+
+  /**
+   * @brief  Returns a view of the samples timestamped at or after `sinceMs`, oldest first.
+   *
+   * @param[in]     sinceMs Oldest timestamp to include, compared with wraparound as `millis()`
+   *
+   * @attention  Assumes the timestamps were pushed in order and span less than 24 days.
+   *
+   * @return  View of the matching samples, possibly empty.
+   */
+  sample_ring_view_t viewSince(uint32_t sinceMs) const;
+
+  /**
+   * @brief  Drops from a view the samples overwritten since it was taken.
+   *
+   * @param[in,out] view View from `view()` or `viewSince()` of this ring
+   *
+   * @attention  Call after reading the samples: the values read are valid only for the samples still
+   *             in the view afterwards.
+   *
+   * @return  Number of samples left in the view.
+   */
+  uint16_t trim(sample_ring_view_t *view) const;
+
+  /**
+   * @brief  Returns the number of samples stored, at most `capacity()`.
+   */
+  uint16_t size() const;
+
+  /**
+   * @brief  Returns the number of samples the ring can hold.
+   */
+  uint16_t capacity() const;
+
+  /**
+   * @brief  Returns the number of samples pushed since the start, wrapping at 2^32.
+   */
+  uint32_t pushed() const;
+
+  /**
+   * @brief  Returns the number of samples in a view.
+   */
+  static inline uint16_t length(const sample_ring_view_t *view)
+  {
+    return view->firstLength + view->secondLength;
+  }
+
+  /**
+   * @brief  Returns the sample `index` of a view, 0 being the oldest, without bounds check.
+   */
+  static inline const sample_ring_sample_t *at(const sample_ring_view_t *view, uint16_t index)
+  {
+    return (index < view->firstLength) ? &view->first[index] : &view->second[index - view->firstLength];
+  }
+
+private:
+  sample_ring_sample_t *_buffer;
+  uint16_t              _mask;
+  std::atomic<uint32_t> _claimed; // Pushes started, the slot of `_claimed - 1` may be in the writing
+  std::atomic<uint32_t> _head;    // Pushes finished, samples below are readable
+
+  sample_ring_view_t makeView(uint32_t head, uint16_t count) const;
+};
+
+/**
+ * @brief Sample ring with its storage, `DEPTH` samples of 8 bytes.
+ */
+template <uint16_t DEPTH>
+class SampleRingBuffer : public SampleRing
+{
+  static_assert(DEPTH >= 2 && (DEPTH & (DEPTH - 1)) == 0, "Sample ring depth must be a power of two");
+
+public:
+  SampleRingBuffer() : SampleRing(_storage, DEPTH) {}
+
+private:
+  sample_ring_sample_t _storage[DEPTH];
+};
+
+#endif // SAMPLE_RING_H
+
+/* End of file -------------------------------------------------------- */
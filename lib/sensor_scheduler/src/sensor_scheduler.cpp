@@ -0,0 +1,273 @@
+/**
+ * @file       sensor_scheduler.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-09
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the sensor sampling scheduler
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "sensor_scheduler.h"
+
+/* Private defines ---------------------------------------------------- */
+#define WHEEL_SLOTS (1UL << SENSOR_SCHEDULER_WHEEL_BITS)
+#define WHEEL_MASK  (WHEEL_SLOTS - 1)
+#define WHEEL_RANGE (1UL << (SENSOR_SCHEDULER_WHEEL_BITS * SENSOR_SCHEDULER_WHEEL_LEVELS)) // Ticks
+#define TICK_US     (SENSOR_SCHEDULER_TICK_MS * 1000UL)
+#define JOB_NONE    (-1)
+
+/* Private enumerate/structure ---------------------------------------- */
+
+/* Private macros ----------------------------------------------------- */
+// Slot of `tick` in `level`
+#define WHEEL_INDEX(tick, level) (((tick) >> (SENSOR_SCHEDULER_WHEEL_BITS * (level))) & WHEEL_MASK)
+
+/* Public variables --------------------------------------------------- */
+SensorScheduler sensorScheduler;
+
+/* Private variables -------------------------------------------------- */
+
+/* Class method definitions-------------------------------------------- */
+SensorScheduler::SensorScheduler() : _lock(xSemaphoreCreateMutex())
+{
+  memset(_slots, JOB_NONE, sizeof(_slots));
+  memset(_occupied, 0, sizeof(_occupied));
+}
+
+int SensorScheduler::addJob(const char *name, sensor_scheduler_job_t job, void *context, uint32_t periodMs,
+                            uint32_t phaseMs, uint32_t deadlineMs)
+{
+  if (_started || _jobCount >= SENSOR_SCHEDULER_MAX_JOBS || job == NULL || periodMs == 0)
+  {
+    return -1;
+  }
+
+  job_t *entry = &_jobs[_jobCount];
+  memset(entry, 0, sizeof(*entry));
+  strncpy(entry->name, (name != NULL) ? name : "", sizeof(entry->name) - 1);
+  entry->job         = job;
+  entry->context     = context;
+  entry->periodTicks = (periodMs + SENSOR_SCHEDULER_TICK_MS - 1) / SENSOR_SCHEDULER_TICK_MS;
+  entry->deadlineUs  = ((deadlineMs > 0) ? deadlineMs : periodMs) * 1000UL;
+  entry->dueTick     = phaseMs / SENSOR_SCHEDULER_TICK_MS; // Tick 0 is the first call to run()
+  insert(_jobCount);
+
+  return _jobCount++;
+}
+
+uint32_t SensorScheduler::run()
+{
+  if (!_started)
+  {
+    _tickMs  = millis();
+    _tickUs  = micros();
+    _started = true;
+  }
+
+  // Expire every tick that has started, a long job only delays the ticks behind it
+  while ((int32_t) (millis() - _tickMs) >= 0)
+  {
+    expire(_tick & WHEEL_MASK);
+    _tick++;
+    _tickMs += SENSOR_SCHEDULER_TICK_MS;
+    _tickUs += TICK_US;
+
+    // Each time a level wraps, the next slot of the level above moves down
+    for (uint8_t level = 1; level < SENSOR_SCHEDULER_WHEEL_LEVELS; level++)
+    {
+      if (WHEEL_INDEX(_tick, level - 1) != 0)
+      {
+        break;
+      }
+      cascade(level);
+    }
+  }
+
+  // Sleep until the next occupied level 0 slot, at the latest until level 0 wraps
+  uint32_t offset = _tick & WHEEL_MASK;
+  uint64_t ahead  = (offset == 0) ? _occupied[0] : (_occupied[0] >> offset) | (_occupied[0] << (64 - offset));
+  uint32_t ticks  = WHEEL_SLOTS - offset;
+  if (ahead != 0 && (uint32_t) __builtin_ctzll(ahead) < ticks)
+  {
+    ticks = __builtin_ctzll(ahead);
+  }
+  int32_t waitMs = (int32_t) (_tickMs + ticks * SENSOR_SCHEDULER_TICK_MS - millis());
+
+  return (waitMs > 0) ? (uint32_t) waitMs : 0;
+}
+
+sensor_scheduler_error_t SensorScheduler::start()
+{
+  if (_jobCount == 0)
+  {
+    return SENSOR_SCHEDULER_OK;
+  }
+  if (xTaskCreate(task, "Sensor Scheduler Task", SENSOR_SCHEDULER_TASK_STACK, this,
+                  SENSOR_SCHEDULER_TASK_PRIORITY, NULL) != pdPASS)
+  {
+    return SENSOR_SCHEDULER_ERR;
+  }
+  return SENSOR_SCHEDULER_OK;
+}
+
+uint8_t SensorScheduler::jobCount() { return _jobCount; }
+
+const char *SensorScheduler::jobName(uint8_t index) { return (index < _jobCount) ? _jobs[index].name : NULL; }
+
+sensor_scheduler_error_t SensorScheduler::getJobStats(uint8_t index, sensor_scheduler_stats_t *stats)
+{
+  if (index >= _jobCount || stats == NULL)
+  {
+    return SENSOR_SCHEDULER_ERR;
+  }
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  *stats = _jobs[index].stats;
+  xSemaphoreGive(_lock);
+
+  return SENSOR_SCHEDULER_OK;
+}
+
+size_t SensorScheduler::statsToJson(const sensor_scheduler_stats_t *stats, char *buffer, size_t size)
+{
+  uint32_t average = (stats->runs > 0) ? (uint32_t) (stats->jitterTotalUs / stats->runs) : 0;
+  int      len     = snprintf(buffer, size,
+                              "{\"runs\":%lu,\"ovr\":%lu,\"skip\":%lu,\"jit\":%lu,\"jit_avg\":%lu,"
+                              "\"jit_max\":%lu,\"run\":%lu,\"run_max\":%lu}",
+                              (unsigned long) stats->runs, (unsigned long) stats->overruns,
+                              (unsigned long) stats->skipped, (unsigned long) stats->jitterLastUs,
+                              (unsigned long) average, (unsigned long) stats->jitterMaxUs,
+                              (unsigned long) stats->runLastUs, (unsigned long) stats->runMaxUs);
+
+  return (len < 0) ? 0 : (size_t) len;
+}
+
+void SensorScheduler::insert(uint8_t index)
+{
+  job_t   *job     = &_jobs[index];
+  int32_t  delta   = (int32_t) (job->dueTick - _tick);
+  uint32_t expires = job->dueTick;
+  uint8_t  level   = 0;
+
+  if (delta < 0)
+  {
+    // Already due, expire with the next tick
+    delta   = 0;
+    expires = _tick;
+  }
+  else if ((uint32_t) delta >= WHEEL_RANGE)
+  {
+    // Beyond the wheel, park in the farthest slot and reinsert when it cascades
+    delta   = WHEEL_RANGE - 1;
+    expires = _tick + delta;
+  }
+  while (level < SENSOR_SCHEDULER_WHEEL_LEVELS - 1 &&
+         (uint32_t) delta >= (1UL << (SENSOR_SCHEDULER_WHEEL_BITS * (level + 1))))
+  {
+    level++;
+  }
+
+  uint32_t slot        = WHEEL_INDEX(expires, level);
+  job->next            = _slots[level][slot];
+  _slots[level][slot]  = index;
+  _occupied[level]    |= 1ULL << slot;
+}
+
+void SensorScheduler::cascade(uint8_t level)
+{
+  uint32_t slot  = WHEEL_INDEX(_tick, level);
+  int8_t   index = _slots[level][slot];
+
+  _slots[level][slot]  = JOB_NONE;
+  _occupied[level]    &= ~(1ULL << slot);
+  while (index != JOB_NONE)
+  {
+    int8_t next = _jobs[index].next;
+    insert(index);
+    index = next;
+  }
+}
+
+void SensorScheduler::expire(uint32_t slot)
+{
+  int8_t index = _slots[0][slot];
+
+  _slots[0][slot]  = JOB_NONE;
+  _occupied[0]    &= ~(1ULL << slot);
+  while (index != JOB_NONE)
+  {
+    int8_t next = _jobs[index].next;
+    // Jobs parked early by a clamped or wrapped insert go back into the wheel
+    if ((int32_t) (_jobs[index].dueTick - _tick) > 0)
+    {
+      insert(index);
+    }
+    else
+    {
+      runJob(index);
+    }
+    index = next;
+  }
+}
+
+void SensorScheduler::runJob(uint8_t index)
+{
+  job_t   *job     = &_jobs[index];
+  uint32_t dueUs   = _tickUs - (_tick - job->dueTick) * TICK_US;
+  uint32_t startUs = micros();
+  int32_t  jitter  = (int32_t) (startUs - dueUs);
+
+  job->job(job->context);
+  uint32_t runUs = micros() - startUs;
+
+  // Keep the period grid, but do not replay periods missed while an earlier job ran long
+  uint32_t nowTick = _tick + (millis() - _tickMs) / SENSOR_SCHEDULER_TICK_MS;
+  uint32_t missed  = 0;
+  job->dueTick    += job->periodTicks;
+  if ((int32_t) (nowTick - job->dueTick) > 0)
+  {
+    missed        = (nowTick - job->dueTick) / job->periodTicks + 1;
+    job->dueTick += missed * job->periodTicks;
+  }
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  sensor_scheduler_stats_t *stats = &job->stats;
+  stats->runs++;
+  stats->skipped       += missed;
+  stats->jitterLastUs   = (jitter > 0) ? (uint32_t) jitter : 0;
+  stats->jitterTotalUs += stats->jitterLastUs;
+  stats->runLastUs      = runUs;
+  if (stats->jitterLastUs > stats->jitterMaxUs)
+  {
+    stats->jitterMaxUs = stats->jitterLastUs;
+  }
+  if (runUs > stats->runMaxUs)
+  {
+    stats->runMaxUs = runUs;
+  }
+  if (runUs > job->deadlineUs)
+  {
+    stats->overruns++;
+  }
+  xSemaphoreGive(_lock);
+
+  insert(index);
+}
+
+void SensorScheduler::task(void *pvParameters)
+{
+  SensorScheduler *scheduler = (SensorScheduler *) pvParameters;
+
+  for (;;)
+  {
+    uint32_t waitMs = scheduler->run();
+    vTaskDelay(pdMS_TO_TICKS(waitMs > 0 ? waitMs : 1));
+  }
+}
+
+/* Private function prototypes ---------------------------------------- */
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,193 @@
+/**
+ * @file       sensor_scheduler.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-09
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the sensor sampling scheduler
+ *
+ * @note       Runs every periodic sensor, display and input job from one task instead of one task and stack
+ *             per device. Jobs sit in a hierarchical timer wheel (three levels of 64 slots, 10 ms ticks,
+ *             about 43 minutes of range), so adding a job, expiring a tick and finding the next wake-up cost
+ *             the same whatever the number of jobs. Each job has a period, a phase offset and a deadline;
+ *             start jitter, run time, overruns and skipped periods are recorded per job.
+ * @example    `sensorScheduler.addJob("sht40", sht40Job, NULL, 60000, 0, 200);`
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef SENSOR_SCHEDULER_H
+  #define SENSOR_SCHEDULER_H
+
+  /* Includes ----------------------------------------------------------- */
+  #if ARDUINO >= 100
+    #include "Arduino.h"
+  #else
+    #include "WProgram.h"
+  #endif
+
+  /* Public defines ----------------------------------------------------- */
+  #define SENSOR_SCHEDULER_MAX_JOBS      24   // Jobs in the table
+  #define SENSOR_SCHEDULER_TICK_MS       10   // Wheel resolution, shortest period
+  #define SENSOR_SCHEDULER_WHEEL_BITS    6    // 64 slots per level
+  #define SENSOR_SCHEDULER_WHEEL_LEVELS  3    // 64 x 10 ms, 64 x 640 ms, 64 x 40.96 s
+  #define SENSOR_SCHEDULER_TASK_STACK    8192 // Largest stack of the tasks it replaces (LCD, button)
+  #define SENSOR_SCHEDULER_TASK_PRIORITY 2    // As the LCD task, button polling stays responsive
+  #define SENSOR_SCHEDULER_NAME_LENGTH   12   // Job name, including the terminator
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef enum
+{
+  SENSOR_SCHEDULER_OK = 0, /* No error */
+  SENSOR_SCHEDULER_ERR     /* Generic error */
+} sensor_scheduler_error_t;
+
+// Timing counters of one job
+typedef struct
+{
+  uint32_t runs;          /**< Times the job ran */
+  uint32_t overruns;      /**< Runs longer than the deadline */
+  uint32_t skipped;       /**< Periods dropped because the job started more than a period late */
+  uint32_t jitterLastUs;  /**< Start delay after the due time, last run */
+  uint32_t jitterMaxUs;   /**< Largest start delay */
+  uint64_t jitterTotalUs; /**< Sum of the start delays, for the average */
+  uint32_t runLastUs;     /**< Run time, last run */
+  uint32_t runMaxUs;      /**< Longest run time */
+} sensor_scheduler_stats_t;
+
+/**
+ * @brief  Periodic job, called from the scheduler task.
+ *
+ * @param[in]     context Pointer given to `addJob()`
+ *
+ * @attention  Jobs share one task: return quickly and keep state between calls instead of waiting in
+ *             `vTaskDelay()`, a blocked job delays every other job.
+ */
+typedef void (*sensor_scheduler_job_t)(void *context);
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/**
+ * @brief Runs periodic jobs from a hierarchical timer wheel in one task.
+ *
+ * Jobs are added before `start()`. A job whose expiry is less than 64 ticks away sits in level 0, further
+ * ones in the coarser levels, and move down a level each time the lower level wraps. The task sleeps until
+ * the next occupied level 0 slot or the next level change.
+ */
+class SensorScheduler
+{
+public:
+  SensorScheduler();
+
+  /**
+   * @brief  Adds a periodic job.
+   *
+   * @param[in]     name       Short name used in the statistics, truncated to
+   *                           `SENSOR_SCHEDULER_NAME_LENGTH - 1` characters
+   * @param[in]     job        Function to run
+   * @param[in]     context    Passed to `job`
+   * @param[in]     periodMs   Period in milliseconds, rounded up to `SENSOR_SCHEDULER_TICK_MS`
+   * @param[in]     phaseMs    Delay of the first run after `start()`, spreads jobs with the same period
+   * @param[in]     deadlineMs Longest expected run time, 0 for the period; longer runs count as overruns
+   *
+   * @attention  Call before `start()`, the table is not locked against the scheduler task.
+   *
+   * @return  Job index, or -1 when the table is full or the job is invalid.
+   */
+  int addJob(const char *name, sensor_scheduler_job_t job, void *context, uint32_t periodMs,
+             uint32_t phaseMs = 0, uint32_t deadlineMs = 0);
+
+  /**
+   * @brief  Advances the wheel to the current time and runs every job that expired.
+   *
+   * @param[in]     None
+   *
+   * @attention  Called by the scheduler task, only call it directly when the task is not started.
+   *
+   * @return  Milliseconds until the wheel needs to advance again.
+   */
+  uint32_t run();
+
+  /**
+   * @brief  Starts the scheduler task, phase offsets count from here.
+   *
+   * @param[in]     None
+   *
+   * @return
+   *  - `SENSOR_SCHEDULER_OK` : Task running, or no job to run
+   *  - `SENSOR_SCHEDULER_ERR`: Task could not be created
+   */
+  sensor_scheduler_error_t start();
+
+  /**
+   * @brief  Returns the number of jobs in the table.
+   */
+  uint8_t jobCount();
+
+  /**
+   * @brief  Returns the name of a job, or `NULL` when there is no job at `index`.
+   */
+  const char *jobName(uint8_t index);
+
+  /**
+   * @brief  Reads the counters of one job.
+   *
+   * @param[in]     index Job index returned by `addJob()`
+   * @param[out]    stats Counters
+   *
+   * @return
+   *  - `SENSOR_SCHEDULER_OK` : Success
+   *  - `SENSOR_SCHEDULER_ERR`: No job at `index`
+   */
+  sensor_scheduler_error_t getJobStats(uint8_t index, sensor_scheduler_stats_t *stats);
+
+  /**
+   * @brief  Formats counters as a compact JSON object.
+   *
+   * @param[in]     stats  Counters to format
+   * @param[out]    buffer Destination string
+   * @param[in]     size   Size of `buffer`
+   *
+   * @return  Number of characters that would have been written, as `snprintf()`.
+   */
+  static size_t statsToJson(const sensor_scheduler_stats_t *stats, char *buffer, size_t size);
+
+private:
+  typedef struct
+  {
+    char                     name[SENSOR_SCHEDULER_NAME_LENGTH];
+    sensor_scheduler_job_t   job;
+    void                    *context;
+    uint32_t                 periodTicks;
+    uint32_t                 deadlineUs;
+    uint32_t                 dueTick; // Wheel tick of the next run
+    int8_t                   next;    // Next job in the same slot, -1 ends the list
+    sensor_scheduler_stats_t stats;
+  } job_t;
+
+  SemaphoreHandle_t _lock;
+  job_t             _jobs[SENSOR_SCHEDULER_MAX_JOBS];
+  uint8_t           _jobCount = 0;
+  int8_t            _slots[SENSOR_SCHEDULER_WHEEL_LEVELS][1 << SENSOR_SCHEDULER_WHEEL_BITS];
+  uint64_t          _occupied[SENSOR_SCHEDULER_WHEEL_LEVELS]; // One bit per non-empty slot
+  uint32_t          _tick   = 0;                              // Next tick to expire
+  uint32_t          _tickMs = 0;                              // millis() of `_tick`
+  uint32_t          _tickUs = 0;                              // micros() of `_tick`, for the jitter
+  bool              _started = false;
+
+  void        insert(uint8_t index);
+  void        cascade(uint8_t level);
+  void        expire(uint32_t slot);
+  void        runJob(uint8_t index);
+  static void task(void *pvParameters);
+};
+
+extern SensorScheduler sensorScheduler;
+
+#endif // SENSOR_SCHEDULER_H
+
+/* End of file -------------------------------------------------------- */
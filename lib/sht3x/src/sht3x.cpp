@@ -25,22 +25,23 @@
 /* Private variables -------------------------------------------------- */
 
 /* Class method definitions-------------------------------------------- */
-sht3x_error_t SHT3X::begin(uint8_t i2c_addr)
+sht3x_error_t SHT3X::begin(uint8_t i2c_addr, bsp_i2c_bus_t bus)
 {
   _addr = i2c_addr;
-  return (bspI2CExist(_addr) == true) ? SHT3X_OK : SHT3X_ERR_I2C;
+  _bus  = bus;
+  return (bspI2CExist(_bus, _addr) == true) ? SHT3X_OK : SHT3X_ERR_I2C;
 }
 sht3x_error_t SHT3X::update()
 {
   uint8_t data[6];
 
-  bspI2CWriteByte(_addr, 0x2C, 0x06); // 0x2C : Clock stretching ON
+  bspI2CWriteByte(_bus, _addr, 0x2C, 0x06); // 0x2C : Clock stretching ON
                                       // 0x06 : Repeatability HIGH
   DELAY(200);
 
   // Read 6 bytes of data
   // cTemp msb, cTemp lsb, cTemp crc, humidity msb, humidity lsb, humidity crc
-  bspI2CReadBytes(_addr, data, sizeof(data));
+  bspI2CReadBytes(_bus, _addr, data, sizeof(data));
 
   DELAY(50);
 
@@ -18,6 +18,7 @@
   #else
     #include "WProgram.h"
   #endif
+  #include "bsp_i2c.h"
 
   /* Public defines ----------------------------------------------------- */
   #define SHT3X_LIB_VERSION       (F("0.1.0"))
@@ -91,6 +92,7 @@ public:
    * Configures the sensor with the specified I2C address and checks for its presence on the I2C bus.
    *
    * @param[in] i2c_addr The I2C address of the sensor (default: `SHT3X_I2C_ADDR_DEFAULT`, 0x44).
+   * @param[in] bus I2C bus the sensor is wired to (default: `BSP_I2C_BUS_0`).
    *
    * @attention Ensure the sensor is powered and connected to the I2C bus before calling.
    *
@@ -99,7 +101,7 @@ public:
    *
    *  - `SHT3X_ERR_I2C`: Sensor not found or I2C communication error
    */
-  sht3x_error_t begin(uint8_t i2c_addr = SHT3X_I2C_ADDR_DEFAULT);
+  sht3x_error_t begin(uint8_t i2c_addr = SHT3X_I2C_ADDR_DEFAULT, bsp_i2c_bus_t bus = BSP_I2C_BUS_0);
 
   /**
    * @brief Updates temperature and humidity readings from the SHT3X sensor.
@@ -159,7 +161,8 @@ public:
 private:
   float sensorValues[2] = {0}; // index 0 : Humidity
                                // index 1 : Temperature
-  uint8_t _addr;
+  uint8_t       _addr;
+  bsp_i2c_bus_t _bus = BSP_I2C_BUS_0;
 };
 
 #endif // SHT3X_H
@@ -12,8 +12,8 @@
 /* Includes ----------------------------------------------------------- */
 #include "sht4x.h"
 #include "bsp_i2c.h"
+#include "checksum.h"
 #include "config.h"
-#include "utility.h"
 
 /* Private defines ---------------------------------------------------- */
 
@@ -27,7 +27,11 @@
 
 /* Class method definitions ------------------------------------------- */
 
-sht4x_error_t SHT4X::begin() { return (bspI2CExist(SHT40_I2C_ADDR_44) == true) ? SHT4X_OK : SHT4X_ERR_I2C; }
+sht4x_error_t SHT4X::begin(bsp_i2c_bus_t bus)
+{
+  _bus = bus;
+  return (bspI2CExist(_bus, SHT40_I2C_ADDR_44) == true) ? SHT4X_OK : SHT4X_ERR_I2C;
+}
 
 sht4x_error_t SHT4X::update()
 {
@@ -78,11 +82,11 @@ sht4x_error_t SHT4X::update()
       duration = 110;
       break;
   }
-  bspI2CWriteByte(SHT40_I2C_ADDR_44, cmd, 1);
+  bspI2CWriteByte(_bus, SHT40_I2C_ADDR_44, cmd, 1);
 
   DELAY(duration);
 
-  bspI2CReadBytes(SHT40_I2C_ADDR_44, readBuffer, sizeof(readBuffer));
+  bspI2CReadBytes(_bus, SHT40_I2C_ADDR_44, readBuffer, sizeof(readBuffer));
 
   if (readBuffer[2] != crc8(readBuffer, 2) || readBuffer[5] != crc8(readBuffer + 3, 2))
   {
@@ -19,6 +19,7 @@
   #else
     #include "WProgram.h"
   #endif
+  #include "bsp_i2c.h"
 
   /* Public defines ----------------------------------------------------- */
   #define SHT4X_LIB_VERSION              (F("0.1.0"))
@@ -119,7 +120,7 @@ typedef enum
  *
  * - Sensor must be connected to a valid I2C bus at address `SHT40_I2C_ADDR_44` (0x44).
  *
- * - Depends on `utility.h` for `crc8` function and `config.h` for configuration settings.
+ * - Depends on `checksum.h` for the `crc8` function and `config.h` for configuration settings.
  */
 class SHT4X
 {
@@ -129,7 +130,7 @@ public:
    *
    * Checks for the presence of the SHT4X sensor on the I2C bus at address 0x44.
    *
-   * @param[in] None
+   * @param[in] bus I2C bus the sensor is wired to (default: `BSP_I2C_BUS_0`).
    *
    * @attention Ensure the sensor is powered and connected to the I2C bus before calling.
    *
@@ -138,7 +139,7 @@ public:
    *
    *  - `SHT4X_ERR_I2C`: Sensor not found or I2C communication error
    */
-  sht4x_error_t begin();
+  sht4x_error_t begin(bsp_i2c_bus_t bus = BSP_I2C_BUS_0);
 
   /**
    * @brief Updates temperature and humidity readings from the SHT4X sensor.
@@ -232,6 +233,8 @@ public:
   float getHumidity();
 
 private:
+  bsp_i2c_bus_t _bus = BSP_I2C_BUS_0;
+
   float sensorValue[2] = {0.f}; // Humidity: index 0
                                 // Temperature: index 1
   sht4x_precision_t _precision = SHT4X_HIGH_PRECISION;
@@ -0,0 +1,188 @@
+/**
+ * @file       telemetry_batch.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-16
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the telemetry batch
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "telemetry_batch.h"
+#include <ArduinoJson.h>
+
+/* Private defines ---------------------------------------------------- */
+#define PIECE_LENGTH 64 // Longest `,"key":value` with a 23-character key
+
+/* Private enumerate/structure ---------------------------------------- */
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+
+/* Private variables -------------------------------------------------- */
+
+/* Private function prototypes ---------------------------------------- */
+static int formatValue(char *buffer, size_t size, const telemetry_batch_entry_t *entry, bool comma);
+
+/* Class method definitions-------------------------------------------- */
+TelemetryBatch::TelemetryBatch(telemetry_batch_entry_t *entries, uint16_t capacity)
+    : _entries(entries), _capacity(capacity)
+{
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+bool TelemetryBatch::add(const char *key, float value)
+{
+  if (_count == _capacity || strlen(key) >= TELEMETRY_BATCH_KEY_LENGTH)
+  {
+    return false;
+  }
+  strcpy(_entries[_count].key, key);
+  _entries[_count].value = value;
+  _count++;
+
+  return true;
+}
+
+uint16_t TelemetryBatch::encode(uint16_t first, char *payload, size_t size)
+{
+  char     piece[PIECE_LENGTH];
+  size_t   length = 1;
+  uint16_t index  = first;
+
+  payload[0] = '{';
+  for (; index < _count; index++)
+  {
+    int pieceLength = formatValue(piece, sizeof(piece), &_entries[index], index > first);
+
+    // Keep room for the closing brace and the terminator
+    if (pieceLength < 0 || (size_t) pieceLength >= sizeof(piece) || length + pieceLength + 2 > size)
+    {
+      break;
+    }
+    memcpy(&payload[length], piece, pieceLength);
+    length += pieceLength;
+  }
+  payload[length++] = '}';
+  payload[length]   = '\0';
+
+  return index - first;
+}
+
+void TelemetryBatch::setDictionary(const char *const *keys, uint8_t count, uint8_t version)
+{
+  _dictionary        = keys;
+  _dictionaryCount   = (count <= (1 << TELEMETRY_BATCH_ID_BITS)) ? count : (1 << TELEMETRY_BATCH_ID_BITS);
+  _dictionaryVersion = version;
+}
+
+uint16_t TelemetryBatch::encodeMsgPack(uint16_t first, uint8_t *payload, size_t size, size_t *length)
+{
+  // The document holds no more pairs than the payload can, however large the batch
+  size_t              pairs = size / TELEMETRY_BATCH_MSGPACK_PAIR_MIN;
+  uint16_t            last  = (pairs < (size_t) (_count - first)) ? first + pairs : _count;
+  DynamicJsonDocument doc(JSON_ARRAY_SIZE(1 + 2 * (last - first)));
+  JsonArray           array = doc.to<JsonArray>();
+  uint16_t            index = first;
+
+  array.add(_dictionaryVersion);
+  for (; index < last; index++)
+  {
+    int32_t id = keyId(_entries[index].key);
+    if (id >= 0)
+    {
+      array.add(id);
+    }
+    else
+    {
+      // Stored as a pointer, the entry outlives the document
+      array.add((const char *) _entries[index].key);
+    }
+    array.add(_entries[index].value);
+
+    // Drop the pair again when it does not fit, the array header may also have grown by two bytes
+    if (measureMsgPack(doc) > size)
+    {
+      array.remove(array.size() - 1);
+      array.remove(array.size() - 1);
+      break;
+    }
+  }
+  *length = serializeMsgPack(doc, payload, size);
+
+  return index - first;
+}
+
+const telemetry_batch_entry_t *TelemetryBatch::entry(uint16_t index) const { return &_entries[index]; }
+
+uint16_t TelemetryBatch::count() const { return _count; }
+
+uint16_t TelemetryBatch::capacity() const { return _capacity; }
+
+void TelemetryBatch::clear() { _count = 0; }
+
+void TelemetryBatch::countPublish(uint16_t first, uint16_t count, size_t payloadLength)
+{
+  char piece[PIECE_LENGTH];
+
+  _stats.publishes++;
+  _stats.values += count;
+  _stats.bytes += TELEMETRY_BATCH_PUBLISH_OVERHEAD + payloadLength;
+
+  // One message per value would carry `{"key":value}` behind its own header and topic
+  for (uint16_t i = first; i < first + count && i < _count; i++)
+  {
+    int pieceLength = formatValue(piece, sizeof(piece), &_entries[i], false);
+    _stats.bytesSingle += TELEMETRY_BATCH_PUBLISH_OVERHEAD + 2 + ((pieceLength > 0) ? pieceLength : 0);
+  }
+}
+
+void TelemetryBatch::getStats(telemetry_batch_stats_t *stats) { *stats = _stats; }
+
+size_t TelemetryBatch::statsToJson(const telemetry_batch_stats_t *stats, char *buffer, size_t size)
+{
+  uint32_t saved = (stats->bytesSingle > stats->bytes) ? stats->bytesSingle - stats->bytes : 0;
+  int      len   = snprintf(buffer, size, "{\"pub\":%lu,\"vals\":%lu,\"pub_saved\":%lu,\"b_saved\":%lu}",
+                            (unsigned long) stats->publishes, (unsigned long) stats->values,
+                            (unsigned long) (stats->values - stats->publishes), (unsigned long) saved);
+
+  return (len < 0) ? 0 : (size_t) len;
+}
+
+int32_t TelemetryBatch::keyId(const char *key)
+{
+  for (uint8_t i = 0; i < _dictionaryCount; i++)
+  {
+    size_t length = strlen(_dictionary[i]);
+    if (strncmp(key, _dictionary[i], length) != 0)
+    {
+      continue;
+    }
+    if (key[length] == '\0')
+    {
+      return i;
+    }
+
+    // "<key>_<number>", the number above the index bits
+    char         *end    = NULL;
+    unsigned long suffix = (key[length] == '_') ? strtoul(&key[length + 1], &end, 10) : 0;
+    bool          valid  = end != NULL && end != &key[length + 1] && *end == '\0';
+    if (valid && suffix < (1UL << (31 - TELEMETRY_BATCH_ID_BITS)))
+    {
+      return (int32_t) (i | (suffix << TELEMETRY_BATCH_ID_BITS));
+    }
+  }
+
+  return -1;
+}
+
+/* Private definitions ------------------------------------------------ */
+static int formatValue(char *buffer, size_t size, const telemetry_batch_entry_t *entry, bool comma)
+{
+  return snprintf(buffer, size, "%s\"%s\":%.7g", comma ? "," : "", entry->key, entry->value);
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,201 @@
+/**
+ * @file       telemetry_batch.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-16
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the telemetry batch
+ *
+ * @note       Collects the telemetry values of one cycle and encodes them as few JSON objects as the MQTT
+ *             send buffer allows, `{"temperature":24.5,"humidity":61,...}`, instead of one publish per key.
+ *             Every publish carries an MQTT header and the topic name on top of its payload, about as long
+ *             as a value itself; the counters compare what was sent with what one publish per value would
+ *             have cost.
+ *
+ *             `encodeMsgPack()` is the binary alternative for links billed by the byte: a MsgPack array of
+ *             the dictionary version followed by key id and value pairs, `[1, 0, 24.5, 1, 61.0, ...]`. The
+ *             id of a key is its index in the dictionary given to `setDictionary()`; a key made of a
+ *             dictionary key, an underscore and a number ("soilPh_3") gets the id `index | number << 7`.
+ *             A key the dictionary does not know is sent as its name. Floats take 5 bytes and ids below
+ *             128 one, against 20 bytes or so per JSON value.
+ * @example    TelemetryBatchBuffer<64> batch;
+ *             batch.add("temperature", 24.5f);
+ *             for (uint16_t first = 0; first < batch.count(); first += used)
+ *             {
+ *               used = batch.encode(first, payload, sizeof(payload));
+ *               if (tb.sendTelemetryString(payload)) { batch.countPublish(first, used, strlen(payload)); }
+ *             }
+ *             batch.clear();
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef TELEMETRY_BATCH_H
+  #define TELEMETRY_BATCH_H
+
+  /* Includes ----------------------------------------------------------- */
+  #if ARDUINO >= 100
+    #include "Arduino.h"
+  #else
+    #include "WProgram.h"
+  #endif
+
+  /* Public defines ----------------------------------------------------- */
+  #define TELEMETRY_BATCH_KEY_LENGTH       24 // Longest key name, terminator included
+  #define TELEMETRY_BATCH_TOPIC_LENGTH     23 // "v1/devices/me/telemetry"
+  #define TELEMETRY_BATCH_PUBLISH_HEADER   4  // MQTT fixed header and topic length field, QoS 0
+  #define TELEMETRY_BATCH_PUBLISH_OVERHEAD (TELEMETRY_BATCH_PUBLISH_HEADER + TELEMETRY_BATCH_TOPIC_LENGTH)
+  #define TELEMETRY_BATCH_ID_BITS          7  // Dictionary index bits of a MsgPack key id, the suffix above
+  #define TELEMETRY_BATCH_MSGPACK_PAIR_MIN 2  // Smallest MsgPack pair, a 1-byte id and a whole value below 128
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef struct
+{
+  char  key[TELEMETRY_BATCH_KEY_LENGTH];
+  float value;
+} telemetry_batch_entry_t;
+
+typedef struct
+{
+  uint32_t publishes;   /**< Messages sent */
+  uint32_t values;      /**< Values in those messages */
+  uint32_t bytes;       /**< MQTT bytes of those messages, header and topic included */
+  uint32_t bytesSingle; /**< MQTT bytes the same values take with one message each */
+} telemetry_batch_stats_t;
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/**
+ * @brief Telemetry values of one cycle over a caller-provided array, encoded into JSON objects of bounded
+ * size.
+ */
+class TelemetryBatch
+{
+public:
+  /**
+   * @brief  Uses `entries` as the storage of the batch.
+   *
+   * @param[in]     entries  Array of `capacity` values, must outlive the batch
+   * @param[in]     capacity Values collected per cycle
+   */
+  TelemetryBatch(telemetry_batch_entry_t *entries, uint16_t capacity);
+
+  /**
+   * @brief  Adds a value to the batch.
+   *
+   * @param[in]     key   Telemetry key name
+   * @param[in]     value Telemetry value, not NAN
+   *
+   * @return  `false` when the batch is full or the key too long, the value was not added.
+   */
+  bool add(const char *key, float value);
+
+  /**
+   * @brief  Encodes the values from `first` on into one JSON object, as many as fit.
+   *
+   * @param[in]     first   Index of the first value to encode
+   * @param[out]    payload Output string
+   * @param[in]     size    Size of `payload`, the largest payload a publish can carry plus the terminator
+   *
+   * @return  Number of values encoded, at least one while `first < count()`.
+   */
+  uint16_t encode(uint16_t first, char *payload, size_t size);
+
+  /**
+   * @brief  Sets the key dictionary of `encodeMsgPack()`.
+   *
+   * @param[in]     keys    Array of `count` key names, must outlive the batch
+   * @param[in]     count   Number of keys, up to 128
+   * @param[in]     version Dictionary version, sent first in every message so the decoder can check it
+   */
+  void setDictionary(const char *const *keys, uint8_t count, uint8_t version);
+
+  /**
+   * @brief  Encodes the values from `first` on into one MsgPack array, as many as fit.
+   *
+   * @param[in]     first   Index of the first value to encode
+   * @param[out]    payload Output bytes
+   * @param[in]     size    Size of `payload`, the largest payload a publish can carry
+   * @param[out]    length  Bytes written
+   *
+   * @return  Number of values encoded, at least one while `first < count()` and `size` holds one value.
+   */
+  uint16_t encodeMsgPack(uint16_t first, uint8_t *payload, size_t size, size_t *length);
+
+  /**
+   * @brief  Returns the value at `index`, without bounds check.
+   */
+  const telemetry_batch_entry_t *entry(uint16_t index) const;
+
+  /**
+   * @brief  Returns the number of values in the batch.
+   */
+  uint16_t count() const;
+
+  /**
+   * @brief  Returns the number of values the batch can hold.
+   */
+  uint16_t capacity() const;
+
+  /**
+   * @brief  Empties the batch.
+   */
+  void clear();
+
+  /**
+   * @brief  Counts a published message of `count` values from `first` on, for the statistics.
+   *
+   * @param[in]     first         Index of its first value
+   * @param[in]     count         Number of values it carried
+   * @param[in]     payloadLength Length of its payload
+   */
+  void countPublish(uint16_t first, uint16_t count, size_t payloadLength);
+
+  /**
+   * @brief  Copies the counters.
+   */
+  void getStats(telemetry_batch_stats_t *stats);
+
+  /**
+   * @brief  Formats counters as a JSON object, e.g. `{"pub":120,"vals":960,"pub_saved":840,"b_saved":21000}`.
+   *
+   * @param[in]     stats  Counters from `getStats()`
+   * @param[out]    buffer Output string
+   * @param[in]     size   Size of `buffer`
+   *
+   * @return  Length written, as `snprintf()`.
+   */
+  static size_t statsToJson(const telemetry_batch_stats_t *stats, char *buffer, size_t size);
+
+private:
+  telemetry_batch_entry_t *_entries;
+  uint16_t                 _capacity;
+  uint16_t                 _count = 0;
+  telemetry_batch_stats_t  _stats;
+  const char *const       *_dictionary        = NULL;
+  uint8_t                  _dictionaryCount   = 0;
+  uint8_t                  _dictionaryVersion = 0;
+
+  int32_t keyId(const char *key);
+};
+
+/**
+ * @brief Telemetry batch with its storage, `VALUES` values of 28 bytes.
+ */
+template <uint16_t VALUES>
+class TelemetryBatchBuffer : public TelemetryBatch
+{
+public:
+  TelemetryBatchBuffer() : TelemetryBatch(_storage, VALUES) {}
+
+private:
+  telemetry_batch_entry_t _storage[VALUES];
+};
+
+#endif // TELEMETRY_BATCH_H
+
+/* End of file -------------------------------------------------------- */
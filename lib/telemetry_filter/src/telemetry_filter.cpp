@@ -0,0 +1,135 @@
+/**
+ * @file       telemetry_filter.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-15
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the report-by-exception telemetry filter
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "telemetry_filter.h"
+
+/* Private defines ---------------------------------------------------- */
+
+/* Private enumerate/structure ---------------------------------------- */
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+
+/* Private variables -------------------------------------------------- */
+
+/* Class method definitions-------------------------------------------- */
+TelemetryFilter::TelemetryFilter(const telemetry_filter_policy_t *policies, uint8_t count,
+                                 telemetry_filter_key_t *states, uint16_t capacity)
+    : _policies(policies), _policyCount(count), _states(states), _capacity(capacity)
+{
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+bool TelemetryFilter::accept(const char *key, float value, uint32_t nowMs)
+{
+  const telemetry_filter_policy_t *policy = findPolicy(key);
+  telemetry_filter_key_t          *state  = (policy != NULL) ? findState(key) : NULL;
+
+  if (state == NULL || !state->sent)
+  {
+    return true;
+  }
+
+  uint32_t elapsed   = nowMs - state->sentMs;
+  bool     heartbeat = policy->heartbeatMs > 0 && elapsed >= policy->heartbeatMs;
+  if (!heartbeat &&
+      (elapsed < policy->minIntervalMs || fabsf(value - state->value) <= deadband(policy, state)))
+  {
+    _stats.suppressed++;
+    return false;
+  }
+
+  return true;
+}
+
+void TelemetryFilter::commit(const char *key, float value, uint32_t nowMs)
+{
+  const telemetry_filter_policy_t *policy = findPolicy(key);
+  telemetry_filter_key_t          *state  = (policy != NULL) ? findState(key) : NULL;
+
+  _stats.sent++;
+  if (state == NULL)
+  {
+    return;
+  }
+  // Inside the deadband the value only went out because the heartbeat was due
+  if (state->sent && fabsf(value - state->value) <= deadband(policy, state))
+  {
+    _stats.heartbeats++;
+  }
+
+  state->value  = value;
+  state->sentMs = nowMs;
+  state->sent   = true;
+}
+
+void TelemetryFilter::reset() { _stateCount = 0; }
+
+void TelemetryFilter::getStats(telemetry_filter_stats_t *stats) { *stats = _stats; }
+
+size_t TelemetryFilter::statsToJson(const telemetry_filter_stats_t *stats, char *buffer, size_t size)
+{
+  int len = snprintf(buffer, size, "{\"sent\":%lu,\"hb\":%lu,\"supp\":%lu}", (unsigned long) stats->sent,
+                     (unsigned long) stats->heartbeats, (unsigned long) stats->suppressed);
+
+  return (len < 0) ? 0 : (size_t) len;
+}
+
+const telemetry_filter_policy_t *TelemetryFilter::findPolicy(const char *key)
+{
+  for (uint8_t i = 0; i < _policyCount; i++)
+  {
+    size_t length = strlen(_policies[i].key);
+    if (strncmp(key, _policies[i].key, length) == 0 && (key[length] == '\0' || key[length] == '_'))
+    {
+      return &_policies[i];
+    }
+  }
+
+  return NULL;
+}
+
+telemetry_filter_key_t *TelemetryFilter::findState(const char *key)
+{
+  for (uint16_t i = 0; i < _stateCount; i++)
+  {
+    if (strcmp(_states[i].key, key) == 0)
+    {
+      return &_states[i];
+    }
+  }
+  if (_stateCount == _capacity || strlen(key) >= TELEMETRY_FILTER_KEY_LENGTH)
+  {
+    return NULL;
+  }
+
+  telemetry_filter_key_t *state = &_states[_stateCount++];
+  memset(state, 0, sizeof(*state));
+  strcpy(state->key, key);
+
+  return state;
+}
+
+float TelemetryFilter::deadband(const telemetry_filter_policy_t *policy, const telemetry_filter_key_t *state)
+{
+  if (policy->deadbandType == TELEMETRY_FILTER_PERCENT)
+  {
+    return fabsf(state->value) * policy->deadband / 100.0f;
+  }
+
+  return policy->deadband;
+}
+
+/* Private function prototypes ---------------------------------------- */
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,174 @@
+/**
+ * @file       telemetry_filter.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-15
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the report-by-exception telemetry filter
+ *
+ * @note       Decides per key whether a new value is worth publishing. A policy gives a deadband, absolute
+ *             or in percent of the last value sent, a minimum interval between two sends and a heartbeat:
+ *             a value that left the deadband is sent once the minimum interval is over, an unchanged one
+ *             is sent again after the heartbeat, so the server never holds a value older than that.
+ *
+ *             A policy applies to the key of the same name and to the keys made of that name, an
+ *             underscore and a suffix: "soilPh" covers "soilPh_3" and "soilPh_4", each with its own
+ *             last value. Keys without a policy are always sent.
+ *
+ *             `accept()` only decides, `commit()` takes the value as sent once it reached the server or the
+ *             offline queue, so a value lost on the way is offered again the next cycle.
+ * @example    const telemetry_filter_policy_t policies[] = {
+ *               {"temperature", 0.2f, TELEMETRY_FILTER_ABSOLUTE, 30000, 600000}};
+ *             TelemetryFilterTable<8> filter(policies, 1);
+ *             if (filter.accept("temperature", 24.5f, millis()) && tb.sendTelemetryData(...))
+ *             {
+ *               filter.commit("temperature", 24.5f, millis());
+ *             }
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef TELEMETRY_FILTER_H
+  #define TELEMETRY_FILTER_H
+
+  /* Includes ----------------------------------------------------------- */
+  #if ARDUINO >= 100
+    #include "Arduino.h"
+  #else
+    #include "WProgram.h"
+  #endif
+
+  /* Public defines ----------------------------------------------------- */
+  #define TELEMETRY_FILTER_KEY_LENGTH 24 // Longest key name, terminator included
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef enum
+{
+  TELEMETRY_FILTER_ABSOLUTE = 0, /* Deadband in the unit of the value */
+  TELEMETRY_FILTER_PERCENT       /* Deadband in percent of the last value sent */
+} telemetry_filter_deadband_t;
+
+typedef struct
+{
+  const char                 *key;           /**< Key name, or prefix of `<key>_<suffix>` keys */
+  float                       deadband;      /**< Changes up to this are not sent, 0 sends every change */
+  telemetry_filter_deadband_t deadbandType;  /**< Unit of `deadband` */
+  uint32_t                    minIntervalMs; /**< Shortest time between two sends of the key */
+  uint32_t                    heartbeatMs;   /**< Longest time without a send, 0 for none */
+} telemetry_filter_policy_t;
+
+typedef struct
+{
+  char     key[TELEMETRY_FILTER_KEY_LENGTH]; /**< Key name */
+  float    value;                            /**< Last value sent */
+  uint32_t sentMs;                           /**< When it was sent */
+  bool     sent;                             /**< `value` and `sentMs` are set */
+} telemetry_filter_key_t;
+
+typedef struct
+{
+  uint32_t sent;       /**< Values committed */
+  uint32_t heartbeats; /**< Of which sent only because the heartbeat was due */
+  uint32_t suppressed; /**< Values held back */
+} telemetry_filter_stats_t;
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/**
+ * @brief Per-key deadband, rate limit and heartbeat over a table of policies and a caller-provided table
+ * of last values.
+ */
+class TelemetryFilter
+{
+public:
+  /**
+   * @brief  Uses `policies` for the keys it names and `states` for their last values.
+   *
+   * @param[in]     policies Array of `count` policies, must outlive the filter
+   * @param[in]     count    Number of policies
+   * @param[in]     states   Array of `capacity` key states, must outlive the filter
+   * @param[in]     capacity Distinct keys with a last value
+   */
+  TelemetryFilter(const telemetry_filter_policy_t *policies, uint8_t count, telemetry_filter_key_t *states,
+                  uint16_t capacity);
+
+  /**
+   * @brief  Tells whether `value` should be sent. The last value sent stays as it is until `commit()`.
+   *
+   * @param[in]     key   Telemetry key name
+   * @param[in]     value New value, not NAN
+   * @param[in]     nowMs `millis()`
+   *
+   * @attention  Not thread safe, call from the task that publishes. A key beyond the capacity of the state
+   *             table has no last value and is always sent.
+   *
+   * @return  `true` when the value is to be sent.
+   */
+  bool accept(const char *key, float value, uint32_t nowMs);
+
+  /**
+   * @brief  Takes an accepted value as the last value sent, once it was published or queued.
+   *
+   * @param[in]     key   Telemetry key name
+   * @param[in]     value Value sent
+   * @param[in]     nowMs `millis()`
+   */
+  void commit(const char *key, float value, uint32_t nowMs);
+
+  /**
+   * @brief  Forgets the last values, every key is sent at its next `accept()`.
+   */
+  void reset();
+
+  /**
+   * @brief  Copies the counters.
+   */
+  void getStats(telemetry_filter_stats_t *stats);
+
+  /**
+   * @brief  Formats counters as a JSON object, e.g. `{"sent":120,"hb":40,"supp":1100}`.
+   *
+   * @param[in]     stats  Counters from `getStats()`
+   * @param[out]    buffer Output string
+   * @param[in]     size   Size of `buffer`
+   *
+   * @return  Length written, as `snprintf()`.
+   */
+  static size_t statsToJson(const telemetry_filter_stats_t *stats, char *buffer, size_t size);
+
+private:
+  const telemetry_filter_policy_t *_policies;
+  uint8_t                          _policyCount;
+  telemetry_filter_key_t          *_states;
+  uint16_t                         _capacity;
+  uint16_t                         _stateCount = 0;
+  telemetry_filter_stats_t         _stats;
+
+  const telemetry_filter_policy_t *findPolicy(const char *key);
+  telemetry_filter_key_t          *findState(const char *key);
+  float deadband(const telemetry_filter_policy_t *policy, const telemetry_filter_key_t *state);
+};
+
+/**
+ * @brief Telemetry filter with its state table, `KEYS` keys of 36 bytes.
+ */
+template <uint16_t KEYS>
+class TelemetryFilterTable : public TelemetryFilter
+{
+public:
+  TelemetryFilterTable(const telemetry_filter_policy_t *policies, uint8_t count)
+      : TelemetryFilter(policies, count, _storage, KEYS)
+  {
+  }
+
+private:
+  telemetry_filter_key_t _storage[KEYS];
+};
+
+#endif // TELEMETRY_FILTER_H
+
+/* End of file -------------------------------------------------------- */
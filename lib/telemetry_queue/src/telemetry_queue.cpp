@@ -0,0 +1,445 @@
+/**
+ * @file       telemetry_queue.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-14
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the store-and-forward telemetry queue on LittleFS
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "telemetry_queue.h"
+#include "checksum.h"
+
+/* Private defines ---------------------------------------------------- */
+#define EVICTED_MAX  8 // Segments beyond the index deleted per begin()
+#define PEEK_RECORDS 32 // Records read from the file at a time
+
+// Record layout, little endian
+#define RECORD_TIME  0
+#define RECORD_VALUE 4
+#define RECORD_KEY   8
+#define RECORD_CRC   9
+
+/* Private enumerate/structure ---------------------------------------- */
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+TelemetryQueue telemetryQueue;
+
+/* Private variables -------------------------------------------------- */
+
+/* Private function prototypes ---------------------------------------- */
+static void     putU32(uint8_t *buffer, uint32_t value);
+static uint32_t getU32(const uint8_t *buffer);
+
+/* Class method definitions-------------------------------------------- */
+TelemetryQueue::TelemetryQueue() : _fs(NULL)
+{
+  _directory[0] = '\0';
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+telemetry_queue_error_t TelemetryQueue::begin(fs::FS &fs, const char *directory)
+{
+  if (strlen(directory) >= sizeof(_directory))
+  {
+    return TELEMETRY_QUEUE_ERR;
+  }
+
+  _fs = &fs;
+  strcpy(_directory, directory);
+  _segmentCount = 0;
+  _readOffset   = 0;
+  _keyCount     = 0;
+  _buffered     = 0;
+
+  if (!fs.exists(_directory) && !fs.mkdir(_directory))
+  {
+    return TELEMETRY_QUEUE_ERR_FS;
+  }
+  fs::File dir = fs.open(_directory);
+  if (!dir || !dir.isDirectory())
+  {
+    return TELEMETRY_QUEUE_ERR_FS;
+  }
+
+  // Index the segments by sequence, keeping the newest when there are too many
+  uint32_t evicted[EVICTED_MAX];
+  uint8_t  evictedCount = 0;
+  for (fs::File entry = dir.openNextFile(); entry; entry = dir.openNextFile())
+  {
+    const char *name  = strrchr(entry.name(), '/');
+    char       *end   = NULL;
+    name              = (name != NULL) ? name + 1 : entry.name();
+    uint32_t sequence = strtoul(name, &end, 16);
+    uint32_t size     = entry.size();
+    entry.close();
+    if (end != name + 8 || strcmp(end, ".q") != 0)
+    {
+      continue;
+    }
+
+    uint8_t index = _segmentCount;
+    while (index > 0 && _segments[index - 1].sequence > sequence)
+    {
+      index--;
+    }
+    if (_segmentCount == TELEMETRY_QUEUE_MAX_SEGMENTS)
+    {
+      if (evictedCount < EVICTED_MAX)
+      {
+        evicted[evictedCount++] = (index == 0) ? sequence : _segments[0].sequence;
+      }
+      if (index == 0)
+      {
+        continue;
+      }
+      memmove(&_segments[0], &_segments[1], (index - 1) * sizeof(segment_t));
+      index--;
+    }
+    else
+    {
+      memmove(&_segments[index + 1], &_segments[index], (_segmentCount - index) * sizeof(segment_t));
+      _segmentCount++;
+    }
+
+    // A reset during a write leaves a partial record, reads stop before it and pushes go elsewhere
+    _segments[index].sequence = sequence;
+    _segments[index].size     = size - size % TELEMETRY_QUEUE_RECORD_SIZE;
+    _segments[index].sealed   = (size % TELEMETRY_QUEUE_RECORD_SIZE) != 0;
+  }
+  dir.close();
+
+  char path[TELEMETRY_QUEUE_PATH_LENGTH];
+  for (uint8_t i = 0; i < evictedCount; i++)
+  {
+    segmentPath(path, evicted[i]);
+    fs.remove(path);
+  }
+
+  if (_segmentCount > 0)
+  {
+    _nextSequence = _segments[_segmentCount - 1].sequence + 1;
+    loadKeys();
+  }
+  else
+  {
+    // Nothing queued, the ids of an old dictionary are free again
+    keysPath(path);
+    fs.remove(path);
+  }
+
+  return TELEMETRY_QUEUE_OK;
+}
+
+telemetry_queue_error_t TelemetryQueue::push(uint32_t time, const char *key, float value)
+{
+  telemetry_queue_error_t result = TELEMETRY_QUEUE_OK;
+
+  if (_fs == NULL)
+  {
+    return TELEMETRY_QUEUE_ERR;
+  }
+
+  int16_t id = -1;
+  for (uint8_t i = 0; i < _keyCount; i++)
+  {
+    if (strcmp(_keys[i], key) == 0)
+    {
+      id = i;
+      break;
+    }
+  }
+  if (id < 0 && (id = addKey(key)) < 0)
+  {
+    return TELEMETRY_QUEUE_ERR_KEYS;
+  }
+
+  if (_buffered == TELEMETRY_QUEUE_BUFFER)
+  {
+    result = flush();
+  }
+
+  uint8_t *record = &_buffer[_buffered * TELEMETRY_QUEUE_RECORD_SIZE];
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  putU32(&record[RECORD_TIME], time);
+  putU32(&record[RECORD_VALUE], bits);
+  record[RECORD_KEY] = (uint8_t) id;
+  record[RECORD_CRC] = crc8(record, RECORD_CRC);
+  _buffered++;
+  _stats.recordsPushed++;
+
+  return result;
+}
+
+telemetry_queue_error_t TelemetryQueue::flush()
+{
+  if (_fs == NULL)
+  {
+    return TELEMETRY_QUEUE_ERR;
+  }
+  if (_buffered == 0)
+  {
+    return TELEMETRY_QUEUE_OK;
+  }
+
+  uint32_t   bytes   = _buffered * TELEMETRY_QUEUE_RECORD_SIZE;
+  segment_t *segment = (_segmentCount > 0) ? &_segments[_segmentCount - 1] : NULL;
+
+  if (segment == NULL || segment->sealed || segment->size + bytes > TELEMETRY_QUEUE_SEGMENT_SIZE)
+  {
+    // Rotate, a full queue drops its oldest segment
+    if (_segmentCount == TELEMETRY_QUEUE_MAX_SEGMENTS)
+    {
+      _stats.recordsDropped += (_segments[0].size - _readOffset) / TELEMETRY_QUEUE_RECORD_SIZE;
+      removeOldest();
+    }
+    segment           = &_segments[_segmentCount++];
+    segment->sequence = _nextSequence++;
+    segment->size     = 0;
+    segment->sealed   = false;
+  }
+
+  char path[TELEMETRY_QUEUE_PATH_LENGTH];
+  segmentPath(path, segment->sequence);
+  fs::File file    = _fs->open(path, "a");
+  size_t   written = file ? file.write(_buffer, bytes) : 0;
+  if (file)
+  {
+    file.close();
+  }
+  _buffered = 0;
+
+  segment->size += written - written % TELEMETRY_QUEUE_RECORD_SIZE;
+  if (written != bytes)
+  {
+    // Whatever part did reach the flash may end in a partial record
+    segment->sealed = true;
+    _stats.writeErrors++;
+    return TELEMETRY_QUEUE_ERR_FS;
+  }
+
+  return TELEMETRY_QUEUE_OK;
+}
+
+uint16_t TelemetryQueue::peek(telemetry_queue_record_t *records, uint16_t maxCount)
+{
+  uint8_t  data[PEEK_RECORDS * TELEMETRY_QUEUE_RECORD_SIZE];
+  uint16_t count = 0;
+  char     path[TELEMETRY_QUEUE_PATH_LENGTH];
+
+  if (_fs == NULL)
+  {
+    return 0;
+  }
+  // A failed first write leaves an empty segment behind the newer ones
+  while (_segmentCount > 1 && _readOffset >= _segments[0].size)
+  {
+    removeOldest();
+  }
+  if (_segmentCount == 0 || _readOffset >= _segments[0].size)
+  {
+    return 0;
+  }
+
+  uint32_t available = (_segments[0].size - _readOffset) / TELEMETRY_QUEUE_RECORD_SIZE;
+  if (available < maxCount)
+  {
+    maxCount = (uint16_t) available;
+  }
+
+  segmentPath(path, _segments[0].sequence);
+  fs::File file = _fs->open(path, "r");
+  if (file && file.seek(_readOffset))
+  {
+    while (count < maxCount)
+    {
+      uint16_t chunk = (maxCount - count < PEEK_RECORDS) ? maxCount - count : PEEK_RECORDS;
+      size_t   bytes = chunk * TELEMETRY_QUEUE_RECORD_SIZE;
+      if (file.read(data, bytes) != bytes)
+      {
+        break;
+      }
+      for (uint16_t i = 0; i < chunk; i++, count++)
+      {
+        const uint8_t            *record = &data[i * TELEMETRY_QUEUE_RECORD_SIZE];
+        telemetry_queue_record_t *out    = &records[count];
+        uint32_t                  bits   = getU32(&record[RECORD_VALUE]);
+
+        out->time = getU32(&record[RECORD_TIME]);
+        memcpy(&out->value, &bits, sizeof(bits));
+        out->key = NULL;
+        if (crc8(record, RECORD_CRC) == record[RECORD_CRC] && record[RECORD_KEY] < _keyCount)
+        {
+          out->key = _keys[record[RECORD_KEY]];
+        }
+        else
+        {
+          _stats.recordsCorrupt++;
+        }
+      }
+    }
+  }
+  if (file)
+  {
+    file.close();
+  }
+
+  // An unreadable segment would stall the queue for good, give its records up
+  if (count == 0 && maxCount > 0)
+  {
+    _stats.recordsDropped += available;
+    removeOldest();
+  }
+
+  return count;
+}
+
+void TelemetryQueue::pop(uint16_t count)
+{
+  if (_segmentCount == 0)
+  {
+    return;
+  }
+
+  _readOffset += count * TELEMETRY_QUEUE_RECORD_SIZE;
+  _stats.recordsPopped += count;
+  if (_readOffset < _segments[0].size)
+  {
+    return;
+  }
+
+  // Segment sent to its end, the next flush() opens a new one if it was the newest
+  removeOldest();
+  if (_segmentCount == 0 && _buffered == 0)
+  {
+    char path[TELEMETRY_QUEUE_PATH_LENGTH];
+    keysPath(path);
+    _fs->remove(path);
+    _keyCount = 0;
+  }
+}
+
+uint32_t TelemetryQueue::size()
+{
+  uint32_t bytes = _buffered * TELEMETRY_QUEUE_RECORD_SIZE;
+
+  for (uint8_t i = 0; i < _segmentCount; i++)
+  {
+    bytes += _segments[i].size;
+  }
+
+  return (bytes - ((_segmentCount > 0) ? _readOffset : 0)) / TELEMETRY_QUEUE_RECORD_SIZE;
+}
+
+void TelemetryQueue::getStats(telemetry_queue_stats_t *stats) { *stats = _stats; }
+
+void TelemetryQueue::segmentPath(char *path, uint32_t sequence)
+{
+  snprintf(path, TELEMETRY_QUEUE_PATH_LENGTH, "%s/%08lx.q", _directory, (unsigned long) sequence);
+}
+
+void TelemetryQueue::keysPath(char *path)
+{
+  snprintf(path, TELEMETRY_QUEUE_PATH_LENGTH, "%s/keys", _directory);
+}
+
+void TelemetryQueue::loadKeys()
+{
+  char path[TELEMETRY_QUEUE_PATH_LENGTH];
+  int  c;
+
+  keysPath(path);
+  fs::File file = _fs->open(path, "r");
+  if (!file)
+  {
+    return;
+  }
+
+  // Every name is written after a newline, a name torn by a reset still takes its id
+  uint8_t length = 0;
+  while ((c = file.read()) >= 0)
+  {
+    if (c == '\n')
+    {
+      if (_keyCount == TELEMETRY_QUEUE_MAX_KEYS)
+      {
+        break;
+      }
+      _keyCount++;
+      length = 0;
+    }
+    else if (_keyCount > 0 && length + 1 < TELEMETRY_QUEUE_KEY_LENGTH)
+    {
+      _keys[_keyCount - 1][length++] = (char) c;
+      _keys[_keyCount - 1][length]   = '\0';
+    }
+  }
+  file.close();
+}
+
+int16_t TelemetryQueue::addKey(const char *key)
+{
+  char   path[TELEMETRY_QUEUE_PATH_LENGTH];
+  char   line[TELEMETRY_QUEUE_KEY_LENGTH + 1];
+  size_t length = strlen(key);
+
+  if (_keyCount == TELEMETRY_QUEUE_MAX_KEYS || length == 0 || length >= TELEMETRY_QUEUE_KEY_LENGTH)
+  {
+    return -1;
+  }
+
+  // The name reaches the flash before any record using its id
+  keysPath(path);
+  fs::File file = _fs->open(path, "a");
+  if (!file)
+  {
+    return -1;
+  }
+  line[0] = '\n';
+  memcpy(&line[1], key, length);
+  size_t written = file.write((const uint8_t *) line, length + 1);
+  file.close();
+
+  // Once the newline is in the file the id is taken, keep the next ids in step with the file
+  if (written == 0)
+  {
+    return -1;
+  }
+  strcpy(_keys[_keyCount], (written == length + 1) ? key : "");
+  _keyCount++;
+
+  return (written == length + 1) ? _keyCount - 1 : -1;
+}
+
+void TelemetryQueue::removeOldest()
+{
+  char path[TELEMETRY_QUEUE_PATH_LENGTH];
+
+  segmentPath(path, _segments[0].sequence);
+  _fs->remove(path);
+  memmove(&_segments[0], &_segments[1], (_segmentCount - 1) * sizeof(segment_t));
+  _segmentCount--;
+  _readOffset = 0;
+}
+
+/* Private definitions ------------------------------------------------ */
+static void putU32(uint8_t *buffer, uint32_t value)
+{
+  buffer[0] = (uint8_t) value;
+  buffer[1] = (uint8_t) (value >> 8);
+  buffer[2] = (uint8_t) (value >> 16);
+  buffer[3] = (uint8_t) (value >> 24);
+}
+
+static uint32_t getU32(const uint8_t *buffer)
+{
+  return buffer[0] | (buffer[1] << 8) | ((uint32_t) buffer[2] << 16) | ((uint32_t) buffer[3] << 24);
+}
+
+/* End of file -------------------------------------------------------- */
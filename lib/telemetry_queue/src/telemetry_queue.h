@@ -0,0 +1,190 @@
+/**
+ * @file       telemetry_queue.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-14
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the store-and-forward telemetry queue on LittleFS
+ *
+ * @note       Holds the telemetry that could not be published, in order, until the connection is back.
+ *             Records are 10 bytes: time, value, key id and a CRC-8 over the other 9 bytes. Key names are
+ *             kept once in a dictionary file, `<directory>/keys`, one name per line, the line number being
+ *             the id. Records go to segment files, `<directory>/<sequence>.q`, oldest first; when the queue
+ *             exceeds `TELEMETRY_QUEUE_MAX_SEGMENTS` the oldest segment is dropped, so a long outage keeps
+ *             its most recent telemetry.
+ *
+ *             Reading is peek then pop: `peek()` copies the oldest records out, `pop()` drops them once
+ *             they are published. A segment is deleted when it has been popped to its end; the position
+ *             inside it is not saved, so after a reset the records of a partly sent segment are published
+ *             again. Telemetry with an explicit timestamp overwrites itself on the server, repeating it is
+ *             harmless.
+ * @example    telemetryQueue.begin(LittleFS);
+ *             telemetryQueue.push(time(NULL), "temperature", 24.5f);
+ *             telemetryQueue.flush();
+ *             uint16_t count = telemetryQueue.peek(records, 32);
+ *             if (publish(records, count)) { telemetryQueue.pop(count); }
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef TELEMETRY_QUEUE_H
+  #define TELEMETRY_QUEUE_H
+
+  /* Includes ----------------------------------------------------------- */
+  #if ARDUINO >= 100
+    #include "Arduino.h"
+  #else
+    #include "WProgram.h"
+  #endif
+
+  #include <FS.h>
+
+  /* Public defines ----------------------------------------------------- */
+  #define TELEMETRY_QUEUE_DIRECTORY    "/tlmq"
+  #define TELEMETRY_QUEUE_RECORD_SIZE  10            // Time, value, key id, CRC-8
+  #define TELEMETRY_QUEUE_SEGMENT_SIZE (8UL * 1024)  // Pushes move to a new segment past this size
+  #define TELEMETRY_QUEUE_MAX_SEGMENTS 16            // 128 KB, about 9 h of a dozen keys every 30 s
+  #define TELEMETRY_QUEUE_BUFFER       32            // Records pushed before `flush()` writes them
+  #define TELEMETRY_QUEUE_MAX_KEYS     48            // Distinct key names while records are queued
+  #define TELEMETRY_QUEUE_KEY_LENGTH   24            // Longest key name, terminator included
+  #define TELEMETRY_QUEUE_PATH_LENGTH  32
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef enum
+{
+  TELEMETRY_QUEUE_OK = 0,  /* No error */
+  TELEMETRY_QUEUE_ERR,     /* Generic error */
+  TELEMETRY_QUEUE_ERR_FS,  /* File system operation failed */
+  TELEMETRY_QUEUE_ERR_KEYS /* Key dictionary full or key name too long */
+} telemetry_queue_error_t;
+
+typedef struct
+{
+  uint32_t    time;  /**< Seconds since the epoch */
+  float       value; /**< Telemetry value */
+  const char *key;   /**< Key name, `NULL` for a record that failed its CRC, skip it but pop it */
+} telemetry_queue_record_t;
+
+typedef struct
+{
+  uint32_t recordsPushed;  /**< Records accepted by `push()` */
+  uint32_t recordsPopped;  /**< Records removed by `pop()` */
+  uint32_t recordsDropped; /**< Records lost with the oldest segment when the queue was full */
+  uint32_t recordsCorrupt; /**< Records failing their CRC */
+  uint32_t writeErrors;    /**< Failed writes, the buffered records are lost */
+} telemetry_queue_stats_t;
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/**
+ * @brief Durable FIFO of timestamped telemetry values.
+ */
+class TelemetryQueue
+{
+public:
+  TelemetryQueue();
+
+  /**
+   * @brief  Opens the queue in `directory`, creating it, and recovers the segments and the key dictionary.
+   *
+   * @param[in]     fs        Mounted file system
+   * @param[in]     directory Directory of the queue
+   *
+   * @attention  The queue has no lock: `begin()` it once, then use it from a single task.
+   *
+   * @return
+   *  - `TELEMETRY_QUEUE_OK`    : Queue ready
+   *  - `TELEMETRY_QUEUE_ERR_FS`: Directory could not be created or listed
+   */
+  telemetry_queue_error_t begin(fs::FS &fs, const char *directory = TELEMETRY_QUEUE_DIRECTORY);
+
+  /**
+   * @brief  Adds a value to the RAM buffer, writing the buffer out first when it is full.
+   *
+   * @param[in]     time  Seconds since the epoch
+   * @param[in]     key   Telemetry key name
+   * @param[in]     value Telemetry value
+   *
+   * @return
+   *  - `TELEMETRY_QUEUE_OK`      : Success
+   *  - `TELEMETRY_QUEUE_ERR`     : Queue not started
+   *  - `TELEMETRY_QUEUE_ERR_KEYS`: Key not in the dictionary and no room for it
+   *  - `TELEMETRY_QUEUE_ERR_FS`  : The full buffer could not be written, it was dropped
+   */
+  telemetry_queue_error_t push(uint32_t time, const char *key, float value);
+
+  /**
+   * @brief  Writes the RAM buffer to the newest segment.
+   *
+   * @return
+   *  - `TELEMETRY_QUEUE_OK`    : Success, or nothing to write
+   *  - `TELEMETRY_QUEUE_ERR_FS`: Write failed, the buffered records were dropped
+   */
+  telemetry_queue_error_t flush();
+
+  /**
+   * @brief  Copies the oldest records without removing them.
+   *
+   * @param[out]    records  Array of `maxCount` records
+   * @param[in]     maxCount Largest number of records to copy
+   *
+   * @attention  Stops at the end of the oldest segment and does not see the RAM buffer, `flush()` first.
+   *             The key names point into the dictionary and stay valid until the queue is empty.
+   *
+   * @return  Number of records copied, 0 when the queue is empty.
+   */
+  uint16_t peek(telemetry_queue_record_t *records, uint16_t maxCount);
+
+  /**
+   * @brief  Removes the `count` oldest records, those the last `peek()` returned and were published.
+   *
+   * @param[in]     count Number of records, at most what the last `peek()` returned
+   */
+  void pop(uint16_t count);
+
+  /**
+   * @brief  Returns the number of records queued, RAM buffer included.
+   */
+  uint32_t size();
+
+  /**
+   * @brief  Copies the counters.
+   */
+  void getStats(telemetry_queue_stats_t *stats);
+
+private:
+  typedef struct
+  {
+    uint32_t sequence;
+    uint32_t size;   // Bytes of whole records
+    bool     sealed; // Ends in a torn record, pushes go to a new segment
+  } segment_t;
+
+  fs::FS                 *_fs;
+  char                    _directory[TELEMETRY_QUEUE_PATH_LENGTH - 12];
+  segment_t               _segments[TELEMETRY_QUEUE_MAX_SEGMENTS];
+  uint8_t                 _segmentCount = 0;
+  uint32_t                _nextSequence = 0;
+  uint32_t                _readOffset   = 0; // Bytes of the oldest segment already popped
+  char                    _keys[TELEMETRY_QUEUE_MAX_KEYS][TELEMETRY_QUEUE_KEY_LENGTH];
+  uint8_t                 _keyCount = 0;
+  uint8_t                 _buffer[TELEMETRY_QUEUE_BUFFER * TELEMETRY_QUEUE_RECORD_SIZE];
+  uint8_t                 _buffered = 0;
+  telemetry_queue_stats_t _stats;
+
+  void    segmentPath(char *path, uint32_t sequence);
+  void    keysPath(char *path);
+  void    loadKeys();
+  int16_t addKey(const char *key);
+  void    removeOldest();
+};
+
+extern TelemetryQueue telemetryQueue;
+
+#endif // TELEMETRY_QUEUE_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,860 @@
+/**
+ * @file       ts_log.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-12
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the time-series log on LittleFS
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "ts_log.h"
+#include "checksum.h"
+
+/* Private defines ---------------------------------------------------- */
+#define BLOCK_MAGIC       0x4C54 // "TL"
+#define BLOCK_COMPACTED   0x01   // Block flag, the records are bucket means
+#define BLOCK_GORILLA     0x02   // Block flag, one channel in Gorilla coding, its number first
+#define SEGMENT_COMPACTED 0x01   // Segment flag, compacted blocks only
+#define SEGMENT_SEALED    0x02   // Segment flag, ends in a torn block, appends go to a new segment
+#define RECORD_MAX_LENGTH 10     // Channel, 5-byte varint, float
+#define EVICTED_MAX       8      // Segments beyond the index deleted per begin()
+
+// Block header layout, little endian
+#define HEADER_MAGIC      0
+#define HEADER_FLAGS      2
+#define HEADER_RECORDS    3
+#define HEADER_BASE       4
+#define HEADER_LENGTH     8
+#define HEADER_CRC        10
+#define GORILLA_OFFSET    (TS_LOG_BLOCK_HEADER + 1) // Gorilla coding after the channel
+
+/* Private enumerate/structure ---------------------------------------- */
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+TsLog tsLog;
+
+/* Private variables -------------------------------------------------- */
+
+/* Private function prototypes ---------------------------------------- */
+static void     putU16(uint8_t *buffer, uint16_t value);
+static void     putU32(uint8_t *buffer, uint32_t value);
+static uint16_t getU16(const uint8_t *buffer);
+static uint32_t getU32(const uint8_t *buffer);
+static uint32_t blockCrc(const uint8_t *block);
+static bool     decodeRecord(const uint8_t *block, uint16_t length, uint16_t *position, uint32_t *time,
+                             ts_log_record_t *record);
+static bool     decodeGorillaRecord(ts_log_cursor_t *cursor, ts_log_record_t *record);
+
+/* Class method definitions-------------------------------------------- */
+TsLog::TsLog() : _fs(NULL), _lock(xSemaphoreCreateMutex())
+{
+  _directory[0] = '\0';
+  memset(&_stats, 0, sizeof(_stats));
+  blockReset(&_block, 0);
+}
+
+ts_log_error_t TsLog::begin(fs::FS &fs, const char *directory)
+{
+  if (strlen(directory) >= sizeof(_directory))
+  {
+    return TS_LOG_ERR;
+  }
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  _fs = &fs;
+  strcpy(_directory, directory);
+  _segmentCount = 0;
+  blockReset(&_block, 0);
+
+  if (!fs.exists(_directory) && !fs.mkdir(_directory))
+  {
+    xSemaphoreGive(_lock);
+    return TS_LOG_ERR_FS;
+  }
+  fs::File dir = fs.open(_directory);
+  if (!dir || !dir.isDirectory())
+  {
+    xSemaphoreGive(_lock);
+    return TS_LOG_ERR_FS;
+  }
+
+  // Index the segments by sequence, keeping the newest when there are too many
+  uint32_t evicted[EVICTED_MAX];
+  uint8_t  evictedCount = 0;
+  for (fs::File entry = dir.openNextFile(); entry; entry = dir.openNextFile())
+  {
+    const char *name  = strrchr(entry.name(), '/');
+    char       *end   = NULL;
+    name              = (name != NULL) ? name + 1 : entry.name();
+    uint32_t sequence = strtoul(name, &end, 16);
+    entry.close();
+    if (end != name + 8 || strcmp(end, ".seg") != 0)
+    {
+      continue;
+    }
+
+    uint8_t index = _segmentCount;
+    while (index > 0 && _segments[index - 1].sequence > sequence)
+    {
+      index--;
+    }
+    if (_segmentCount == TS_LOG_MAX_SEGMENTS)
+    {
+      if (evictedCount < EVICTED_MAX)
+      {
+        evicted[evictedCount++] = (index == 0) ? sequence : _segments[0].sequence;
+      }
+      if (index == 0)
+      {
+        continue;
+      }
+      memmove(&_segments[0], &_segments[1], (index - 1) * sizeof(segment_t));
+      index--;
+    }
+    else
+    {
+      memmove(&_segments[index + 1], &_segments[index], (_segmentCount - index) * sizeof(segment_t));
+      _segmentCount++;
+    }
+    _segments[index].sequence = sequence;
+  }
+  dir.close();
+
+  char path[TS_LOG_PATH_LENGTH];
+  for (uint8_t i = 0; i < evictedCount; i++)
+  {
+    segmentPath(path, evicted[i], ".seg");
+    fs.remove(path);
+  }
+
+  for (uint8_t i = 0; i < _segmentCount; i++)
+  {
+    // A compaction interrupted before its rename leaves a temporary copy
+    segmentPath(path, _segments[i].sequence, ".tmp");
+    if (fs.exists(path))
+    {
+      fs.remove(path);
+    }
+    loadSegment(&_segments[i]);
+  }
+
+  // A merge interrupted after its rename leaves the previous compacted segment twice
+  for (uint8_t i = _segmentCount; i-- > 1;)
+  {
+    segment_t *previous = &_segments[i - 1];
+    if ((previous->flags & _segments[i].flags & SEGMENT_COMPACTED) && previous->firstCrc != 0 &&
+        previous->firstCrc == _segments[i].firstCrc)
+    {
+      removeSegment(i - 1);
+    }
+  }
+
+  // A segment starting with a bad block ends where the one before does
+  for (uint8_t i = 1; i < _segmentCount; i++)
+  {
+    if (_segments[i].firstTime == 0)
+    {
+      _segments[i].firstTime = _segments[i - 1].firstTime;
+    }
+  }
+
+  if (_segmentCount > 0)
+  {
+    recoverTail(&_segments[_segmentCount - 1]);
+    _nextSequence = _segments[_segmentCount - 1].sequence + 1;
+  }
+  xSemaphoreGive(_lock);
+
+  return TS_LOG_OK;
+}
+
+ts_log_error_t TsLog::append(uint8_t channel, uint32_t time, float value)
+{
+  ts_log_error_t result = TS_LOG_OK;
+
+  if (channel >= TS_LOG_CHANNELS)
+  {
+    return TS_LOG_ERR;
+  }
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  if (_fs == NULL)
+  {
+    xSemaphoreGive(_lock);
+    return TS_LOG_ERR;
+  }
+  if (!blockAdd(&_block, channel, time, value))
+  {
+    result = writeBlock();
+    blockAdd(&_block, channel, time, value);
+  }
+  _stats.recordsAppended++;
+  xSemaphoreGive(_lock);
+
+  return result;
+}
+
+ts_log_error_t TsLog::flush()
+{
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  ts_log_error_t result = (_fs != NULL) ? writeBlock() : TS_LOG_ERR;
+  xSemaphoreGive(_lock);
+
+  return result;
+}
+
+ts_log_error_t TsLog::maintain(uint32_t now)
+{
+  ts_log_error_t result = TS_LOG_ERR_IDLE;
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  if (_fs == NULL)
+  {
+    result = TS_LOG_ERR;
+  }
+  else if (_readers > 0)
+  {
+    result = TS_LOG_ERR_BUSY;
+  }
+  // Retention, the oldest segment ends where the next one starts; the active one always stays
+  else if (_segmentCount > 1 &&
+           (totalBytes() > TS_LOG_MAX_BYTES || _segments[1].firstTime + TS_LOG_MAX_AGE_S < now))
+  {
+    removeSegment(0);
+    _stats.segmentsDeleted++;
+    result = TS_LOG_OK;
+  }
+  else
+  {
+    // Compaction, oldest raw segment first once all its records are old enough
+    for (uint8_t i = 0; i + 1 < _segmentCount; i++)
+    {
+      if (!(_segments[i].flags & SEGMENT_COMPACTED))
+      {
+        if (_segments[i + 1].firstTime + TS_LOG_COMPACT_AFTER_S <= now)
+        {
+          result = compact(i);
+        }
+        break;
+      }
+    }
+  }
+  xSemaphoreGive(_lock);
+
+  return result;
+}
+
+ts_log_error_t TsLog::openCursor(ts_log_cursor_t *cursor, uint32_t fromTime, uint32_t toTime)
+{
+  if (cursor == NULL)
+  {
+    return TS_LOG_ERR;
+  }
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  if (_fs == NULL)
+  {
+    xSemaphoreGive(_lock);
+    return TS_LOG_ERR;
+  }
+
+  // Start in the last segment that begins before the range, the ones before end before it
+  uint8_t first = 0;
+  while (first + 1 < _segmentCount && _segments[first + 1].firstTime <= fromTime)
+  {
+    first++;
+  }
+  cursor->fromTime = fromTime;
+  cursor->toTime   = toTime;
+  cursor->sequence = (_segmentCount > 0) ? _segments[first].sequence : _nextSequence;
+  cursor->offset   = 0;
+  cursor->time     = 0;
+  cursor->length   = 0;
+  cursor->position = 0;
+  _readers++;
+  xSemaphoreGive(_lock);
+
+  return TS_LOG_OK;
+}
+
+ts_log_error_t TsLog::next(ts_log_cursor_t *cursor, ts_log_record_t *record)
+{
+  for (;;)
+  {
+    while (cursor->position < cursor->length)
+    {
+      bool gorilla = (cursor->block[HEADER_FLAGS] & BLOCK_GORILLA) != 0;
+      bool decoded = gorilla ? decodeGorillaRecord(cursor, record)
+                             : decodeRecord(cursor->block, cursor->length, &cursor->position, &cursor->time,
+                                            record);
+      if (!decoded)
+      {
+        cursor->position = cursor->length;
+        break;
+      }
+      if (record->time >= cursor->fromTime && record->time <= cursor->toTime)
+      {
+        return TS_LOG_OK;
+      }
+    }
+    if (loadBlock(cursor) != TS_LOG_OK)
+    {
+      return TS_LOG_ERR_END;
+    }
+  }
+}
+
+void TsLog::closeCursor(ts_log_cursor_t *cursor)
+{
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  if (_readers > 0)
+  {
+    _readers--;
+  }
+  cursor->length   = 0;
+  cursor->position = 0;
+  xSemaphoreGive(_lock);
+}
+
+uint32_t TsLog::totalBytes()
+{
+  // Also called by maintain() with the lock held, a few 32-bit reads need no lock of their own
+  uint32_t total = (_block.records > 0) ? _block.length : 0;
+
+  for (uint8_t i = 0; i < _segmentCount; i++)
+  {
+    total += _segments[i].size;
+  }
+
+  return total;
+}
+
+uint8_t TsLog::segmentCount() { return _segmentCount; }
+
+void TsLog::getStats(ts_log_stats_t *stats)
+{
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  *stats = _stats;
+  xSemaphoreGive(_lock);
+}
+
+void TsLog::segmentPath(char *path, uint32_t sequence, const char *extension)
+{
+  snprintf(path, TS_LOG_PATH_LENGTH, "%s/%08lx%s", _directory, (unsigned long) sequence, extension);
+}
+
+void TsLog::loadSegment(segment_t *segment)
+{
+  char path[TS_LOG_PATH_LENGTH];
+
+  segmentPath(path, segment->sequence, ".seg");
+  fs::File file      = _fs->open(path, "r");
+  segment->size      = file ? file.size() : 0;
+  segment->firstTime = 0;
+  segment->firstCrc  = 0;
+  segment->flags     = 0;
+  if (file && readBlock(file, _readBuffer) > 0)
+  {
+    segment->firstTime = getU32(&_readBuffer[HEADER_BASE]);
+    segment->firstCrc  = getU32(&_readBuffer[HEADER_CRC]);
+    segment->flags     = (_readBuffer[HEADER_FLAGS] & BLOCK_COMPACTED) ? SEGMENT_COMPACTED : 0;
+  }
+  if (file)
+  {
+    file.close();
+  }
+}
+
+void TsLog::recoverTail(segment_t *segment)
+{
+  char     path[TS_LOG_PATH_LENGTH];
+  uint32_t end = 0;
+  uint16_t length;
+
+  segmentPath(path, segment->sequence, ".seg");
+  fs::File file = _fs->open(path, "r");
+  if (!file)
+  {
+    return;
+  }
+  while ((length = readBlock(file, _readBuffer)) > 0)
+  {
+    end += length;
+  }
+  file.close();
+
+  // A reset during a write leaves a partial block, readers stop before it and appends go elsewhere
+  if (end != segment->size)
+  {
+    segment->flags |= SEGMENT_SEALED;
+    _stats.blocksCorrupt++;
+  }
+}
+
+void TsLog::removeSegment(uint8_t index)
+{
+  char path[TS_LOG_PATH_LENGTH];
+
+  segmentPath(path, _segments[index].sequence, ".seg");
+  _fs->remove(path);
+  memmove(&_segments[index], &_segments[index + 1], (_segmentCount - index - 1) * sizeof(segment_t));
+  _segmentCount--;
+}
+
+TsLog::segment_t *TsLog::activeSegment()
+{
+  if (_segmentCount > 0)
+  {
+    segment_t *last = &_segments[_segmentCount - 1];
+    if (!(last->flags & (SEGMENT_SEALED | SEGMENT_COMPACTED)) && last->size < TS_LOG_SEGMENT_SIZE)
+    {
+      return last;
+    }
+  }
+
+  // Rotate, a full index drops its oldest segment
+  if (_segmentCount == TS_LOG_MAX_SEGMENTS)
+  {
+    removeSegment(0);
+    _stats.segmentsDeleted++;
+  }
+  segment_t *segment = &_segments[_segmentCount++];
+  memset(segment, 0, sizeof(*segment));
+  segment->sequence = _nextSequence++;
+
+  return segment;
+}
+
+ts_log_error_t TsLog::writeBlock()
+{
+  char path[TS_LOG_PATH_LENGTH];
+
+  if (_block.records == 0)
+  {
+    return TS_LOG_OK;
+  }
+
+  blockSeal(&_block);
+  segment_t *segment = activeSegment();
+  segmentPath(path, segment->sequence, ".seg");
+  fs::File file    = _fs->open(path, "a");
+  size_t   written = file ? file.write(_block.data, _block.length) : 0;
+  if (file)
+  {
+    file.close();
+  }
+
+  if (written != _block.length)
+  {
+    // Whatever reached the flash is a torn block, close the segment behind it
+    segment->size  += written;
+    segment->flags |= SEGMENT_SEALED;
+    _stats.writeErrors++;
+    blockReset(&_block, 0);
+    return TS_LOG_ERR_FS;
+  }
+
+  if (segment->size == 0)
+  {
+    segment->firstTime = getU32(&_block.data[HEADER_BASE]);
+    segment->firstCrc  = getU32(&_block.data[HEADER_CRC]);
+  }
+  segment->size += written;
+  _stats.blocksWritten++;
+  blockReset(&_block, 0);
+
+  return TS_LOG_OK;
+}
+
+ts_log_error_t TsLog::loadBlock(ts_log_cursor_t *cursor)
+{
+  char           path[TS_LOG_PATH_LENGTH];
+  ts_log_error_t result = TS_LOG_ERR_END;
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  for (;;)
+  {
+    // Segments removed by retention since the last block are skipped
+    uint8_t index = 0;
+    while (index < _segmentCount && _segments[index].sequence < cursor->sequence)
+    {
+      index++;
+    }
+    if (index == _segmentCount)
+    {
+      break;
+    }
+    segment_t *segment = &_segments[index];
+    if (segment->sequence != cursor->sequence)
+    {
+      cursor->sequence = segment->sequence;
+      cursor->offset   = 0;
+    }
+    if (cursor->offset == 0 && segment->firstTime > cursor->toTime)
+    {
+      break;
+    }
+    if (cursor->offset >= segment->size)
+    {
+      cursor->sequence++;
+      cursor->offset = 0;
+      continue;
+    }
+
+    segmentPath(path, segment->sequence, ".seg");
+    fs::File file   = _fs->open(path, "r");
+    uint16_t length = 0;
+    if (file)
+    {
+      if (file.seek(cursor->offset))
+      {
+        length = readBlock(file, cursor->block);
+      }
+      file.close();
+    }
+    if (length == 0)
+    {
+      // Nothing readable after a bad block, go on with the next segment
+      _stats.blocksCorrupt++;
+      cursor->sequence++;
+      cursor->offset = 0;
+      continue;
+    }
+
+    cursor->offset  += length;
+    cursor->length   = length;
+    cursor->position = TS_LOG_BLOCK_HEADER;
+    cursor->time     = getU32(&cursor->block[HEADER_BASE]);
+    result           = TS_LOG_OK;
+    if ((cursor->block[HEADER_FLAGS] & BLOCK_GORILLA) && length > GORILLA_OFFSET)
+    {
+      cursor->position = GORILLA_OFFSET;
+      cursor->decoder.begin(&cursor->block[GORILLA_OFFSET], length - GORILLA_OFFSET,
+                            cursor->block[HEADER_RECORDS]);
+    }
+    break;
+  }
+  xSemaphoreGive(_lock);
+
+  return result;
+}
+
+ts_log_error_t TsLog::compact(uint8_t index)
+{
+  char     sourcePath[TS_LOG_PATH_LENGTH];
+  char     tempPath[TS_LOG_PATH_LENGTH];
+  uint16_t length;
+  bool     ok    = true;
+  bool     merge = false;
+
+  // Small compacted segments before it are merged in, one file holds days of means
+  if (index > 0 && (_segments[index - 1].flags & SEGMENT_COMPACTED) &&
+      _segments[index - 1].size + _segments[index].size / 8 < TS_LOG_SEGMENT_SIZE)
+  {
+    merge = true;
+  }
+
+  segmentPath(sourcePath, _segments[index].sequence, ".seg");
+  segmentPath(tempPath, _segments[index].sequence, ".tmp");
+  fs::File out = _fs->open(tempPath, "w");
+  if (!out)
+  {
+    return TS_LOG_ERR_FS;
+  }
+
+  if (merge)
+  {
+    char previousPath[TS_LOG_PATH_LENGTH];
+    segmentPath(previousPath, _segments[index - 1].sequence, ".seg");
+    fs::File in = _fs->open(previousPath, "r");
+    ok          = (bool) in;
+    while (ok && (length = readBlock(in, _readBuffer)) > 0)
+    {
+      ok = (out.write(_readBuffer, length) == length);
+    }
+    if (in)
+    {
+      in.close();
+    }
+  }
+
+  // One pass per channel, each channel gets blocks of its own. The first pass takes the channel of the
+  // first record, its first bucket dates the segment, and finds the other channels
+  uint32_t present = 0;
+  uint8_t  first   = TS_LOG_CHANNELS;
+  ok               = ok && compactChannel(out, sourcePath, &first, &present);
+  for (uint8_t channel = 0; ok && channel < TS_LOG_CHANNELS; channel++)
+  {
+    uint8_t current = channel;
+    if (channel != first && (present & (1UL << channel)))
+    {
+      ok = compactChannel(out, sourcePath, &current, &present);
+    }
+  }
+  out.close();
+
+  // The rename swaps the files in one step, a reset before it leaves the raw segment and a stray .tmp
+  if (!ok || !_fs->rename(tempPath, sourcePath))
+  {
+    _fs->remove(tempPath);
+    return TS_LOG_ERR_FS;
+  }
+  loadSegment(&_segments[index]);
+  _stats.segmentsCompacted++;
+  if (merge)
+  {
+    removeSegment(index - 1);
+    index--;
+  }
+  if (_segments[index].size == 0)
+  {
+    removeSegment(index);
+  }
+
+  return TS_LOG_OK;
+}
+
+bool TsLog::compactChannel(fs::File &file, const char *sourcePath, uint8_t *channel, uint32_t *present)
+{
+  bucket_t bucket = {0, 0, 0};
+  uint16_t length;
+  fs::File in = _fs->open(sourcePath, "r");
+  bool     ok = (bool) in;
+
+  // Set again by the first record when the channel is not known yet
+  compactBlockReset(*channel);
+
+  // A running mean, a record ends the bucket when it starts a newer one
+  while (ok && (length = readBlock(in, _readBuffer)) > 0)
+  {
+    ts_log_record_t record;
+    uint16_t        position = TS_LOG_BLOCK_HEADER;
+    uint32_t        time     = getU32(&_readBuffer[HEADER_BASE]);
+    while (ok && decodeRecord(_readBuffer, length, &position, &time, &record))
+    {
+      *present |= 1UL << record.channel;
+      if (*channel == TS_LOG_CHANNELS)
+      {
+        *channel = record.channel;
+        compactBlockReset(*channel);
+      }
+      if (record.channel != *channel)
+      {
+        continue;
+      }
+
+      uint32_t start = record.time - record.time % TS_LOG_COMPACT_BUCKET_S;
+      if (bucket.count > 0 && bucket.time != start)
+      {
+        ok = emitBucket(file, &bucket);
+      }
+      bucket.time   = start;
+      bucket.sum   += record.value;
+      bucket.count += 1;
+    }
+  }
+  if (in)
+  {
+    in.close();
+  }
+  if (ok && bucket.count > 0)
+  {
+    ok = emitBucket(file, &bucket);
+  }
+
+  return ok && writeCompactBlock(file);
+}
+
+bool TsLog::emitBucket(fs::File &file, bucket_t *bucket)
+{
+  float mean = bucket->sum / bucket->count;
+  bool  ok   = true;
+
+  if (_compactBlock.records == UINT8_MAX || !_compactEncoder.append(bucket->time, mean))
+  {
+    ok = writeCompactBlock(file);
+    _compactEncoder.append(bucket->time, mean);
+  }
+  if (_compactBlock.records == 0)
+  {
+    putU32(&_compactBlock.data[HEADER_BASE], bucket->time);
+  }
+  _compactBlock.records++;
+  _compactBlock.length = GORILLA_OFFSET + _compactEncoder.length();
+  bucket->sum          = 0;
+  bucket->count        = 0;
+
+  return ok;
+}
+
+void TsLog::compactBlockReset(uint8_t channel)
+{
+  blockReset(&_compactBlock, BLOCK_COMPACTED | BLOCK_GORILLA);
+  _compactBlock.data[TS_LOG_BLOCK_HEADER] = channel;
+  _compactBlock.length                    = GORILLA_OFFSET;
+  _compactEncoder.begin(&_compactBlock.data[GORILLA_OFFSET], TS_LOG_BLOCK_SIZE - GORILLA_OFFSET);
+}
+
+bool TsLog::writeCompactBlock(fs::File &file)
+{
+  if (_compactBlock.records == 0)
+  {
+    return true;
+  }
+
+  blockSeal(&_compactBlock);
+  bool ok = (file.write(_compactBlock.data, _compactBlock.length) == _compactBlock.length);
+  compactBlockReset(_compactBlock.data[TS_LOG_BLOCK_HEADER]);
+
+  return ok;
+}
+
+void TsLog::blockReset(block_t *block, uint8_t flags)
+{
+  block->length             = TS_LOG_BLOCK_HEADER;
+  block->records            = 0;
+  block->lastTime           = 0;
+  block->data[HEADER_FLAGS] = flags;
+}
+
+bool TsLog::blockAdd(block_t *block, uint8_t channel, uint32_t time, float value)
+{
+  if (block->records == UINT8_MAX || block->length + RECORD_MAX_LENGTH > TS_LOG_BLOCK_SIZE)
+  {
+    return false;
+  }
+  if (block->records == 0)
+  {
+    putU32(&block->data[HEADER_BASE], time);
+    block->lastTime = time;
+  }
+
+  // Zigzag, channels sampled a few seconds apart give small negative deltas
+  int32_t  delta   = (int32_t) (time - block->lastTime);
+  uint32_t encoded = ((uint32_t) delta << 1) ^ (uint32_t) (delta >> 31);
+  uint8_t *out     = &block->data[block->length];
+
+  *out++ = channel;
+  while (encoded >= 0x80)
+  {
+    *out++    = (uint8_t) (encoded | 0x80);
+    encoded >>= 7;
+  }
+  *out++ = (uint8_t) encoded;
+  memcpy(out, &value, sizeof(value));
+  out += sizeof(value);
+
+  block->length   = out - block->data;
+  block->lastTime = time;
+  block->records++;
+
+  return true;
+}
+
+void TsLog::blockSeal(block_t *block)
+{
+  putU16(&block->data[HEADER_MAGIC], BLOCK_MAGIC);
+  block->data[HEADER_RECORDS] = block->records;
+  putU16(&block->data[HEADER_LENGTH], block->length - TS_LOG_BLOCK_HEADER);
+  putU32(&block->data[HEADER_CRC], blockCrc(block->data));
+}
+
+uint16_t TsLog::readBlock(fs::File &file, uint8_t *buffer)
+{
+  if (file.read(buffer, TS_LOG_BLOCK_HEADER) != TS_LOG_BLOCK_HEADER ||
+      getU16(&buffer[HEADER_MAGIC]) != BLOCK_MAGIC)
+  {
+    return 0;
+  }
+
+  uint16_t length = getU16(&buffer[HEADER_LENGTH]);
+  if (length > TS_LOG_BLOCK_SIZE - TS_LOG_BLOCK_HEADER ||
+      file.read(&buffer[TS_LOG_BLOCK_HEADER], length) != length ||
+      blockCrc(buffer) != getU32(&buffer[HEADER_CRC]))
+  {
+    return 0;
+  }
+
+  return TS_LOG_BLOCK_HEADER + length;
+}
+
+/* Private definitions ------------------------------------------------ */
+static void putU16(uint8_t *buffer, uint16_t value)
+{
+  buffer[0] = (uint8_t) value;
+  buffer[1] = (uint8_t) (value >> 8);
+}
+
+static void putU32(uint8_t *buffer, uint32_t value)
+{
+  putU16(buffer, (uint16_t) value);
+  putU16(buffer + 2, (uint16_t) (value >> 16));
+}
+
+static uint16_t getU16(const uint8_t *buffer) { return buffer[0] | (buffer[1] << 8); }
+
+static uint32_t getU32(const uint8_t *buffer)
+{
+  return getU16(buffer) | ((uint32_t) getU16(buffer + 2) << 16);
+}
+
+// CRC-32 of the header up to the CRC field, then of the payload
+static uint32_t blockCrc(const uint8_t *block)
+{
+  uint32_t crc = crc32(block, HEADER_CRC);
+
+  return crc32(&block[TS_LOG_BLOCK_HEADER], getU16(&block[HEADER_LENGTH]), crc);
+}
+
+static bool decodeRecord(const uint8_t *block, uint16_t length, uint16_t *position, uint32_t *time,
+                         ts_log_record_t *record)
+{
+  uint16_t index   = *position;
+  uint32_t encoded = 0;
+
+  if (index + 1 > length)
+  {
+    return false;
+  }
+  record->channel = block[index++];
+  for (uint8_t shift = 0;; shift += 7)
+  {
+    if (index >= length || shift > 28)
+    {
+      return false;
+    }
+    uint8_t byte  = block[index++];
+    encoded      |= (uint32_t) (byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+    {
+      break;
+    }
+  }
+  if (index + sizeof(float) > length || record->channel >= TS_LOG_CHANNELS)
+  {
+    return false;
+  }
+  memcpy(&record->value, &block[index], sizeof(float));
+
+  *time            += (uint32_t) ((encoded >> 1) ^ -(encoded & 1));
+  *position         = index + sizeof(float);
+  record->time      = *time;
+  record->compacted = (block[HEADER_FLAGS] & BLOCK_COMPACTED) != 0;
+
+  return true;
+}
+
+static bool decodeGorillaRecord(ts_log_cursor_t *cursor, ts_log_record_t *record)
+{
+  record->channel   = cursor->block[TS_LOG_BLOCK_HEADER];
+  record->compacted = true;
+
+  return record->channel < TS_LOG_CHANNELS && cursor->decoder.next(&record->time, &record->value);
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,276 @@
+/**
+ * @file       ts_log.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-12
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the time-series log on LittleFS
+ *
+ * @note       Persistent sensor history as an append-only log of segment files, `<directory>/<sequence>.seg`.
+ *             A segment is a run of blocks; a block is a 14-byte header (magic, flags, record count, base
+ *             time, payload length, CRC-32 over header and payload) followed by records of 6 bytes or so:
+ *             channel, signed time delta to the previous record as a zigzag varint, float value. Records
+ *             collect in one RAM block and reach the flash a whole block at a time.
+ *
+ *             `begin()` rebuilds the segment index from the directory and checks the last segment block
+ *             by block: a block torn by a reset ends that segment and appends continue in a new one.
+ *             `maintain()` runs one step of background work at a time: deleting the oldest segment beyond the
+ *             size or age limit, or compacting the oldest raw segment past `TS_LOG_COMPACT_AFTER_S` into one
+ *             mean per channel per `TS_LOG_COMPACT_BUCKET_S`, merged into the compacted segment before it. A
+ *             compacted segment replaces the raw one by a rename, so a reset leaves the old or the new file.
+ *             Its blocks hold one channel each in Gorilla coding (gorilla.h), the evenly spaced means cost a
+ *             bit of timestamp and the changed bits of their value, about two thirds of the raw record size.
+ *
+ *             A `ts_log_cursor_t` streams a time range back out through one block buffer.
+ * @example    tsLog.begin(LittleFS);
+ *             tsLog.append(DATA_HUB_TEMPERATURE, time(NULL), 24.5f);
+ *             tsLog.openCursor(&cursor, from, to);
+ *             while (tsLog.next(&cursor, &record) == TS_LOG_OK) { ... }
+ *             tsLog.closeCursor(&cursor);
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef TS_LOG_H
+  #define TS_LOG_H
+
+  /* Includes ----------------------------------------------------------- */
+  #if ARDUINO >= 100
+    #include "Arduino.h"
+  #else
+    #include "WProgram.h"
+  #endif
+
+  #include "gorilla.h"
+  #include <FS.h>
+
+  /* Public defines ----------------------------------------------------- */
+  #define TS_LOG_DIRECTORY        "/tslog"
+  #define TS_LOG_BLOCK_SIZE       512             // Largest block with its header, the RAM of a buffer
+  #define TS_LOG_BLOCK_HEADER     14              // Bytes of a block header
+  #define TS_LOG_SEGMENT_SIZE     (16UL * 1024)   // Appends move to a new segment past this size, ~5 h raw
+  #define TS_LOG_MAX_SEGMENTS     64              // Segments in the RAM index, the oldest goes beyond
+  #define TS_LOG_MAX_BYTES        (192UL * 1024)  // Retention by size, the web UI shares the partition
+  #define TS_LOG_MAX_AGE_S        (120UL * 86400) // Retention by age
+  #define TS_LOG_COMPACT_AFTER_S  (6UL * 3600)    // Raw records older than this are downsampled
+  #define TS_LOG_COMPACT_BUCKET_S 1800            // One mean per channel per bucket once compacted
+  #define TS_LOG_CHANNELS         16              // Channel numbers 0 to TS_LOG_CHANNELS - 1
+  #define TS_LOG_PATH_LENGTH      32
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef enum
+{
+  TS_LOG_OK = 0,   /* No error */
+  TS_LOG_ERR,      /* Generic error */
+  TS_LOG_ERR_FS,   /* File system operation failed */
+  TS_LOG_ERR_END,  /* Cursor: no more records in the range */
+  TS_LOG_ERR_IDLE, /* maintain(): nothing to do */
+  TS_LOG_ERR_BUSY  /* maintain(): a cursor is open, files are left alone */
+} ts_log_error_t;
+
+typedef struct
+{
+  uint32_t time;      /**< Seconds since the epoch */
+  float    value;     /**< Measurement, or the bucket mean of a compacted record */
+  uint8_t  channel;   /**< Channel given to `append()` */
+  bool     compacted; /**< `time` is the start of a `TS_LOG_COMPACT_BUCKET_S` bucket */
+} ts_log_record_t;
+
+// Read position in the log, holds one block
+typedef struct
+{
+  uint32_t       fromTime;
+  uint32_t       toTime;
+  uint32_t       sequence; // Segment being read
+  uint32_t       offset;   // Next block in the segment
+  uint32_t       time;     // Time of the last decoded record
+  uint16_t       length;   // Block bytes in `block`
+  uint16_t       position; // Next record in `block`
+  GorillaDecoder decoder;  // Records of a Gorilla block
+  uint8_t        block[TS_LOG_BLOCK_SIZE];
+} ts_log_cursor_t;
+
+typedef struct
+{
+  uint32_t recordsAppended;   /**< Records accepted by `append()` */
+  uint32_t blocksWritten;     /**< Blocks appended to segments */
+  uint32_t blocksCorrupt;     /**< Blocks failing the CRC or cut short, at recovery or read */
+  uint32_t writeErrors;       /**< Failed block writes, the block is dropped */
+  uint32_t segmentsDeleted;   /**< Segments removed by retention */
+  uint32_t segmentsCompacted; /**< Raw segments downsampled */
+} ts_log_stats_t;
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/**
+ * @brief Append-only, segmented time-series log with retention and compaction.
+ */
+class TsLog
+{
+public:
+  TsLog();
+
+  /**
+   * @brief  Opens the log in `directory`, creating it, and recovers the segment index.
+   *
+   * @param[in]     fs        Mounted file system
+   * @param[in]     directory Directory of the segments
+   *
+   * @return
+   *  - `TS_LOG_OK`    : Log ready
+   *  - `TS_LOG_ERR_FS`: Directory could not be created or listed
+   */
+  ts_log_error_t begin(fs::FS &fs, const char *directory = TS_LOG_DIRECTORY);
+
+  /**
+   * @brief  Adds a record to the RAM block, writing the block out first when it is full.
+   *
+   * @param[in]     channel Channel number, below `TS_LOG_CHANNELS`
+   * @param[in]     time    Seconds since the epoch
+   * @param[in]     value   Measurement
+   *
+   * @attention  Keep each channel in time order, channels may interleave a few seconds apart.
+   *
+   * @return
+   *  - `TS_LOG_OK`    : Success
+   *  - `TS_LOG_ERR`   : Log not started or invalid channel
+   *  - `TS_LOG_ERR_FS`: The full block could not be written, it was dropped
+   */
+  ts_log_error_t append(uint8_t channel, uint32_t time, float value);
+
+  /**
+   * @brief  Writes the RAM block out, records appended before are then safe from a reset.
+   *
+   * @return
+   *  - `TS_LOG_OK`    : Success, or nothing to write
+   *  - `TS_LOG_ERR_FS`: Write failed, the block was dropped
+   */
+  ts_log_error_t flush();
+
+  /**
+   * @brief  Runs one step of retention or compaction.
+   *
+   * @param[in]     now Current time, seconds since the epoch
+   *
+   * @attention  A step can read a whole segment and write its compacted copy: call from a low priority
+   *             task, as long as it returns `TS_LOG_OK`.
+   *
+   * @return
+   *  - `TS_LOG_OK`      : One segment deleted or compacted
+   *  - `TS_LOG_ERR_IDLE`: Nothing to do
+   *  - `TS_LOG_ERR_BUSY`: A cursor is open
+   *  - `TS_LOG_ERR_FS`  : Compaction failed, the raw segment is kept
+   */
+  ts_log_error_t maintain(uint32_t now);
+
+  /**
+   * @brief  Starts reading the records timestamped within [`fromTime`, `toTime`].
+   *
+   * @attention  Records still in the RAM block are not seen, `flush()` first. Compaction and retention
+   *             wait until `closeCursor()`, always close a cursor.
+   *
+   * @return
+   *  - `TS_LOG_OK` : Success
+   *  - `TS_LOG_ERR`: Log not started or `NULL` cursor
+   */
+  ts_log_error_t openCursor(ts_log_cursor_t *cursor, uint32_t fromTime, uint32_t toTime);
+
+  /**
+   * @brief  Reads the next record of the cursor range, oldest first within a channel.
+   *
+   * @attention  A compacted segment gives its channels one after the other, merge by time when needed.
+   *
+   * @return
+   *  - `TS_LOG_OK`     : `record` filled
+   *  - `TS_LOG_ERR_END`: No more records
+   */
+  ts_log_error_t next(ts_log_cursor_t *cursor, ts_log_record_t *record);
+
+  /**
+   * @brief  Ends a read started by `openCursor()`.
+   */
+  void closeCursor(ts_log_cursor_t *cursor);
+
+  /**
+   * @brief  Returns the bytes used by the segments and the RAM block.
+   */
+  uint32_t totalBytes();
+
+  /**
+   * @brief  Returns the number of segments.
+   */
+  uint8_t segmentCount();
+
+  /**
+   * @brief  Copies the counters.
+   */
+  void getStats(ts_log_stats_t *stats);
+
+private:
+  typedef struct
+  {
+    uint32_t sequence;
+    uint32_t firstTime; // Base time of the first block, the end of the segment before
+    uint32_t firstCrc;  // CRC of the first block, finds the leftover of an interrupted merge
+    uint32_t size;
+    uint8_t  flags;
+  } segment_t;
+
+  // Block being filled
+  typedef struct
+  {
+    uint8_t  data[TS_LOG_BLOCK_SIZE];
+    uint16_t length; // Header included
+    uint8_t  records;
+    uint32_t lastTime;
+  } block_t;
+
+  // Running mean of one channel while compacting
+  typedef struct
+  {
+    uint32_t time; // Start of the bucket
+    float    sum;
+    uint16_t count;
+  } bucket_t;
+
+  fs::FS           *_fs;
+  char              _directory[TS_LOG_PATH_LENGTH - 14];
+  SemaphoreHandle_t _lock;
+  segment_t         _segments[TS_LOG_MAX_SEGMENTS];
+  uint8_t           _segmentCount = 0;
+  uint32_t          _nextSequence = 0;
+  uint8_t           _readers      = 0;
+  block_t           _block;
+  block_t           _compactBlock;
+  GorillaEncoder    _compactEncoder;
+  uint8_t           _readBuffer[TS_LOG_BLOCK_SIZE];
+  ts_log_stats_t    _stats;
+
+  void           segmentPath(char *path, uint32_t sequence, const char *extension);
+  void           loadSegment(segment_t *segment);
+  void           recoverTail(segment_t *segment);
+  void           removeSegment(uint8_t index);
+  segment_t     *activeSegment();
+  ts_log_error_t writeBlock();
+  ts_log_error_t loadBlock(ts_log_cursor_t *cursor);
+  ts_log_error_t compact(uint8_t index);
+  bool           compactChannel(fs::File &file, const char *sourcePath, uint8_t *channel, uint32_t *present);
+  bool           emitBucket(fs::File &file, bucket_t *bucket);
+  void           compactBlockReset(uint8_t channel);
+  bool           writeCompactBlock(fs::File &file);
+
+  static void     blockReset(block_t *block, uint8_t flags);
+  static bool     blockAdd(block_t *block, uint8_t channel, uint32_t time, float value);
+  static void     blockSeal(block_t *block);
+  static uint16_t readBlock(fs::File &file, uint8_t *buffer);
+};
+
+extern TsLog tsLog;
+
+#endif // TS_LOG_H
+
+/* End of file -------------------------------------------------------- */
@@ -23,9 +23,16 @@
 /* Private variables -------------------------------------------------- */
 
 /* Class method definitions-------------------------------------------- */
-unit_4relay_error_t Unit4Relay::begin()
+unit_4relay_error_t Unit4Relay::begin(bsp_i2c_bus_t bus)
 {
-  if (!bspI2CExist(UNIT_4RELAY_I2C_ADDR))
+  _bus = bus;
+  if (!bspI2CExist(_bus, UNIT_4RELAY_I2C_ADDR))
+  {
+    return UNIT_4RELAY_ERR_I2C;
+  }
+
+  // Relay/LED latch reads back what was written, cache it instead of reading before every change
+  if (bspI2CShadowAttach(_bus, UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG) != BSP_I2C_OK)
   {
     return UNIT_4RELAY_ERR_I2C;
   }
@@ -35,12 +42,12 @@ unit_4relay_error_t Unit4Relay::begin()
 
 unit_4relay_error_t Unit4Relay::init(bool mode)
 {
-  if (bspI2CWriteByte(UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_REG, mode) != BSP_I2C_OK)
+  if (bspI2CWriteByte(_bus, UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_REG, mode) != BSP_I2C_OK)
   {
     return UNIT_4RELAY_ERR_INIT;
   }
 
-  if (bspI2CWriteByte(UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, 0) != BSP_I2C_OK)
+  if (bspI2CWriteByte(_bus, UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, 0) != BSP_I2C_OK)
   {
     return UNIT_4RELAY_ERR_INIT;
   }
@@ -48,86 +55,69 @@ unit_4relay_error_t Unit4Relay::init(bool mode)
   return UNIT_4RELAY_OK;
 }
 
-unit_4relay_error_t Unit4Relay::relayWrite(uint8_t number, bool state)
+unit_4relay_error_t Unit4Relay::relayWrite(uint8_t number, bool state, bool flush)
 {
   if (number >= UNIT_4RELAY_MAX_RELAYS)
   {
     return UNIT_4RELAY_ERR_INDEX;
   }
 
-  uint8_t stateFromDevice;
-
-  bspI2CReadByte(UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, stateFromDevice);
-
-  if (state == 0)
-  {
-    stateFromDevice &= ~(0x01 << number);
-  }
-  else
-  {
-    stateFromDevice |= (0x01 << number);
-  }
-
   relayState[number] = state;
+  bspI2CShadowUpdate(_bus, UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, 0x01 << number, state ? 0xFF : 0x00);
 
-  bspI2CWriteByte(UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, stateFromDevice);
-
-  return UNIT_4RELAY_OK;
+  return flush ? this->flush() : UNIT_4RELAY_OK;
 }
 
 unit_4relay_error_t Unit4Relay::relayAll(bool state)
 {
-  bspI2CWriteByte(UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, state * (0x0f));
-
   for (int i = 0; i < UNIT_4RELAY_MAX_RELAYS; i++)
   {
     relayState[i] = state;
   }
+  bspI2CShadowUpdate(_bus, UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, UNIT_4RELAY_RELAY_MASK,
+                     state ? 0xFF : 0x00);
 
-  return UNIT_4RELAY_OK;
+  return flush();
 }
 
-unit_4relay_error_t Unit4Relay::ledWrite(uint8_t number, bool state)
+unit_4relay_error_t Unit4Relay::ledWrite(uint8_t number, bool state, bool flush)
 {
   if (number >= UNIT_4RELAY_MAX_RELAYS)
   {
     return UNIT_4RELAY_ERR_INDEX;
   }
 
-  uint8_t stateFromDevice;
-
-  bspI2CReadByte(UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, stateFromDevice);
-  if (state == 0)
-  {
-    stateFromDevice &= ~(UNIT_4RELAY_REG << number);
-  }
-  else
-  {
-    stateFromDevice |= (UNIT_4RELAY_REG << number);
-  }
-
   ledState[number] = state;
+  bspI2CShadowUpdate(_bus, UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, 0x10 << number, state ? 0xFF : 0x00);
 
-  bspI2CWriteByte(UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, stateFromDevice);
-
-  return UNIT_4RELAY_OK;
+  return flush ? this->flush() : UNIT_4RELAY_OK;
 }
 
 unit_4relay_error_t Unit4Relay::ledAll(bool state)
 {
-  bspI2CWriteByte(UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, state * (0xf0));
-
   for (int i = 0; i < UNIT_4RELAY_MAX_RELAYS; i++)
   {
     ledState[i] = state;
   }
+  bspI2CShadowUpdate(_bus, UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, UNIT_4RELAY_LED_MASK,
+                     state ? 0xFF : 0x00);
+
+  return flush();
+}
+
+unit_4relay_error_t Unit4Relay::flush(void)
+{
+  if (bspI2CShadowFlush(_bus, UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG) != BSP_I2C_OK)
+  {
+    return UNIT_4RELAY_ERR_I2C;
+  }
 
   return UNIT_4RELAY_OK;
 }
 
 unit_4relay_error_t Unit4Relay::switchMode(bool mode)
 {
-  bspI2CWriteByte(UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_REG, mode);
+  bspI2CWriteByte(_bus, UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_REG, mode);
 
   return UNIT_4RELAY_OK;
 }
@@ -174,11 +164,9 @@ unit_4relay_error_t Unit4Relay::applyRelayState()
       stateByte |= (0x01 << i);
     }
   }
-  if (bspI2CWriteByte(UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, stateByte) != BSP_I2C_OK)
-  {
-    return UNIT_4RELAY_ERR_I2C;
-  }
-  return UNIT_4RELAY_OK;
+  bspI2CShadowUpdate(_bus, UNIT_4RELAY_I2C_ADDR, UNIT_4RELAY_RELAY_REG, UNIT_4RELAY_RELAY_MASK, stateByte);
+
+  return flush();
 }
 /* Private function prototypes ---------------------------------------- */
 
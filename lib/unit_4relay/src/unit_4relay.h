@@ -18,6 +18,7 @@
   #else
     #include "WProgram.h"
   #endif
+  #include "bsp_i2c.h"
 
   /* Public defines ----------------------------------------------------- */
   #define UNIT_4RELAY_LIB_VERSION (F("0.1.0"))
@@ -27,6 +28,8 @@
   #define UNIT_4RELAY_RELAY_REG   0x11
 
   #define UNIT_4RELAY_MAX_RELAYS  4
+  #define UNIT_4RELAY_RELAY_MASK  0x0F // Relay bits of UNIT_4RELAY_RELAY_REG
+  #define UNIT_4RELAY_LED_MASK    0xF0 // LED bits of UNIT_4RELAY_RELAY_REG
 /* Public enumerate/structure ----------------------------------------- */
 
 /**
@@ -90,7 +93,7 @@ public:
    *
    * Checks for the presence of the module on the I2C bus at address 0x26.
    *
-   * @param[in] None
+   * @param[in] bus I2C bus the module is wired to (default: `BSP_I2C_BUS_0`).
    *
    * @attention Ensure the module is powered and connected to the I2C bus before calling.
    *
@@ -99,7 +102,7 @@ public:
    *
    *  - `UNIT_4RELAY_ERR_I2C`: Module not found or I2C communication error
    */
-  unit_4relay_error_t begin();
+  unit_4relay_error_t begin(bsp_i2c_bus_t bus = BSP_I2C_BUS_0);
 
   /**
    * @brief Configures the operating mode and turns off all relays.
@@ -124,10 +127,12 @@ public:
   /**
    * @brief Sets the state of an individual relay.
    *
-   * Turns a specified relay ON or OFF by updating the I2C register and internal state.
+   * Turns a specified relay ON or OFF by updating the I2C register and internal state. The register is
+   * shadowed by bsp_i2c, so the other relay and LED bits are merged locally instead of being read back.
    *
    * @param[in] number Relay index (0–3).
    * @param[in] state Desired state (`true` for ON, `false` for OFF).
+   * @param[in] flush Write the register now, pass `false` to batch several changes and call `flush()` once.
    *
    * @attention Ensure the relay index is valid (0–3).
    *
@@ -135,8 +140,10 @@ public:
    *  - `UNIT_4RELAY_OK`: Success
    *
    *  - `UNIT_4RELAY_ERR_INDEX`: Invalid relay index
+   *
+   *  - `UNIT_4RELAY_ERR_I2C`: I2C communication error
    */
-  unit_4relay_error_t relayWrite(uint8_t number, bool state);
+  unit_4relay_error_t relayWrite(uint8_t number, bool state, bool flush = true);
 
   /**
    * @brief Sets all relays to the same state.
@@ -157,14 +164,28 @@ public:
    *
    * @param[in] number LED index (0–3).
    * @param[in] state Desired state (`true` for ON, `false` for OFF).
+   * @param[in] flush Write the register now, pass `false` to batch several changes and call `flush()` once.
    *
    * @attention Ensure the LED index is valid (0–3).
    *
    * @return
    *  - `UNIT_4RELAY_OK`: Success
    *  - `UNIT_4RELAY_ERR_INDEX`: Invalid LED index
+   *  - `UNIT_4RELAY_ERR_I2C`: I2C communication error
+   */
+  unit_4relay_error_t ledWrite(uint8_t number, bool state, bool flush = true);
+
+  /**
+   * @brief Writes the relay and LED changes staged with `flush = false`.
+   *
+   * Issues a single register write, or nothing when no change is pending.
+   *
+   * @return
+   *  - `UNIT_4RELAY_OK`: Success
+   *
+   *  - `UNIT_4RELAY_ERR_I2C`: I2C communication error
    */
-  unit_4relay_error_t ledWrite(uint8_t number, bool state);
+  unit_4relay_error_t flush(void);
 
   /**
    * @brief Sets all LEDs to the same state.
@@ -262,8 +283,9 @@ public:
   unit_4relay_error_t applyRelayState();
 
 private:
-  bool relayState[4] = {false};
-  bool ledState[4]   = {false};
+  bsp_i2c_bus_t _bus          = BSP_I2C_BUS_0;
+  bool          relayState[4] = {false};
+  bool          ledState[4]   = {false};
 };
 
 #endif // UNIT_4RELAY_H
@@ -70,34 +70,6 @@ void scanI2CDevices()
   delay(2000); // wait 2 seconds for next scan
 }
 
-uint8_t crc8(const uint8_t *data, int len)
-{
-  /*
-   *
-   * CRC-8 formula from page 9/17 of SHT40 datasheet
-   *
-   * Test data 0xBE, 0xEF should yield 0x92
-   *
-   * Initialization data 0xFF
-   * Polynomial 0x31 (x8 + x5 +x4 +1)
-   * Final XOR 0x00
-   */
-
-  const uint8_t POLYNOMIAL(0x31);
-  uint8_t       crc(0xFF);
-
-  for (int j = len; j; --j)
-  {
-    crc ^= *data++;
-
-    for (int i = 8; i; --i)
-    {
-      crc = (crc & 0x80) ? (crc << 1) ^ POLYNOMIAL : (crc << 1);
-    }
-  }
-  return crc;
-}
-
 int compareVersion(String v1, String v2)
 {
   int parts1[3] = {0}, parts2[3] = {0};
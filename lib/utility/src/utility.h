@@ -72,30 +72,6 @@
  */
 void scanI2CDevices(void);
 
-/**
- * @brief  Calculates CRC-8 checksum for the given data using SHT40's polynomial.
- *
- * This function computes an 8-bit CRC checksum using the polynomial defined in the SHT40
- * datasheet. It is used to verify data integrity when reading from the SHT40 sensor.
- *
- * The CRC-8 parameters are:
- *   - Initialization value: 0xFF
- *   - Polynomial: 0x31 (x⁸ + x⁵ + x⁴ + 1)
- *   - No final XOR (0x00)
- *
- * Example from datasheet: For data bytes {0xBE, 0xEF}, the CRC result is 0x92.
- *
- * @param[in]     data  Pointer to the input data buffer.
- * @param[in]     len   Length of the data buffer in bytes.
- *
- * @attention  Ensure that `data` points to a valid memory location of at least `len` bytes.
- *             This function does not perform bounds checking.
- *
- * @return
- *  - CRC-8 checksum as an 8-bit unsigned integer.
- */
-uint8_t crc8(const uint8_t *data, int len);
-
 /**
  * @brief  Compares two firmware version strings.
  *
@@ -0,0 +1,96 @@
+/**
+ * @file       window_agg.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-19
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the windowed sample aggregator
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "window_agg.h"
+
+/* Private defines ---------------------------------------------------- */
+
+/* Private enumerate/structure ---------------------------------------- */
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+
+/* Private variables -------------------------------------------------- */
+
+/* Class method definitions-------------------------------------------- */
+WindowAggregator::WindowAggregator() : _lock(xSemaphoreCreateMutex())
+{
+  memset(_windows, 0, sizeof(_windows));
+}
+
+window_agg_error_t WindowAggregator::add(uint8_t channel, float value)
+{
+  if (channel >= WINDOW_AGG_MAX_CHANNELS)
+  {
+    return WINDOW_AGG_ERR;
+  }
+
+  uint32_t       now    = millis();
+  accumulator_t *window = &_windows[channel];
+
+  // Held for a few stores, the sampling job and the consumer run on different cores
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  if (window->count == 0)
+  {
+    window->min     = value;
+    window->max     = value;
+    window->sum     = 0.0f;
+    window->startMs = now;
+  }
+  else
+  {
+    window->min = (value < window->min) ? value : window->min;
+    window->max = (value > window->max) ? value : window->max;
+  }
+  if (window->count < UINT16_MAX)
+  {
+    window->sum += value;
+    window->count++;
+  }
+  window->last   = value;
+  window->lastMs = now;
+  xSemaphoreGive(_lock);
+
+  return WINDOW_AGG_OK;
+}
+
+window_agg_error_t WindowAggregator::take(uint8_t channel, window_agg_t *window)
+{
+  if (channel >= WINDOW_AGG_MAX_CHANNELS || window == NULL)
+  {
+    return WINDOW_AGG_ERR;
+  }
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  accumulator_t current   = _windows[channel];
+  _windows[channel].count = 0;
+  xSemaphoreGive(_lock);
+
+  if (current.count == 0)
+  {
+    return WINDOW_AGG_ERR_EMPTY;
+  }
+  window->min     = current.min;
+  window->max     = current.max;
+  window->mean    = current.sum / current.count;
+  window->last    = current.last;
+  window->count   = current.count;
+  window->startMs = current.startMs;
+  window->lastMs  = current.lastMs;
+
+  return WINDOW_AGG_OK;
+}
+
+/* Private function prototypes ---------------------------------------- */
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,110 @@
+/**
+ * @file       window_agg.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-19
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the windowed sample aggregator
+ *
+ * @note       Folds every sample of a channel into running minimum, maximum, sum, count and last value, a
+ *             few words per channel whatever the sampling rate. The consumer takes the aggregate of the
+ *             window once per send interval, which starts the next window: a sensor sampled every 2 s and
+ *             sent every 30 s reports the spike between two sends in its maximum instead of losing it.
+ * @example    windows.add(channel, value); // Sampling job, every sample
+ *             if (windows.take(channel, &window) == WINDOW_AGG_OK) { ... window.max ... }
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef WINDOW_AGG_H
+  #define WINDOW_AGG_H
+
+  /* Includes ----------------------------------------------------------- */
+  #if ARDUINO >= 100
+    #include "Arduino.h"
+  #else
+    #include "WProgram.h"
+  #endif
+
+  /* Public defines ----------------------------------------------------- */
+  #define WINDOW_AGG_MAX_CHANNELS 16 // Channel numbers 0 to WINDOW_AGG_MAX_CHANNELS - 1
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef enum
+{
+  WINDOW_AGG_OK = 0,   /* No error */
+  WINDOW_AGG_ERR,      /* Invalid channel or `NULL` window */
+  WINDOW_AGG_ERR_EMPTY /* No sample since the last take */
+} window_agg_error_t;
+
+typedef struct
+{
+  float    min;     /**< Smallest sample of the window */
+  float    max;     /**< Largest sample of the window */
+  float    mean;    /**< Mean of the samples of the window */
+  float    last;    /**< Newest sample */
+  uint16_t count;   /**< Samples in the window, the mean stops taking new ones at `UINT16_MAX` */
+  uint32_t startMs; /**< `millis()` of the first sample */
+  uint32_t lastMs;  /**< `millis()` of the newest sample */
+} window_agg_t;
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Class Declaration -------------------------------------------------- */
+
+/**
+ * @brief Running min/max/mean/count/last of every channel since the consumer last took it.
+ */
+class WindowAggregator
+{
+public:
+  WindowAggregator();
+
+  /**
+   * @brief  Adds a sample to the current window of a channel.
+   *
+   * @param[in]     channel Channel number
+   * @param[in]     value   Sample, not NAN
+   *
+   * @return
+   *  - `WINDOW_AGG_OK` : Success
+   *  - `WINDOW_AGG_ERR`: Invalid channel
+   */
+  window_agg_error_t add(uint8_t channel, float value);
+
+  /**
+   * @brief  Copies the aggregate of the current window of a channel and starts a new window.
+   *
+   * @param[in]     channel Channel number
+   * @param[out]    window  Aggregate
+   *
+   * @attention  One consumer per channel, every take ends the window for everyone.
+   *
+   * @return
+   *  - `WINDOW_AGG_OK`       : `window` filled
+   *  - `WINDOW_AGG_ERR`      : Invalid channel or `NULL` window
+   *  - `WINDOW_AGG_ERR_EMPTY`: No sample since the last take, `window` untouched
+   */
+  window_agg_error_t take(uint8_t channel, window_agg_t *window);
+
+private:
+  typedef struct
+  {
+    float    min;
+    float    max;
+    float    sum; // Float is enough, a window holds tens of samples
+    float    last;
+    uint16_t count;
+    uint32_t startMs;
+    uint32_t lastMs;
+  } accumulator_t;
+
+  accumulator_t     _windows[WINDOW_AGG_MAX_CHANNELS];
+  SemaphoreHandle_t _lock;
+};
+
+#endif // WINDOW_AGG_H
+
+/* End of file -------------------------------------------------------- */
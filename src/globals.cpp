@@ -33,7 +33,7 @@ SoilMoisture soilMoisture(SOIL_MOISTURE_PIN);
 #endif
 
 #ifdef ES_SOIL_RS485_MODULE
-EsSoil7n1 esSoil;
+EsSoil7n1 esSoil[ES_SOIL_PROBE_COUNT];
 #endif // ES_SOIL_RS485_MODULE
 
 #ifdef HUSKYLENS_MODULE
@@ -41,7 +41,7 @@ HUSKYLENS huskylens;
 #endif // HUSKYLENS_MODULE
 
 #ifdef LCD_MODULE
-LCD_I2C lcd(0x21, 16, 2);
+LCD_I2C lcd(0x21, 16, 2, LCD_I2C_BUS);
 #endif
 
 #ifdef MINI_FAN_MODULE
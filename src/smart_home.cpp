@@ -12,6 +12,7 @@
 /* Includes ----------------------------------------------------------- */
 #include "smart_home.h"
 #include "globals.h"
+#include "sensor_scheduler.h"
 
 /* Private defines ---------------------------------------------------- */
 
@@ -40,7 +41,10 @@ void SmartHome::serialSetup(bool uart, bool rs485, bool i2c)
 
   if (i2c)
   {
-    Wire.begin();
+    bspI2CBegin(BSP_I2C_BUS_0);
+    bspI2CBusStart(BSP_I2C_BUS_0);
+    bspI2CBegin(BSP_I2C_BUS_1, I2C1_SDA_PIN, I2C1_SCL_PIN);
+    bspI2CBusStart(BSP_I2C_BUS_1);
   }
 }
 
@@ -69,6 +73,13 @@ void SmartHome::deviceSetup()
       deviceInitialize(i);
     }
   }
+  // The device setups only register their periodic jobs, one task runs them all
+  sensorScheduler.start();
+
+#ifdef TS_LOG_MODULE
+  // Records what the jobs publish to the data hub
+  storageSetup();
+#endif // TS_LOG_MODULE
 }
 
 void SmartHome::connectivitySetup()
@@ -124,7 +135,7 @@ void SmartHome::deviceInitialize(uint8_t index)
       break;
 
     case DEVICE_INDEX_AC_MEASURE:
-      // acMeasureSetup();
+      acMeasureSetup();
       break;
 
     case DEVICE_INDEX_HUSKYLENS:
@@ -27,7 +27,7 @@
 #ifdef UNIT_4_RELAY_MODULE
 void unit4RelaySetup()
 {
-  unit4Relay.begin();
+  unit4Relay.begin(SENSOR_I2C_BUS);
   unit4Relay.init(1);
   unit4Relay.relayAll(0);
 }
@@ -12,6 +12,7 @@
 /* Includes ----------------------------------------------------------- */
 #include "button_task.h"
 #include "globals.h"
+#include "sensor_scheduler.h"
 
 #ifdef BUTTON_MODULE
 /* Private defines ---------------------------------------------------- */
@@ -24,15 +25,11 @@
 
 /* Private variables -------------------------------------------------- */
 
-/* Task definitions ------------------------------------------- */
-void buttonTask(void *pvParameters)
+/* Job definitions -------------------------------------------- */
+void buttonJob(void *context)
 {
-  for (;;)
-  {
-    // Serial.print(bspGpioDigitalRead(BUTTON_PIN));
-    button.update();
-    vTaskDelay(pdMS_TO_TICKS(DELAY_BUTTON));
-  }
+  // Serial.print(bspGpioDigitalRead(BUTTON_PIN));
+  button.update();
 }
 
 void buttonSetup()
@@ -67,7 +64,7 @@ void buttonSetup()
     esp_restart();
   });
 
-  xTaskCreate(buttonTask, "Button Task", 8192, NULL, 1, NULL);
+  sensorScheduler.addJob("button", buttonJob, NULL, DELAY_BUTTON);
 }
 #endif
 /* End of file -------------------------------------------------------- */
\ No newline at end of file
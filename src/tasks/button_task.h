@@ -29,7 +29,7 @@
 /* Public variables --------------------------------------------------- */
 
 /* Funtions Declaration -------------------------------------------------- */
-void buttonTask(void *pvParameters);
+void buttonJob(void *context);
 void buttonSetup();
 #endif // BUTTON_TASK_H
 
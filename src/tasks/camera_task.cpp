@@ -12,6 +12,7 @@
 /* Includes ----------------------------------------------------------- */
 #include "camera_task.h"
 #include "globals.h"
+#include "sensor_scheduler.h"
 
 /* Private defines ---------------------------------------------------- */
 
@@ -22,8 +23,10 @@
 /* Public variables --------------------------------------------------- */
 
 /* Private variables -------------------------------------------------- */
+static bool     doorHoldActive  = false;
+static uint32_t doorHoldStartMs = 0;
 
-/* Task definitions-------------------------------------------- */
+/* Job definitions--------------------------------------------- */
 void printResult(HUSKYLENSResult result)
 {
   if (result.command == COMMAND_RETURN_BLOCK)
@@ -42,72 +45,70 @@ void printResult(HUSKYLENSResult result)
   }
 }
 
-void huskylensTask(void *pvParameters)
+void huskylensJob(void *context)
 {
-  for (;;)
+  // The door stays open while the person walks through, the camera is not read meanwhile
+  if (doorHoldActive)
   {
-#ifdef DEBUG_PRINT_RTOS_TIMING
-    unsigned long startTime = micros();
-#endif
-    if (huskylens.getCameraStatus())
+    if (millis() - doorHoldStartMs < CAMERA_DOOR_HOLD_MS)
     {
-      if (!huskylens.request())
-      {
+      return;
+    }
+    doorHoldActive = false;
+  }
+
+  if (!huskylens.getCameraStatus())
+  {
+    return;
+  }
+  if (!huskylens.request())
+  {
 #ifdef DEBUG_PRINT
-        Serial.println(F("Fail to request data from HUSKYLENS, recheck the connection!"));
+    Serial.println(F("Fail to request data from HUSKYLENS, recheck the connection!"));
 #endif // DEBUG_PRINT
-      }
-      else if (!huskylens.isLearned())
-      {
+  }
+  else if (!huskylens.isLearned())
+  {
 #ifdef DEBUG_PRINT
-        Serial.println(F("Nothing learned, press learn button on HUSKYLENS to learn one!"));
+    Serial.println(F("Nothing learned, press learn button on HUSKYLENS to learn one!"));
 #endif // DEBUG_PRINT
-      }
-      else if (!huskylens.available())
-      {
+  }
+  else if (!huskylens.available())
+  {
 #ifdef DEBUG_PRINT
-        Serial.println(F("No block or arrow appears on the screen!"));
+    Serial.println(F("No block or arrow appears on the screen!"));
 #endif // DEBUG_PRINT
-        lcd.setScreenState(LCD_SCREEN_CAMERA_NONE);
-        doorServo.setDoorStatus(false);
-        doorServo.writePos(0);
-      }
-      else
-      {
-        Serial.println(F("###########"));
-        while (huskylens.available())
-        {
-          huskylens.read();
-          HUSKYLENSResult result = huskylens.getResult();
+    lcd.setScreenState(LCD_SCREEN_CAMERA_NONE);
+    doorServo.setDoorStatus(false);
+    doorServo.writePos(0);
+  }
+  else
+  {
+    Serial.println(F("###########"));
+    while (huskylens.available())
+    {
+      huskylens.read();
+      HUSKYLENSResult result = huskylens.getResult();
 
-          if (result.ID == 1) // Recognized face
-          {
-            lcd.setScreenState(LCD_SCREEN_CAMERA_FACE_DETECTED);
-            doorServo.setDoorStatus(true);
-            doorServo.writePos(180);
-            vTaskDelay(pdMS_TO_TICKS(5000)); // Delay for going through the door
-          }
+      if (result.ID == 1) // Recognized face
+      {
+        lcd.setScreenState(LCD_SCREEN_CAMERA_FACE_DETECTED);
+        doorServo.setDoorStatus(true);
+        doorServo.writePos(180);
+        doorHoldActive  = true;
+        doorHoldStartMs = millis();
+      }
 #ifdef DEBUG_PRINT
-          printResult(result);
+      printResult(result);
 #endif // DEBUG_PRINT
-        }
-      }
     }
-#ifdef DEBUG_PRINT_RTOS_TIMING
-    unsigned long endTime       = micros();
-    unsigned long executionTime = endTime - startTime;
-    Serial.print("Huskylens Execution Time: ");
-    Serial.print(executionTime);
-    Serial.println(" us");
-#endif
-    vTaskDelay(pdMS_TO_TICKS(1000));
   }
 }
 
 void huskylensSetup()
 {
-  huskylens.begin(Wire);
-  xTaskCreate(&huskylensTask, "Huskeylens Task", 4096, nullptr, 1, nullptr);
+  huskylens.begin(HUSKYLENS_I2C_BUS);
+  sensorScheduler.addJob("huskylens", huskylensJob, NULL, DELAY_HUSKYLENS);
 }
 /* Private function prototypes ---------------------------------------- */
 
@@ -23,6 +23,8 @@
 
 /* Public defines ----------------------------------------------------- */
 #define CAMERA_TASK_LIB_VERSION (F("0.1.0"))
+#define DELAY_HUSKYLENS         1000
+#define CAMERA_DOOR_HOLD_MS     5000 // Door kept open after a recognized face
 
 /* Public enumerate/structure ----------------------------------------- */
 
@@ -33,7 +35,7 @@
 /* Class Declaration -------------------------------------------------- */
 void printResult(HUSKYLENSResult result);
 
-void huskylensTask(void *pvParameters);
+void huskylensJob(void *context);
 
 void huskylensSetup();
 
@@ -12,9 +12,17 @@
 /* Includes ----------------------------------------------------------- */
 #include "iot_server_task.h"
 #include "bsp_gpio.h"
+#include "bsp_i2c.h"
+#include "bsp_modbus_poller.h"
+#include "data_hub.h"
 #include "globals.h"
+#include "sensor_scheduler.h"
+#include "telemetry_batch.h"
+#include "telemetry_filter.h"
+#include "telemetry_queue.h"
 
 #include <Arduino_MQTT_Client.h>
+#include <LittleFS.h>
 #include <WiFi.h>
 
 #include <Attribute_Request.h>
@@ -64,6 +72,31 @@ constexpr uint64_t   REQUEST_TIMEOUT_MICROSECONDS       = 15000U * 1000U;
 
 constexpr int16_t telemetrySendInterval = 30000U;
 
+// Telemetry cycles are not exactly one interval apart: the time between two sends of a key moves with
+// the work and the MQTT calls of each cycle. Policy intervals are whole cycles minus a quarter cycle, so a key
+// due every cycle is never held back by the cycle coming a few ticks early.
+constexpr uint32_t TELEMETRY_CYCLE_SLACK_MS = telemetrySendInterval / 4;
+
+constexpr uint32_t telemetryCycles(uint32_t cycles)
+{
+  return cycles * telemetrySendInterval - TELEMETRY_CYCLE_SLACK_MS;
+}
+
+// Publish the I2C bus profiler and the Modbus poller counters every N telemetry cycles (5 minutes)
+constexpr uint8_t I2C_STATS_SEND_CYCLES = 10U;
+
+// Samples older than three sampling periods come from a sensor that stopped answering, do not send them
+constexpr uint32_t SAMPLE_MAX_AGE_MS = 90000U;
+
+// Store-and-forward: the queued telemetry goes out in a bounded number of messages per cycle, so the
+// backlog of an outage drains in minutes while the live values and the RPC traffic keep their turn
+constexpr uint8_t  REPLAY_MESSAGES_PER_CYCLE = 32U;
+constexpr uint16_t REPLAY_MESSAGE_GAP_MS     = 100U;
+constexpr uint8_t  REPLAY_PEEK_RECORDS       = 48U;
+
+// Room left in the MQTT send buffer for a telemetry payload once the fixed header and the topic are in
+constexpr uint16_t TELEMETRY_PAYLOAD_SIZE = MAX_MESSAGE_SEND_SIZE - 32U;
+
 // DHT20 / SHT40
 constexpr char TEMPERATURE_KEY[] = "temperature";
 constexpr char HUMIDITY_KEY[]    = "humidity";
@@ -91,6 +124,76 @@ constexpr char SOIL_NITROGEN_KEY[]     = "soilNitrogen";
 constexpr char SOIL_PHOSPHORUS_KEY[]   = "soilPhosphorus";
 constexpr char SOIL_POTASSIUM_KEY[]    = "soilPotassium";
 
+#ifdef TELEMETRY_MSGPACK_MODULE
+// Binary telemetry is for a bridge decoding it with the same dictionary (tools/telemetry_msgpack), the
+// ThingsBoard telemetry topic itself only takes JSON
+constexpr char    TELEMETRY_MSGPACK_TOPIC[]    = "v1/devices/me/msgpack";
+constexpr uint8_t TELEMETRY_DICTIONARY_VERSION = 1U;
+
+// MsgPack key ids are the indexes, agreed at provisioning: append only, bump the version on any other change.
+// The window statistics of publishChannel() follow the plain keys
+const char *const TELEMETRY_DICTIONARY[] = {
+TEMPERATURE_KEY,      HUMIDITY_KEY,          ILLUMINANCE_KEY,    PRESSURE_KEY,
+ALTITUDE_KEY,         VOLTAGE_KEY,           CURRENT_KEY,        POWER_KEY,
+POWER_FACTOR_KEY,     POWER_EFFICIENCY_KEY,  SOIL_PH_KEY,        SOIL_MOISTURE_KEY,
+SOIL_TEMPERATURE_KEY, SOIL_CONDUCTIVITY_KEY, SOIL_NITROGEN_KEY,  SOIL_PHOSPHORUS_KEY,
+SOIL_POTASSIUM_KEY,   "voltage_mean",        "voltage_min",      "voltage_max",
+"current_mean",       "current_min",         "current_max",      "power_mean",
+"power_min",          "power_max",           "illuminance_mean", "illuminance_min",
+"illuminance_max"};
+#endif // TELEMETRY_MSGPACK_MODULE
+
+// WiFi signal strength, an attribute that goes through the telemetry policies
+constexpr char RSSI_ATTR[] = "rssi";
+
+// Report by exception: a key is sent when it leaves its deadband, not more often than the minimum
+// interval, and at least once per heartbeat. Soil keys match every probe ("soilPh" covers "soilPh_3").
+// Key, deadband, deadband unit, minimum interval, heartbeat, in telemetry cycles
+const telemetry_filter_policy_t TELEMETRY_POLICIES[] = {
+{TEMPERATURE_KEY, 0.2f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(1), telemetryCycles(20)},
+{HUMIDITY_KEY, 1.0f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(1), telemetryCycles(20)},
+{PRESSURE_KEY, 20.0f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(2), telemetryCycles(30)},
+{ALTITUDE_KEY, 2.0f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(2), telemetryCycles(30)},
+{ILLUMINANCE_KEY, 10.0f, TELEMETRY_FILTER_PERCENT, telemetryCycles(1), telemetryCycles(20)},
+{VOLTAGE_KEY, 2.0f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(1), telemetryCycles(20)},
+{CURRENT_KEY, 5.0f, TELEMETRY_FILTER_PERCENT, telemetryCycles(1), telemetryCycles(20)},
+{POWER_KEY, 5.0f, TELEMETRY_FILTER_PERCENT, telemetryCycles(1), telemetryCycles(20)},
+{POWER_FACTOR_KEY, 0.02f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(1), telemetryCycles(20)},
+{POWER_EFFICIENCY_KEY, 2.0f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(1), telemetryCycles(20)},
+{SOIL_PH_KEY, 0.1f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(2), telemetryCycles(60)},
+{SOIL_MOISTURE_KEY, 1.0f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(2), telemetryCycles(60)},
+{SOIL_TEMPERATURE_KEY, 0.3f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(2), telemetryCycles(60)},
+{SOIL_CONDUCTIVITY_KEY, 5.0f, TELEMETRY_FILTER_PERCENT, telemetryCycles(2), telemetryCycles(60)},
+{SOIL_NITROGEN_KEY, 2.0f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(2), telemetryCycles(60)},
+{SOIL_PHOSPHORUS_KEY, 2.0f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(2), telemetryCycles(60)},
+{SOIL_POTASSIUM_KEY, 2.0f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(2), telemetryCycles(60)},
+{RSSI_ATTR, 4.0f, TELEMETRY_FILTER_ABSOLUTE, telemetryCycles(1), telemetryCycles(10)}};
+
+// Keys of one cycle: the fixed ones, seven per soil probe and the mean, minimum and maximum of voltage,
+// current, power and illuminance. The filter also holds the RSSI
+constexpr uint16_t TELEMETRY_FIXED_KEY_COUNT = 10U;
+constexpr uint16_t TELEMETRY_SOIL_KEY_COUNT  = 7U;
+#ifdef ES_SOIL_RS485_MODULE
+constexpr uint16_t TELEMETRY_PROBE_KEY_COUNT = TELEMETRY_SOIL_KEY_COUNT * ES_SOIL_PROBE_COUNT;
+#else
+constexpr uint16_t TELEMETRY_PROBE_KEY_COUNT = 0U;
+#endif // ES_SOIL_RS485_MODULE
+#ifdef TELEMETRY_WINDOW_MODULE
+constexpr uint16_t TELEMETRY_WINDOW_KEY_COUNT = 4U * 3U;
+#else
+constexpr uint16_t TELEMETRY_WINDOW_KEY_COUNT = 0U;
+#endif // TELEMETRY_WINDOW_MODULE
+constexpr uint16_t TELEMETRY_KEY_COUNT =
+TELEMETRY_FIXED_KEY_COUNT + TELEMETRY_PROBE_KEY_COUNT + TELEMETRY_WINDOW_KEY_COUNT;
+
+static_assert(sizeof(TELEMETRY_POLICIES) / sizeof(TELEMETRY_POLICIES[0]) ==
+              TELEMETRY_FIXED_KEY_COUNT + TELEMETRY_SOIL_KEY_COUNT + 1U,
+              "TELEMETRY_FIXED_KEY_COUNT and TELEMETRY_SOIL_KEY_COUNT must follow TELEMETRY_POLICIES");
+// Longest soil key with the largest slave address, "soilConductivity_247"
+static_assert(sizeof(SOIL_CONDUCTIVITY_KEY) + 4U <= TELEMETRY_BATCH_KEY_LENGTH &&
+              sizeof(SOIL_CONDUCTIVITY_KEY) + 4U <= TELEMETRY_FILTER_KEY_LENGTH,
+              "Soil probe keys do not fit the telemetry key length");
+
 // Attribute names
 constexpr char LED_STATE_ATTR[]    = "ledState";
 constexpr char FAN_SPEED_ATTR[]    = "fanSpeed";
@@ -137,6 +240,10 @@ RELAY2_STATE_ATTR, RELAY3_STATE_ATTR, RELAY4_STATE_ATTR, CAMERA_STATE_ATTR};
 // List of client attributes for requesting them (Using to initialize device states)
 constexpr std::array<const char *, 2U> CLIENT_ATTRIBUTES_LIST = {LED_STATE_ATTR, DOOR_STATE_ATTR};
 
+TelemetryBatchBuffer<TELEMETRY_KEY_COUNT> telemetryBatch;
+TelemetryFilterTable<TELEMETRY_KEY_COUNT + 1U>
+telemetryFilter(TELEMETRY_POLICIES, sizeof(TELEMETRY_POLICIES) / sizeof(TELEMETRY_POLICIES[0]));
+
 WiFiClient          wifiClient;
 Arduino_MQTT_Client mqttClient(wifiClient);
 ThingsBoard tb(mqttClient, MAX_MESSAGE_RECEIVE_SIZE, MAX_MESSAGE_SEND_SIZE, Default_Max_Stack_Size, apis);
@@ -421,6 +528,201 @@ void requestTimedOut()
 #endif // DEBUG_PRINT
 }
 
+// Publish the I2C bus profiler, one client attribute per bus and device address ("i2c0_0x44", ...)
+void sendI2CStats()
+{
+  bsp_i2c_stats_t stats;
+  char            key[12];
+  char            value[BSP_I2C_STATS_JSON_SIZE];
+
+  for (uint8_t bus = 0; bus < BSP_I2C_BUS_COUNT; bus++)
+  {
+    for (uint8_t i = 0; i < BSP_I2C_STATS_ADDRESSES; i++)
+    {
+      if (bspI2CGetStatsAt((bsp_i2c_bus_t) bus, i, &stats) != BSP_I2C_OK)
+      {
+        continue;
+      }
+      snprintf(key, sizeof(key), "i2c%u_0x%02X", bus, stats.address);
+      // A truncated object is not valid JSON, leave the attribute as it was rather than send it
+      if (bspI2CStatsToJson(&stats, value, sizeof(value)) >= sizeof(value))
+      {
+        continue;
+      }
+#ifdef DEBUG_PRINT
+      Serial.printf("%s: %s\n", key, value);
+#endif // DEBUG_PRINT
+      tb.sendAttributeData(key, value);
+    }
+  }
+}
+
+// Publish the sensor scheduler timing, one client attribute per job ("sched_sht40", ...)
+void sendSchedulerStats()
+{
+  sensor_scheduler_stats_t stats;
+  char                     key[8 + SENSOR_SCHEDULER_NAME_LENGTH];
+  char                     value[160];
+
+  for (uint8_t i = 0; i < sensorScheduler.jobCount(); i++)
+  {
+    if (sensorScheduler.getJobStats(i, &stats) != SENSOR_SCHEDULER_OK)
+    {
+      continue;
+    }
+    snprintf(key, sizeof(key), "sched_%s", sensorScheduler.jobName(i));
+    SensorScheduler::statsToJson(&stats, value, sizeof(value));
+#ifdef DEBUG_PRINT
+    Serial.printf("%s: %s\n", key, value);
+#endif // DEBUG_PRINT
+    tb.sendAttributeData(key, value);
+  }
+}
+
+// Publish the report-by-exception and batching counters as the "telemetry" and "telemetry_batch"
+// client attributes
+void sendTelemetryStats()
+{
+  telemetry_filter_stats_t filterStats;
+  telemetry_batch_stats_t  batchStats;
+  char                     value[96];
+
+  telemetryFilter.getStats(&filterStats);
+  TelemetryFilter::statsToJson(&filterStats, value, sizeof(value));
+#ifdef DEBUG_PRINT
+  Serial.printf("telemetry: %s\n", value);
+#endif // DEBUG_PRINT
+  tb.sendAttributeData("telemetry", value);
+
+  telemetryBatch.getStats(&batchStats);
+  TelemetryBatch::statsToJson(&batchStats, value, sizeof(value));
+#ifdef DEBUG_PRINT
+  Serial.printf("telemetry_batch: %s\n", value);
+#endif // DEBUG_PRINT
+  tb.sendAttributeData("telemetry_batch", value);
+}
+
+// Values neither published nor queued stay uncommitted, the filter offers them again the next cycle
+void commitTelemetry(uint16_t first, uint16_t count)
+{
+  uint32_t nowMs = millis();
+
+  for (uint16_t i = first; i < first + count; i++)
+  {
+    telemetryFilter.commit(telemetryBatch.entry(i)->key, telemetryBatch.entry(i)->value, nowMs);
+  }
+}
+
+// Sends the values collected since the last call in as few messages as the send buffer allows, or queues
+// them with their timestamp when the server cannot be reached
+void sendTelemetryBatch()
+{
+  static char payload[TELEMETRY_PAYLOAD_SIZE];
+  uint16_t    used;
+
+  for (uint16_t first = 0; first < telemetryBatch.count(); first += used)
+  {
+    size_t length;
+    bool   sent;
+#ifdef TELEMETRY_MSGPACK_MODULE
+    used = telemetryBatch.encodeMsgPack(first, (uint8_t *) payload, sizeof(payload), &length);
+    sent = tb.connected() && mqttClient.publish(TELEMETRY_MSGPACK_TOPIC, (uint8_t *) payload, length);
+#else
+    used   = telemetryBatch.encode(first, payload, sizeof(payload));
+    length = strlen(payload);
+    sent   = tb.connected() && tb.sendTelemetryString(payload);
+#endif // TELEMETRY_MSGPACK_MODULE
+    if (sent)
+    {
+      telemetryBatch.countPublish(first, used, length);
+      commitTelemetry(first, used);
+      continue;
+    }
+#ifdef TELEMETRY_QUEUE_MODULE
+    // Without a set clock the values could not be placed in time later on, they are lost as before
+    time_t now = time(NULL);
+    for (uint16_t i = first; i < first + used && now >= (time_t) STORAGE_MIN_VALID_TIME; i++)
+    {
+      const telemetry_batch_entry_t *entry = telemetryBatch.entry(i);
+      if (telemetryQueue.push((uint32_t) now, entry->key, entry->value) == TELEMETRY_QUEUE_OK)
+      {
+        commitTelemetry(i, 1);
+      }
+    }
+#endif // TELEMETRY_QUEUE_MODULE
+  }
+  telemetryBatch.clear();
+}
+
+// Adds a telemetry value its policy lets through to the batch of the cycle
+void publishTelemetry(const char *key, float value)
+{
+  if (!telemetryFilter.accept(key, value, millis()))
+  {
+    return;
+  }
+  if (!telemetryBatch.add(key, value))
+  {
+    sendTelemetryBatch();
+    telemetryBatch.add(key, value);
+  }
+}
+
+#ifdef ES_SOIL_RS485_MODULE
+void sendSoilProbeTelemetry(EsSoil7n1 *probe)
+{
+  // Probes that never answered have nothing to report yet
+  if (probe->getLastUpdate() == 0)
+  {
+    return;
+  }
+
+  const struct
+  {
+    const char *key;
+    float       value;
+  } soilValues[] = {{SOIL_PH_KEY, probe->getSoilPh()},
+                    {SOIL_MOISTURE_KEY, probe->getSoilMoisture()},
+                    {SOIL_TEMPERATURE_KEY, probe->getSoilTemperature()},
+                    {SOIL_CONDUCTIVITY_KEY, probe->getSoilConductivity()},
+                    {SOIL_NITROGEN_KEY, probe->getSoilNitrogen()},
+                    {SOIL_PHOSPHORUS_KEY, probe->getSoilPhosphorus()},
+                    {SOIL_POTASSIUM_KEY, probe->getSoilPotassium()}};
+  char key[24];
+
+  // One key per probe and value, e.g. "soilPh_3" for the probe at slave address 3
+  for (const auto &soilValue : soilValues)
+  {
+    snprintf(key, sizeof(key), "%s_%u", soilValue.key, probe->getSlaveId());
+  #ifdef DEBUG_PRINT
+    Serial.printf("%s: %.2f\n", key, soilValue.value);
+  #endif // DEBUG_PRINT
+    publishTelemetry(key, soilValue.value);
+  }
+}
+
+void sendModbusStats()
+{
+  bsp_modbus_poll_stats_t stats;
+  char                    key[12];
+  char                    value[192];
+
+  for (uint8_t i = 0; i < ES_SOIL_PROBE_COUNT; i++)
+  {
+    if (modbusPoller1.getSlaveStats(ES_SOIL_PROBE_SLAVES[i], &stats) != BSP_MODBUS_OK)
+    {
+      continue;
+    }
+    snprintf(key, sizeof(key), "modbus_%u", ES_SOIL_PROBE_SLAVES[i]);
+    BspModbusPoller::statsToJson(&stats, value, sizeof(value));
+  #ifdef DEBUG_PRINT
+    Serial.printf("%s: %s\n", key, value);
+  #endif // DEBUG_PRINT
+    tb.sendAttributeData(key, value);
+  }
+}
+#endif // ES_SOIL_RS485_MODULE
+
 const Shared_Attribute_Callback<MAX_ATTRIBUTES>
 attributes_callback(&processSharedAttributes, SHARED_ATTRIBUTES_LIST.cbegin(), SHARED_ATTRIBUTES_LIST.cend());
 
@@ -431,6 +733,138 @@ attribute_shared_request_callback(&processSharedAttributes, REQUEST_TIMEOUT_MICR
 const Attribute_Request_Callback<MAX_ATTRIBUTES>
 attribute_client_request_callback(&processClientAttributes, REQUEST_TIMEOUT_MICROSECONDS, &requestTimedOut,
                                   CLIENT_ATTRIBUTES_LIST);
+
+// Last good value of a channel, NAN when the sensor has not answered for SAMPLE_MAX_AGE_MS
+float readFreshSample(data_hub_channel_t channel)
+{
+  data_hub_sample_t sample;
+
+  if (dataHub.read(channel, &sample) != DATA_HUB_OK || !DataHub::isFresh(&sample, SAMPLE_MAX_AGE_MS))
+  {
+    return NAN;
+  }
+  return sample.value;
+}
+
+#if defined(AC_MEASURE_MODULE) || defined(LIGHT_SENSOR_MODULE)
+// Sends an oversampled channel: the newest value under `key` and, with the window stage, the mean, minimum
+// and maximum since the last cycle under `key_mean`, `key_min` and `key_max`
+void publishChannel(data_hub_channel_t channel, const char *key)
+{
+  #ifdef TELEMETRY_WINDOW_MODULE
+  window_agg_t window;
+  char         windowKey[TELEMETRY_BATCH_KEY_LENGTH];
+
+  // Taken every cycle, an empty window means the sensor has not answered since the last one
+  if (dataHub.takeWindow(channel, &window) != DATA_HUB_OK)
+  {
+    return;
+  }
+    #ifdef DEBUG_PRINT
+  Serial.printf("%s: %.2f (mean %.2f, min %.2f, max %.2f, %u samples)\n", key, window.last, window.mean,
+                window.min, window.max, window.count);
+    #endif // DEBUG_PRINT
+  publishTelemetry(key, window.last);
+  snprintf(windowKey, sizeof(windowKey), "%s_mean", key);
+  publishTelemetry(windowKey, window.mean);
+  snprintf(windowKey, sizeof(windowKey), "%s_min", key);
+  publishTelemetry(windowKey, window.min);
+  snprintf(windowKey, sizeof(windowKey), "%s_max", key);
+  publishTelemetry(windowKey, window.max);
+  #else
+  float value = readFreshSample(channel);
+  if (isnan(value))
+  {
+    return;
+  }
+    #ifdef DEBUG_PRINT
+  Serial.printf("%s: %.2f\n", key, value);
+    #endif // DEBUG_PRINT
+  publishTelemetry(key, value);
+  #endif // TELEMETRY_WINDOW_MODULE
+}
+#endif // defined(AC_MEASURE_MODULE) || defined(LIGHT_SENSOR_MODULE)
+
+#ifdef TELEMETRY_QUEUE_MODULE
+// Writes as many records as fit into a ThingsBoard array of {"ts", "values"}, one entry per timestamp.
+// Returns the number of records used, records that failed their CRC included
+uint16_t buildReplayPayload(const telemetry_queue_record_t *records, uint16_t count, char *payload,
+                            size_t size)
+{
+  char     piece[96];
+  size_t   length    = 1;
+  uint16_t used      = 0;
+  bool     entries   = false;
+  uint32_t entryTime = 0;
+
+  payload[0] = '[';
+  for (; used < count; used++)
+  {
+    const telemetry_queue_record_t *record = &records[used];
+    int                             pieceLength;
+
+    if (record->key == NULL)
+    {
+      continue;
+    }
+    if (!entries || record->time != entryTime)
+    {
+      pieceLength = snprintf(piece, sizeof(piece), "%s{\"ts\":%lu000,\"values\":{\"%s\":%.7g",
+                             entries ? "}}," : "", (unsigned long) record->time, record->key, record->value);
+    }
+    else
+    {
+      pieceLength = snprintf(piece, sizeof(piece), ",\"%s\":%.7g", record->key, record->value);
+    }
+
+    // Keep room for the closing "}}]" and the terminator
+    if (pieceLength < 0 || (size_t) pieceLength >= sizeof(piece) || length + pieceLength + 4 > size)
+    {
+      break;
+    }
+    memcpy(&payload[length], piece, pieceLength);
+    length += pieceLength;
+
+    entries   = true;
+    entryTime = record->time;
+  }
+  if (entries)
+  {
+    memcpy(&payload[length], "}}]", 3);
+    length += 3;
+  }
+  payload[entries ? length : 0] = '\0';
+
+  return used;
+}
+
+// Sends the oldest queued telemetry, up to REPLAY_MESSAGES_PER_CYCLE messages
+void replayTelemetry()
+{
+  static telemetry_queue_record_t records[REPLAY_PEEK_RECORDS];
+  static char                     payload[TELEMETRY_PAYLOAD_SIZE];
+
+  telemetryQueue.flush();
+  for (uint8_t message = 0; message < REPLAY_MESSAGES_PER_CYCLE && tb.connected(); message++)
+  {
+    uint16_t count = telemetryQueue.peek(records, REPLAY_PEEK_RECORDS);
+    if (count == 0)
+    {
+      break;
+    }
+    uint16_t used = buildReplayPayload(records, count, payload, sizeof(payload));
+
+    // Kept queued when the publish fails, the next cycle sends the same records again
+    if (payload[0] != '\0' && !tb.sendTelemetryString(payload))
+    {
+      break;
+    }
+    telemetryQueue.pop(used);
+    vTaskDelay(pdMS_TO_TICKS(REPLAY_MESSAGE_GAP_MS));
+  }
+}
+#endif // TELEMETRY_QUEUE_MODULE
+
 /* Task definitions ------------------------------------------- */
 
 void iotServerTask(void *pvParameters)
@@ -552,160 +986,105 @@ void iotServerTask(void *pvParameters)
 
 void sendTelemetryTask(void *pvParameters)
 {
-  TickType_t lastWakeTime = xTaskGetTickCount();
+  TickType_t lastWakeTime  = xTaskGetTickCount();
+  uint8_t    i2cStatsCycle = 0;
 
   for (;;)
   {
-    if (WiFi.status() == WL_CONNECTED)
-    {
-      if (tb.connected())
-      {
-#ifdef DHT20_MODULE
-        //      dht20.readTempAndHumidity();
-        float temperature = dht20.getTemperature();
-        float humidity    = dht20.getHumidity();
-#endif // DHT20_MODULE
-
-#ifdef SHT4X_MODULE
-        sht40.update();
-        float temperature = sht40.getTemperature();
-        float humidity    = sht40.getHumidity();
-#endif // SHT4X_MODULE
+    // Sensor values come from the data hub, the sampling jobs own the buses. They are read every cycle:
+    // publishTelemetry() queues them while the server is unreachable
+#if defined(DHT20_MODULE) || defined(SHT4X_MODULE)
+    float temperature = readFreshSample(DATA_HUB_TEMPERATURE);
+    float humidity    = readFreshSample(DATA_HUB_HUMIDITY);
+#endif // defined(DHT20_MODULE) || defined(SHT4X_MODULE)
 
 #ifdef BMP280_MODULE
-        bmp280.update();
-        float pressure = bmp280.getPressure();
-        float altitude = bmp280.getAltitude();
-        // float temperature = bmp280.getTemperature();
-        if (!(isnan(pressure) || isnan(altitude)))
-        {
+    float pressure = readFreshSample(DATA_HUB_PRESSURE);
+    float altitude = readFreshSample(DATA_HUB_ALTITUDE);
+    if (!(isnan(pressure) || isnan(altitude)))
+    {
   #ifdef DEBUG_PRINT
-          Serial.print("Pressure: ");
-          Serial.print(pressure);
-          Serial.print(" Pa, Altitude: ");
-          Serial.print(altitude);
-          Serial.println(" m");
+      Serial.print("Pressure: ");
+      Serial.print(pressure);
+      Serial.print(" Pa, Altitude: ");
+      Serial.print(altitude);
+      Serial.println(" m");
   #endif // DEBUG_PRINT
-          tb.sendTelemetryData(PRESSURE_KEY, pressure);
-          tb.sendTelemetryData(ALTITUDE_KEY, altitude);
-        }
+      publishTelemetry(PRESSURE_KEY, pressure);
+      publishTelemetry(ALTITUDE_KEY, altitude);
+    }
 #endif // BMP280_MODULE
 
 #ifdef AC_MEASURE_MODULE
-        if (acMeasure.getReady())
-        {
-          float   voltage         = acMeasure.getVoltage();
-          float   current         = acMeasure.getCurrent();
-          float   power           = acMeasure.getPower();
-          float   powerFactor     = acMeasure.getPowerFactor();
-          uint8_t powerEfficiency = powerFactor * 100;
-
-          if (!(isnan(voltage) || isnan(current) || isnan(power) || isnan(powerFactor)))
-          {
-  #ifdef DEBUG_PRINT
-            Serial.print("Voltage: ");
-            Serial.print(voltage);
-            Serial.print(" V, Current: ");
-            Serial.print(current);
-            Serial.println(" A");
-
-            Serial.print("Power: ");
-            Serial.print(power);
-            Serial.print(" W, Power factor: ");
-            Serial.print(powerFactor);
-            Serial.println(" %");
-  #endif // DEBUG_PRINT
-
-            tb.sendTelemetryData(VOLTAGE_KEY, voltage);
-            tb.sendTelemetryData(CURRENT_KEY, current);
-            tb.sendTelemetryData(POWER_KEY, power);
-            tb.sendTelemetryData(POWER_FACTOR_KEY, powerFactor);
-            tb.sendTelemetryData(POWER_EFFICIENCY_KEY, powerEfficiency);
-          }
-        }
+    float powerFactor = readFreshSample(DATA_HUB_AC_POWER_FACTOR);
+    if (!isnan(powerFactor))
+    {
+      publishChannel(DATA_HUB_AC_VOLTAGE, VOLTAGE_KEY);
+      publishChannel(DATA_HUB_AC_CURRENT, CURRENT_KEY);
+      publishChannel(DATA_HUB_AC_POWER, POWER_KEY);
+      publishTelemetry(POWER_FACTOR_KEY, powerFactor);
+      publishTelemetry(POWER_EFFICIENCY_KEY, (uint8_t) (powerFactor * 100));
+    }
 #endif // AC_MEASURE_MODULE
 
 #ifdef LIGHT_SENSOR_MODULE
-        lightSensor.read();
-        float illuminance = lightSensor.getLightValuePercentage();
-        if (!(isnan(illuminance)))
-        {
-  #ifdef DEBUG_PRINT
-          Serial.print("Illuminance: ");
-          Serial.print(illuminance);
-          Serial.println(" lux");
-  #endif // DEBUG_PRINT
-          tb.sendTelemetryData(ILLUMINANCE_KEY, illuminance);
-        }
+    publishChannel(DATA_HUB_LIGHT, ILLUMINANCE_KEY);
 #endif // LIGHT_SENSOR_MODULE
 
 #ifdef ES_SOIL_RS485_MODULE
-        float soilPh           = esSoil.getSoilPh();
-        float soilMoisture     = esSoil.getSoilMoisture();
-        float soilTemperature  = esSoil.getSoilTemperature();
-        float soilConductivity = esSoil.getSoilConductivity();
-        float soilNitrogen     = esSoil.getSoilNitrogen();
-        float soilPhosphorus   = esSoil.getSoilPhosphorus();
-        float soilPotassium    = esSoil.getSoilPotassium();
-
-  #ifdef DEBUG_PRINT
-        Serial.print("Soil Ph: ");
-        Serial.print(soilPh);
-        Serial.println(" pH");
-
-        Serial.print("Soil Moisture: ");
-        Serial.print(soilMoisture);
-        Serial.println(" % RH");
-
-        Serial.print("Soil Temperature: ");
-        Serial.print(soilTemperature);
-        Serial.println(" *C");
-
-        Serial.print("Soil Conductivity: ");
-        Serial.print(soilConductivity);
-        Serial.println(" us/cm");
-
-        Serial.print("Soil Nitrogen: ");
-        Serial.print(soilNitrogen);
-        Serial.println(" mg/kg");
-
-        Serial.print("Soil Phosphorus: ");
-        Serial.print(soilPhosphorus);
-        Serial.println(" mg/kg");
-
-        Serial.print("Soil Potassium: ");
-        Serial.print(soilPotassium);
-        Serial.println(" mg/kg");
-  #endif // DEBUG_PRINT
-
-        tb.sendTelemetryData(SOIL_PH_KEY, soilPh);
-        tb.sendTelemetryData(SOIL_MOISTURE_KEY, soilMoisture);
-        tb.sendTelemetryData(SOIL_TEMPERATURE_KEY, soilTemperature);
-        tb.sendTelemetryData(SOIL_CONDUCTIVITY_KEY, soilConductivity);
-        tb.sendTelemetryData(SOIL_NITROGEN_KEY, soilNitrogen);
-        tb.sendTelemetryData(SOIL_PHOSPHORUS_KEY, soilPhosphorus);
-        tb.sendTelemetryData(SOIL_POTASSIUM_KEY, soilPotassium);
+    for (uint8_t i = 0; i < ES_SOIL_PROBE_COUNT; i++)
+    {
+      sendSoilProbeTelemetry(&esSoil[i]);
+    }
 #endif // ES_SOIL_RS485_MODULE
 
 #if defined(DHT20_MODULE) || defined(SHT4X_MODULE)
-        if (!(isnan(temperature) || isnan(humidity)))
-        {
+    if (!(isnan(temperature) || isnan(humidity)))
+    {
   #ifdef DEBUG_PRINT
-          Serial.print("Temperature: ");
-          Serial.print(temperature);
-          Serial.print(" °C, Humidity: ");
-          Serial.print(humidity);
-          Serial.println(" %");
+      Serial.print("Temperature: ");
+      Serial.print(temperature);
+      Serial.print(" °C, Humidity: ");
+      Serial.print(humidity);
+      Serial.println(" %");
   #endif // DEBUG_PRINT
 
-          tb.sendTelemetryData(TEMPERATURE_KEY, temperature);
-          tb.sendTelemetryData(HUMIDITY_KEY, humidity);
-        }
+      publishTelemetry(TEMPERATURE_KEY, temperature);
+      publishTelemetry(HUMIDITY_KEY, humidity);
+    }
 #endif // defined(DHT20_MODULE) || defined(SHT4X_MODULE)
 
-        // Send WiFi signal strength
-        tb.sendAttributeData("rssi", WiFi.RSSI());
+    // All the keys of the cycle in one publish, or a few when they exceed the send buffer
+    sendTelemetryBatch();
+#ifdef TELEMETRY_QUEUE_MODULE
+    // One write per cycle while offline, a no-op while the values go out live
+    telemetryQueue.flush();
+#endif // TELEMETRY_QUEUE_MODULE
+
+    if (WiFi.status() == WL_CONNECTED && tb.connected())
+    {
+      // Send WiFi signal strength
+      int8_t rssi = WiFi.RSSI();
+      if (telemetryFilter.accept(RSSI_ATTR, rssi, millis()) && tb.sendAttributeData(RSSI_ATTR, rssi))
+      {
+        telemetryFilter.commit(RSSI_ATTR, rssi, millis());
+      }
+
+      if (++i2cStatsCycle >= I2C_STATS_SEND_CYCLES)
+      {
+        i2cStatsCycle = 0;
+        sendI2CStats();
+        sendSchedulerStats();
+        sendTelemetryStats();
+#ifdef ES_SOIL_RS485_MODULE
+        sendModbusStats();
+#endif // ES_SOIL_RS485_MODULE
       }
+
+#ifdef TELEMETRY_QUEUE_MODULE
+      // Backlog of an outage after the live values, with the timestamps it was measured at
+      replayTelemetry();
+#endif // TELEMETRY_QUEUE_MODULE
     }
     vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(telemetrySendInterval));
   }
@@ -775,13 +1154,15 @@ void updateDevicesStateTask(void *pvParameters)
     {
       relaysStateChanged = false;
 
+      // Stage every changed relay, then write the register once
       for (int i = 0; i < 4; i++)
       {
         if (unit4Relay.getRelayState(i) != relaysState[i])
         {
-          unit4Relay.relayWrite(i, relaysState[i]);
+          unit4Relay.relayWrite(i, relaysState[i], false);
         }
       }
+      unit4Relay.flush();
     }
 #endif // UNIT_4_RELAY_MODULE
 
@@ -814,9 +1195,10 @@ void updateDevicesStateTask(void *pvParameters)
     }
     else
     {
-      if (pirStatus != pirSensor.getStatus())
+      bool motionDetected = readFreshSample(DATA_HUB_MOTION) > 0;
+      if (pirStatus != motionDetected)
       {
-        pirStatus = pirSensor.getStatus();
+        pirStatus = motionDetected;
         doorState = pirStatus;
         if (doorState)
         {
@@ -848,6 +1230,21 @@ void thingsboardLoopTask(void *pvParameters)
 
 void iotServerSetup()
 {
+#ifdef TELEMETRY_MSGPACK_MODULE
+  // Every MsgPack message carries the dictionary version, the bridge refuses one it does not have
+  telemetryBatch.setDictionary(TELEMETRY_DICTIONARY,
+                               sizeof(TELEMETRY_DICTIONARY) / sizeof(TELEMETRY_DICTIONARY[0]),
+                               TELEMETRY_DICTIONARY_VERSION);
+#endif // TELEMETRY_MSGPACK_MODULE
+#ifdef TELEMETRY_QUEUE_MODULE
+  // Mounted without formatting, a failed mount must not wipe the web UI on the same partition
+  if (!LittleFS.begin() || telemetryQueue.begin(LittleFS) != TELEMETRY_QUEUE_OK)
+  {
+  #ifdef DEBUG_PRINT
+    Serial.println("Telemetry queue unavailable, offline telemetry will be lost");
+  #endif // DEBUG_PRINT
+  }
+#endif // TELEMETRY_QUEUE_MODULE
   xTaskCreate(iotServerTask, "IOT Server Task", 8192, NULL, 1, NULL);
   xTaskCreate(sendTelemetryTask, "Send Telemetry Task", 8192, NULL, 1, NULL);
   xTaskCreate(thingsboardLoopTask, "ThingsBoard Loop Task", 8192, NULL, 1, NULL);
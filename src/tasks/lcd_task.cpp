@@ -11,7 +11,9 @@
 
 /* Includes ----------------------------------------------------------- */
 #include "lcd_task.h"
+#include "data_hub.h"
 #include "globals.h"
+#include "sensor_scheduler.h"
 
 /* Private defines ---------------------------------------------------- */
 
@@ -23,151 +25,168 @@
 
 /* Private variables -------------------------------------------------- */
 HUSKYLENSResult _result;
-/* Task definitions ------------------------------------------- */
+
+/* Private function prototypes ---------------------------------------- */
+#ifdef LCD_MODULE
+static float hubValue(data_hub_channel_t channel);
+#endif // LCD_MODULE
+
+/* Job definitions -------------------------------------------- */
 #ifdef LCD_MODULE
-void lcdTask(void *pvParameters)
+void lcdJob(void *context)
 {
-  for (;;)
+  if (wifiConnected)
   {
-    if (wifiConnected)
+    switch (lcd.getScreenState())
     {
-      switch (lcd.getScreenState())
-      {
   #ifdef DHT20_MODULE
-        case LCD_SCREEN_DHT20:
-          lcd.clear();
-          lcd.print("Hum: ");
-          lcd.print(dht20.getHumidity());
-          lcd.print(" %");
-          lcd.setCursor(0, 1);
-          lcd.print("Temp: ");
-          lcd.print(dht20.getTemperature());
-          lcd.print(" *C");
-          break;
+      case LCD_SCREEN_DHT20:
+        lcd.clear();
+        lcd.print("Hum: ");
+        lcd.print(hubValue(DATA_HUB_HUMIDITY));
+        lcd.print(" %");
+        lcd.setCursor(0, 1);
+        lcd.print("Temp: ");
+        lcd.print(hubValue(DATA_HUB_TEMPERATURE));
+        lcd.print(" *C");
+        break;
   #endif
 
   #ifdef SERVO_MODULE
-        case LCD_SCREEN_DOOR:
-          lcd.clear();
-          lcd.print("Door Status: ");
-          lcd.setCursor(0, 1);
-          if (doorServo.getDoorStatus())
-          {
-            lcd.print("Opened");
-          }
-          else
-          {
-            lcd.print("Closed");
-          }
-          break;
+      case LCD_SCREEN_DOOR:
+        lcd.clear();
+        lcd.print("Door Status: ");
+        lcd.setCursor(0, 1);
+        if (doorServo.getDoorStatus())
+        {
+          lcd.print("Opened");
+        }
+        else
+        {
+          lcd.print("Closed");
+        }
+        break;
   #endif // SERVO_MODULE
 
   #ifdef SHT4X_MODULE
-        case LCD_SCREEN_SHT4X:
-          lcd.clear();
-          lcd.print("Hum: ");
-          lcd.print(sht40.getHumidity());
-          lcd.print(" %");
-          lcd.setCursor(0, 1);
-          lcd.print("Temp: ");
-          lcd.print(sht40.getTemperature());
-          lcd.print(" *C");
-          break;
+      case LCD_SCREEN_SHT4X:
+        lcd.clear();
+        lcd.print("Hum: ");
+        lcd.print(hubValue(DATA_HUB_HUMIDITY));
+        lcd.print(" %");
+        lcd.setCursor(0, 1);
+        lcd.print("Temp: ");
+        lcd.print(hubValue(DATA_HUB_TEMPERATURE));
+        lcd.print(" *C");
+        break;
   #endif
 
   #ifdef BMP280_MODULE
-        case LCD_SCREEN_BMP280:
-          lcd.clear();
-          lcd.print("Pres.: ");
-          lcd.print(bmp280.getPressure());
-          lcd.print(" atm");
-          lcd.setCursor(0, 1);
-          lcd.print("Alt.: ");
-          lcd.print(bmp280.getAltitude());
-          lcd.print(" m");
-          break;
+      case LCD_SCREEN_BMP280:
+        lcd.clear();
+        lcd.print("Pres.: ");
+        lcd.print(hubValue(DATA_HUB_PRESSURE));
+        lcd.print(" atm");
+        lcd.setCursor(0, 1);
+        lcd.print("Alt.: ");
+        lcd.print(hubValue(DATA_HUB_ALTITUDE));
+        lcd.print(" m");
+        break;
   #endif
 
   #ifdef LIGHT_SENSOR_MODULE
-        case LCD_SCREEN_LIGHT:
-          lcd.clear();
-          lcd.print("Light level: ");
-          lcd.print(lightSensor.getLightValuePercentage());
-          lcd.progressBar(1, lightSensor.getLightValuePercentage());
-          break;
+      case LCD_SCREEN_LIGHT:
+        lcd.clear();
+        lcd.print("Light level: ");
+      {
+        float light = hubValue(DATA_HUB_LIGHT);
+        lcd.print(light);
+        lcd.progressBar(1, isnan(light) ? 0 : light);
+        break;
+      }
   #endif
 
   #ifdef ULTRASONIC_MODULE
-        case LCD_SCREEN_ULTRASONIC:
-          lcd.clear();
-          lcd.print("Distance: ");
-          lcd.print(ultrasonic.getDistance('c'));
-          lcd.print(" cm");
-          break;
+      case LCD_SCREEN_ULTRASONIC:
+        lcd.clear();
+        lcd.print("Distance: ");
+        lcd.print(hubValue(DATA_HUB_DISTANCE));
+        lcd.print(" cm");
+        break;
   #endif
 
   #ifdef SOIL_MOISTURE_MODULE
-        case LCD_SCREEN_MOISTURE:
-          lcd.clear();
-          lcd.print("Moisture: ");
-          lcd.print(soilMoisture.getMoisture());
-          lcd.setCursor(0, 1);
-          lcd.print(soilMoisture.getMoisturePercentage());
-          lcd.print(" %");
-          break;
+      case LCD_SCREEN_MOISTURE:
+        lcd.clear();
+        lcd.print("Moisture: ");
+        lcd.print(hubValue(DATA_HUB_SOIL_MOISTURE));
+        lcd.setCursor(0, 1);
+        lcd.print(hubValue(DATA_HUB_SOIL_MOISTURE_PERCENT));
+        lcd.print(" %");
+        break;
   #endif
 
   #ifdef PIR_MODULE
-        case LCD_SCREEN_PIR:
-          lcd.clear();
-          lcd.print(pirSensor.getStatus() ? "Motion Detected!" : "No Motion!");
-          break;
+      case LCD_SCREEN_PIR:
+        lcd.clear();
+        lcd.print(hubValue(DATA_HUB_MOTION) > 0 ? "Motion Detected!" : "No Motion!");
+        break;
   #endif
 
   #ifdef MINI_FAN_MODULE
-        case LCD_SCREEN_MINIFAN:
-          lcd.clear();
-          lcd.print("Fan Speed: ");
-          lcd.print(miniFan.getFanSpeedPercentage());
-          lcd.print("%");
-          lcd.setCursor(0, 1);
-          lcd.print(miniFan.getFanSpeed());
-          break;
+      case LCD_SCREEN_MINIFAN:
+        lcd.clear();
+        lcd.print("Fan Speed: ");
+        lcd.print(miniFan.getFanSpeedPercentage());
+        lcd.print("%");
+        lcd.setCursor(0, 1);
+        lcd.print(miniFan.getFanSpeed());
+        break;
   #endif
 
   #ifdef HUSKYLENS_MODULE
-        case LCD_SCREEN_CAMERA_FACE_DETECTED:
-          lcd.clear();
-          lcd.print("Face Detected");
-          lcd.setCursor(0, 1);
-          lcd.print("ID: ");
-          _result = huskylens.getResult();
-          lcd.print(_result.ID);
-          break;
-
-        case LCD_SCREEN_CAMERA_NONE:
-          lcd.clear();
-          lcd.print("Nothing");
-          break;
+      case LCD_SCREEN_CAMERA_FACE_DETECTED:
+        lcd.clear();
+        lcd.print("Face Detected");
+        lcd.setCursor(0, 1);
+        lcd.print("ID: ");
+        _result = huskylens.getResult();
+        lcd.print(_result.ID);
+        break;
+
+      case LCD_SCREEN_CAMERA_NONE:
+        lcd.clear();
+        lcd.print("Nothing");
+        break;
   #endif // HUSKYLENS_MODULE
 
-        default:
-          lcd.clear();
-          lcd.print("Blank screen");
-          break;
-      }
+      default:
+        lcd.clear();
+        lcd.print("Blank screen");
+        break;
     }
-    vTaskDelay(pdMS_TO_TICKS(DELAY_LCD));
   }
 }
 
 void lcdSetup()
 {
-  lcd.begin(&Wire);
+  lcd.begin();
   lcd.display();
   lcd.backlight();
   lcd.clear();
-  xTaskCreate(lcdTask, "LCD Task", 8192, NULL, 2, NULL);
+  sensorScheduler.addJob("lcd", lcdJob, NULL, DELAY_LCD);
+}
+
+// Last value published on a channel, NAN until the first good read
+static float hubValue(data_hub_channel_t channel)
+{
+  data_hub_sample_t sample;
+
+  if (dataHub.read(channel, &sample) != DATA_HUB_OK || sample.quality != DATA_HUB_QUALITY_GOOD)
+  {
+    return NAN;
+  }
+  return sample.value;
 }
 #endif // LCD_MODULE
 
@@ -29,7 +29,7 @@
 /* Public variables --------------------------------------------------- */
 
 /* Funtions Declaration -------------------------------------------------- */
-void lcdTask(void *pvParameters);
+void lcdJob(void *context);
 void lcdSetup();
 
 #endif // LCD_TASK_H
@@ -12,6 +12,7 @@
 /* Includes ----------------------------------------------------------- */
 #include "rs485_sensors_task.h"
 #include "globals.h"
+#include "bsp_modbus_poller.h"
 
 /* Private defines ---------------------------------------------------- */
 
@@ -22,28 +23,63 @@
 /* Public variables --------------------------------------------------- */
 
 /* Private variables -------------------------------------------------- */
+#ifdef ES_SOIL_RS485_MODULE
+static uint16_t soilSpans[ES_SOIL_PROBE_COUNT][ES_SOIL_SPAN_LENGTH];
+static int      soilBlocks[ES_SOIL_PROBE_COUNT]; // Poller block of every probe
+#endif // ES_SOIL_RS485_MODULE
 
 /* Task definitions-------------------------------------------- */
 
 #ifdef ES_SOIL_RS485_MODULE
-void soilRs485Task(void *pvParameters)
+void soilRs485PollCallback(uint8_t slave, uint16_t address, const uint16_t *values, uint16_t count,
+                           bsp_modbus_error_t result, void *context)
 {
-  for (;;)
-  {
-    esSoil.readSoilPh();
-    esSoil.readSoilTempAndMoisture();
-    esSoil.readSoilConductivity();
-    esSoil.readSoilNPK();
+  EsSoil7n1 *probe = (EsSoil7n1 *) context;
 
-    vTaskDelay(pdMS_TO_TICKS(DELAY_SOIL_RS485));
+  if (result == BSP_MODBUS_OK)
+  {
+    probe->decodeSpan(values);
+  }
+  else if (result == BSP_MODBUS_ERR_EXCEPTION)
+  {
+    // Probe rejects these requests: poll the driver's next smaller plan from now on, through the poller so
+    // the requests stay in the slave's counters. The last plan is kept even if it is rejected too.
+    bsp_modbus_range_t ranges[ES_SOIL_MAX_PLAN_RANGES];
+    uint8_t            count = probe->nextReadPlan(ranges);
+    if (count > 0)
+    {
+      modbusPoller1.splitBlock(soilBlocks[probe - esSoil], ranges, count);
+    }
+  }
+#ifdef DEBUG_PRINT
+  else
+  {
+    Serial.printf("Error: soil probe 0x%02X poll failed (%d)\n", slave, result);
   }
+#endif // DEBUG_PRINT
 }
 
-void soilRs485Setup() { xTaskCreate(&soilRs485Task, "ES Soil Task", 4096, nullptr, 1, nullptr); }
+void soilRs485Setup()
+{
+  // Every probe is one span block, the poller runs them back to back on the shared line
+  for (uint8_t i = 0; i < ES_SOIL_PROBE_COUNT; i++)
+  {
+    esSoil[i].begin(ES_SOIL_PROBE_SLAVES[i], modbusMaster1);
+    soilBlocks[i] = modbusPoller1.addBlock(ES_SOIL_PROBE_SLAVES[i], BSP_MODBUS_READ_HOLDING_REGISTERS,
+                                           ES_SOIL_FIRST_REG, ES_SOIL_SPAN_LENGTH, DELAY_SOIL_RS485,
+                                           soilSpans[i], soilRs485PollCallback, &esSoil[i]);
+  }
+  modbusPoller1.start();
+}
 #endif // ES_SOIL_RS485_MODULE
 
 #ifdef RS485_MODULE
-void rs485Setup() { rs485Serial1.begin(9600, SERIAL_8N1, D7, D6); }
+void rs485Setup()
+{
+  rs485Serial1.begin(9600, SERIAL_8N1, D7, D6);
+  // Modbus replies complete on the UART RX-timeout event instead of a polled silence
+  rs485Serial1.enableFrameNotify();
+}
 #endif // RS485_MODULE
 
 /* Private function prototypes ---------------------------------------- */
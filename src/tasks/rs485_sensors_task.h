@@ -19,6 +19,7 @@
     #include "WProgram.h"
   #endif
 
+  #include "bsp_modbus.h"
   #include "bsp_rs485.h"
 
   /* Public defines ----------------------------------------------------- */
@@ -31,7 +32,8 @@
 /* Public variables --------------------------------------------------- */
 
 /* Task Declaration -------------------------------------------------- */
-void soilRs485Task(void *pvParameters);
+void soilRs485PollCallback(uint8_t slave, uint16_t address, const uint16_t *values, uint16_t count,
+                           bsp_modbus_error_t result, void *context);
 
 void soilRs485Setup();
 
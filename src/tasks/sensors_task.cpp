@@ -12,7 +12,9 @@
 /* Includes ----------------------------------------------------------- */
 #include "sensors_task.h"
 #include "bsp_rs485.h"
+#include "data_hub.h"
 #include "globals.h"
+#include "sensor_scheduler.h"
 
 /* Private defines ---------------------------------------------------- */
 
@@ -24,61 +26,93 @@
 
 /* Private variables -------------------------------------------------- */
 
-/* Task definitions ------------------------------------------- */
+/* Job definitions -------------------------------------------- */
 #ifdef DHT20_MODULE
-void dht20Task(void *pvParameters)
+void dht20Job(void *context)
 {
-  for (;;)
+  if (dht20.readTempAndHumidity() != DHT20_OK)
   {
-    dht20.readTempAndHumidity();
-    vTaskDelay(DELAY_DHT20 / portTICK_PERIOD_MS);
+    dataHub.publishError(DATA_HUB_TEMPERATURE);
+    dataHub.publishError(DATA_HUB_HUMIDITY);
+    return;
   }
+  dataHub.publish(DATA_HUB_TEMPERATURE, dht20.getTemperature());
+  dataHub.publish(DATA_HUB_HUMIDITY, dht20.getHumidity());
 }
 
 void dht20Setup()
 {
-  dht20.begin();
-  xTaskCreate(dht20Task, "DHT 20 Task", 8192, NULL, 1, NULL);
+  dht20.begin(SENSOR_I2C_BUS);
+  sensorScheduler.addJob("dht20", dht20Job, NULL, DELAY_DHT20, PHASE_DHT20);
 }
 #endif // DHT20_MODULE
 
 #ifdef SHT4X_MODULE
-void sht40Task(void *pvParameters)
+void sht40Job(void *context)
 {
-  for (;;)
+  if (sht40.update() != SHT4X_OK)
   {
-    sht40.update();
-    vTaskDelay(DELAY_SHT4X / portTICK_PERIOD_MS);
+    dataHub.publishError(DATA_HUB_TEMPERATURE);
+    dataHub.publishError(DATA_HUB_HUMIDITY);
+    return;
   }
+  dataHub.publish(DATA_HUB_TEMPERATURE, sht40.getTemperature());
+  dataHub.publish(DATA_HUB_HUMIDITY, sht40.getHumidity());
 }
+
 void sht40Setup()
 {
-  sht40.begin();
+  sht40.begin(SENSOR_I2C_BUS);
   sht40.setHeater(SHT4X_NO_HEATER);
   sht40.setPrecision(SHT4X_HIGH_PRECISION);
-  xTaskCreate(sht40Task, "SHT40 Task", 4096, NULL, 1, NULL);
+  sensorScheduler.addJob("sht40", sht40Job, NULL, DELAY_SHT4X, PHASE_SHT4X);
 }
 #endif // SHT4X_MODULE
 
 #ifdef BMP280_MODULE
-void bmp280Task(void *pvParameters)
+// Starts the forced conversion bmp280Job() reads, the sensor sleeps between the two
+void bmp280TriggerJob(void *context)
 {
-  for (;;)
+  if (bmp280.startForcedMeasurement() != BMP280_OK)
+  {
+    dataHub.publishError(DATA_HUB_PRESSURE);
+    dataHub.publishError(DATA_HUB_ALTITUDE);
+  }
+}
+
+void bmp280Job(void *context)
+{
+  bmp280_error_t result = bmp280.update();
+
+  // No conversion to read: the trigger was skipped or failed (it reported that), or the conversion is
+  // still running and the next trigger starts over. Either way there is no new value this cycle
+  if (result == BMP280_ERR_NO_DATA || result == BMP280_ERR_BUSY)
+  {
+    return;
+  }
+  if (result != BMP280_OK)
   {
-    bmp280.update();
-    vTaskDelay(DELAY_BMP280 / portTICK_PERIOD_MS);
+    dataHub.publishError(DATA_HUB_PRESSURE);
+    dataHub.publishError(DATA_HUB_ALTITUDE);
+    return;
   }
+  dataHub.publish(DATA_HUB_PRESSURE, bmp280.getPressure());
+  dataHub.publish(DATA_HUB_ALTITUDE, bmp280.getAltitude());
 }
 
 void bmp280Setup()
 {
-  bmp280.begin();
-  bmp280.setSampling(MODE_NORMAL,     /* Operating Mode. */
+  bmp280.begin(SENSOR_I2C_BUS);
+  // One conversion per read instead of one every 500 ms. The IIR filter is off: across conversions 30 s
+  // apart it would average minutes of pressure, the x16 oversampling already smooths each reading
+  bmp280.setSampling(MODE_FORCED,     /* Operating Mode. */
                      SAMPLING_X2,     /* Temp. oversampling */
                      SAMPLING_X16,    /* Pressure oversampling */
-                     FILTER_X16,      /* Filtering. */
-                     STANDBY_MS_500); /* Standby time. */
-  xTaskCreate(bmp280Task, "BMP280 Task", 4096, NULL, 1, NULL);
+                     FILTER_OFF,      /* Filtering. */
+                     STANDBY_MS_500); /* Standby time, unused in forced mode. */
+  sensorScheduler.addJob("bmp280_trig", bmp280TriggerJob, NULL, DELAY_BMP280, PHASE_BMP280);
+  sensorScheduler.addJob("bmp280", bmp280Job, NULL, DELAY_BMP280,
+                         PHASE_BMP280 + bmp280.measurementTimeMs() + BMP280_TRIGGER_MARGIN_MS);
 }
 #endif // BMP280_MODULE
 
@@ -91,58 +125,92 @@ void unitENVIVSetup()
 #endif // defined(SHT4X_MODULE) && defined(BMP280_MODULE)
 
 #ifdef AC_MEASURE_MODULE
-void acMeasureSetup() { acMeasure.begin(); }
+void acMeasureJob(void *context)
+{
+  ac_measure_snapshot_t snapshot;
+
+  if (acMeasure.readSnapshot(&snapshot) != UNIT_AC_MEASURE_OK)
+  {
+    dataHub.publishError(DATA_HUB_AC_VOLTAGE);
+    dataHub.publishError(DATA_HUB_AC_CURRENT);
+    dataHub.publishError(DATA_HUB_AC_POWER);
+    dataHub.publishError(DATA_HUB_AC_POWER_FACTOR);
+    return;
+  }
+  dataHub.publish(DATA_HUB_AC_VOLTAGE, snapshot.voltage);
+  dataHub.publish(DATA_HUB_AC_CURRENT, snapshot.current);
+  dataHub.publish(DATA_HUB_AC_POWER, snapshot.power);
+  dataHub.publish(DATA_HUB_AC_POWER_FACTOR, snapshot.powerFactor);
+}
+
+void acMeasureSetup()
+{
+  // Without the unit every run would only publish errors and hold the bus for a NACK
+  if (acMeasure.begin(SENSOR_I2C_BUS) != UNIT_AC_MEASURE_OK)
+  {
+  #ifdef DEBUG_PRINT
+    Serial.println("Error: AC measure unit not found, AC job not scheduled");
+  #endif // DEBUG_PRINT
+    return;
+  }
+  sensorScheduler.addJob("ac", acMeasureJob, NULL, DELAY_AC_MEASURE, PHASE_AC_MEASURE);
+}
 #endif // AC_MEASURE_MODULE
 
 #ifdef LIGHT_SENSOR_MODULE
-void lightSensorTask(void *pvParameters)
+void lightSensorJob(void *context)
 {
-  for (;;)
+  if (lightSensor.read() != LIGHT_SENSOR_OK)
   {
-    lightSensor.read();
-    vTaskDelay(DELAY_LIGHT_SENSOR / portTICK_PERIOD_MS);
+    dataHub.publishError(DATA_HUB_LIGHT);
+    return;
   }
+  dataHub.publish(DATA_HUB_LIGHT, lightSensor.getLightValuePercentage());
 }
 
-void lightSensorSetup() { xTaskCreate(lightSensorTask, "Light Sensor Task", 4096, NULL, 1, NULL); }
+void lightSensorSetup()
+{
+  sensorScheduler.addJob("light", lightSensorJob, NULL, DELAY_LIGHT_SENSOR, PHASE_LIGHT_SENSOR);
+}
 #endif // LIGHT_SENSOR_MODULE
 
 #ifdef ULTRASONIC_MODULE
-void ultrasonicTask(void *pvParameters)
+void ultrasonicJob(void *context)
 {
-  for (;;)
-  {
-    ultrasonic.read('c');
-    ultrasonic.read('m');
-    ultrasonic.read('i');
-    vTaskDelay(DELAY_ULTRASONIC / portTICK_PERIOD_MS);
-  }
+  ultrasonic.read('c');
+  ultrasonic.read('m');
+  ultrasonic.read('i');
+  dataHub.publish(DATA_HUB_DISTANCE, ultrasonic.getDistance('c'));
+}
+
+void ultrasonicSetup()
+{
+  sensorScheduler.addJob("ultrasonic", ultrasonicJob, NULL, DELAY_ULTRASONIC, PHASE_ULTRASONIC);
 }
-void ultrasonicSetup() { xTaskCreate(ultrasonicTask, "Ultrasonic Sensor Task", 4096, NULL, 1, NULL); }
 #endif // ULTRASONIC_MODULE
 
 #ifdef PIR_MODULE
-void pirSensorTask(void *pvParameters)
+void pirSensorJob(void *context)
 {
-  for (;;)
-  {
-    pirSensor.read();
-    vTaskDelay(DELAY_PIRSENSOR / portTICK_PERIOD_MS);
-  }
+  pirSensor.read();
+  dataHub.publish(DATA_HUB_MOTION, pirSensor.getStatus());
 }
-void pirSensorSetup() { xTaskCreate(pirSensorTask, "PIR Sensor Task", 4096, NULL, 1, NULL); }
+
+void pirSensorSetup() { sensorScheduler.addJob("pir", pirSensorJob, NULL, DELAY_PIRSENSOR, PHASE_PIRSENSOR); }
 #endif // PIR_MODULE
 
 #ifdef SOIL_MOISTURE_MODULE
-void soilMoistureTask(void *pvParameters)
+void soilMoistureJob(void *context)
 {
-  for (;;)
-  {
-    soilMoisture.read();
-    vTaskDelay(DELAY_MOISTURE / portTICK_PERIOD_MS);
-  }
+  soilMoisture.read();
+  dataHub.publish(DATA_HUB_SOIL_MOISTURE, soilMoisture.getMoisture());
+  dataHub.publish(DATA_HUB_SOIL_MOISTURE_PERCENT, soilMoisture.getMoisturePercentage());
+}
+
+void soilMoistureSetup()
+{
+  sensorScheduler.addJob("moisture", soilMoistureJob, NULL, DELAY_MOISTURE, PHASE_MOISTURE);
 }
-void soilMoistureSetup() { xTaskCreate(soilMoistureTask, "Soil Moisture Task", 4096, NULL, 1, NULL); }
 #endif // SOIL_MOISTURE_MODULE
 
 /* End of file -------------------------------------------------------- */
\ No newline at end of file
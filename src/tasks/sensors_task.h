@@ -21,15 +21,29 @@
   #endif
 
   /* Public defines ----------------------------------------------------- */
-  #define DELAY_DHT20        60000
-  #define DELAY_SHT4X        60000
-  #define DELAY_BMP280       60000
-  #define DELAY_LIGHT_SENSOR 10000
+  #define DELAY_DHT20        30000
+  #define DELAY_SHT4X        30000
+  #define DELAY_BMP280       30000
+  #define DELAY_LIGHT_SENSOR 2000 // Oversampled, the telemetry window reports min/max/mean
+  #define DELAY_AC_MEASURE   2000 // Oversampled, the telemetry window reports min/max/mean
   #define DELAY_ULTRASONIC   1000
   #define DELAY_PIRSENSOR    1000
   #define DELAY_MOISTURE     60000
   #define DELAY_SOIL_RS485   60000
 
+  // First run after the scheduler starts, spreads the reads that share a period
+  #define PHASE_DHT20        0
+  #define PHASE_SHT4X        0
+  #define PHASE_BMP280       250
+  #define PHASE_LIGHT_SENSOR 500
+  #define PHASE_ULTRASONIC   0
+  #define PHASE_PIRSENSOR    0
+  #define PHASE_MOISTURE     750
+  #define PHASE_AC_MEASURE   100
+
+  // Forced-mode BMP280: the read follows the trigger by the conversion time plus this margin
+  #define BMP280_TRIGGER_MARGIN_MS 20
+
 /* Public enumerate/structure ----------------------------------------- */
 
 /* Public macros ------------------------------------------------------ */
@@ -37,13 +51,15 @@
 /* Public variables --------------------------------------------------- */
 
 /* Funtions Declaration -------------------------------------------------- */
-void dht20Task(void *pvParameters);
-void sht40Task(void *pvParameters);
-void bmp280Task(void *pvParameters);
-void acMeasureTask(void *pvParameters);
-void lightSensorTask(void *pvParameters);
-void ultraSonicTask(void *pvParameters);
-void pirSensorTask(void *pvParameters);
+void dht20Job(void *context);
+void sht40Job(void *context);
+void bmp280TriggerJob(void *context);
+void bmp280Job(void *context);
+void acMeasureJob(void *context);
+void lightSensorJob(void *context);
+void ultrasonicJob(void *context);
+void pirSensorJob(void *context);
+void soilMoistureJob(void *context);
 
 void dht20Setup();
 void sht40Setup();
@@ -0,0 +1,130 @@
+/**
+ * @file       storage_task.cpp
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-12
+ * @author     Tuan Nguyen
+ *
+ * @brief      Source file for the sensor history storage task
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "storage_task.h"
+#include "data_hub.h"
+#include "globals.h"
+#include "ts_log.h"
+#include <LittleFS.h>
+
+/* Private defines ---------------------------------------------------- */
+
+/* Private enumerate/structure ---------------------------------------- */
+
+/* Private macros ----------------------------------------------------- */
+
+/* Public variables --------------------------------------------------- */
+
+/* Private variables -------------------------------------------------- */
+
+/* Private function prototypes ---------------------------------------- */
+#ifdef TS_LOG_MODULE
+static void storageBackfill(time_t now, uint32_t *lastVersion);
+#endif // TS_LOG_MODULE
+
+/* Task definitions ------------------------------------------- */
+#ifdef TS_LOG_MODULE
+void storageTask(void *pvParameters)
+{
+  uint32_t   lastVersion[DATA_HUB_CHANNEL_COUNT] = {0};
+  uint8_t    flushCycle                          = 0;
+  bool       clockSet                            = false;
+  TickType_t lastWakeTime                        = xTaskGetTickCount();
+
+  for (;;)
+  {
+    vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(DELAY_STORAGE));
+
+    // Records carry wall-clock time so they stay in order across reboots. Until SNTP sets the clock (wifi
+    // task, once connected) samples wait in the data hub history under their millis() time.
+    time_t now = time(NULL);
+    if (now < (time_t) STORAGE_MIN_VALID_TIME)
+    {
+      continue;
+    }
+    if (!clockSet)
+    {
+      clockSet = true;
+      storageBackfill(now, lastVersion);
+    }
+
+    // Newest sample of every channel that published since the last cycle, back-dated to its read time
+    for (uint8_t channel = 0; channel < DATA_HUB_CHANNEL_COUNT; channel++)
+    {
+      data_hub_sample_t sample;
+      if (dataHub.read((data_hub_channel_t) channel, &sample) == DATA_HUB_OK &&
+          sample.quality == DATA_HUB_QUALITY_GOOD && sample.version != lastVersion[channel])
+      {
+        lastVersion[channel] = sample.version;
+        tsLog.append(channel, (uint32_t) now - (millis() - sample.timestampMs) / 1000, sample.value);
+      }
+    }
+
+    if (++flushCycle >= STORAGE_FLUSH_CYCLES)
+    {
+      flushCycle = 0;
+      tsLog.flush();
+    }
+
+    // At most one retention or compaction step per cycle, the log needs a few per day
+    tsLog.maintain((uint32_t) now);
+  }
+}
+
+void storageSetup()
+{
+  // Mounted without formatting, a failed mount must not wipe the web UI on the same partition
+  if (!LittleFS.begin() || tsLog.begin(LittleFS) != TS_LOG_OK)
+  {
+  #ifdef DEBUG_PRINT
+    Serial.println("Time-series log unavailable");
+  #endif // DEBUG_PRINT
+    return;
+  }
+  xTaskCreate(storageTask, "Storage Task", STORAGE_TASK_STACK, NULL, STORAGE_TASK_PRIORITY, NULL);
+}
+
+// Logs the history measured before the clock was set, as far back as the rings reach
+static void storageBackfill(time_t now, uint32_t *lastVersion)
+{
+  uint32_t nowMs = millis();
+
+  for (uint8_t channel = 0; channel < DATA_HUB_CHANNEL_COUNT; channel++)
+  {
+    const SampleRing *ring = dataHub.history((data_hub_channel_t) channel);
+    data_hub_sample_t newest;
+    if (ring == NULL || dataHub.read((data_hub_channel_t) channel, &newest) != DATA_HUB_OK ||
+        newest.quality != DATA_HUB_QUALITY_GOOD)
+    {
+      continue;
+    }
+
+    // Up to the sample read above, the regular cycle picks up anything newer by its version
+    sample_ring_view_t view  = ring->view();
+    uint16_t           count = SampleRing::length(&view);
+    for (uint16_t i = 0; i < count; i++)
+    {
+      sample_ring_sample_t sample = *SampleRing::at(&view, i);
+      sample_ring_view_t   check  = view;
+      // trim() drops the samples the producer overwrote meanwhile, all older than the ones it keeps
+      if (count - ring->trim(&check) > i || (int32_t) (sample.timestampMs - newest.timestampMs) > 0)
+      {
+        continue;
+      }
+      tsLog.append(channel, (uint32_t) now - (nowMs - sample.timestampMs) / 1000, sample.value);
+    }
+    lastVersion[channel] = newest.version;
+  }
+}
+#endif // TS_LOG_MODULE
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,42 @@
+/**
+ * @file       storage_task.h
+ * @license    This library is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-12
+ * @author     Tuan Nguyen
+ *
+ * @brief      Header file for the sensor history storage task
+ *
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef STORAGE_TASK_H
+  #define STORAGE_TASK_H
+
+  /* Includes ----------------------------------------------------------- */
+  #if ARDUINO >= 100
+    #include "Arduino.h"
+  #else
+    #include "WProgram.h"
+  #endif
+
+  /* Public defines ----------------------------------------------------- */
+  #define DELAY_STORAGE          60000        // One record per channel per minute
+  #define STORAGE_FLUSH_CYCLES   10           // Write the RAM block at least every 10 minutes
+  #define STORAGE_MIN_VALID_TIME 1704067200UL // 2024-01-01, earlier means the clock is not set
+  #define STORAGE_TASK_STACK     6144
+  #define STORAGE_TASK_PRIORITY  1
+
+/* Public enumerate/structure ----------------------------------------- */
+
+/* Public macros ------------------------------------------------------ */
+
+/* Public variables --------------------------------------------------- */
+
+/* Funtions Declaration -------------------------------------------------- */
+void storageTask(void *pvParameters);
+void storageSetup();
+
+#endif // STORAGE_TASK_H
+
+/* End of file -------------------------------------------------------- */
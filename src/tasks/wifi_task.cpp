@@ -187,6 +187,9 @@ void wifiTask(void *pvParameters)
         Serial.println("Connected to WiFi");
 #endif // DEBUG_PRINT
 
+        // Wall-clock time for the sensor history and the offline telemetry, SNTP keeps it set from now on
+        configTime(0, 0, NTP_SERVER_PRIMARY, NTP_SERVER_SECONDARY);
+
 #ifdef LCD_MODULE
         lcd.clear();
         lcd.print("WiFi connected");
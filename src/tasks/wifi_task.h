@@ -22,6 +22,8 @@
 
   #include <Preferences.h>
 /* Public defines ----------------------------------------------------- */
+  #define NTP_SERVER_PRIMARY   "pool.ntp.org"
+  #define NTP_SERVER_SECONDARY "time.google.com"
 
 /* Public enumerate/structure ----------------------------------------- */
 
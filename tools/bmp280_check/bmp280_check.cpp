@@ -0,0 +1,158 @@
+/**
+ * @file       bmp280_check.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-22
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host check of the BMP280 driver against the datasheet on the virtual bus
+ *
+ * @note       The virtual BMP280 holds the compensation words and raw readings of the datasheet worked example
+ *             (section 8.2): 25.08 °C, and 100653.27 Pa in double precision or 25767233 / 256 = 100653.25 Pa
+ *             with the 64-bit integer formula the driver uses. Checks that:
+ *               - a forced cycle reproduces those values, reading the data registers as one 6-byte burst
+ *               - the per-field `readTemperature()` and `readPressure()` agree with the burst
+ *               - `setSampling()` in forced mode starts a conversion, `update()` reads each conversion once
+ *               - `update()` reports no data without a started conversion and busy while the status register
+ *                 shows one running, and leaves the data registers alone in both cases
+ *               - a skipped measurement (raw 0x80000) is no data
+ *               - `measurementTimeMs()` covers the maximum conversion times of the datasheet presets (table 13)
+ *             Exits with 1 when a check fails.
+ * @example    g++ -std=gnu++11 -O2 -pthread -DARDUINO=10819 -DBSP_I2C_VIRTUAL -Itools/modbus_sim/host \
+ *                 -Ilib/bsp -Ilib/config/src -Ilib/checksum/src -Ilib/fast_math/src -Ilib/bmp280/src \
+ *                 tools/bmp280_check/bmp280_check.cpp tools/modbus_sim/host/host_arduino.cpp \
+ *                 tools/modbus_sim/host/host_wire.cpp lib/bsp/bsp_i2c.cpp lib/bsp/bsp_i2c_virtual.cpp \
+ *                 lib/checksum/src/checksum.cpp lib/fast_math/src/fast_math.cpp lib/bmp280/src/bmp280.cpp \
+ *                 -o bmp280_check && ./bmp280_check
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "Arduino.h"
+#include "bmp280.h"
+#include "bsp_i2c.h"
+#include "bsp_i2c_virtual.h"
+
+#include <math.h>
+#include <stdio.h>
+
+/* Private defines ---------------------------------------------------- */
+#define CHECK_BUS              BSP_I2C_VIRTUAL_SENSOR_BUS
+#define CHECK_ADDR             BSP_I2C_VIRTUAL_BMP280_ADDR
+#define CHECK_REG_STATUS       0xF3
+#define CHECK_REG_DATA         0xF7
+#define CHECK_STATUS_MEASURING 0x08
+
+// Datasheet section 8.2, results of the integer compensation
+#define CHECK_TEMPERATURE 25.08f
+#define CHECK_PRESSURE    (25767233 / 256.0f)
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef struct
+{
+  const char       *name;
+  bmp280_sampling_t temperature;
+  bmp280_sampling_t pressure;
+  float             maxMs; // Maximum measurement time, datasheet table 13
+} check_preset_t;
+
+/* Private variables -------------------------------------------------- */
+static const check_preset_t presets[] = {{"ultra low power", SAMPLING_X1, SAMPLING_X1, 6.4f},
+                                         {"low power", SAMPLING_X1, SAMPLING_X2, 8.7f},
+                                         {"standard resolution", SAMPLING_X1, SAMPLING_X4, 13.3f},
+                                         {"high resolution", SAMPLING_X1, SAMPLING_X8, 22.5f},
+                                         {"ultra high resolution", SAMPLING_X2, SAMPLING_X16, 43.2f}};
+
+static int checkFailures = 0;
+
+/* Private function prototypes ---------------------------------------- */
+static void check(bool condition, const char *what);
+static void setStatus(uint8_t status);
+
+/* Function definitions ----------------------------------------------- */
+int main()
+{
+  BMP280                  bmp280;
+  bsp_i2c_virtual_stats_t before;
+  bsp_i2c_virtual_stats_t after;
+
+  Serial.mute(true);
+  bspI2CBegin(CHECK_BUS);
+  check(bmp280.begin(CHECK_BUS) == BMP280_OK, "begin");
+  Serial.mute(false);
+
+  // Conversion times of the datasheet presets
+  for (const check_preset_t &preset : presets)
+  {
+    bmp280.setSampling(MODE_FORCED, preset.temperature, preset.pressure, FILTER_OFF, STANDBY_MS_500);
+    uint32_t timeMs = bmp280.measurementTimeMs();
+    printf("%-22s %3u ms (datasheet max %.1f ms)\n", preset.name, timeMs, preset.maxMs);
+    check(timeMs >= preset.maxMs && timeMs < preset.maxMs + 1.0f, "measurement time of a preset");
+  }
+
+  // The firmware's setting from here on, writing the control register in forced mode starts a conversion
+  bmp280.setSampling(MODE_FORCED, SAMPLING_X2, SAMPLING_X16, FILTER_OFF, STANDBY_MS_500);
+  check(bmp280.update() == BMP280_OK, "conversion started by setSampling()");
+
+  // Nothing started since: no data, and no read of the data registers
+  bspI2CVirtualGetStats(CHECK_ADDR, &before);
+  check(bmp280.update() == BMP280_ERR_NO_DATA, "no data without a started conversion");
+  bspI2CVirtualGetStats(CHECK_ADDR, &after);
+  check(after.transactions == before.transactions, "no traffic without a started conversion");
+
+  // Conversion running: busy until the status register clears, the conversion stays pending
+  check(bmp280.startForcedMeasurement() == BMP280_OK, "start a forced conversion");
+  setStatus(CHECK_STATUS_MEASURING);
+  bspI2CVirtualGetStats(CHECK_ADDR, &before);
+  check(bmp280.update() == BMP280_ERR_BUSY, "busy while measuring");
+  bspI2CVirtualGetStats(CHECK_ADDR, &after);
+  check(after.transactions == before.transactions + 1 && after.bytesRead == before.bytesRead + 1,
+        "only the status byte read while measuring");
+  setStatus(0);
+
+  // Conversion done: one status byte, then the six data registers in one burst
+  bspI2CVirtualGetStats(CHECK_ADDR, &before);
+  check(bmp280.update() == BMP280_OK, "update after the conversion");
+  bspI2CVirtualGetStats(CHECK_ADDR, &after);
+  float temperature = bmp280.getTemperature();
+  float pressure    = bmp280.getPressure();
+  printf("burst: T %.2f C, P %.2f Pa, altitude %.1f m, %u transactions, %u bytes read\n", temperature,
+         pressure, bmp280.getAltitude(), after.transactions - before.transactions,
+         after.bytesRead - before.bytesRead);
+  check(fabsf(temperature - CHECK_TEMPERATURE) < 0.005f, "datasheet temperature");
+  check(fabsf(pressure - CHECK_PRESSURE) < 0.01f, "datasheet pressure");
+  check(after.transactions - before.transactions == 2 && after.bytesRead - before.bytesRead == 7,
+        "status byte and one 6-byte burst");
+  check(bmp280.update() == BMP280_ERR_NO_DATA, "a conversion is read once");
+
+  // The per-field reads compensate the same registers
+  check(bmp280.readTemperature() == BMP280_OK && bmp280.readPressure() == BMP280_OK, "per-field reads");
+  printf("per field: T %.2f C, P %.2f Pa\n", bmp280.getTemperature(), bmp280.getPressure());
+  check(bmp280.getTemperature() == temperature && bmp280.getPressure() == pressure, "per-field values");
+
+  // Pressure measurement skipped: the data registers hold the reset value 0x80000
+  const uint8_t skipped[3] = {0x80, 0x00, 0x00};
+  uint8_t       data[6];
+  bspI2CReadBytes(CHECK_BUS, CHECK_ADDR, CHECK_REG_DATA, data, sizeof(data));
+  bspI2CVirtualSetRegisters(CHECK_ADDR, CHECK_REG_DATA, skipped, sizeof(skipped));
+  bmp280.startForcedMeasurement();
+  check(bmp280.update() == BMP280_ERR_NO_DATA, "skipped measurement is no data");
+  bspI2CVirtualSetRegisters(CHECK_ADDR, CHECK_REG_DATA, data, sizeof(data));
+
+  printf("%s\n", (checkFailures == 0) ? "PASS" : "FAIL");
+
+  return (checkFailures == 0) ? 0 : 1;
+}
+
+/* Private definitions ------------------------------------------------ */
+static void check(bool condition, const char *what)
+{
+  if (!condition)
+  {
+    printf("FAILED: %s\n", what);
+    checkFailures++;
+  }
+}
+
+static void setStatus(uint8_t status) { bspI2CVirtualSetRegisters(CHECK_ADDR, CHECK_REG_STATUS, &status, 1); }
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,194 @@
+/**
+ * @file       fast_math_bench.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-20
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host microbenchmark of the Fast Math library against the libm code it replaced
+ *
+ * @note       Measures the largest error of every function against libm in double precision over the
+ *             ranges the drivers use (every pascal from 300 hPa to 1100 hPa for the altitude, the boiling
+ *             point over the same range, log2 within ±8 and over all floats, exp2 within ±8, pow for bases
+ *             1/4 to 4 and exponents within ±4), then times both versions. Exits with 1 when an error exceeds
+ *             the bound documented in fast_math.h.
+ *
+ *             The host has a double precision FPU, the timings understate the gain on the ESP32-S3 where
+ *             `pow()` and `log()` run in software.
+ * @example    g++ -std=gnu++11 -O2 -Ilib/fast_math/src tools/fast_math_bench/fast_math_bench.cpp \
+ *                 lib/fast_math/src/fast_math.cpp -o fast_math_bench && ./fast_math_bench
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "fast_math.h"
+
+#include <chrono>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+
+/* Private defines ---------------------------------------------------- */
+#define BENCH_SEA_LEVEL_HPA   1013.25f
+#define BENCH_PRESSURE_MIN_PA 30000
+#define BENCH_PRESSURE_MAX_PA 110000
+#define BENCH_RANDOM_SAMPLES  1000000
+#define BENCH_TIMING_CALLS    2000000
+
+#define BENCH_BOUND_LOG       3e-6   // Absolute, fastLog2f and fastLnf while |log2(x)| <= 8
+#define BENCH_BOUND_EXP       1.5e-6 // Relative, fastExp2f
+#define BENCH_BOUND_POW_Y     2e-6   // Relative, fastPowf adds this per unit of |y|
+#define BENCH_BOUND_ALTITUDE  0.05   // Meters
+#define BENCH_BOUND_BOILING   0.001  // Degrees Celsius
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef std::chrono::steady_clock bench_clock_t;
+
+/* Private variables -------------------------------------------------- */
+static uint32_t     benchSeed = 0x2545F491;
+static volatile int benchSink;
+
+/* Private function prototypes ---------------------------------------- */
+static uint32_t nextRandom();
+static double   uniform(double low, double high);
+static bool     check(const char *name, double error, double bound);
+static double   nsSince(bench_clock_t::time_point start);
+
+/* Function definitions ----------------------------------------------- */
+int main()
+{
+  bool   ok = true;
+  double error;
+
+  // log2 within the bound range, then on every exponent, subnormals included, where the float rounding of
+  // results up to 149 adds to the table error
+  error = 0.0;
+  for (int i = 0; i < BENCH_RANDOM_SAMPLES; i++)
+  {
+    float x = (float) ldexp(uniform(1.0, 2.0), (int) (nextRandom() % 16) - 8);
+    error   = fmax(error, fabs(fastLog2f(x) - log2((double) x)));
+  }
+  ok = check("fastLog2f", error, BENCH_BOUND_LOG) && ok;
+
+  error = 0.0;
+  for (int i = 0; i < BENCH_RANDOM_SAMPLES; i++)
+  {
+    float x = (float) ldexp(uniform(1.0, 2.0), (int) (nextRandom() % 276) - 149);
+    if (x > 0.0f)
+    {
+      error = fmax(error, fabs(fastLog2f(x) - log2((double) x)) - ldexp(fabs(log2((double) x)), -24));
+    }
+  }
+  ok = check("fastLog2f all floats", error, BENCH_BOUND_LOG) && ok;
+
+  error = 0.0;
+  for (int i = 0; i < BENCH_RANDOM_SAMPLES; i++)
+  {
+    float x = (float) uniform(1e-3, 1e3);
+    error   = fmax(error, fabs(fastLnf(x) - log((double) x)));
+  }
+  ok = check("fastLnf", error, BENCH_BOUND_LOG) && ok;
+
+  error = 0.0;
+  for (int i = 0; i < BENCH_RANDOM_SAMPLES; i++)
+  {
+    float  y     = (float) uniform(-8.0, 8.0);
+    double exact = exp2((double) y);
+    error        = fmax(error, fabs(fastExp2f(y) - exact) / exact);
+  }
+  ok = check("fastExp2f", error, BENCH_BOUND_EXP) && ok;
+
+  error = 0.0;
+  for (int i = 0; i < BENCH_RANDOM_SAMPLES; i++)
+  {
+    float  x     = (float) uniform(0.25, 4.0);
+    float  y     = (float) uniform(-4.0, 4.0);
+    double exact = pow((double) x, (double) y);
+    error        = fmax(error, fabs(fastPowf(x, y) - exact) / exact - BENCH_BOUND_POW_Y * fabs(y));
+  }
+  ok = check("fastPowf - 2e-6 |y|", error, BENCH_BOUND_EXP) && ok;
+
+  // Every pascal the BMP280 reports, against BMP280::readAltitude() as it was
+  error = 0.0;
+  for (int32_t pressure = BENCH_PRESSURE_MIN_PA; pressure <= BENCH_PRESSURE_MAX_PA; pressure++)
+  {
+    double exact = 44330 * (1.0 - pow(pressure / 100.0f / BENCH_SEA_LEVEL_HPA, 0.1903));
+    error        = fmax(error, fabs(fastPressureAltitude((float) pressure, BENCH_SEA_LEVEL_HPA) - exact));
+  }
+  ok = check("fastPressureAltitude", error, BENCH_BOUND_ALTITUDE) && ok;
+
+  // BMP280::waterBoilingPoint() as it was and with one fastLnf()
+  error = 0.0;
+  for (int32_t pressure = BENCH_PRESSURE_MIN_PA; pressure <= BENCH_PRESSURE_MAX_PA; pressure++)
+  {
+    float  hPa   = pressure / 100.0f;
+    double exact = (234.175 * log(hPa / 6.1078)) / (17.08085 - log(hPa / 6.1078));
+    float  ln    = fastLnf(hPa / 6.1078f);
+    error        = fmax(error, fabs(234.175f * ln / (17.08085f - ln) - exact));
+  }
+  ok = check("boiling point", error, BENCH_BOUND_BOILING) && ok;
+
+  // Timing, the inputs drift so nothing is hoisted out of the loops
+  double libmAltitude, fastAltitude, libmLn, fastLn;
+  {
+    bench_clock_t::time_point start = bench_clock_t::now();
+    for (int i = 0; i < BENCH_TIMING_CALLS; i++)
+    {
+      float pressure  = 90000.0f + (i & 0x3FFF);
+      benchSink      += (int) (44330 * (1.0 - pow(pressure / 100 / BENCH_SEA_LEVEL_HPA, 0.1903)));
+    }
+    libmAltitude = nsSince(start) / BENCH_TIMING_CALLS;
+
+    start = bench_clock_t::now();
+    for (int i = 0; i < BENCH_TIMING_CALLS; i++)
+    {
+      benchSink += (int) fastPressureAltitude(90000.0f + (i & 0x3FFF), BENCH_SEA_LEVEL_HPA);
+    }
+    fastAltitude = nsSince(start) / BENCH_TIMING_CALLS;
+
+    start = bench_clock_t::now();
+    for (int i = 0; i < BENCH_TIMING_CALLS; i++)
+    {
+      benchSink += (int) (1000 * log((900.0f + (i & 0xFF)) / 6.1078));
+    }
+    libmLn = nsSince(start) / BENCH_TIMING_CALLS;
+
+    start = bench_clock_t::now();
+    for (int i = 0; i < BENCH_TIMING_CALLS; i++)
+    {
+      benchSink += (int) (1000 * fastLnf((900.0f + (i & 0xFF)) / 6.1078f));
+    }
+    fastLn = nsSince(start) / BENCH_TIMING_CALLS;
+  }
+  printf("\n%-22s %10s %10s\n", "ns per call", "before", "fast_math");
+  printf("%-22s %10.1f %10.1f\n", "altitude", libmAltitude, fastAltitude);
+  printf("%-22s %10.1f %10.1f\n", "ln", libmLn, fastLn);
+
+  return ok ? 0 : 1;
+}
+
+/* Private definitions ------------------------------------------------ */
+// xorshift32, the same inputs on every run
+static uint32_t nextRandom()
+{
+  benchSeed ^= benchSeed << 13;
+  benchSeed ^= benchSeed >> 17;
+  benchSeed ^= benchSeed << 5;
+
+  return benchSeed;
+}
+
+static double uniform(double low, double high) { return low + (high - low) * (nextRandom() / 4294967296.0); }
+
+static bool check(const char *name, double error, double bound)
+{
+  printf("%-22s max error %.3g (bound %.3g)%s\n", name, error, bound, (error > bound) ? "  EXCEEDED" : "");
+
+  return error <= bound;
+}
+
+static double nsSince(bench_clock_t::time_point start)
+{
+  return std::chrono::duration<double, std::nano>(bench_clock_t::now() - start).count();
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,308 @@
+/**
+ * @file       gorilla_bench.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-18
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host benchmark of the Gorilla codec on sensor traces
+ *
+ * @note       Generates a day of samples per channel shaped like the drivers produce them: SHT40 readings
+ *             converted from 16-bit ticks every 30 s, ES soil 7-in-1 registers scaled by 0.01 or 0.1 every
+ *             60 s and AC meter registers scaled by 1/100 every 10 s, with a daily cycle, a random walk,
+ *             a tick or two of noise and a second of timing jitter. Every trace is cut into 512-byte blocks
+ *             as the time-series log writes them, then decoded again and compared bit for bit; exits with 1
+ *             on a mismatch.
+ *
+ *             Prints bytes per sample in the raw log format (channel, varint delta and float per record) and
+ *             in Gorilla blocks, block headers included, and the encode and decode time.
+ * @example    g++ -std=gnu++11 -O2 -DARDUINO=10819 -Itools/modbus_sim/host -Ilib/gorilla/src \
+ *                 tools/gorilla_bench/gorilla_bench.cpp lib/gorilla/src/gorilla.cpp \
+ *                 tools/modbus_sim/host/host_arduino.cpp -o gorilla_bench && ./gorilla_bench
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "gorilla.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+/* Private defines ---------------------------------------------------- */
+#define BENCH_DAY_S        86400
+#define BENCH_BLOCK_SIZE   512 // TS_LOG_BLOCK_SIZE
+#define BENCH_BLOCK_HEADER 15  // TS_LOG_BLOCK_HEADER and the channel byte
+#define BENCH_REPEAT       20  // Encodes and decodes per timing
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef std::chrono::steady_clock bench_clock_t;
+
+typedef enum
+{
+  BENCH_SHT40_TEMPERATURE = 0,
+  BENCH_SHT40_HUMIDITY,
+  BENCH_SOIL_PH,
+  BENCH_SOIL_MOISTURE,
+  BENCH_SOIL_TEMPERATURE,
+  BENCH_SOIL_CONDUCTIVITY,
+  BENCH_SOIL_NITROGEN,
+  BENCH_AC_VOLTAGE,
+  BENCH_AC_CURRENT,
+  BENCH_AC_POWER
+} bench_trace_kind_t;
+
+typedef struct
+{
+  const char        *name;
+  bench_trace_kind_t kind;
+  uint32_t           periodS;
+  float              base;  // Level, in the unit of the value
+  float              daily; // Amplitude of the daily cycle
+  float              walk;  // Step of the random walk
+  float              noise; // Noise, in ticks
+} bench_trace_t;
+
+typedef struct
+{
+  std::vector<uint32_t> times;
+  std::vector<float>    values;
+} bench_series_t;
+
+/* Private variables -------------------------------------------------- */
+static const bench_trace_t TRACES[] = {
+{"sht40 temperature", BENCH_SHT40_TEMPERATURE, 30, 27.0f, 3.0f, 0.01f, 2.0f},
+{"sht40 humidity", BENCH_SHT40_HUMIDITY, 30, 65.0f, 10.0f, 0.05f, 3.0f},
+{"soil ph", BENCH_SOIL_PH, 60, 6.5f, 0.05f, 0.002f, 0.5f},
+{"soil moisture", BENCH_SOIL_MOISTURE, 60, 32.0f, 1.5f, 0.02f, 0.5f},
+{"soil temperature", BENCH_SOIL_TEMPERATURE, 60, 25.0f, 2.0f, 0.01f, 0.5f},
+{"soil conductivity", BENCH_SOIL_CONDUCTIVITY, 60, 1200.0f, 40.0f, 0.5f, 1.0f},
+{"soil nitrogen", BENCH_SOIL_NITROGEN, 60, 40.0f, 1.0f, 0.02f, 0.3f},
+{"ac voltage", BENCH_AC_VOLTAGE, 10, 229.0f, 2.0f, 0.02f, 8.0f},
+{"ac current", BENCH_AC_CURRENT, 10, 0.4f, 0.15f, 0.002f, 1.0f},
+{"ac power", BENCH_AC_POWER, 10, 85.0f, 30.0f, 0.3f, 20.0f}};
+
+static uint32_t benchSeed = 0x2545F491;
+
+/* Private function prototypes ---------------------------------------- */
+static uint32_t       nextRandom();
+static float          uniform();
+static float          quantize(bench_trace_kind_t kind, float level);
+static float          tickSize(bench_trace_kind_t kind);
+static bench_series_t makeSeries(const bench_trace_t *trace);
+static size_t         rawBytes(const bench_series_t *series);
+static double         nsSince(bench_clock_t::time_point start);
+
+/* Function definitions ----------------------------------------------- */
+int main()
+{
+  static uint8_t blocks[64 * 1024];
+  bool           ok          = true;
+  size_t         totalRaw    = 0;
+  size_t         totalCoded  = 0;
+  size_t         totalSample = 0;
+
+  printf("%-18s %7s %9s %11s %9s %9s\n", "trace", "samples", "raw B/smp", "gorilla B/s", "enc ns", "dec ns");
+  for (const bench_trace_t &trace : TRACES)
+  {
+    bench_series_t series = makeSeries(&trace);
+    size_t         count  = series.times.size();
+
+    // Encode into consecutive blocks, each block starting its own stream
+    std::vector<size_t>   offsets;
+    std::vector<uint16_t> counts;
+    std::vector<size_t>   lengths;
+    size_t                coded = 0;
+    double                encodeNs;
+    {
+      bench_clock_t::time_point start = bench_clock_t::now();
+      for (int repeat = 0; repeat < BENCH_REPEAT; repeat++)
+      {
+        GorillaEncoder encoder;
+        size_t         offset = 0;
+        offsets.clear();
+        counts.clear();
+        lengths.clear();
+        encoder.begin(&blocks[offset], BENCH_BLOCK_SIZE - BENCH_BLOCK_HEADER);
+        for (size_t i = 0; i < count; i++)
+        {
+          if (!encoder.append(series.times[i], series.values[i]))
+          {
+            offsets.push_back(offset);
+            counts.push_back(encoder.count());
+            lengths.push_back(encoder.length());
+            offset += encoder.length();
+            encoder.begin(&blocks[offset], BENCH_BLOCK_SIZE - BENCH_BLOCK_HEADER);
+            encoder.append(series.times[i], series.values[i]);
+          }
+        }
+        offsets.push_back(offset);
+        counts.push_back(encoder.count());
+        lengths.push_back(encoder.length());
+      }
+      encodeNs = nsSince(start) / BENCH_REPEAT / count;
+    }
+    for (size_t length : lengths)
+    {
+      coded += BENCH_BLOCK_HEADER + length;
+    }
+
+    // Decode and compare bit for bit
+    double decodeNs;
+    size_t mismatches = 0;
+    {
+      bench_clock_t::time_point start = bench_clock_t::now();
+      for (int repeat = 0; repeat < BENCH_REPEAT; repeat++)
+      {
+        size_t index = 0;
+        for (size_t block = 0; block < offsets.size(); block++)
+        {
+          GorillaDecoder decoder;
+          uint32_t       time;
+          float          value;
+          decoder.begin(&blocks[offsets[block]], lengths[block], counts[block]);
+          while (decoder.next(&time, &value))
+          {
+            if (index >= count || time != series.times[index] ||
+                memcmp(&value, &series.values[index], sizeof(value)) != 0)
+            {
+              mismatches++;
+            }
+            index++;
+          }
+        }
+        if (index != count)
+        {
+          mismatches++;
+        }
+      }
+      decodeNs = nsSince(start) / BENCH_REPEAT / count;
+    }
+
+    size_t raw = rawBytes(&series);
+    printf("%-18s %7zu %9.2f %11.2f %9.1f %9.1f%s\n", trace.name, count, (double) raw / count,
+           (double) coded / count, encodeNs, decodeNs, (mismatches > 0) ? "  MISMATCH" : "");
+    ok           = ok && mismatches == 0;
+    totalRaw    += raw;
+    totalCoded  += coded;
+    totalSample += count;
+  }
+  printf("%-18s %7zu %9.2f %11.2f   (%.0f%% of raw)\n", "all", totalSample, (double) totalRaw / totalSample,
+         (double) totalCoded / totalSample, 100.0 * totalCoded / totalRaw);
+
+  return ok ? 0 : 1;
+}
+
+/* Private definitions ------------------------------------------------ */
+// xorshift32, the same traces on every run
+static uint32_t nextRandom()
+{
+  benchSeed ^= benchSeed << 13;
+  benchSeed ^= benchSeed >> 17;
+  benchSeed ^= benchSeed << 5;
+
+  return benchSeed;
+}
+
+static float uniform() { return (nextRandom() >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f; }
+
+// Level to value through the register or tick scaling of the driver
+static float quantize(bench_trace_kind_t kind, float level)
+{
+  switch (kind)
+  {
+  case BENCH_SHT40_TEMPERATURE:
+  {
+    uint16_t ticks = (uint16_t) lroundf((level + 45.0f) / 175.0f * 65535.0f);
+    return -45.0f + 175.0f * (ticks * (1.0f / 65535.0f));
+  }
+  case BENCH_SHT40_HUMIDITY:
+  {
+    uint16_t ticks = (uint16_t) lroundf((level + 6.0f) / 125.0f * 65535.0f);
+    return -6.0f + 125.0f * (ticks * (1.0f / 65535.0f));
+  }
+  case BENCH_SOIL_PH:
+    return lroundf(level * 100.0f) * 0.01;
+  case BENCH_SOIL_MOISTURE:
+  case BENCH_SOIL_TEMPERATURE:
+    return lroundf(level * 10.0f) * 0.1;
+  case BENCH_SOIL_CONDUCTIVITY:
+  case BENCH_SOIL_NITROGEN:
+    return (float) lroundf(level);
+  default:
+    return lroundf(level * 100.0f) / 100.0f;
+  }
+}
+
+static float tickSize(bench_trace_kind_t kind)
+{
+  switch (kind)
+  {
+  case BENCH_SHT40_TEMPERATURE:
+    return 175.0f / 65535.0f;
+  case BENCH_SHT40_HUMIDITY:
+    return 125.0f / 65535.0f;
+  case BENCH_SOIL_PH:
+    return 0.01f;
+  case BENCH_SOIL_MOISTURE:
+  case BENCH_SOIL_TEMPERATURE:
+    return 0.1f;
+  case BENCH_SOIL_CONDUCTIVITY:
+  case BENCH_SOIL_NITROGEN:
+    return 1.0f;
+  default:
+    return 0.01f;
+  }
+}
+
+static bench_series_t makeSeries(const bench_trace_t *trace)
+{
+  bench_series_t series;
+  uint32_t       start = 1750000000;
+  float          walk  = 0.0f;
+
+  for (uint32_t t = 0; t < BENCH_DAY_S; t += trace->periodS)
+  {
+    float phase  = 2.0f * (float) M_PI * t / BENCH_DAY_S;
+    float noise  = trace->noise * tickSize(trace->kind) * uniform();
+    walk        += trace->walk * uniform();
+    float level  = trace->base + trace->daily * sinf(phase) + walk + noise;
+
+    // Read times are back-dated from millis(), a second off now and then
+    uint32_t jitter = (nextRandom() % 8 == 0) ? 1 : 0;
+    series.times.push_back(start + t + jitter);
+    series.values.push_back(quantize(trace->kind, level));
+  }
+
+  return series;
+}
+
+// Channel byte, zigzag varint of the delta and the float of the raw log record, plus the block headers
+static size_t rawBytes(const bench_series_t *series)
+{
+  size_t   bytes = 0;
+  uint32_t last  = series->times.empty() ? 0 : series->times[0];
+
+  for (uint32_t time : series->times)
+  {
+    int32_t  delta   = (int32_t) (time - last);
+    uint32_t encoded = ((uint32_t) delta << 1) ^ (uint32_t) (delta >> 31);
+    bytes           += 1 + sizeof(float) + 1;
+    while (encoded >= 0x80)
+    {
+      bytes++;
+      encoded >>= 7;
+    }
+    last = time;
+  }
+
+  return bytes + (BENCH_BLOCK_HEADER - 1) * ((bytes + BENCH_BLOCK_SIZE - BENCH_BLOCK_HEADER) /
+                                             (BENCH_BLOCK_SIZE - BENCH_BLOCK_HEADER + 1));
+}
+
+static double nsSince(bench_clock_t::time_point start)
+{
+  return std::chrono::duration<double, std::nano>(bench_clock_t::now() - start).count();
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,216 @@
+/**
+ * @file       i2c_bench.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-22
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host benchmark of the I2C drivers on the virtual bus
+ *
+ * @note       Runs the firmware's `bsp_i2c` with `BSP_I2C_VIRTUAL` on the host Arduino core of
+ *             `tools/modbus_sim/host`, both bus owner tasks started as in `smart_home.cpp`. Each driver
+ *             operation the tasks perform runs `count` times (default 200) and the bench prints the I2C
+ *             transactions, bytes written (register byte included), bytes read and wall time per operation.
+ *             The counts come from the virtual device models and must match the `bspI2CGetStats()` profiler,
+ *             the time includes the conversion waits of the drivers. Exits with 1 when an operation fails or
+ *             the two counts differ.
+ * @example    g++ -std=gnu++11 -O2 -pthread -DARDUINO=10819 -DBSP_I2C_VIRTUAL -Itools/modbus_sim/host \
+ *                 -Ilib/bsp -Ilib/config/src -Ilib/checksum/src -Ilib/fast_math/src -Ilib/sht4x/src \
+ *                 -Ilib/bmp280/src -Ilib/ac_measure/src -Ilib/unit_4relay/src -Ilib/lcd_16x2/src \
+ *                 tools/i2c_bench/i2c_bench.cpp tools/modbus_sim/host/host_arduino.cpp \
+ *                 tools/modbus_sim/host/host_wire.cpp lib/bsp/bsp_i2c.cpp lib/bsp/bsp_i2c_virtual.cpp \
+ *                 lib/checksum/src/checksum.cpp lib/fast_math/src/fast_math.cpp lib/sht4x/src/sht4x.cpp \
+ *                 lib/bmp280/src/bmp280.cpp lib/ac_measure/src/ac_measure.cpp \
+ *                 lib/unit_4relay/src/unit_4relay.cpp lib/lcd_16x2/src/lcd_16x2.cpp -o i2c_bench \
+ *                 && ./i2c_bench 200
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "Arduino.h"
+#include "ac_measure.h"
+#include "bmp280.h"
+#include "bsp_i2c.h"
+#include "bsp_i2c_virtual.h"
+#include "lcd_16x2.h"
+#include "sht4x.h"
+#include "unit_4relay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private defines ---------------------------------------------------- */
+#define BENCH_SENSOR_BUS BSP_I2C_VIRTUAL_SENSOR_BUS
+#define BENCH_LCD_BUS    BSP_I2C_VIRTUAL_LCD_BUS
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef bool (*bench_run_t)(uint32_t iteration); // One driver operation, false when it failed
+
+typedef struct
+{
+  const char   *name;
+  bsp_i2c_bus_t bus;
+  uint8_t       address;
+  bench_run_t   run;
+} bench_op_t;
+
+/* Private variables -------------------------------------------------- */
+static SHT4X      sht40;
+static BMP280     bmp280;
+static AcMeasure  acMeasure;
+static Unit4Relay relay;
+static LCD_I2C    lcd(BSP_I2C_VIRTUAL_LCD_ADDR, 16, 2, BENCH_LCD_BUS);
+
+/* Private function prototypes ---------------------------------------- */
+static bool runSht40(uint32_t iteration);
+static bool runBmp280(uint32_t iteration);
+static bool runAcSnapshot(uint32_t iteration);
+static bool runAcGetters(uint32_t iteration);
+static bool runRelayWrite(uint32_t iteration);
+static bool runRelayAll(uint32_t iteration);
+static bool runLcdRow(uint32_t iteration);
+static bool runLcdClear(uint32_t iteration);
+
+/* Function definitions ----------------------------------------------- */
+int main(int argc, char **argv)
+{
+  static const bench_op_t ops[] = {
+  {"sht40 update", BENCH_SENSOR_BUS, BSP_I2C_VIRTUAL_SHT40_ADDR, runSht40},
+  {"bmp280 forced cycle", BENCH_SENSOR_BUS, BSP_I2C_VIRTUAL_BMP280_ADDR, runBmp280},
+  {"ac readSnapshot", BENCH_SENSOR_BUS, BSP_I2C_VIRTUAL_AC_ADDR, runAcSnapshot},
+  {"ac six getters", BENCH_SENSOR_BUS, BSP_I2C_VIRTUAL_AC_ADDR, runAcGetters},
+  {"relay relayWrite", BENCH_SENSOR_BUS, BSP_I2C_VIRTUAL_RELAY_ADDR, runRelayWrite},
+  {"relay relayAll", BENCH_SENSOR_BUS, BSP_I2C_VIRTUAL_RELAY_ADDR, runRelayAll},
+  {"lcd row of 16", BENCH_LCD_BUS, BSP_I2C_VIRTUAL_LCD_ADDR, runLcdRow},
+  {"lcd clear", BENCH_LCD_BUS, BSP_I2C_VIRTUAL_LCD_ADDR, runLcdClear}};
+  long count    = (argc > 1) ? atol(argv[1]) : 200;
+  int  failures = 0;
+
+  if (count < 1)
+  {
+    fprintf(stderr, "usage: i2c_bench [count]\n");
+    return 2;
+  }
+
+  // Bring-up as smart_home.cpp, the drivers print their debug output on Serial
+  Serial.mute(true);
+  bspI2CBegin(BSP_I2C_BUS_0);
+  bspI2CBusStart(BSP_I2C_BUS_0);
+  bspI2CBegin(BSP_I2C_BUS_1);
+  bspI2CBusStart(BSP_I2C_BUS_1);
+  bool started = sht40.begin(BENCH_SENSOR_BUS) == SHT4X_OK && bmp280.begin(BENCH_SENSOR_BUS) == BMP280_OK &&
+                 acMeasure.begin(BENCH_SENSOR_BUS) == UNIT_AC_MEASURE_OK &&
+                 relay.begin(BENCH_SENSOR_BUS) == UNIT_4RELAY_OK && relay.init(false) == UNIT_4RELAY_OK;
+  bmp280.setSampling(MODE_FORCED, SAMPLING_X2, SAMPLING_X16, FILTER_OFF, STANDBY_MS_500);
+  lcd.begin();
+  Serial.mute(false);
+  if (!started)
+  {
+    printf("FAILED: driver begin() on the virtual bus\n");
+    return 1;
+  }
+
+  printf("%ld runs per operation, bus owner tasks started\n", count);
+  printf("%-20s %4s %7s %8s %8s %8s %10s\n", "operation", "bus", "address", "xfers", "written", "read",
+         "us/op");
+  for (const bench_op_t &op : ops)
+  {
+    bsp_i2c_virtual_stats_t device;
+    bsp_i2c_stats_t         profiler;
+    long                    failed = 0;
+
+    bspI2CVirtualResetStats();
+    bspI2CResetStats();
+    Serial.mute(true);
+    unsigned long startUs = micros();
+    for (long i = 0; i < count; i++)
+    {
+      failed += !op.run((uint32_t) i);
+    }
+    unsigned long elapsedUs = micros() - startUs;
+    Serial.mute(false);
+
+    bspI2CVirtualGetStats(op.address, &device);
+    bool profiled = bspI2CGetStats(op.bus, op.address, &profiler) == BSP_I2C_OK;
+    printf("%-20s %4u %#7x %8.2f %8.2f %8.2f %10.1f\n", op.name, (unsigned) op.bus, op.address,
+           (double) device.transactions / count, (double) device.bytesWritten / count,
+           (double) device.bytesRead / count, (double) elapsedUs / count);
+
+    if (failed > 0)
+    {
+      printf("FAILED: %s, %ld of %ld runs returned an error\n", op.name, failed, count);
+      failures++;
+    }
+    if (!profiled || profiler.transactions != device.transactions ||
+        profiler.bytesWritten != device.bytesWritten || profiler.bytesRead != device.bytesRead ||
+        profiler.nacks != 0 || profiler.shortReads != 0)
+    {
+      printf("FAILED: %s, profiler counts differ from the bus\n", op.name);
+      failures++;
+    }
+  }
+  printf("%s\n", (failures == 0) ? "PASS" : "FAIL");
+
+  return (failures == 0) ? 0 : 1;
+}
+
+/* Private definitions ------------------------------------------------ */
+static bool runSht40(uint32_t iteration)
+{
+  (void) iteration;
+
+  return sht40.update() == SHT4X_OK;
+}
+
+// The two steps of the sensors task job; the model never reports a conversion in progress
+static bool runBmp280(uint32_t iteration)
+{
+  (void) iteration;
+
+  return bmp280.startForcedMeasurement() == BMP280_OK && bmp280.update() == BMP280_OK;
+}
+
+static bool runAcSnapshot(uint32_t iteration)
+{
+  ac_measure_snapshot_t snapshot;
+
+  (void) iteration;
+
+  return acMeasure.readSnapshot(&snapshot) == UNIT_AC_MEASURE_OK;
+}
+
+// The per-quantity reads readSnapshot() replaced, the getters do not report errors
+static bool runAcGetters(uint32_t iteration)
+{
+  (void) iteration;
+
+  float sum = acMeasure.getVoltage() + acMeasure.getCurrent() + acMeasure.getPower() +
+              acMeasure.getApparentPower() + acMeasure.getPowerFactor() + acMeasure.getKWH();
+  return sum == sum;
+}
+
+static bool runRelayWrite(uint32_t iteration)
+{
+  return relay.relayWrite(iteration % 4, (iteration / 4) % 2 == 0) == UNIT_4RELAY_OK;
+}
+
+static bool runRelayAll(uint32_t iteration) { return relay.relayAll(iteration % 2 == 0) == UNIT_4RELAY_OK; }
+
+static bool runLcdRow(uint32_t iteration)
+{
+  char row[17];
+
+  snprintf(row, sizeof(row), "T %4.1fC H %4.1f%%", 20.0 + (iteration % 100) * 0.1, 50.0);
+  lcd.setCursor(0, 0);
+  return lcd.print(row) == strlen(row);
+}
+
+static bool runLcdClear(uint32_t iteration)
+{
+  (void) iteration;
+
+  lcd.clear();
+  return true;
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,199 @@
+/**
+ * @file       i2c_virtual_check.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-22
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host check of the virtual I2C bus routing, NACK accounting and concurrency
+ *
+ * @note       Runs `bsp_i2c` with `BSP_I2C_VIRTUAL` on the host core of `tools/modbus_sim/host`, both bus owner
+ *             tasks started. Checks that:
+ *               - a model answers only on its own bus, the SHT40 addressed on bus 1 NACKs
+ *               - LCD traffic is counted on bus 1 only
+ *               - a write to an absent address is a NACK in both the bus and the profiler counters, a plain
+ *                 read from it a short read in the profiler
+ *               - threads hammering both buses at once leave exact counter totals and untorn reads
+ *             Exits with 1 when a check fails.
+ * @example    g++ -std=gnu++11 -O2 -pthread -DARDUINO=10819 -DBSP_I2C_VIRTUAL -Itools/modbus_sim/host \
+ *                 -Ilib/bsp -Ilib/config/src -Ilib/checksum/src tools/i2c_virtual_check/i2c_virtual_check.cpp \
+ *                 tools/modbus_sim/host/host_arduino.cpp tools/modbus_sim/host/host_wire.cpp \
+ *                 lib/bsp/bsp_i2c.cpp lib/bsp/bsp_i2c_virtual.cpp lib/checksum/src/checksum.cpp \
+ *                 -o i2c_virtual_check && ./i2c_virtual_check
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "Arduino.h"
+#include "bsp_i2c.h"
+#include "bsp_i2c_virtual.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+/* Private defines ---------------------------------------------------- */
+#define CHECK_SENSOR_BUS     BSP_I2C_VIRTUAL_SENSOR_BUS
+#define CHECK_LCD_BUS        BSP_I2C_VIRTUAL_LCD_BUS
+#define CHECK_ABSENT_ADDR    0x50
+#define CHECK_BMP280_CALIB   0x88 // First calibration register, read as one burst
+#define CHECK_BMP280_CALIB_N 24
+#define CHECK_RELAY_REG      0x11
+#define CHECK_RUNS           2000 // Transfers per thread in the concurrency check
+
+/* Private variables -------------------------------------------------- */
+static int checkFailures = 0;
+
+/* Private function prototypes ---------------------------------------- */
+static void     check(bool condition, const char *what);
+static uint32_t busCount(bsp_i2c_bus_t bus, uint32_t bsp_i2c_virtual_stats_t::*counter);
+
+/* Function definitions ----------------------------------------------- */
+int main()
+{
+  const uint8_t           sht40Measure = 0xFD;
+  bsp_i2c_virtual_stats_t device;
+  bsp_i2c_stats_t         profiler;
+  uint8_t                 byte;
+
+  bspI2CBegin(BSP_I2C_BUS_0);
+  bspI2CBusStart(BSP_I2C_BUS_0);
+  bspI2CBegin(BSP_I2C_BUS_1);
+  bspI2CBusStart(BSP_I2C_BUS_1);
+
+  // Each model answers on its own bus only
+  check(bspI2CExist(CHECK_SENSOR_BUS, BSP_I2C_VIRTUAL_SHT40_ADDR), "SHT40 on the sensor bus");
+  check(!bspI2CExist(CHECK_LCD_BUS, BSP_I2C_VIRTUAL_SHT40_ADDR), "SHT40 absent from the LCD bus");
+  check(bspI2CExist(CHECK_LCD_BUS, BSP_I2C_VIRTUAL_LCD_ADDR), "LCD on the LCD bus");
+  check(!bspI2CExist(CHECK_SENSOR_BUS, BSP_I2C_VIRTUAL_LCD_ADDR), "LCD absent from the sensor bus");
+  check(bspI2CWriteBytes(CHECK_LCD_BUS, BSP_I2C_VIRTUAL_SHT40_ADDR, &sht40Measure, 1) == BSP_I2C_ERR_WRITE,
+        "SHT40 command on the LCD bus NACKed");
+  bspI2CVirtualGetStats(BSP_I2C_VIRTUAL_SHT40_ADDR, &device);
+  printf("routing: SHT40 saw %u transactions, LCD bus %u NACKs\n", device.transactions,
+         busCount(CHECK_LCD_BUS, &bsp_i2c_virtual_stats_t::nacks));
+  check(device.transactions == 1, "SHT40 counts only its own bus");
+
+  // LCD traffic stays on bus 1
+  bspI2CVirtualResetStats();
+  bspI2CResetStats();
+  for (uint8_t i = 0; i < 10; i++)
+  {
+    byte = (uint8_t) (0x08 | (i << 4));
+    bspI2CWriteBytes(CHECK_LCD_BUS, BSP_I2C_VIRTUAL_LCD_ADDR, &byte, 1);
+  }
+  printf("lcd: bus 0 %u transactions, bus 1 %u transactions\n",
+         busCount(CHECK_SENSOR_BUS, &bsp_i2c_virtual_stats_t::transactions),
+         busCount(CHECK_LCD_BUS, &bsp_i2c_virtual_stats_t::transactions));
+  check(busCount(CHECK_SENSOR_BUS, &bsp_i2c_virtual_stats_t::transactions) == 0, "no LCD traffic on bus 0");
+  check(busCount(CHECK_LCD_BUS, &bsp_i2c_virtual_stats_t::transactions) == 10 &&
+        busCount(CHECK_LCD_BUS, &bsp_i2c_virtual_stats_t::bytesWritten) == 10,
+        "LCD traffic on bus 1");
+
+  // Absent address: NACK on a write, short read on a plain read
+  bspI2CVirtualResetStats();
+  bspI2CResetStats();
+  check(bspI2CWriteByte(CHECK_SENSOR_BUS, CHECK_ABSENT_ADDR, 0x00, 0x55) == BSP_I2C_ERR_WRITE,
+        "write to an absent address");
+  check(bspI2CReadByte(CHECK_SENSOR_BUS, CHECK_ABSENT_ADDR, byte) == BSP_I2C_ERR_READ,
+        "plain read from an absent address");
+  bspI2CGetStats(CHECK_SENSOR_BUS, CHECK_ABSENT_ADDR, &profiler);
+  printf("absent: bus %u NACKs, profiler %u transactions, %u NACKs, %u short reads\n",
+         busCount(CHECK_SENSOR_BUS, &bsp_i2c_virtual_stats_t::nacks), profiler.transactions, profiler.nacks,
+         profiler.shortReads);
+  check(busCount(CHECK_SENSOR_BUS, &bsp_i2c_virtual_stats_t::nacks) == 2, "bus NACK count");
+  check(profiler.transactions == 2 && profiler.nacks == 1 && profiler.shortReads == 1, "profiler NACK count");
+
+  // Both buses at once: two threads per bus through the owner tasks
+  uint8_t calibration[CHECK_BMP280_CALIB_N];
+  bspI2CReadBytes(CHECK_SENSOR_BUS, BSP_I2C_VIRTUAL_BMP280_ADDR, CHECK_BMP280_CALIB, calibration,
+                  sizeof(calibration));
+  bspI2CVirtualResetStats();
+  bspI2CResetStats();
+
+  std::vector<std::thread> threads;
+  uint32_t                 torn = 0;
+  threads.emplace_back([&calibration, &torn]() {
+    uint8_t bytes[CHECK_BMP280_CALIB_N];
+    for (int i = 0; i < CHECK_RUNS; i++)
+    {
+      bspI2CReadBytes(CHECK_SENSOR_BUS, BSP_I2C_VIRTUAL_BMP280_ADDR, CHECK_BMP280_CALIB, bytes, sizeof(bytes));
+      torn += (memcmp(bytes, calibration, sizeof(bytes)) != 0);
+    }
+  });
+  threads.emplace_back([]() {
+    uint8_t value;
+    for (int i = 0; i < CHECK_RUNS; i++)
+    {
+      bspI2CReadByte(CHECK_SENSOR_BUS, BSP_I2C_VIRTUAL_RELAY_ADDR, CHECK_RELAY_REG, value);
+    }
+  });
+  threads.emplace_back([]() {
+    for (int i = 0; i < CHECK_RUNS; i++)
+    {
+      uint8_t value = (uint8_t) (0x08 | ((i & 0x0F) << 4));
+      bspI2CWriteBytes(CHECK_LCD_BUS, BSP_I2C_VIRTUAL_LCD_ADDR, &value, 1);
+    }
+  });
+  threads.emplace_back([]() {
+    uint8_t value = 0;
+    for (int i = 0; i < CHECK_RUNS; i++)
+    {
+      bspI2CWriteBytes(CHECK_LCD_BUS, CHECK_ABSENT_ADDR, &value, 1);
+    }
+  });
+  for (std::thread &thread : threads)
+  {
+    thread.join();
+  }
+
+  bsp_i2c_stats_t bmp280;
+  bsp_i2c_stats_t lcd;
+  bsp_i2c_stats_t absent;
+  bspI2CGetStats(CHECK_SENSOR_BUS, BSP_I2C_VIRTUAL_BMP280_ADDR, &bmp280);
+  bspI2CGetStats(CHECK_LCD_BUS, BSP_I2C_VIRTUAL_LCD_ADDR, &lcd);
+  bspI2CGetStats(CHECK_LCD_BUS, CHECK_ABSENT_ADDR, &absent);
+  printf("concurrent: bus 0 %u transactions %u read, bus 1 %u transactions %u NACKs, %u torn reads\n",
+         busCount(CHECK_SENSOR_BUS, &bsp_i2c_virtual_stats_t::transactions),
+         busCount(CHECK_SENSOR_BUS, &bsp_i2c_virtual_stats_t::bytesRead),
+         busCount(CHECK_LCD_BUS, &bsp_i2c_virtual_stats_t::transactions),
+         busCount(CHECK_LCD_BUS, &bsp_i2c_virtual_stats_t::nacks), torn);
+  check(busCount(CHECK_SENSOR_BUS, &bsp_i2c_virtual_stats_t::transactions) == 2 * CHECK_RUNS &&
+        busCount(CHECK_SENSOR_BUS, &bsp_i2c_virtual_stats_t::bytesWritten) == 2 * CHECK_RUNS &&
+        busCount(CHECK_SENSOR_BUS, &bsp_i2c_virtual_stats_t::bytesRead) ==
+        CHECK_RUNS * (CHECK_BMP280_CALIB_N + 1) &&
+        busCount(CHECK_SENSOR_BUS, &bsp_i2c_virtual_stats_t::nacks) == 0,
+        "bus 0 totals");
+  check(busCount(CHECK_LCD_BUS, &bsp_i2c_virtual_stats_t::transactions) == 2 * CHECK_RUNS &&
+        busCount(CHECK_LCD_BUS, &bsp_i2c_virtual_stats_t::bytesWritten) == CHECK_RUNS &&
+        busCount(CHECK_LCD_BUS, &bsp_i2c_virtual_stats_t::nacks) == CHECK_RUNS,
+        "bus 1 totals");
+  check(bmp280.transactions == CHECK_RUNS && bmp280.bytesRead == CHECK_RUNS * CHECK_BMP280_CALIB_N &&
+        lcd.transactions == CHECK_RUNS && absent.nacks == CHECK_RUNS,
+        "profiler totals");
+  check(torn == 0, "untorn burst reads");
+
+  printf("%s\n", (checkFailures == 0) ? "PASS" : "FAIL");
+
+  return (checkFailures == 0) ? 0 : 1;
+}
+
+/* Private definitions ------------------------------------------------ */
+static void check(bool condition, const char *what)
+{
+  if (!condition)
+  {
+    printf("FAILED: %s\n", what);
+    checkFailures++;
+  }
+}
+
+static uint32_t busCount(bsp_i2c_bus_t bus, uint32_t bsp_i2c_virtual_stats_t::*counter)
+{
+  bsp_i2c_virtual_stats_t stats;
+
+  bspI2CVirtualGetBusStats(bus, &stats);
+  return stats.*counter;
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,214 @@
+/**
+ * @file       Arduino.h
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-06
+ * @author     Tuan Nguyen
+ *
+ * @brief      Minimal Arduino-ESP32 core for building the RS-485 stack on Linux
+ *
+ * @note       Covers what `bsp_uart`, `bsp_rs485`, `bsp_modbus`, `bsp_modbus_poller` and `es_soil_7n1` use,
+ *             and with `Wire.h` what `bsp_i2c` and the I2C drivers use. `HardwareSerial` drives a tty (e.g.
+ *             the pty of `modbus_slave_sim`) and reproduces the ESP32 UART RX-timeout event, `Serial` prints
+ *             to stdout.
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef HOST_ARDUINO_H
+  #define HOST_ARDUINO_H
+
+  /* Includes ----------------------------------------------------------- */
+  #include <math.h>
+  #include <stdarg.h>
+  #include <stddef.h>
+  #include <stdint.h>
+  #include <stdio.h>
+  #include <stdlib.h>
+  #include <string.h>
+
+  #include <algorithm>
+  #include <deque>
+  #include <functional>
+  #include <mutex>
+  #include <thread>
+
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/queue.h"
+  #include "freertos/semphr.h"
+  #include "freertos/task.h"
+
+  /* Public defines ----------------------------------------------------- */
+  #define ARDUINO_HOST
+  #define F(string_literal) (string_literal)
+
+  #define SERIAL_8N1 0x800001c
+
+  #define UART_HW_FLOWCTRL_DISABLE 0
+  #define UART_HW_FLOWCTRL_CTS_RTS 3
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef uint8_t byte;
+
+// As the ESP32 core, min() and max() are the std templates
+using std::max;
+using std::min;
+
+typedef int SerialHwFlowCtrl;
+typedef int SerialMode;
+
+typedef enum
+{
+  UART_NO_ERROR,
+  UART_BREAK_ERROR,
+  UART_BUFFER_FULL_ERROR,
+  UART_FIFO_OVF_ERROR,
+  UART_FRAME_ERROR,
+  UART_PARITY_ERROR
+} hardwareSerial_error_t;
+
+typedef std::function<void(void)>                   OnReceiveCb;
+typedef std::function<void(hardwareSerial_error_t)> OnReceiveErrorCb;
+
+/* Public function prototypes ----------------------------------------- */
+unsigned long millis(void);
+unsigned long micros(void);
+void          delay(unsigned long ms);
+void          delayMicroseconds(unsigned int us);
+
+/* Class Declaration -------------------------------------------------- */
+class Print
+{
+public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+
+  size_t print(const char *s);
+  size_t print(char c);
+  size_t print(int n, int base = 10);
+  size_t print(unsigned int n, int base = 10);
+  size_t print(long n, int base = 10);
+  size_t print(unsigned long n, int base = 10);
+  size_t print(double n, int digits = 2);
+  size_t println(void);
+  template <typename T> size_t println(T value)
+  {
+    size_t n = print(value);
+    return n + println();
+  }
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print
+{
+public:
+  virtual int  available() = 0;
+  virtual int  read()      = 0;
+  virtual int  peek()      = 0;
+  virtual void flush() {}
+
+  size_t readBytes(uint8_t *buffer, size_t length);
+  size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *) buffer, length); }
+};
+
+/**
+ * @brief Console on stdout, stands in for the USB CDC `Serial`.
+ */
+class HostConsole : public Stream
+{
+public:
+  int    available() override { return 0; }
+  int    read() override { return -1; }
+  int    peek() override { return -1; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+
+  void begin(unsigned long baud) { (void) baud; }
+
+  /**
+   * @brief  Drops everything printed while muted, e.g. the driver debug output during a benchmark.
+   */
+  void mute(bool muted) { _muted = muted; }
+
+  operator bool() const { return true; }
+
+private:
+  bool _muted = false;
+};
+
+/**
+ * @brief UART on a Linux tty.
+ *
+ * A reader thread moves received bytes to the RX buffer and reports the end of a frame once the line has been
+ * idle for the RX timeout (in characters at the configured baud rate), like the ESP32 UART driver. Writes
+ * are paced by `flush()` at the wire time of the bytes sent since the previous flush.
+ */
+class HardwareSerial : public Stream
+{
+public:
+  HardwareSerial(int uartNr);
+  ~HardwareSerial();
+
+  /**
+   * @brief  Sets the tty opened by `begin()`, e.g. the path printed by `modbus_slave_sim`.
+   */
+  void setDevice(const char *path);
+
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1,
+             bool invert = false, unsigned long timeout_ms = 20000UL, uint8_t rxfifo_full_thrhd = 112);
+  void end(bool turnOffDebug = true);
+
+  bool setRxTimeout(uint8_t symbols_timeout);
+  bool setRxFIFOFull(uint8_t fifoBytes);
+  void onReceive(OnReceiveCb function, bool onlyOnTimeout = false);
+  void onReceiveError(OnReceiveErrorCb function);
+  void eventQueueReset();
+  void updateBaudRate(unsigned long baud);
+
+  int      available() override;
+  int      availableForWrite();
+  int      peek() override;
+  int      read() override;
+  size_t   read(uint8_t *buffer, size_t size);
+  void     flush() override;
+  void     flush(bool txOnly);
+  size_t   write(uint8_t c) override;
+  size_t   write(const uint8_t *buffer, size_t size) override;
+  uint32_t baudRate();
+
+  void   setDebugOutput(bool enable) { (void) enable; }
+  void   setRxInvert(bool invert) { (void) invert; }
+  bool   setPins(int8_t rxPin, int8_t txPin, int8_t ctsPin = -1, int8_t rtsPin = -1);
+  bool   setHwFlowCtrlMode(SerialHwFlowCtrl mode = UART_HW_FLOWCTRL_CTS_RTS, uint8_t threshold = 64);
+  bool   setMode(SerialMode mode);
+  size_t setRxBufferSize(size_t new_size);
+  size_t setTxBufferSize(size_t new_size);
+
+  operator bool() const { return _fd >= 0; }
+
+private:
+  int                 _uartNr;
+  const char         *_device        = NULL;
+  int                 _fd            = -1;
+  uint32_t            _baud          = 0;
+  uint8_t             _rxTimeout     = 2;
+  bool                _onlyOnTimeout = false;
+  size_t              _pendingTx     = 0;
+  volatile bool       _running       = false;
+  std::thread         _reader;
+  std::mutex          _lock;
+  std::deque<uint8_t> _rx;
+  OnReceiveCb         _onReceive;
+
+  void readerLoop();
+};
+
+extern HostConsole    Serial;
+extern HardwareSerial Serial0;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif // HOST_ARDUINO_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,86 @@
+/**
+ * @file       FS.h
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-22
+ * @author     Tuan Nguyen
+ *
+ * @brief      Arduino-ESP32 `fs::FS` and `fs::File` on a POSIX directory, with write fault injection
+ *
+ * @note       Paths are relative to the root given to `fs::FS`, like LittleFS paths are relative to the
+ *             partition. Only the calls of the repo's file users are provided. `failWritesAfter()` makes
+ *             every write past a byte budget short, the way a full or failing flash returns fewer bytes.
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef HOST_FS_H
+  #define HOST_FS_H
+
+  /* Includes ----------------------------------------------------------- */
+  #include <dirent.h>
+  #include <stddef.h>
+  #include <stdint.h>
+  #include <stdio.h>
+
+  #include <memory>
+  #include <string>
+
+/* Class Declaration -------------------------------------------------- */
+namespace fs
+{
+class File
+{
+public:
+  File() {}
+  File(FILE *file, const std::string &name, std::shared_ptr<long> writeBudget);
+  File(DIR *dir, const std::string &path, const std::string &name);
+
+  explicit operator bool() const { return _file != nullptr || _dir != nullptr; }
+
+  size_t      write(uint8_t value) { return write(&value, 1); }
+  size_t      write(const uint8_t *buffer, size_t size);
+  int         read();
+  size_t      read(uint8_t *buffer, size_t size);
+  bool        seek(uint32_t position);
+  size_t      position() const;
+  size_t      size() const;
+  void        close();
+  bool        isDirectory() const { return _dir != nullptr; }
+  const char *name() const { return _name.c_str(); }
+  File        openNextFile();
+
+private:
+  std::shared_ptr<FILE> _file;
+  std::shared_ptr<DIR>  _dir;
+  std::string           _path; // Directory path on the host, for openNextFile()
+  std::string           _name;
+  std::shared_ptr<long> _writeBudget;
+};
+
+class FS
+{
+public:
+  explicit FS(const char *root);
+
+  File open(const char *path, const char *mode = "r");
+  bool exists(const char *path);
+  bool mkdir(const char *path);
+  bool remove(const char *path);
+  bool rename(const char *from, const char *to);
+
+  /**
+   * @brief  Lets `bytes` more bytes be written, every later write comes back short. -1 lifts the limit.
+   */
+  void failWritesAfter(long bytes) { *_writeBudget = bytes; }
+
+private:
+  std::string           _root;
+  std::shared_ptr<long> _writeBudget;
+
+  std::string hostPath(const char *path) const { return _root + path; }
+};
+} // namespace fs
+
+#endif // HOST_FS_H
+
+/* End of file -------------------------------------------------------- */
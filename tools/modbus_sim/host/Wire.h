@@ -0,0 +1,88 @@
+/**
+ * @file       Wire.h
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-22
+ * @author     Tuan Nguyen
+ *
+ * @brief      Arduino-ESP32 `TwoWire` with nothing on the bus
+ *
+ * @note       Only lets `bsp_i2c` link on the host. Every address NACKs and every read comes back empty; host
+ *             tools build with `BSP_I2C_VIRTUAL` so transactions go to the device models instead.
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef HOST_WIRE_H
+  #define HOST_WIRE_H
+
+  /* Includes ----------------------------------------------------------- */
+  #include "Arduino.h"
+
+/* Class Declaration -------------------------------------------------- */
+class TwoWire : public Stream
+{
+public:
+  TwoWire(uint8_t busNum) : _busNum(busNum) {}
+
+  bool begin(int sda, int scl, uint32_t frequency = 0);
+  bool begin(uint8_t address, int sda, int scl, uint32_t frequency);
+  bool begin(uint8_t address) { return begin(address, -1, -1, 0); }
+  bool begin(int address) { return begin((uint8_t) address, -1, -1, 0); }
+  bool begin() { return begin(-1, -1); }
+
+  bool     setClock(uint32_t frequency);
+  uint32_t getClock() { return _frequency; }
+  void     setTimeOut(uint16_t timeOutMillis) { _timeOutMillis = timeOutMillis; }
+  uint16_t getTimeOut() { return _timeOutMillis; }
+
+  void    beginTransmission(uint16_t address);
+  void    beginTransmission(uint8_t address) { beginTransmission((uint16_t) address); }
+  void    beginTransmission(int address) { beginTransmission((uint16_t) address); }
+  uint8_t endTransmission(bool sendStop);
+  uint8_t endTransmission(void) { return endTransmission(true); }
+
+  size_t  requestFrom(uint16_t address, size_t size, bool sendStop);
+  uint8_t requestFrom(uint16_t address, uint8_t size, bool sendStop)
+  {
+    return (uint8_t) requestFrom(address, (size_t) size, sendStop);
+  }
+  uint8_t requestFrom(uint16_t address, uint8_t size, uint8_t sendStop)
+  {
+    return (uint8_t) requestFrom(address, (size_t) size, sendStop != 0);
+  }
+  size_t requestFrom(uint8_t address, size_t len, bool stopBit)
+  {
+    return requestFrom((uint16_t) address, len, stopBit);
+  }
+  uint8_t requestFrom(uint16_t address, uint8_t size) { return requestFrom(address, size, true); }
+  uint8_t requestFrom(uint8_t address, uint8_t size, uint8_t sendStop)
+  {
+    return requestFrom((uint16_t) address, size, sendStop);
+  }
+  uint8_t requestFrom(uint8_t address, uint8_t size) { return requestFrom((uint16_t) address, size, true); }
+  uint8_t requestFrom(int address, int size, int sendStop)
+  {
+    return (uint8_t) requestFrom((uint16_t) address, (size_t) size, sendStop != 0);
+  }
+  uint8_t requestFrom(int address, int size) { return requestFrom(address, size, 1); }
+
+  size_t write(uint8_t data) override;
+  size_t write(const uint8_t *data, size_t quantity) override;
+  int    available() override { return 0; }
+  int    read() override { return -1; }
+  int    peek() override { return -1; }
+  void   flush() override {}
+
+private:
+  uint8_t  _busNum;
+  uint32_t _frequency     = 100000;
+  uint16_t _timeOutMillis = 50;
+  bool     _transmitting  = false;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif // HOST_WIRE_H
+
+/* End of file -------------------------------------------------------- */
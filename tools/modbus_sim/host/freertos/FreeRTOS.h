@@ -0,0 +1,36 @@
+/**
+ * @file       FreeRTOS.h
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-06
+ * @author     Tuan Nguyen
+ *
+ * @brief      FreeRTOS types for the Linux build of the RS-485 stack, tasks map to threads
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef HOST_FREERTOS_H
+  #define HOST_FREERTOS_H
+
+  /* Includes ----------------------------------------------------------- */
+  #include <stdint.h>
+
+  /* Public defines ----------------------------------------------------- */
+  #define configTICK_RATE_HZ 1000
+  #define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+  #define portMAX_DELAY      ((TickType_t) 0xFFFFFFFFUL)
+  #define pdMS_TO_TICKS(ms)  ((TickType_t) (((uint64_t) (ms) * configTICK_RATE_HZ) / 1000))
+
+  #define pdFALSE            0
+  #define pdTRUE             1
+  #define pdFAIL             pdFALSE
+  #define pdPASS             pdTRUE
+
+/* Public enumerate/structure ----------------------------------------- */
+typedef int          BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t     TickType_t;
+
+#endif // HOST_FREERTOS_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,31 @@
+/**
+ * @file       queue.h
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-22
+ * @author     Tuan Nguyen
+ *
+ * @brief      FreeRTOS queue API on a std::deque, items copied by value
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef HOST_FREERTOS_QUEUE_H
+  #define HOST_FREERTOS_QUEUE_H
+
+  /* Includes ----------------------------------------------------------- */
+  #include "FreeRTOS.h"
+
+/* Public enumerate/structure ----------------------------------------- */
+struct host_queue;
+typedef struct host_queue *QueueHandle_t;
+
+/* Public function prototypes ----------------------------------------- */
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t    xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticksToWait);
+BaseType_t    xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticksToWait);
+UBaseType_t   uxQueueMessagesWaiting(QueueHandle_t queue);
+void          vQueueDelete(QueueHandle_t queue);
+
+#endif // HOST_FREERTOS_QUEUE_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,34 @@
+/**
+ * @file       semphr.h
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-06
+ * @author     Tuan Nguyen
+ *
+ * @brief      FreeRTOS mutex and semaphore API on std::mutex and std::condition_variable
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef HOST_FREERTOS_SEMPHR_H
+  #define HOST_FREERTOS_SEMPHR_H
+
+  /* Includes ----------------------------------------------------------- */
+  #include "FreeRTOS.h"
+
+/* Public enumerate/structure ----------------------------------------- */
+struct host_semaphore;
+typedef struct host_semaphore *SemaphoreHandle_t;
+
+/* Public function prototypes ----------------------------------------- */
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+BaseType_t        xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t        xSemaphoreGive(SemaphoreHandle_t semaphore);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+BaseType_t        xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t        xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore);
+void              vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+#endif // HOST_FREERTOS_SEMPHR_H
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,35 @@
+/**
+ * @file       task.h
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-06
+ * @author     Tuan Nguyen
+ *
+ * @brief      FreeRTOS task API on threads, with direct-to-task notifications
+ */
+
+/* Define to prevent recursive inclusion ------------------------------ */
+#ifndef HOST_FREERTOS_TASK_H
+  #define HOST_FREERTOS_TASK_H
+
+  /* Includes ----------------------------------------------------------- */
+  #include "FreeRTOS.h"
+
+/* Public enumerate/structure ----------------------------------------- */
+struct host_task;
+typedef struct host_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+/* Public function prototypes ----------------------------------------- */
+BaseType_t   xTaskCreate(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameters,
+                         UBaseType_t priority, TaskHandle_t *created);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TickType_t   xTaskGetTickCount(void);
+void         vTaskDelay(TickType_t ticks);
+void         vTaskDelayUntil(TickType_t *previousWake, TickType_t period);
+uint32_t     ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait);
+BaseType_t   xTaskNotifyGive(TaskHandle_t task);
+
+#endif // HOST_FREERTOS_TASK_H
+
+/* End of file -------------------------------------------------------- */
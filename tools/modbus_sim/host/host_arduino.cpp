@@ -0,0 +1,627 @@
+/**
+ * @file       host_arduino.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-06
+ * @author     Tuan Nguyen
+ *
+ * @brief      Linux implementation of the minimal Arduino-ESP32 core and FreeRTOS API
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "Arduino.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <vector>
+
+/* Private defines ---------------------------------------------------- */
+#define HOST_UART_CHAR_BITS     11  // Start, 8 data, parity or second stop, stop
+#define HOST_UART_IDLE_POLL_MS  50  // Reader wake-up period while nothing is pending
+#define HOST_STREAM_TIMEOUT_MS  1000
+#define HOST_PRINT_BUFFER_SIZE  256
+
+/* Private enumerate/structure ---------------------------------------- */
+struct host_task
+{
+  std::mutex              lock;
+  std::condition_variable wake;
+  uint32_t                notifications = 0;
+};
+
+// Counting semaphore capped at one, a mutex starts given and a binary semaphore taken. A recursive mutex
+// also records its holder and how often the holder took it.
+struct host_semaphore
+{
+  std::mutex              lock;
+  std::condition_variable wake;
+  bool                    given;
+  host_task              *holder;
+  uint32_t                depth;
+};
+
+struct host_queue
+{
+  std::mutex                        lock;
+  std::condition_variable           wake;
+  size_t                            length;
+  size_t                            itemSize;
+  std::deque<std::vector<uint8_t> > items;
+};
+
+/* Private variables -------------------------------------------------- */
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+static thread_local host_task                     *currentTask = NULL;
+
+/* Public variables --------------------------------------------------- */
+HostConsole    Serial;
+HardwareSerial Serial0(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+/* Private function prototypes ---------------------------------------- */
+static uint64_t uptimeUs(void);
+
+/* Function definitions ----------------------------------------------- */
+unsigned long millis(void) { return (unsigned long) (uptimeUs() / 1000); }
+
+unsigned long micros(void) { return (unsigned long) uptimeUs(); }
+
+void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+void delayMicroseconds(unsigned int us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+
+/* FreeRTOS ----------------------------------------------------------- */
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameters,
+                       UBaseType_t priority, TaskHandle_t *created)
+{
+  (void) name;
+  (void) stackDepth;
+  (void) priority;
+
+  host_task *task = new host_task();
+  std::thread([task, function, parameters]() {
+    currentTask = task;
+    function(parameters);
+  }).detach();
+
+  if (created != NULL)
+  {
+    *created = task;
+  }
+  return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+  // Threads not started by xTaskCreate (e.g. main) get a task record on first use
+  if (currentTask == NULL)
+  {
+    currentTask = new host_task();
+  }
+  return currentTask;
+}
+
+TickType_t xTaskGetTickCount(void) { return (TickType_t) millis(); }
+
+void vTaskDelay(TickType_t ticks) { delay(ticks * portTICK_PERIOD_MS); }
+
+void vTaskDelayUntil(TickType_t *previousWake, TickType_t period)
+{
+  *previousWake += period;
+  int32_t remaining = (int32_t) (*previousWake - xTaskGetTickCount());
+  if (remaining > 0)
+  {
+    vTaskDelay(remaining);
+  }
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait)
+{
+  host_task                   *task = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> guard(task->lock);
+
+  if (ticksToWait == portMAX_DELAY)
+  {
+    task->wake.wait(guard, [task]() { return task->notifications > 0; });
+  }
+  else
+  {
+    task->wake.wait_for(guard, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS),
+                        [task]() { return task->notifications > 0; });
+  }
+
+  uint32_t value = task->notifications;
+  if (value > 0)
+  {
+    task->notifications = clearOnExit ? 0 : value - 1;
+  }
+  return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+  {
+    std::lock_guard<std::mutex> guard(task->lock);
+    task->notifications++;
+  }
+  task->wake.notify_one();
+  return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) { return new host_semaphore{{}, {}, true, NULL, 0}; }
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) { return new host_semaphore{{}, {}, false, NULL, 0}; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+  std::unique_lock<std::mutex> guard(semaphore->lock);
+
+  if (ticksToWait == portMAX_DELAY)
+  {
+    semaphore->wake.wait(guard, [semaphore]() { return semaphore->given; });
+  }
+  else
+  {
+    semaphore->wake.wait_for(guard, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS),
+                             [semaphore]() { return semaphore->given; });
+  }
+
+  bool taken       = semaphore->given;
+  semaphore->given = false;
+  return taken ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+  {
+    std::lock_guard<std::mutex> guard(semaphore->lock);
+    semaphore->given = true;
+  }
+  semaphore->wake.notify_one();
+  return pdTRUE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void) { return xSemaphoreCreateMutex(); }
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+  host_task *task = xTaskGetCurrentTaskHandle();
+
+  // Only the holder touches `holder` and `depth` while it holds the mutex
+  if (semaphore->holder == task)
+  {
+    semaphore->depth++;
+    return pdTRUE;
+  }
+  if (xSemaphoreTake(semaphore, ticksToWait) != pdTRUE)
+  {
+    return pdFALSE;
+  }
+  semaphore->holder = task;
+  semaphore->depth  = 1;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore)
+{
+  if (semaphore->holder != xTaskGetCurrentTaskHandle())
+  {
+    return pdFALSE;
+  }
+  if (--semaphore->depth == 0)
+  {
+    semaphore->holder = NULL;
+    xSemaphoreGive(semaphore);
+  }
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) { delete semaphore; }
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+  host_queue *queue = new host_queue();
+  queue->length     = length;
+  queue->itemSize   = itemSize;
+  return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticksToWait)
+{
+  {
+    std::unique_lock<std::mutex> guard(queue->lock);
+    auto                         hasRoom = [queue]() { return queue->items.size() < queue->length; };
+    if (ticksToWait == portMAX_DELAY)
+    {
+      queue->wake.wait(guard, hasRoom);
+    }
+    else if (!queue->wake.wait_for(guard, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS),
+                                   hasRoom))
+    {
+      return pdFALSE;
+    }
+    const uint8_t *bytes = (const uint8_t *) item;
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+  }
+  queue->wake.notify_all();
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticksToWait)
+{
+  {
+    std::unique_lock<std::mutex> guard(queue->lock);
+    auto                         hasItem = [queue]() { return !queue->items.empty(); };
+    if (ticksToWait == portMAX_DELAY)
+    {
+      queue->wake.wait(guard, hasItem);
+    }
+    else if (!queue->wake.wait_for(guard, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS),
+                                   hasItem))
+    {
+      return pdFALSE;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+  }
+  queue->wake.notify_all();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+  std::lock_guard<std::mutex> guard(queue->lock);
+  return (UBaseType_t) queue->items.size();
+}
+
+void vQueueDelete(QueueHandle_t queue) { delete queue; }
+
+/* Class method definitions-------------------------------------------- */
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t n = 0;
+  while (n < size && write(buffer[n]) == 1)
+  {
+    n++;
+  }
+  return n;
+}
+
+size_t Print::print(const char *s) { return write((const uint8_t *) s, strlen(s)); }
+
+size_t Print::print(char c) { return write((uint8_t) c); }
+
+size_t Print::print(int n, int base) { return print((long) n, base); }
+
+size_t Print::print(unsigned int n, int base) { return print((unsigned long) n, base); }
+
+size_t Print::print(long n, int base)
+{
+  return (base == 10) ? printf("%ld", n) : print((unsigned long) n, base);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+  return (base == 16) ? printf("%lX", n) : (base == 8) ? printf("%lo", n) : printf("%lu", n);
+}
+
+size_t Print::print(double n, int digits) { return printf("%.*f", digits, n); }
+
+size_t Print::println(void) { return print("\r\n"); }
+
+size_t Print::printf(const char *format, ...)
+{
+  char    buffer[HOST_PRINT_BUFFER_SIZE];
+  va_list args;
+
+  va_start(args, format);
+  int len = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (len < 0)
+  {
+    return 0;
+  }
+  if ((size_t) len < sizeof(buffer))
+  {
+    return write((const uint8_t *) buffer, len);
+  }
+
+  // Longer than the stack buffer, format again into the heap
+  char *large = (char *) malloc(len + 1);
+  if (large == NULL)
+  {
+    return 0;
+  }
+  va_start(args, format);
+  vsnprintf(large, len + 1, format, args);
+  va_end(args);
+  size_t n = write((const uint8_t *) large, len);
+  free(large);
+  return n;
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length)
+{
+  size_t        n       = 0;
+  unsigned long startMs = millis();
+
+  while (n < length && millis() - startMs < HOST_STREAM_TIMEOUT_MS)
+  {
+    int c = read();
+    if (c < 0)
+    {
+      delay(1);
+      continue;
+    }
+    buffer[n++] = (uint8_t) c;
+  }
+  return n;
+}
+
+size_t HostConsole::write(uint8_t c) { return write(&c, 1); }
+
+size_t HostConsole::write(const uint8_t *buffer, size_t size)
+{
+  if (!_muted)
+  {
+    fwrite(buffer, 1, size, stdout);
+  }
+  return size;
+}
+
+HardwareSerial::HardwareSerial(int uartNr) : _uartNr(uartNr) {}
+
+HardwareSerial::~HardwareSerial() { end(); }
+
+void HardwareSerial::setDevice(const char *path) { _device = path; }
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin, bool invert,
+                           unsigned long timeout_ms, uint8_t rxfifo_full_thrhd)
+{
+  (void) config;
+  (void) rxPin;
+  (void) txPin;
+  (void) invert;
+  (void) timeout_ms;
+  (void) rxfifo_full_thrhd;
+
+  end();
+  _baud = baud;
+  if (_device == NULL)
+  {
+    fprintf(stderr, "Serial%d: no device, call setDevice() before begin()\n", _uartNr);
+    return;
+  }
+
+  _fd = open(_device, O_RDWR | O_NOCTTY);
+  if (_fd < 0)
+  {
+    fprintf(stderr, "Serial%d: %s: %s\n", _uartNr, _device, strerror(errno));
+    return;
+  }
+
+  // Raw bytes, the baud rate only paces writes and times the RX timeout (a pty has no line speed)
+  struct termios tio;
+  if (tcgetattr(_fd, &tio) == 0)
+  {
+    cfmakeraw(&tio);
+    tcsetattr(_fd, TCSANOW, &tio);
+  }
+
+  _running = true;
+  _reader  = std::thread(&HardwareSerial::readerLoop, this);
+}
+
+void HardwareSerial::end(bool turnOffDebug)
+{
+  (void) turnOffDebug;
+
+  _running = false;
+  if (_reader.joinable())
+  {
+    _reader.join();
+  }
+  if (_fd >= 0)
+  {
+    close(_fd);
+    _fd = -1;
+  }
+  std::lock_guard<std::mutex> guard(_lock);
+  _rx.clear();
+}
+
+bool HardwareSerial::setRxTimeout(uint8_t symbols_timeout)
+{
+  _rxTimeout = symbols_timeout;
+  return symbols_timeout > 0;
+}
+
+bool HardwareSerial::setRxFIFOFull(uint8_t fifoBytes) { return fifoBytes > 0; }
+
+void HardwareSerial::onReceive(OnReceiveCb function, bool onlyOnTimeout)
+{
+  std::lock_guard<std::mutex> guard(_lock);
+  _onReceive     = function;
+  _onlyOnTimeout = onlyOnTimeout;
+}
+
+void HardwareSerial::onReceiveError(OnReceiveErrorCb function) { (void) function; }
+
+void HardwareSerial::eventQueueReset() {}
+
+void HardwareSerial::updateBaudRate(unsigned long baud) { _baud = baud; }
+
+int HardwareSerial::available()
+{
+  std::lock_guard<std::mutex> guard(_lock);
+  return (int) _rx.size();
+}
+
+int HardwareSerial::availableForWrite() { return (_fd >= 0) ? 128 : 0; }
+
+int HardwareSerial::peek()
+{
+  std::lock_guard<std::mutex> guard(_lock);
+  return _rx.empty() ? -1 : _rx.front();
+}
+
+int HardwareSerial::read()
+{
+  std::lock_guard<std::mutex> guard(_lock);
+  if (_rx.empty())
+  {
+    return -1;
+  }
+  int c = _rx.front();
+  _rx.pop_front();
+  return c;
+}
+
+size_t HardwareSerial::read(uint8_t *buffer, size_t size)
+{
+  std::lock_guard<std::mutex> guard(_lock);
+  size_t                      n = 0;
+  while (n < size && !_rx.empty())
+  {
+    buffer[n++] = _rx.front();
+    _rx.pop_front();
+  }
+  return n;
+}
+
+void HardwareSerial::flush() {}
+
+void HardwareSerial::flush(bool txOnly) { (void) txOnly; }
+
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+  if (_fd < 0)
+  {
+    return 0;
+  }
+
+  // The bytes reach the other end when their last bit would have left the wire
+  if (_baud > 0)
+  {
+    delayMicroseconds((unsigned int) ((uint64_t) size * HOST_UART_CHAR_BITS * 1000000ULL / _baud));
+  }
+
+  size_t n = 0;
+  while (n < size)
+  {
+    ssize_t written = ::write(_fd, buffer + n, size - n);
+    if (written < 0)
+    {
+      if (errno == EINTR || errno == EAGAIN)
+      {
+        continue;
+      }
+      break;
+    }
+    n += written;
+  }
+  return n;
+}
+
+uint32_t HardwareSerial::baudRate() { return _baud; }
+
+bool HardwareSerial::setPins(int8_t rxPin, int8_t txPin, int8_t ctsPin, int8_t rtsPin)
+{
+  (void) rxPin;
+  (void) txPin;
+  (void) ctsPin;
+  (void) rtsPin;
+  return true;
+}
+
+bool HardwareSerial::setHwFlowCtrlMode(SerialHwFlowCtrl mode, uint8_t threshold)
+{
+  (void) mode;
+  (void) threshold;
+  return true;
+}
+
+bool HardwareSerial::setMode(SerialMode mode)
+{
+  (void) mode;
+  return true;
+}
+
+size_t HardwareSerial::setRxBufferSize(size_t new_size) { return new_size; }
+
+size_t HardwareSerial::setTxBufferSize(size_t new_size) { return new_size; }
+
+void HardwareSerial::readerLoop()
+{
+  uint8_t  buffer[256];
+  bool     pending = false; // Bytes received since the last end-of-frame event
+  uint64_t lastUs  = 0;
+
+  while (_running)
+  {
+    uint64_t idleUs = (_baud > 0) ? (uint64_t) _rxTimeout * HOST_UART_CHAR_BITS * 1000000ULL / _baud : 0;
+    uint64_t waitUs = HOST_UART_IDLE_POLL_MS * 1000ULL;
+    if (pending)
+    {
+      uint64_t silentUs = uptimeUs() - lastUs;
+      waitUs            = (silentUs < idleUs) ? idleUs - silentUs : 0;
+    }
+
+    struct pollfd   pfd     = {_fd, POLLIN, 0};
+    struct timespec timeout = {(time_t) (waitUs / 1000000), (long) (waitUs % 1000000) * 1000};
+    int             ready   = ppoll(&pfd, 1, &timeout, NULL);
+
+    OnReceiveCb callback;
+    bool        notify = false;
+    if (ready > 0 && (pfd.revents & POLLIN))
+    {
+      ssize_t n = ::read(_fd, buffer, sizeof(buffer));
+      if (n > 0)
+      {
+        std::lock_guard<std::mutex> guard(_lock);
+        _rx.insert(_rx.end(), buffer, buffer + n);
+        callback = _onReceive;
+        notify   = !_onlyOnTimeout;
+        pending  = true;
+        lastUs   = uptimeUs();
+      }
+    }
+    else if (ready > 0 && (pfd.revents & (POLLHUP | POLLERR)))
+    {
+      // Simulator gone, avoid spinning on a hung-up pty
+      delay(HOST_UART_IDLE_POLL_MS);
+    }
+    else if (pending && uptimeUs() - lastUs >= idleUs)
+    {
+      // Line idle for the RX timeout, the frame is complete like on the ESP32 UART
+      std::lock_guard<std::mutex> guard(_lock);
+      callback = _onReceive;
+      notify   = true;
+      pending  = false;
+    }
+
+    if (notify && callback)
+    {
+      callback();
+    }
+  }
+}
+
+/* Private function definitions --------------------------------------- */
+static uint64_t uptimeUs(void)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime)
+  .count();
+}
+
+/* End of file -------------------------------------------------------- */
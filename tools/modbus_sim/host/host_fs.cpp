@@ -0,0 +1,129 @@
+/**
+ * @file       host_fs.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-22
+ * @author     Tuan Nguyen
+ *
+ * @brief      POSIX implementation of the host `fs::FS`
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "FS.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+/* Class method definitions-------------------------------------------- */
+namespace fs
+{
+File::File(FILE *file, const std::string &name, std::shared_ptr<long> writeBudget)
+    : _file(file, fclose), _name(name), _writeBudget(writeBudget)
+{
+}
+
+File::File(DIR *dir, const std::string &path, const std::string &name)
+    : _dir(dir, closedir), _path(path), _name(name)
+{
+}
+
+size_t File::write(const uint8_t *buffer, size_t size)
+{
+  if (!_file)
+  {
+    return 0;
+  }
+  if (_writeBudget && *_writeBudget >= 0)
+  {
+    size           = ((long) size < *_writeBudget) ? size : (size_t) *_writeBudget;
+    *_writeBudget -= (long) size;
+  }
+  size_t written = fwrite(buffer, 1, size, _file.get());
+  fflush(_file.get());
+  return written;
+}
+
+int File::read() { return _file ? fgetc(_file.get()) : -1; }
+
+size_t File::read(uint8_t *buffer, size_t size) { return _file ? fread(buffer, 1, size, _file.get()) : 0; }
+
+bool File::seek(uint32_t position) { return _file && fseek(_file.get(), (long) position, SEEK_SET) == 0; }
+
+size_t File::position() const { return _file ? (size_t) ftell(_file.get()) : 0; }
+
+size_t File::size() const
+{
+  struct stat status;
+
+  return (_file && fstat(fileno(_file.get()), &status) == 0) ? (size_t) status.st_size : 0;
+}
+
+void File::close()
+{
+  _file.reset();
+  _dir.reset();
+}
+
+File File::openNextFile()
+{
+  struct dirent *entry;
+
+  while (_dir && (entry = readdir(_dir.get())) != NULL)
+  {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+    {
+      continue;
+    }
+    std::string path = _path + "/" + entry->d_name;
+    DIR        *dir  = opendir(path.c_str());
+    if (dir != NULL)
+    {
+      return File(dir, path, entry->d_name);
+    }
+    return File(fopen(path.c_str(), "rb"), entry->d_name, nullptr);
+  }
+  return File();
+}
+
+FS::FS(const char *root) : _root(root), _writeBudget(std::make_shared<long>(-1)) {}
+
+File FS::open(const char *path, const char *mode)
+{
+  std::string host = hostPath(path);
+  const char *name = strrchr(path, '/');
+  name             = (name != NULL) ? name + 1 : path;
+
+  if (strcmp(mode, "r") == 0)
+  {
+    DIR *dir = opendir(host.c_str());
+    if (dir != NULL)
+    {
+      return File(dir, host, name);
+    }
+  }
+
+  // Binary modes, "r" "w" "a" as LittleFS, plus the update modes
+  std::string hostMode = std::string(mode) + "b";
+  FILE       *file     = fopen(host.c_str(), hostMode.c_str());
+  return (file != NULL) ? File(file, name, _writeBudget) : File();
+}
+
+bool FS::exists(const char *path)
+{
+  struct stat status;
+
+  return stat(hostPath(path).c_str(), &status) == 0;
+}
+
+bool FS::mkdir(const char *path) { return ::mkdir(hostPath(path).c_str(), 0755) == 0; }
+
+bool FS::remove(const char *path) { return ::remove(hostPath(path).c_str()) == 0; }
+
+bool FS::rename(const char *from, const char *to)
+{
+  return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+} // namespace fs
+
+/* End of file -------------------------------------------------------- */
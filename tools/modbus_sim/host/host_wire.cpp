@@ -0,0 +1,86 @@
+/**
+ * @file       host_wire.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-22
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host `TwoWire` where no device answers
+ *
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "Wire.h"
+
+/* Private defines ---------------------------------------------------- */
+#define HOST_WIRE_NACK_ADDRESS 2 // endTransmission() code for an address NACK
+#define HOST_WIRE_NOT_STARTED  4 // endTransmission() code for any other error
+
+/* Public variables --------------------------------------------------- */
+TwoWire Wire(0);
+TwoWire Wire1(1);
+
+/* Class method definitions-------------------------------------------- */
+bool TwoWire::begin(int sda, int scl, uint32_t frequency)
+{
+  (void) sda;
+  (void) scl;
+
+  return (frequency == 0) || setClock(frequency);
+}
+
+bool TwoWire::begin(uint8_t address, int sda, int scl, uint32_t frequency)
+{
+  (void) address;
+
+  return begin(sda, scl, frequency);
+}
+
+bool TwoWire::setClock(uint32_t frequency)
+{
+  if (frequency == 0)
+  {
+    return false;
+  }
+  _frequency = frequency;
+  return true;
+}
+
+void TwoWire::beginTransmission(uint16_t address)
+{
+  (void) address;
+
+  _transmitting = true;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+  (void) sendStop;
+
+  if (!_transmitting)
+  {
+    return HOST_WIRE_NOT_STARTED;
+  }
+  _transmitting = false;
+  return HOST_WIRE_NACK_ADDRESS;
+}
+
+size_t TwoWire::requestFrom(uint16_t address, size_t size, bool sendStop)
+{
+  (void) address;
+  (void) size;
+  (void) sendStop;
+
+  return 0;
+}
+
+size_t TwoWire::write(uint8_t data) { return write(&data, 1); }
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity)
+{
+  (void) data;
+
+  return _transmitting ? quantity : 0;
+}
+
+/* End of file -------------------------------------------------------- */
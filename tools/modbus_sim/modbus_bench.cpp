@@ -0,0 +1,343 @@
+/**
+ * @file       modbus_bench.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-06
+ * @author     Tuan Nguyen
+ *
+ * @brief      Linux benchmark of the RS-485 stack against `modbus_slave_sim`
+ *
+ * @note       Runs the firmware's `BspRs485`, `BspModbusMaster`, `BspModbusPoller` and `EsSoil7n1` sources on
+ *             the host Arduino core of `host/`, polls every simulated probe for a fixed time and prints
+ *             throughput, timeouts and latency per slave. Exits with 1 when the share of successful
+ *             exchanges is below `--min-success`, so a run can serve as a regression check.
+ * @example    See README.md next to this file for the build command.
+ *             `./modbus_bench --port /tmp/rs485 --slaves 3-12 --seconds 10 --min-success 95`
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "Arduino.h"
+#include "bsp_modbus.h"
+#include "bsp_modbus_poller.h"
+#include "bsp_rs485.h"
+#include "es_soil_7n1.h"
+
+#include <getopt.h>
+
+#include <vector>
+
+/* Private defines ---------------------------------------------------- */
+#define BENCH_MAX_SLAVE 247
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef enum
+{
+  BENCH_MODE_POLLER = 0, // One span block per probe through BspModbusPoller
+  BENCH_MODE_READ_ALL    // EsSoil7n1::readAll() on every probe in turn
+} bench_mode_t;
+
+typedef struct
+{
+  uint8_t             slave;
+  int                 block; // Poller block index
+  EsSoil7n1           probe;
+  uint16_t            span[ES_SOIL_SPAN_LENGTH];
+  uint32_t            requests;
+  uint32_t            successes;
+  uint32_t            timeouts;
+  uint32_t            errors;
+  uint32_t            latencyMaxUs;
+  uint64_t            latencyTotalUs;
+  bsp_modbus_timing_t lastTiming;
+} bench_probe_t;
+
+/* Private variables -------------------------------------------------- */
+
+/* Private function prototypes ---------------------------------------- */
+static bool parseSlaves(const char *list, std::vector<uint8_t> &slaves);
+static void pollCallback(uint8_t slave, uint16_t address, const uint16_t *values, uint16_t count,
+                         bsp_modbus_error_t result, void *context);
+static void record(bench_probe_t *probe, bool success, bool timeout, uint32_t latencyUs);
+static void usage(const char *name);
+
+/* Function definitions ----------------------------------------------- */
+int main(int argc, char **argv)
+{
+  const char          *port          = NULL;
+  std::vector<uint8_t> slaves        = {ES_SOIL_SLAVE_ID};
+  unsigned long        baud          = 9600;
+  unsigned long        seconds       = 10;
+  unsigned long        periodMs      = 1;
+  unsigned long        timeoutMs     = BSP_MODBUS_RESPONSE_TIMEOUT_MS;
+  bench_mode_t         mode          = BENCH_MODE_POLLER;
+  bool                 notify        = true;
+  bool                 verbose       = false;
+  double               minSuccessPct = 0.0;
+
+  static const struct option options[] = {{"port", required_argument, NULL, 'p'},
+                                          {"slaves", required_argument, NULL, 's'},
+                                          {"baud", required_argument, NULL, 'b'},
+                                          {"seconds", required_argument, NULL, 't'},
+                                          {"period", required_argument, NULL, 'P'},
+                                          {"timeout", required_argument, NULL, 'T'},
+                                          {"read-all", no_argument, NULL, 'a'},
+                                          {"no-notify", no_argument, NULL, 'n'},
+                                          {"min-success", required_argument, NULL, 'm'},
+                                          {"verbose", no_argument, NULL, 'v'},
+                                          {"help", no_argument, NULL, 'h'},
+                                          {NULL, 0, NULL, 0}};
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "p:s:b:t:P:T:anm:vh", options, NULL)) != -1)
+  {
+    switch (opt)
+    {
+      case 'p':
+        port = optarg;
+        break;
+      case 's':
+        if (!parseSlaves(optarg, slaves))
+        {
+          fprintf(stderr, "Invalid slave list '%s'\n", optarg);
+          return 2;
+        }
+        break;
+      case 'b':
+        baud = strtoul(optarg, NULL, 10);
+        break;
+      case 't':
+        seconds = strtoul(optarg, NULL, 10);
+        break;
+      case 'P':
+        periodMs = strtoul(optarg, NULL, 10);
+        break;
+      case 'T':
+        timeoutMs = strtoul(optarg, NULL, 10);
+        break;
+      case 'a':
+        mode = BENCH_MODE_READ_ALL;
+        break;
+      case 'n':
+        notify = false;
+        break;
+      case 'm':
+        minSuccessPct = strtod(optarg, NULL);
+        break;
+      case 'v':
+        verbose = true;
+        break;
+      default:
+        usage(argv[0]);
+        return (opt == 'h') ? 0 : 2;
+    }
+  }
+  if (port == NULL || baud == 0 || periodMs == 0)
+  {
+    usage(argv[0]);
+    return 2;
+  }
+  if (mode == BENCH_MODE_POLLER && slaves.size() > BSP_MODBUS_POLLER_MAX_BLOCKS)
+  {
+    fprintf(stderr, "At most %d slaves fit the poller table\n", BSP_MODBUS_POLLER_MAX_BLOCKS);
+    return 2;
+  }
+
+  // The drivers print every raw response, keep the benchmark output readable
+  Serial.mute(!verbose);
+
+  Serial1.setDevice(port);
+  rs485Serial1.begin(baud, SERIAL_8N1);
+  if (!Serial1)
+  {
+    return 2;
+  }
+  if (notify && rs485Serial1.enableFrameNotify() != BSP_RS485_OK)
+  {
+    fprintf(stderr, "RX-timeout notification unavailable, polling the port\n");
+  }
+  modbusMaster1.setResponseTimeout(timeoutMs);
+
+  std::vector<bench_probe_t> probes(slaves.size());
+  for (size_t i = 0; i < slaves.size(); i++)
+  {
+    bench_probe_t *probe = &probes[i];
+    probe->slave         = slaves[i];
+    probe->probe.begin(slaves[i], modbusMaster1);
+    if (mode == BENCH_MODE_POLLER)
+    {
+      probe->block = modbusPoller1.addBlock(slaves[i], BSP_MODBUS_READ_HOLDING_REGISTERS, ES_SOIL_FIRST_REG,
+                                            ES_SOIL_SPAN_LENGTH, periodMs, probe->span, pollCallback, probe);
+    }
+  }
+
+  unsigned long startMs = millis();
+  unsigned long endMs   = startMs + seconds * 1000;
+  while ((long) (millis() - endMs) < 0)
+  {
+    if (mode == BENCH_MODE_POLLER)
+    {
+      uint32_t      waitMs      = modbusPoller1.poll();
+      unsigned long remainingMs = endMs - millis();
+      delay((waitMs < remainingMs) ? waitMs : remainingMs);
+      continue;
+    }
+
+    for (size_t i = 0; i < probes.size() && (long) (millis() - endMs) < 0; i++)
+    {
+      uint32_t            startUs = micros();
+      es_soil_7n1_error_t result  = probes[i].probe.readAll();
+      record(&probes[i], result == ES_SOIL_7N1_OK, result == ES_SOIL_7N1_TIMEOUT, micros() - startUs);
+      probes[i].lastTiming = modbusMaster1.lastTiming();
+    }
+  }
+  double elapsedS = (millis() - startMs) / 1000.0;
+
+  uint32_t requests = 0, successes = 0, timeouts = 0, errors = 0;
+  printf("mode %s, %zu slaves, %lu baud, RX-timeout notification %s\n",
+         (mode == BENCH_MODE_POLLER) ? "poller" : "read-all", probes.size(), baud,
+         rs485Serial1.frameNotifyEnabled() ? "on" : "off");
+  // "sent" counts every request on the line, a probe polled through a split block sends several per poll
+  printf("slave  requests  sent   ok     timeouts  errors  avg_us   max_us   rx_us    wire_us  pH    temp\n");
+  for (bench_probe_t &probe : probes)
+  {
+    bsp_modbus_poll_stats_t line;
+    uint32_t                answered = probe.requests - probe.timeouts;
+    uint32_t                sent     = probe.requests;
+    if (mode == BENCH_MODE_POLLER && modbusPoller1.getSlaveStats(probe.slave, &line) == BSP_MODBUS_OK)
+    {
+      sent = line.requests;
+    }
+    printf("%5u  %8u  %5u  %5u  %8u  %6u  %7lu  %7u  %7u  %7u  %4.2f  %4.1f\n", probe.slave, probe.requests,
+           sent, probe.successes, probe.timeouts, probe.errors,
+           (unsigned long) ((answered > 0) ? probe.latencyTotalUs / answered : 0), probe.latencyMaxUs,
+           probe.lastTiming.responseUs, probe.lastTiming.wireUs, probe.probe.getSoilPh(),
+           probe.probe.getSoilTemperature());
+    requests += probe.requests;
+    successes += probe.successes;
+    timeouts += probe.timeouts;
+    errors += probe.errors;
+  }
+
+  double successPct = (requests > 0) ? 100.0 * successes / requests : 0.0;
+  printf("%.2f s, %u exchanges (%.1f/s), %u ok (%.1f %%), %u timeouts, %u errors\n", elapsedS, requests,
+         requests / elapsedS, successes, successPct, timeouts, errors);
+
+  rs485Serial1.end();
+  return (successPct < minSuccessPct) ? 1 : 0;
+}
+
+static void pollCallback(uint8_t slave, uint16_t address, const uint16_t *values, uint16_t count,
+                         bsp_modbus_error_t result, void *context)
+{
+  bench_probe_t *probe = (bench_probe_t *) context;
+
+  (void) slave;
+  (void) address;
+  (void) count;
+  if (result == BSP_MODBUS_OK)
+  {
+    probe->probe.decodeSpan(values);
+  }
+  else if (result == BSP_MODBUS_ERR_EXCEPTION)
+  {
+    // Same fallback as soilRs485PollCallback(), the block is split into the driver's next smaller plan
+    bsp_modbus_range_t ranges[ES_SOIL_MAX_PLAN_RANGES];
+    uint8_t            count = probe->probe.nextReadPlan(ranges);
+    if (count > 0)
+    {
+      modbusPoller1.splitBlock(probe->block, ranges, count);
+    }
+  }
+  probe->lastTiming = modbusMaster1.lastTiming();
+  record(probe, result == BSP_MODBUS_OK, result == BSP_MODBUS_TIMEOUT,
+         probe->lastTiming.txUs + probe->lastTiming.responseUs);
+}
+
+static void record(bench_probe_t *probe, bool success, bool timeout, uint32_t latencyUs)
+{
+  probe->requests++;
+  if (success)
+  {
+    probe->successes++;
+  }
+  else if (timeout)
+  {
+    probe->timeouts++;
+    return;
+  }
+  else
+  {
+    probe->errors++;
+  }
+
+  // Timeouts only measure the response timeout, keep them out of the latency figures
+  probe->latencyTotalUs += latencyUs;
+  if (latencyUs > probe->latencyMaxUs)
+  {
+    probe->latencyMaxUs = latencyUs;
+  }
+}
+
+static bool parseSlaves(const char *list, std::vector<uint8_t> &slaves)
+{
+  // "3", "3,5,7" or "3-12", ranges and single addresses can be mixed
+  const char *p = list;
+
+  slaves.clear();
+  while (*p != '\0')
+  {
+    char         *end;
+    unsigned long first = strtoul(p, &end, 0);
+    unsigned long last  = first;
+    if (end == p)
+    {
+      return false;
+    }
+    p = end;
+    if (*p == '-')
+    {
+      last = strtoul(p + 1, &end, 0);
+      if (end == p + 1)
+      {
+        return false;
+      }
+      p = end;
+    }
+    if (first == 0 || last > BENCH_MAX_SLAVE || first > last)
+    {
+      return false;
+    }
+    for (unsigned long slave = first; slave <= last; slave++)
+    {
+      slaves.push_back((uint8_t) slave);
+    }
+    if (*p == ',')
+    {
+      p++;
+    }
+    else if (*p != '\0')
+    {
+      return false;
+    }
+  }
+  return !slaves.empty();
+}
+
+static void usage(const char *name)
+{
+  fprintf(stderr,
+          "Usage: %s --port PATH [options]\n"
+          "  --port PATH        tty of the simulator (or a real RS-485 adapter)\n"
+          "  --slaves LIST      slave addresses, e.g. 3 or 3,5 or 3-12 (default 3)\n"
+          "  --baud N           line speed (default 9600)\n"
+          "  --seconds N        benchmark duration (default 10)\n"
+          "  --period MS        polling period of every probe, 1 polls back to back (default 1)\n"
+          "  --timeout MS       response timeout (default %d)\n"
+          "  --read-all         call EsSoil7n1::readAll() in turn instead of using the poller\n"
+          "  --no-notify        find the end of replies by polling instead of the RX-timeout event\n"
+          "  --min-success PCT  exit with 1 when fewer exchanges succeed\n"
+          "  --verbose          keep the drivers' debug output\n",
+          name, BSP_MODBUS_RESPONSE_TIMEOUT_MS);
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,527 @@
+/**
+ * @file       modbus_slave_sim.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-06
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host-side Modbus RTU slave simulator on a pseudo-terminal
+ *
+ * @note       Emulates one or more ES soil 7 in 1 probes on one line. The master opens the pty slave path
+ *             printed at start-up (or the `--link` symlink) as if it were the RS-485 adapter. Reply latency,
+ *             jitter, corrupted CRCs and dropped frames are configurable, replies are delayed by their wire
+ *             time at `--baud` so line throughput matches a real bus.
+ * @example    `g++ -std=gnu++11 -O2 -pthread tools/modbus_sim/modbus_slave_sim.cpp -o modbus_slave_sim`
+ *             `./modbus_slave_sim --slaves 3-12 --latency 20 --jitter 5 --drop 1 --link /tmp/rs485`
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+/* Private defines ---------------------------------------------------- */
+#define SIM_MAX_SLAVE      247
+#define SIM_REG_COUNT      0x30 // Registers 0x00..0x2F are mapped, the probe's table ends at 0x20
+#define SIM_MAX_FRAME      256
+#define SIM_CHAR_BITS      11   // Start, 8 data, parity or second stop, stop
+#define SIM_REQUEST_LENGTH 8    // Slave, function, address, count or value, CRC
+
+#define SIM_READ_HOLDING   0x03
+#define SIM_READ_INPUT     0x04
+#define SIM_WRITE_SINGLE   0x06
+#define SIM_EXCEPTION_FLAG 0x80
+
+#define SIM_EXCEPTION_ILLEGAL_FUNCTION     0x01
+#define SIM_EXCEPTION_ILLEGAL_DATA_ADDRESS 0x02
+#define SIM_EXCEPTION_ILLEGAL_DATA_VALUE   0x03
+
+// ES soil 7 in 1 register map, same addresses as es_soil_7n1.h
+#define SIM_PH_REG           0x06
+#define SIM_MOISTURE_REG     0x12
+#define SIM_TEMPERATURE_REG  0x13
+#define SIM_CONDUCTIVITY_REG 0x15
+#define SIM_NITROGEN_REG     0x1E
+#define SIM_PHOSPHORUS_REG   0x1F
+#define SIM_POTASSIUM_REG    0x20
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef struct
+{
+  bool     present;
+  uint16_t regs[SIM_REG_COUNT];
+  uint32_t requests;
+  uint32_t replies;
+  uint32_t exceptions;
+  uint32_t dropped;
+  uint32_t corrupted;
+} sim_slave_t;
+
+typedef struct
+{
+  uint32_t baud;
+  uint32_t latencyMs;
+  uint32_t jitterMs;
+  double   crcErrorPercent;
+  double   dropPercent;
+  bool     strict; // Reject reads that touch the unused registers inside the probe's table
+  bool     verbose;
+  uint32_t seed;
+} sim_config_t;
+
+/* Private variables -------------------------------------------------- */
+static sim_slave_t           slaves[SIM_MAX_SLAVE + 1];
+static sim_config_t          config    = {9600, 20, 0, 0.0, 0.0, false, false, 1};
+static volatile sig_atomic_t running   = 1;
+static uint32_t              badFrames = 0;
+static std::mt19937          rng;
+
+/* Private function prototypes ---------------------------------------- */
+static uint16_t crc16(const uint8_t *data, size_t length);
+static bool     parseSlaves(const char *list);
+static void     initRegisters(uint8_t slave);
+static bool     regMapped(uint16_t reg);
+static size_t   handleRequest(const uint8_t *request, size_t length, uint8_t *reply);
+static uint32_t wireTimeUs(size_t bytes);
+static bool     chance(double percent);
+static void     printStats(void);
+static void     onSignal(int sig);
+static void     usage(const char *name);
+
+/* Function definitions ----------------------------------------------- */
+int main(int argc, char **argv)
+{
+  const char *link = NULL;
+
+  static const struct option options[] = {{"slaves", required_argument, NULL, 's'},
+                                          {"baud", required_argument, NULL, 'b'},
+                                          {"latency", required_argument, NULL, 'l'},
+                                          {"jitter", required_argument, NULL, 'j'},
+                                          {"crc-error", required_argument, NULL, 'c'},
+                                          {"drop", required_argument, NULL, 'd'},
+                                          {"strict", no_argument, NULL, 'x'},
+                                          {"link", required_argument, NULL, 'L'},
+                                          {"seed", required_argument, NULL, 'S'},
+                                          {"verbose", no_argument, NULL, 'v'},
+                                          {"help", no_argument, NULL, 'h'},
+                                          {NULL, 0, NULL, 0}};
+
+  parseSlaves("3");
+  int opt;
+  while ((opt = getopt_long(argc, argv, "s:b:l:j:c:d:xL:S:vh", options, NULL)) != -1)
+  {
+    switch (opt)
+    {
+      case 's':
+        memset(slaves, 0, sizeof(slaves));
+        if (!parseSlaves(optarg))
+        {
+          fprintf(stderr, "Invalid slave list '%s'\n", optarg);
+          return 1;
+        }
+        break;
+      case 'b':
+        config.baud = strtoul(optarg, NULL, 10);
+        break;
+      case 'l':
+        config.latencyMs = strtoul(optarg, NULL, 10);
+        break;
+      case 'j':
+        config.jitterMs = strtoul(optarg, NULL, 10);
+        break;
+      case 'c':
+        config.crcErrorPercent = strtod(optarg, NULL);
+        break;
+      case 'd':
+        config.dropPercent = strtod(optarg, NULL);
+        break;
+      case 'x':
+        config.strict = true;
+        break;
+      case 'L':
+        link = optarg;
+        break;
+      case 'S':
+        config.seed = strtoul(optarg, NULL, 10);
+        break;
+      case 'v':
+        config.verbose = true;
+        break;
+      default:
+        usage(argv[0]);
+        return (opt == 'h') ? 0 : 1;
+    }
+  }
+  if (config.baud == 0)
+  {
+    fprintf(stderr, "Baud rate must not be 0\n");
+    return 1;
+  }
+  rng.seed(config.seed);
+
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+  {
+    perror("posix_openpt");
+    return 1;
+  }
+  const char *slavePath = ptsname(master);
+
+  // Keep the slave side open and raw so the line survives the client reconnecting
+  int keep = open(slavePath, O_RDWR | O_NOCTTY);
+  if (keep < 0)
+  {
+    perror(slavePath);
+    return 1;
+  }
+  struct termios tio;
+  tcgetattr(keep, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(keep, TCSANOW, &tio);
+
+  if (link != NULL)
+  {
+    unlink(link);
+    if (symlink(slavePath, link) != 0)
+    {
+      perror(link);
+      return 1;
+    }
+  }
+  printf("%s\n", (link != NULL) ? link : slavePath);
+  fflush(stdout);
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  uint8_t  frame[SIM_MAX_FRAME];
+  uint8_t  reply[SIM_MAX_FRAME];
+  size_t   length = 0;
+  uint32_t gapMs  = (wireTimeUs(35) / 10 + 999) / 1000; // t3.5, at least 1 ms
+  while (running)
+  {
+    struct pollfd pfd = {master, POLLIN, 0};
+    int           ready = poll(&pfd, 1, (length > 0) ? (int) gapMs : 200);
+    if (ready < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      perror("poll");
+      break;
+    }
+
+    if (ready > 0)
+    {
+      ssize_t n = read(master, frame + length, sizeof(frame) - length);
+      if (n > 0)
+      {
+        length += n;
+      }
+      // Requests of the supported functions have a fixed length, anything else ends on t3.5
+      if (length < SIM_REQUEST_LENGTH && length < sizeof(frame))
+      {
+        continue;
+      }
+      if (length >= 2 && length < sizeof(frame) &&
+          (frame[1] != SIM_READ_HOLDING && frame[1] != SIM_READ_INPUT && frame[1] != SIM_WRITE_SINGLE))
+      {
+        continue;
+      }
+    }
+    else if (length == 0)
+    {
+      continue;
+    }
+
+    size_t replyLength = handleRequest(frame, length, reply);
+    length             = 0;
+    if (replyLength == 0)
+    {
+      continue;
+    }
+
+    // Turnaround, then the reply arrives complete at the time its last byte would leave the wire
+    uint32_t delayUs = config.latencyMs * 1000;
+    if (config.jitterMs > 0)
+    {
+      delayUs += std::uniform_int_distribution<uint32_t>(0, config.jitterMs * 1000)(rng);
+    }
+    delayUs += wireTimeUs(replyLength);
+    std::this_thread::sleep_for(std::chrono::microseconds(delayUs));
+    if (write(master, reply, replyLength) != (ssize_t) replyLength)
+    {
+      perror("write");
+    }
+  }
+
+  printStats();
+  if (link != NULL)
+  {
+    unlink(link);
+  }
+  close(keep);
+  close(master);
+  return 0;
+}
+
+static size_t handleRequest(const uint8_t *request, size_t length, uint8_t *reply)
+{
+  if (length < 4 || crc16(request, length - 2) != (request[length - 2] | (request[length - 1] << 8)))
+  {
+    // Slaves stay silent on a corrupted frame, the master times out
+    badFrames++;
+    return 0;
+  }
+
+  uint8_t address = request[0];
+  if (address == 0 || !slaves[address].present)
+  {
+    return 0;
+  }
+  sim_slave_t *slave = &slaves[address];
+  slave->requests++;
+
+  if (chance(config.dropPercent))
+  {
+    slave->dropped++;
+    return 0;
+  }
+
+  uint8_t  function  = request[1];
+  uint16_t reg       = (request[2] << 8) | request[3];
+  uint16_t value     = (request[4] << 8) | request[5];
+  uint8_t  exception = 0;
+  size_t   out       = 0;
+
+  reply[out++] = address;
+  reply[out++] = function;
+  switch (function)
+  {
+    case SIM_READ_HOLDING:
+    case SIM_READ_INPUT:
+      if (length != SIM_REQUEST_LENGTH || value == 0 || value > 125)
+      {
+        exception = SIM_EXCEPTION_ILLEGAL_DATA_VALUE;
+        break;
+      }
+      for (uint32_t r = reg; r < (uint32_t) reg + value; r++)
+      {
+        if (r >= SIM_REG_COUNT || (config.strict && !regMapped(r)))
+        {
+          exception = SIM_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+          break;
+        }
+      }
+      if (exception != 0)
+      {
+        break;
+      }
+      reply[out++] = 2 * value;
+      for (uint16_t i = 0; i < value; i++)
+      {
+        reply[out++] = slave->regs[reg + i] >> 8;
+        reply[out++] = slave->regs[reg + i] & 0xFF;
+      }
+      break;
+
+    case SIM_WRITE_SINGLE:
+      if (length != SIM_REQUEST_LENGTH || reg >= SIM_REG_COUNT)
+      {
+        exception = SIM_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+        break;
+      }
+      slave->regs[reg] = value;
+      memcpy(&reply[out], &request[2], 4);
+      out += 4;
+      break;
+
+    default:
+      exception = SIM_EXCEPTION_ILLEGAL_FUNCTION;
+      break;
+  }
+
+  if (exception != 0)
+  {
+    out          = 0;
+    reply[out++] = address;
+    reply[out++] = function | SIM_EXCEPTION_FLAG;
+    reply[out++] = exception;
+    slave->exceptions++;
+  }
+
+  uint16_t crc = crc16(reply, out);
+  reply[out++] = crc & 0xFF;
+  reply[out++] = crc >> 8;
+  if (chance(config.crcErrorPercent))
+  {
+    reply[out - 1] ^= 0x5A;
+    slave->corrupted++;
+  }
+  slave->replies++;
+
+  if (config.verbose)
+  {
+    fprintf(stderr, "slave %u fn 0x%02X reg 0x%04X n %u -> %zu bytes%s\n", address, function, reg, value,
+            out, (exception != 0) ? " (exception)" : "");
+  }
+
+  // Readings drift a little between polls so consecutive values can be told apart
+  slave->regs[SIM_TEMPERATURE_REG] = 200 + address + (slave->requests % 10);
+  return out;
+}
+
+static void initRegisters(uint8_t slave)
+{
+  uint16_t *regs = slaves[slave].regs;
+
+  memset(regs, 0, SIM_REG_COUNT * sizeof(uint16_t));
+  regs[SIM_PH_REG]           = 650 + slave;  // 0.01 pH
+  regs[SIM_MOISTURE_REG]     = 400 + slave;  // 0.1 % RH
+  regs[SIM_TEMPERATURE_REG]  = 200 + slave;  // 0.1 degree Celsius
+  regs[SIM_CONDUCTIVITY_REG] = 1000 + slave; // us/cm
+  regs[SIM_NITROGEN_REG]     = 30 + slave;   // mg/kg
+  regs[SIM_PHOSPHORUS_REG]   = 35 + slave;   // mg/kg
+  regs[SIM_POTASSIUM_REG]    = 45 + slave;   // mg/kg
+}
+
+static bool regMapped(uint16_t reg)
+{
+  switch (reg)
+  {
+    case SIM_PH_REG:
+    case SIM_MOISTURE_REG:
+    case SIM_TEMPERATURE_REG:
+    case SIM_TEMPERATURE_REG + 1: // Inside the moisture..conductivity group the probe accepts
+    case SIM_CONDUCTIVITY_REG:
+    case SIM_NITROGEN_REG:
+    case SIM_PHOSPHORUS_REG:
+    case SIM_POTASSIUM_REG:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static bool parseSlaves(const char *list)
+{
+  // "3", "3,5,7" or "3-12", ranges and single addresses can be mixed
+  const char *p = list;
+  while (*p != '\0')
+  {
+    char         *end;
+    unsigned long first = strtoul(p, &end, 0);
+    unsigned long last  = first;
+    if (end == p)
+    {
+      return false;
+    }
+    p = end;
+    if (*p == '-')
+    {
+      last = strtoul(p + 1, &end, 0);
+      if (end == p + 1)
+      {
+        return false;
+      }
+      p = end;
+    }
+    if (first == 0 || last > SIM_MAX_SLAVE || first > last)
+    {
+      return false;
+    }
+    for (unsigned long slave = first; slave <= last; slave++)
+    {
+      slaves[slave].present = true;
+      initRegisters(slave);
+    }
+    if (*p == ',')
+    {
+      p++;
+    }
+    else if (*p != '\0')
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint16_t crc16(const uint8_t *data, size_t length)
+{
+  uint16_t crc = 0xFFFF;
+
+  for (size_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x0001) ? (crc >> 1) ^ 0xA001 : (crc >> 1);
+    }
+  }
+  return crc;
+}
+
+static uint32_t wireTimeUs(size_t bytes)
+{
+  return (uint32_t) ((uint64_t) bytes * SIM_CHAR_BITS * 1000000ULL / config.baud);
+}
+
+static bool chance(double percent)
+{
+  return percent > 0.0 && std::uniform_real_distribution<double>(0.0, 100.0)(rng) < percent;
+}
+
+static void printStats(void)
+{
+  fprintf(stderr, "slave requests replies exceptions dropped corrupted\n");
+  for (uint16_t i = 1; i <= SIM_MAX_SLAVE; i++)
+  {
+    const sim_slave_t *slave = &slaves[i];
+    if (slave->present && slave->requests > 0)
+    {
+      fprintf(stderr, "%5u %8u %7u %10u %7u %9u\n", i, slave->requests, slave->replies, slave->exceptions,
+              slave->dropped, slave->corrupted);
+    }
+  }
+  fprintf(stderr, "frames with a bad CRC from the master: %u\n", badFrames);
+}
+
+static void onSignal(int sig)
+{
+  (void) sig;
+  running = 0;
+}
+
+static void usage(const char *name)
+{
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  --slaves LIST    slave addresses, e.g. 3 or 3,5 or 3-12 (default 3)\n"
+          "  --baud N         line speed used for reply pacing and t3.5 (default 9600)\n"
+          "  --latency MS     turnaround before every reply (default 20)\n"
+          "  --jitter MS      random extra turnaround, 0..MS (default 0)\n"
+          "  --crc-error PCT  percentage of replies sent with a broken CRC\n"
+          "  --drop PCT       percentage of requests left unanswered\n"
+          "  --strict         reject reads covering the unused registers of the probe map\n"
+          "  --link PATH      symlink the pty slave to PATH\n"
+          "  --seed N         random seed (default 1)\n"
+          "  --verbose        log every request on stderr\n",
+          name);
+}
+
+/* End of file -------------------------------------------------------- */
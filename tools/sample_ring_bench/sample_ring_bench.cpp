@@ -0,0 +1,187 @@
+/**
+ * @file       sample_ring_bench.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-11
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host benchmark of the SampleRing push and in-place iteration
+ *
+ * @note       Times `push()`, a full `view()` walk and `viewSince()` on the ring depths the data hub uses,
+ *             then runs one producer thread pushing as fast as it can against reader threads that walk
+ *             views and `trim()` them. Every sample a reader keeps after `trim()` must be the one pushed
+ *             at its position; exits with 1 when one is not.
+ * @example    g++ -std=gnu++11 -O2 -pthread -Ilib/sample_ring/src \
+ *                 tools/sample_ring_bench/sample_ring_bench.cpp lib/sample_ring/src/sample_ring.cpp \
+ *                 -o sample_ring_bench && ./sample_ring_bench
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "sample_ring.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+/* Private defines ---------------------------------------------------- */
+#define BENCH_PUSHES         (16UL * 1024 * 1024) // Pushes per timing
+#define BENCH_WALKED_SAMPLES (64UL * 1024 * 1024) // Samples read per iteration timing
+#define BENCH_STRESS_MS      2000                 // Length of the producer/reader run
+#define BENCH_READERS        2
+#define BENCH_VALUE_MASK     0xFFFFFF // Integers up to 2^24 are exact in a float
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef std::chrono::steady_clock bench_clock_t;
+
+typedef struct
+{
+  uint64_t views;   // Views walked
+  uint64_t samples; // Samples kept after trim()
+  uint64_t trimmed; // Views trim() shortened
+  uint64_t errors;  // Kept samples that were not the pushed ones
+} bench_reader_stats_t;
+
+/* Private variables -------------------------------------------------- */
+static volatile float benchSink; // Keeps the timed loops from being optimised away
+
+/* Private function prototypes ---------------------------------------- */
+static double nsSince(bench_clock_t::time_point start);
+template <uint16_t DEPTH>
+static void timeRing();
+static bool stress();
+
+/* Function definitions ----------------------------------------------- */
+int main()
+{
+  printf("%-6s %10s %12s %14s\n", "depth", "push ns", "walk ns/smp", "viewSince ns");
+  timeRing<64>();
+  timeRing<128>();
+  timeRing<256>();
+  timeRing<4096>();
+
+  return stress() ? 0 : 1;
+}
+
+static double nsSince(bench_clock_t::time_point start)
+{
+  return std::chrono::duration<double, std::nano>(bench_clock_t::now() - start).count();
+}
+
+template <uint16_t DEPTH>
+static void timeRing()
+{
+  static SampleRingBuffer<DEPTH> ring;
+
+  bench_clock_t::time_point start = bench_clock_t::now();
+  for (uint32_t i = 0; i < BENCH_PUSHES; i++)
+  {
+    ring.push(i * 10, (float) (i & BENCH_VALUE_MASK));
+  }
+  double pushNs = nsSince(start) / BENCH_PUSHES;
+
+  // Sum the full ring in place, as an aggregation over the whole history does
+  uint32_t walks = BENCH_WALKED_SAMPLES / DEPTH;
+  float    sum   = 0;
+  start          = bench_clock_t::now();
+  for (uint32_t walk = 0; walk < walks; walk++)
+  {
+    sample_ring_view_t view = ring.view();
+    for (uint16_t i = 0; i < view.firstLength; i++)
+    {
+      sum += view.first[i].value;
+    }
+    for (uint16_t i = 0; i < view.secondLength; i++)
+    {
+      sum += view.second[i].value;
+    }
+  }
+  double walkNs = nsSince(start) / ((double) walks * DEPTH);
+  benchSink     = sum;
+
+  // Last quarter of the history, the lookup of a windowed aggregate
+  uint32_t newest  = (BENCH_PUSHES - 1) * 10;
+  uint32_t sinceMs = newest - (DEPTH / 4) * 10;
+  uint32_t lookups = 1000000;
+  uint32_t found   = 0;
+  start            = bench_clock_t::now();
+  for (uint32_t i = 0; i < lookups; i++)
+  {
+    sample_ring_view_t view = ring.viewSince(sinceMs + (i & 7) * 10);
+    found += SampleRing::length(&view);
+  }
+  double sinceNs = nsSince(start) / lookups;
+  benchSink      = (float) found;
+
+  printf("%-6u %10.2f %12.3f %14.1f\n", DEPTH, pushNs, walkNs, sinceNs);
+}
+
+static bool stress()
+{
+  static SampleRingBuffer<256> ring;
+  std::atomic<bool>            running(true);
+  bench_reader_stats_t         stats[BENCH_READERS] = {};
+  std::vector<std::thread>     readers;
+
+  for (int r = 0; r < BENCH_READERS; r++)
+  {
+    readers.push_back(std::thread(
+      [&running](bench_reader_stats_t *result)
+      {
+        std::vector<uint8_t> bad(ring.capacity());
+        while (running.load(std::memory_order_relaxed))
+        {
+          sample_ring_view_t view  = ring.view();
+          uint16_t           count = SampleRing::length(&view);
+
+          // Check each sample against its push count, but only trust the result after trim()
+          for (uint16_t i = 0; i < count; i++)
+          {
+            const sample_ring_sample_t *sample = SampleRing::at(&view, i);
+            uint32_t                    index  = view.start + i;
+            bad[i] = (sample->timestampMs != index || sample->value != (float) (index & BENCH_VALUE_MASK));
+          }
+          uint16_t kept = ring.trim(&view);
+          for (uint16_t i = count - kept; i < count; i++)
+          {
+            result->errors += bad[i];
+          }
+          result->views++;
+          result->samples += kept;
+          result->trimmed += (kept < count);
+        }
+      },
+      &stats[r]));
+  }
+
+  uint32_t                  pushes = 0;
+  bench_clock_t::time_point start  = bench_clock_t::now();
+  while (nsSince(start) < BENCH_STRESS_MS * 1e6)
+  {
+    for (int i = 0; i < 1024; i++, pushes++)
+    {
+      ring.push(pushes, (float) (pushes & BENCH_VALUE_MASK));
+    }
+  }
+  running = false;
+  for (size_t r = 0; r < readers.size(); r++)
+  {
+    readers[r].join();
+  }
+
+  uint64_t errors = 0;
+  printf("\nstress: %u pushes in %d ms, %d readers\n", pushes, BENCH_STRESS_MS, BENCH_READERS);
+  for (int r = 0; r < BENCH_READERS; r++)
+  {
+    printf("  reader %d: %llu views, %llu samples kept, %llu views trimmed, %llu errors\n", r,
+           (unsigned long long) stats[r].views, (unsigned long long) stats[r].samples,
+           (unsigned long long) stats[r].trimmed, (unsigned long long) stats[r].errors);
+    errors += stats[r].errors;
+  }
+  printf("%s\n", (errors == 0) ? "PASS" : "FAIL");
+
+  return errors == 0;
+}
+
+/* End of file -------------------------------------------------------- */
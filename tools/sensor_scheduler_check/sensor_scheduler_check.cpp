@@ -0,0 +1,179 @@
+/**
+ * @file       sensor_scheduler_check.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-22
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host check of the sensor scheduler timer wheel against a virtual clock
+ *
+ * @note       Runs the scheduler loop of `SensorScheduler::task()` for three simulated hours. `millis()`,
+ *             `micros()`, `vTaskDelay()` and the mutex are defined here on a virtual clock instead of
+ *             host_arduino.cpp. The clock starts one hour before `millis()` wraps, so `micros()` and
+ *             `millis()` both wrap during the run. Every wake-up comes up to 0.9 ms late, like the 1 ms
+ *             FreeRTOS tick, and each job advances the clock by its run time.
+ *
+ *             The job set has the button and LCD jobs, 30 s sensors, a 150 ms job with a 100 ms deadline
+ *             that delays the rest, a 10 min job in the top level and a 1 h job beyond the wheel range.
+ *             For every job the check requires:
+ *               - every period of the run either ran or was counted as skipped
+ *               - starts stay on the period grid, later than due by at most the longest job and a tick
+ *               - overruns only for the job past its deadline
+ *             Exits with 1 when a check fails.
+ * @example    g++ -std=gnu++11 -O2 -DARDUINO=10819 -Itools/modbus_sim/host -Ilib/sensor_scheduler/src \
+ *                 tools/sensor_scheduler_check/sensor_scheduler_check.cpp \
+ *                 lib/sensor_scheduler/src/sensor_scheduler.cpp -o sensor_scheduler_check \
+ *                 && ./sensor_scheduler_check
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "sensor_scheduler.h"
+
+#include <stdio.h>
+
+/* Private defines ---------------------------------------------------- */
+#define CHECK_DURATION_US (3ULL * 3600 * 1000000)
+#define CHECK_START_US    ((0x100000000ULL - 3600ULL * 1000) * 1000) // millis() wraps after one hour
+#define CHECK_WAKE_LATE   900 // Largest wake-up delay in microseconds
+#define CHECK_LONGEST_US  150000
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef struct
+{
+  const char *name;
+  uint32_t    periodMs;
+  uint32_t    phaseMs;
+  uint32_t    deadlineMs;
+  uint32_t    costUs;
+  uint64_t    maxLateUs; // Largest distance of a start from its grid point
+} check_job_t;
+
+/* Private variables -------------------------------------------------- */
+static check_job_t jobs[] = {
+{"button", 10, 0, 0, 200, 0},
+{"lcd", 1000, 10, 0, 3000, 0},
+{"sht40", 30000, 0, 0, 5000, 0},
+{"bmp280", 30000, 100, 0, 4000, 0},
+{"light", 2000, 200, 0, 100, 0},
+{"slow", 5000, 50, 100, CHECK_LONGEST_US, 0},
+{"level2", 600000, 300, 0, 10, 0},
+{"hourly", 3600000, 1000, 0, 10, 0}};
+
+static uint64_t clockUs  = CHECK_START_US;
+static uint64_t startUs  = 0;
+static uint32_t seed     = 0x9E3779B9;
+static int      failures = 0;
+
+/* Private function prototypes ---------------------------------------- */
+static void     runJob(void *context);
+static uint32_t wakeDelayUs();
+static void     check(bool condition, const char *job, const char *what);
+
+/* Function definitions ----------------------------------------------- */
+// Virtual clock and single-threaded FreeRTOS calls used by the scheduler
+unsigned long millis(void) { return (unsigned long) (uint32_t) (clockUs / 1000); }
+
+unsigned long micros(void) { return (unsigned long) (uint32_t) clockUs; }
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) { return (SemaphoreHandle_t) &seed; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+
+// No task, main() drives the scheduler loop itself
+BaseType_t xTaskCreate(TaskFunction_t, const char *, uint32_t, void *, UBaseType_t, TaskHandle_t *)
+{
+  return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) { clockUs += (uint64_t) ticks * 1000 + wakeDelayUs(); }
+
+int main()
+{
+  const uint8_t count   = sizeof(jobs) / sizeof(jobs[0]);
+  uint32_t      wakeups = 0;
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (sensorScheduler.addJob(jobs[i].name, runJob, &jobs[i], jobs[i].periodMs, jobs[i].phaseMs,
+                               jobs[i].deadlineMs) != i)
+    {
+      printf("FAILED: addJob %s\n", jobs[i].name);
+      return 1;
+    }
+  }
+
+  // SensorScheduler::task() on the virtual clock
+  startUs = clockUs;
+  while (clockUs - startUs < CHECK_DURATION_US)
+  {
+    uint32_t waitMs = sensorScheduler.run();
+    vTaskDelay(pdMS_TO_TICKS(waitMs > 0 ? waitMs : 1));
+    wakeups++;
+  }
+
+  printf("%-8s %8s %8s %6s %6s %9s %9s %9s\n", "job", "periods", "runs", "skip", "ovr", "jit_avg", "jit_max",
+         "grid_max");
+  for (uint8_t i = 0; i < count; i++)
+  {
+    check_job_t             *job = &jobs[i];
+    sensor_scheduler_stats_t stats;
+    sensorScheduler.getJobStats(i, &stats);
+
+    uint64_t durationMs = CHECK_DURATION_US / 1000;
+    uint32_t periods    = (uint32_t) ((durationMs - job->phaseMs) / job->periodMs + 1);
+    uint32_t average    = (stats.runs > 0) ? (uint32_t) (stats.jitterTotalUs / stats.runs) : 0;
+    printf("%-8s %8u %8u %6u %6u %9u %9u %9llu\n", job->name, periods, stats.runs, stats.skipped,
+           stats.overruns, average, stats.jitterMaxUs, (unsigned long long) job->maxLateUs);
+
+    // The run that falls due on the last tick may not have started yet
+    uint32_t accounted = stats.runs + stats.skipped;
+    check(accounted == periods || accounted + 1 == periods, job->name, "periods run or skipped");
+    check(job->maxLateUs <= CHECK_LONGEST_US + SENSOR_SCHEDULER_TICK_MS * 1000 + CHECK_WAKE_LATE, job->name,
+          "start on the period grid");
+    check((stats.overruns > 0) == (job->deadlineMs > 0 && job->costUs > job->deadlineMs * 1000), job->name,
+          "overruns");
+  }
+  printf("%u wake-ups in %llu h of virtual time\n", wakeups, CHECK_DURATION_US / 3600000000ULL);
+  printf("%s\n", (failures == 0) ? "PASS" : "FAIL");
+
+  return (failures == 0) ? 0 : 1;
+}
+
+/* Private definitions ------------------------------------------------ */
+static void runJob(void *context)
+{
+  check_job_t *job       = (check_job_t *) context;
+  uint64_t     elapsedUs = clockUs - startUs;
+  uint64_t     phaseUs   = (uint64_t) job->phaseMs * 1000;
+  uint64_t     periodUs  = (uint64_t) job->periodMs * 1000;
+  uint64_t     lateUs    = (elapsedUs >= phaseUs) ? (elapsedUs - phaseUs) % periodUs : UINT64_MAX;
+
+  if (lateUs > job->maxLateUs)
+  {
+    job->maxLateUs = lateUs;
+  }
+  clockUs += job->costUs;
+}
+
+// xorshift32, the same run every time
+static uint32_t wakeDelayUs()
+{
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+
+  return seed % (CHECK_WAKE_LATE + 1);
+}
+
+static void check(bool condition, const char *job, const char *what)
+{
+  if (!condition)
+  {
+    printf("FAILED: %s %s\n", job, what);
+    failures++;
+  }
+}
+
+/* End of file -------------------------------------------------------- */
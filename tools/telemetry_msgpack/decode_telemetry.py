@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""Server-side stand-in that turns the MsgPack telemetry of the device back into ThingsBoard JSON.
+
+Reads one message per line, as hex, from stdin or the files given after the dictionary and prints the
+JSON object ThingsBoard would have received on ``v1/devices/me/telemetry``. A message is the MsgPack
+array ``[version, id, value, id, value, ...]`` built by ``TelemetryBatch::encodeMsgPack()``: ``id & 0x7f``
+indexes the key dictionary, ``id >> 7`` is the ``_<number>`` suffix of the key when not 0, and a string
+in place of an id is a key the dictionary does not hold.
+
+Usage: decode_telemetry.py telemetry_keys.json [messages.hex ...]
+"""
+
+import fileinput
+import json
+import struct
+import sys
+
+ID_BITS = 7
+
+
+class DecodeError(Exception):
+    pass
+
+
+def unpack(data, pos=0):
+    """Decodes the MsgPack object at ``pos``, returns it and the position behind it.
+
+    Covers what ArduinoJson writes for the telemetry: integers, floats, strings, nil, booleans and
+    arrays. Maps, binaries and extensions are rejected.
+    """
+    if pos >= len(data):
+        raise DecodeError("truncated message")
+    tag = data[pos]
+    pos += 1
+
+    def take(count):
+        if pos + count > len(data):
+            raise DecodeError("truncated message")
+        return data[pos:pos + count]
+
+    if tag <= 0x7F:
+        return tag, pos
+    if tag >= 0xE0:
+        return tag - 0x100, pos
+    if 0xA0 <= tag <= 0xBF:
+        length = tag & 0x1F
+        return take(length).decode("utf-8"), pos + length
+    if 0x90 <= tag <= 0x9F:
+        return unpack_array(data, pos, tag & 0x0F)
+    if tag == 0xC0:
+        return None, pos
+    if tag in (0xC2, 0xC3):
+        return tag == 0xC3, pos
+
+    fixed = {0xCA: ">f", 0xCB: ">d", 0xCC: ">B", 0xCD: ">H", 0xCE: ">I", 0xCF: ">Q",
+             0xD0: ">b", 0xD1: ">h", 0xD2: ">i", 0xD3: ">q"}
+    if tag in fixed:
+        size = struct.calcsize(fixed[tag])
+        return struct.unpack(fixed[tag], take(size))[0], pos + size
+    if tag in (0xD9, 0xDA, 0xDB):
+        size = {0xD9: 1, 0xDA: 2, 0xDB: 4}[tag]
+        length = int.from_bytes(take(size), "big")
+        pos += size
+        return take(length).decode("utf-8"), pos + length
+    if tag in (0xDC, 0xDD):
+        size = 2 if tag == 0xDC else 4
+        length = int.from_bytes(take(size), "big")
+        return unpack_array(data, pos + size, length)
+
+    raise DecodeError("unsupported MsgPack type 0x%02x" % tag)
+
+
+def unpack_array(data, pos, length):
+    items = []
+    for _ in range(length):
+        item, pos = unpack(data, pos)
+        items.append(item)
+    return items, pos
+
+
+def decode(message, version, keys):
+    """Returns the telemetry object of one message."""
+    items, end = unpack(message)
+    if end != len(message):
+        raise DecodeError("%d trailing bytes" % (len(message) - end))
+    if not isinstance(items, list) or len(items) % 2 != 1:
+        raise DecodeError("not a [version, id, value, ...] array")
+    if items[0] != version:
+        raise DecodeError("dictionary version %r, expected %d" % (items[0], version))
+
+    values = {}
+    for key_id, value in zip(items[1::2], items[2::2]):
+        if isinstance(key_id, str):
+            key = key_id
+        elif isinstance(key_id, int) and not isinstance(key_id, bool) and key_id >= 0:
+            index, suffix = key_id & ((1 << ID_BITS) - 1), key_id >> ID_BITS
+            if index >= len(keys):
+                raise DecodeError("key id %d not in dictionary" % key_id)
+            key = keys[index] if suffix == 0 else "%s_%d" % (keys[index], suffix)
+        else:
+            raise DecodeError("invalid key %r" % (key_id,))
+        # The device sends float32, print it as short as `%.7g` does
+        values[key] = float("%.7g" % value) if isinstance(value, float) else value
+
+    return values
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__.strip().splitlines()[-1])
+
+    with open(sys.argv[1]) as file:
+        dictionary = json.load(file)
+    version, keys = dictionary["version"], dictionary["keys"]
+
+    failed = False
+    for line in fileinput.input(sys.argv[2:]):
+        line = line.strip()
+        if not line:
+            continue
+        try:
+            print(json.dumps(decode(bytes.fromhex(line), version, keys), separators=(",", ":")))
+        except (DecodeError, ValueError) as error:
+            print("%s:%d: %s" % (fileinput.filename(), fileinput.filelineno(), error), file=sys.stderr)
+            failed = True
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,126 @@
+/**
+ * @file       msgpack_sample.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-17
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host encoder of a sample telemetry cycle, JSON against MsgPack
+ *
+ * @note       Loads the key dictionary from `telemetry_keys.json`, fills a `TelemetryBatch` with one cycle of
+ *             the keys the firmware sends (climate, AC with a voltage window and two soil probes) and encodes
+ *             it both ways with the payload limit of the firmware. Prints the sizes on stderr and every
+ *             MsgPack message as one hex line on stdout, the input of `decode_telemetry.py`.
+ * @example    g++ -std=gnu++11 -O2 -DARDUINO=10819 -DARDUINOJSON_ENABLE_PROGMEM=0 \
+ *                 -DARDUINOJSON_ENABLE_ARDUINO_STRING=0 -DARDUINOJSON_ENABLE_ARDUINO_STREAM=0 \
+ *                 -DARDUINOJSON_ENABLE_ARDUINO_PRINT=0 -Itools/modbus_sim/host -Ilib/ArduinoJson/src \
+ *                 -Ilib/telemetry_batch/src tools/telemetry_msgpack/msgpack_sample.cpp \
+ *                 lib/telemetry_batch/src/telemetry_batch.cpp tools/modbus_sim/host/host_arduino.cpp \
+ *                 -o msgpack_sample
+ *             ./msgpack_sample tools/telemetry_msgpack/telemetry_keys.json | \
+ *                 python3 tools/telemetry_msgpack/decode_telemetry.py tools/telemetry_msgpack/telemetry_keys.json
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "telemetry_batch.h"
+#include <ArduinoJson.h>
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/* Private defines ---------------------------------------------------- */
+#define SAMPLE_PAYLOAD_SIZE (512 - 32) // TELEMETRY_PAYLOAD_SIZE of the firmware
+#define SAMPLE_MAX_VALUES   32         // Batch capacity, above the sample cycle
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef struct
+{
+  const char *key;
+  float       value;
+} sample_value_t;
+
+/* Private variables -------------------------------------------------- */
+static const sample_value_t SAMPLE_VALUES[] = {
+{"temperature", 26.43f}, {"humidity", 61.2f},          {"illuminance", 412.5f},   {"voltage", 229.8f},
+{"current", 0.412f},     {"power", 84.3f},             {"powerFactor", 0.89f},    {"powerEfficiency", 89.0f},
+{"soilPh_3", 6.4f},      {"soilMoisture_3", 31.5f},    {"soilTemperature_3", 24.1f},
+{"soilConductivity_3", 1250.0f},                       {"soilNitrogen_3", 42.0f}, {"soilPhosphorus_3", 18.0f},
+{"soilPotassium_3", 96.0f},                            {"soilPh_4", 6.8f},        {"soilMoisture_4", 28.0f},
+{"soilTemperature_4", 23.7f},                          {"soilConductivity_4", 980.0f},
+{"soilNitrogen_4", 37.0f},                             {"soilPhosphorus_4", 15.0f},
+{"soilPotassium_4", 88.0f},                            {"voltage_mean", 229.5f},  {"voltage_min", 228.9f},
+{"voltage_max", 230.4f},                               {"rssi_unlisted", -67.0f}};
+
+/* Function definitions ----------------------------------------------- */
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s telemetry_keys.json\n", argv[0]);
+    return 2;
+  }
+
+  FILE *file = fopen(argv[1], "rb");
+  if (file == NULL)
+  {
+    perror(argv[1]);
+    return 2;
+  }
+  std::string text;
+  char        chunk[256];
+  size_t      read;
+  while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+  {
+    text.append(chunk, read);
+  }
+  fclose(file);
+
+  DynamicJsonDocument doc(4096);
+  if (deserializeJson(doc, text) != DeserializationError::Ok)
+  {
+    fprintf(stderr, "%s: invalid JSON\n", argv[1]);
+    return 2;
+  }
+  std::vector<const char *> keys;
+  for (JsonVariant key : doc["keys"].as<JsonArray>())
+  {
+    keys.push_back(key.as<const char *>());
+  }
+
+  TelemetryBatchBuffer<SAMPLE_MAX_VALUES> batch;
+  batch.setDictionary(keys.data(), (uint8_t) keys.size(), doc["version"].as<uint8_t>());
+  for (const sample_value_t &sample : SAMPLE_VALUES)
+  {
+    batch.add(sample.key, sample.value);
+  }
+
+  char     json[SAMPLE_PAYLOAD_SIZE];
+  uint8_t  msgpack[SAMPLE_PAYLOAD_SIZE];
+  size_t   jsonBytes = 0, msgpackBytes = 0, length;
+  uint16_t used, jsonMessages = 0, msgpackMessages = 0;
+
+  for (uint16_t first = 0; first < batch.count(); first += used, jsonMessages++)
+  {
+    used = batch.encode(first, json, sizeof(json));
+    jsonBytes += strlen(json);
+  }
+  for (uint16_t first = 0; first < batch.count(); first += used, msgpackMessages++)
+  {
+    used = batch.encodeMsgPack(first, msgpack, sizeof(msgpack), &length);
+    msgpackBytes += length;
+    for (size_t i = 0; i < length; i++)
+    {
+      printf("%02x", msgpack[i]);
+    }
+    printf("\n");
+  }
+
+  fprintf(stderr, "%u values: JSON %zu bytes in %u messages, MsgPack %zu bytes in %u messages (%.1f%%)\n",
+          batch.count(), jsonBytes, jsonMessages, msgpackBytes, msgpackMessages,
+          100.0 * msgpackBytes / jsonBytes);
+
+  return 0;
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,273 @@
+/**
+ * @file       telemetry_queue_check.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-22
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host check of the offline telemetry queue on a POSIX directory
+ *
+ * @note       Queues an outage of a dozen keys per cycle as the telemetry task does, replays it 32 records
+ *             at a time, and checks every record comes back once, in order, with its key and value. Then the
+ *             same across a reboot (a partly sent segment is sent again), an outage longer than the queue
+ *             (the newest records are kept), a record torn by a reset, a key name torn by a reset, a record
+ *             failing its CRC and a short segment write. Exits with 1 when a check fails.
+ * @example    g++ -std=gnu++11 -O2 -pthread -DARDUINO=10819 -Itools/modbus_sim/host \
+ *                 -Ilib/telemetry_queue/src -Ilib/checksum/src \
+ *                 tools/telemetry_queue_check/telemetry_queue_check.cpp \
+ *                 lib/telemetry_queue/src/telemetry_queue.cpp lib/checksum/src/checksum.cpp \
+ *                 tools/modbus_sim/host/host_arduino.cpp tools/modbus_sim/host/host_fs.cpp \
+ *                 -o telemetry_queue_check && ./telemetry_queue_check
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "telemetry_queue.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+/* Private defines ---------------------------------------------------- */
+#define CHECK_START_TIME 1750000000UL
+#define CHECK_KEYS       12
+#define CHECK_REPLAY     32 // Records per replay message, as replayTelemetry()
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef struct
+{
+  uint32_t records;   // Records replayed with their key
+  uint32_t corrupt;   // Records replayed without a key
+  uint32_t bad;       // Wrong key or value
+  uint32_t backwards; // Older than the record before
+  uint32_t first;     // Index of the first and last record replayed
+  uint32_t last;
+} check_replay_t;
+
+/* Private variables -------------------------------------------------- */
+static const char *const KEYS[CHECK_KEYS] = {"temperature", "humidity", "pressure", "altitude",
+                                             "light",       "motion",   "distance", "soilMoisture",
+                                             "voltage",     "current",  "power",    "powerFactor"};
+
+static std::string checkRoot;
+static int         checkFailures = 0;
+
+/* Private function prototypes ---------------------------------------- */
+static void           pushOutage(TelemetryQueue &queue, uint32_t from, uint32_t count);
+static check_replay_t replay(TelemetryQueue &queue, uint32_t maxRecords = UINT32_MAX);
+static float          valueAt(uint32_t index);
+static void           check(bool condition, const char *what);
+static void           corrupt(const char *path, long offset, const char *bytes, size_t length);
+
+/* Function definitions ----------------------------------------------- */
+int main()
+{
+  char directory[] = "/tmp/telemetry_queue_check.XXXXXX";
+
+  if (mkdtemp(directory) == NULL)
+  {
+    return 2;
+  }
+  checkRoot = directory;
+  fs::FS                  fs(directory);
+  telemetry_queue_stats_t stats;
+  check_replay_t          result;
+  uint32_t                next = 0; // Index of the next record pushed, its time and value follow from it
+
+  // Two hours offline, then the backlog replayed
+  {
+    TelemetryQueue queue;
+    check(queue.begin(fs) == TELEMETRY_QUEUE_OK, "begin on an empty directory");
+    pushOutage(queue, next, 240 * CHECK_KEYS);
+    next   += 240 * CHECK_KEYS;
+    result  = replay(queue);
+    queue.getStats(&stats);
+    printf("outage: %u pushed, %u replayed, %u bad, %u out of order\n", stats.recordsPushed, result.records,
+           result.bad, result.backwards);
+    check(result.records == 240 * CHECK_KEYS && result.bad == 0 && result.backwards == 0, "ordered replay");
+    check(queue.size() == 0 && !fs.exists(TELEMETRY_QUEUE_DIRECTORY "/keys"), "empty queue drops the keys");
+  }
+
+  // Reset in the middle of a replay: the partly sent segment goes out again, nothing is lost
+  uint32_t start = next;
+  {
+    TelemetryQueue queue;
+    queue.begin(fs);
+    pushOutage(queue, next, 1500);
+    next += 1500;
+    replay(queue, 1000);
+  }
+  {
+    TelemetryQueue queue;
+    queue.begin(fs);
+    uint32_t queued = queue.size();
+    result          = replay(queue);
+    printf("reboot mid-replay: %u queued again, resent from record %u of %u\n", queued,
+           result.first - start, next - start);
+    check(result.first <= start + 1000 && result.last == next - 1 && result.bad == 0, "replay after reboot");
+  }
+
+  // Outage longer than the queue: the oldest segments go, the newest records stay in order
+  {
+    TelemetryQueue queue;
+    queue.begin(fs);
+    uint32_t capacity =
+    TELEMETRY_QUEUE_MAX_SEGMENTS * TELEMETRY_QUEUE_SEGMENT_SIZE / TELEMETRY_QUEUE_RECORD_SIZE;
+    pushOutage(queue, next, 2 * capacity);
+    next += 2 * capacity;
+    queue.getStats(&stats);
+    uint32_t queued = queue.size();
+    result          = replay(queue);
+    printf("overflow: %u pushed, %u dropped, %u replayed from record %u\n", stats.recordsPushed,
+           stats.recordsDropped, result.records, result.first);
+    check(queued <= capacity && stats.recordsDropped == stats.recordsPushed - queued, "drop count");
+    check(result.last == next - 1 && result.bad == 0 && result.backwards == 0, "newest records kept");
+  }
+
+  // Reset during a segment write and during a key name write
+  {
+    TelemetryQueue queue;
+    queue.begin(fs);
+    pushOutage(queue, next, 100);
+    next += 100;
+  }
+  corrupt(TELEMETRY_QUEUE_DIRECTORY "/00000000.q", -1, "\x01\x02\x03", 3);
+  corrupt(TELEMETRY_QUEUE_DIRECTORY "/keys", -1, "\nhalfwritt", 10);
+  {
+    TelemetryQueue queue;
+    queue.begin(fs);
+    check(queue.size() == 100, "torn record left out");
+    check(queue.push(CHECK_START_TIME + next, "newKey", valueAt(next)) == TELEMETRY_QUEUE_OK,
+          "key after a torn one");
+    queue.flush();
+    telemetry_queue_record_t records[CHECK_REPLAY];
+    result             = replay(queue, 100);
+    uint16_t count     = queue.peek(records, CHECK_REPLAY);
+    bool     keyIntact = count == 1 && records[0].key != NULL && std::string(records[0].key) == "newKey";
+    printf("torn tail and key: %u replayed, new key %s\n", result.records, keyIntact ? "intact" : "wrong");
+    check(result.records == 100 && result.bad == 0 && keyIntact, "replay after torn writes");
+    queue.pop(count);
+    next++;
+  }
+
+  // A record whose bytes changed on the flash fails its CRC and is skipped, not sent
+  {
+    TelemetryQueue queue;
+    queue.begin(fs);
+    pushOutage(queue, next, 50);
+    next += 50;
+  }
+  corrupt(TELEMETRY_QUEUE_DIRECTORY "/00000000.q", 5 * TELEMETRY_QUEUE_RECORD_SIZE + 2, "\xFF", 1);
+  {
+    TelemetryQueue queue;
+    queue.begin(fs);
+    result = replay(queue);
+    queue.getStats(&stats);
+    printf("crc: %u replayed, %u corrupt\n", result.records, stats.recordsCorrupt);
+    check(result.records == 49 && result.corrupt == 1 && stats.recordsCorrupt == 1, "corrupt record skipped");
+  }
+
+  // Flash full halfway through a write: that buffer is lost, later pushes go to a new segment
+  {
+    TelemetryQueue queue;
+    queue.begin(fs);
+    for (uint32_t index = next; index < next + CHECK_KEYS; index++)
+    {
+      queue.push(CHECK_START_TIME + index, KEYS[index % CHECK_KEYS], valueAt(index));
+    }
+    next += CHECK_KEYS;
+    // One record and a half reach the file
+    fs.failWritesAfter(TELEMETRY_QUEUE_RECORD_SIZE + TELEMETRY_QUEUE_RECORD_SIZE / 2);
+    check(queue.flush() == TELEMETRY_QUEUE_ERR_FS, "short write reported");
+    fs.failWritesAfter(-1);
+    pushOutage(queue, next, 64);
+    next += 64;
+    queue.getStats(&stats);
+    result = replay(queue);
+    printf("write failure: %u write errors, %u replayed\n", stats.writeErrors, result.records);
+    check(stats.writeErrors == 1 && result.records == 1 + 64 && result.bad == 0,
+          "records after a short write");
+  }
+
+  system(("rm -rf " + checkRoot).c_str());
+  printf("%s\n", (checkFailures == 0) ? "PASS" : "FAIL");
+
+  return (checkFailures == 0) ? 0 : 1;
+}
+
+/* Private definitions ------------------------------------------------ */
+// One record per key per cycle, flushed once per cycle like sendTelemetryTask()
+static void pushOutage(TelemetryQueue &queue, uint32_t from, uint32_t count)
+{
+  for (uint32_t index = from; index < from + count; index++)
+  {
+    queue.push(CHECK_START_TIME + index, KEYS[index % CHECK_KEYS], valueAt(index));
+    if ((index + 1) % CHECK_KEYS == 0)
+    {
+      queue.flush();
+    }
+  }
+  queue.flush();
+}
+
+static check_replay_t replay(TelemetryQueue &queue, uint32_t maxRecords)
+{
+  telemetry_queue_record_t records[CHECK_REPLAY];
+  check_replay_t           result   = {0, 0, 0, 0, UINT32_MAX, 0};
+  uint32_t                 previous = 0;
+  uint16_t                 count;
+
+  while (result.records + result.corrupt < maxRecords && (count = queue.peek(records, CHECK_REPLAY)) > 0)
+  {
+    for (uint16_t i = 0; i < count; i++)
+    {
+      uint32_t index = records[i].time - CHECK_START_TIME;
+      if (records[i].key == NULL)
+      {
+        result.corrupt++;
+        continue;
+      }
+      result.records++;
+      result.bad       += (std::string(records[i].key) != KEYS[index % CHECK_KEYS] ||
+                      records[i].value != valueAt(index));
+      result.backwards += (records[i].time < previous);
+      result.first      = (index < result.first) ? index : result.first;
+      result.last       = index;
+      previous          = records[i].time;
+    }
+    queue.pop(count);
+  }
+
+  return result;
+}
+
+static float valueAt(uint32_t index) { return 20.0f + (index % 1000) * 0.125f; }
+
+static void check(bool condition, const char *what)
+{
+  if (!condition)
+  {
+    printf("FAILED: %s\n", what);
+    checkFailures++;
+  }
+}
+
+// Overwrites bytes at `offset`, or appends them when `offset` is negative
+static void corrupt(const char *path, long offset, const char *bytes, size_t length)
+{
+  FILE *file = fopen((checkRoot + path).c_str(), (offset < 0) ? "ab" : "r+b");
+
+  if (file == NULL)
+  {
+    printf("FAILED: open %s\n", path);
+    checkFailures++;
+    return;
+  }
+  if (offset >= 0)
+  {
+    fseek(file, offset, SEEK_SET);
+  }
+  fwrite(bytes, 1, length, file);
+  fclose(file);
+}
+
+/* End of file -------------------------------------------------------- */
@@ -0,0 +1,252 @@
+/**
+ * @file       ts_log_check.cpp
+ * @license    This project is released under the MIT License.
+ * @version    0.1.0
+ * @date       2025-06-22
+ * @author     Tuan Nguyen
+ *
+ * @brief      Host check of the time-series log on a POSIX directory
+ *
+ * @note       Runs the storage task pattern for `days` simulated days (default 3): nine channels, one record
+ *             per channel per minute, a flush every 10 minutes and maintenance until idle every minute. Then
+ *             reads everything back, reopens the log as after a reboot, tears the tail of the newest segment
+ *             and leaves a stray compaction `.tmp` beside it, and makes a block write fail halfway. Raw
+ *             records must come back with the exact values written, compacted ones on bucket boundaries
+ *             with means in range. Exits with 1 when a check fails.
+ *
+ *             With 150 days it shows how much history the size limit keeps (the "span" line).
+ * @example    g++ -std=gnu++11 -O2 -pthread -DARDUINO=10819 -Itools/modbus_sim/host -Ilib/ts_log/src \
+ *                 -Ilib/gorilla/src -Ilib/checksum/src tools/ts_log_check/ts_log_check.cpp \
+ *                 lib/ts_log/src/ts_log.cpp lib/gorilla/src/gorilla.cpp lib/checksum/src/checksum.cpp \
+ *                 tools/modbus_sim/host/host_arduino.cpp tools/modbus_sim/host/host_fs.cpp \
+ *                 -o ts_log_check && ./ts_log_check 3
+ */
+
+/* Includes ----------------------------------------------------------- */
+#include "ts_log.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+/* Private defines ---------------------------------------------------- */
+#define CHECK_START_TIME 1750000000UL // 2025-06-15
+#define CHECK_CHANNELS   9
+#define CHECK_PERIOD_S   60
+#define CHECK_FLUSH_S    600
+#define CHECK_TAIL_S     (30 * CHECK_PERIOD_S) // Records appended after the recovery checks
+
+/* Private enumerate/structure ---------------------------------------- */
+typedef struct
+{
+  long     raw;
+  long     compacted;
+  long     bad;
+  uint32_t first;
+  uint32_t last;
+} check_count_t;
+
+/* Private variables -------------------------------------------------- */
+static std::string checkRoot;
+static int         checkFailures = 0;
+
+/* Private function prototypes ---------------------------------------- */
+static float         valueAt(uint8_t channel, uint32_t time);
+static check_count_t readRange(TsLog &log, uint32_t fromTime, uint32_t toTime);
+static void          check(bool condition, const char *what);
+static std::string   newestSegment(fs::FS &fs);
+
+/* Function definitions ----------------------------------------------- */
+int main(int argc, char **argv)
+{
+  int  days        = (argc > 1) ? atoi(argv[1]) : 3;
+  char directory[] = "/tmp/ts_log_check.XXXXXX";
+
+  if (days < 1 || mkdtemp(directory) == NULL)
+  {
+    fprintf(stderr, "usage: ts_log_check [days]\n");
+    return 2;
+  }
+  checkRoot = directory;
+  fs::FS         fs(directory);
+  ts_log_stats_t stats;
+  check_count_t  all;
+  uint32_t       now = CHECK_START_TIME;
+
+  {
+    TsLog log;
+    check(log.begin(fs) == TS_LOG_OK, "begin on an empty directory");
+    for (uint32_t minute = 0; minute < (uint32_t) days * 1440; minute++)
+    {
+      now = CHECK_START_TIME + minute * CHECK_PERIOD_S;
+      for (uint8_t channel = 0; channel < CHECK_CHANNELS; channel++)
+      {
+        // Back-dated a few seconds per channel like samples read before the storage cycle
+        uint32_t time = now - (CHECK_CHANNELS - 1 - channel) * 3;
+        log.append(channel, time, valueAt(channel, time));
+      }
+      if ((minute + 1) * CHECK_PERIOD_S % CHECK_FLUSH_S == 0)
+      {
+        log.flush();
+      }
+      while (log.maintain(now) == TS_LOG_OK)
+      {
+      }
+    }
+    log.flush();
+    log.getStats(&stats);
+    all                = readRange(log, 0, UINT32_MAX);
+    check_count_t hour = readRange(log, now - 3600, now);
+    printf("%d days: %u segments, %u bytes, %u records, %u blocks, %u compacted, %u deleted\n", days,
+           log.segmentCount(), log.totalBytes(), stats.recordsAppended, stats.blocksWritten,
+           stats.segmentsCompacted, stats.segmentsDeleted);
+    printf("read: %ld raw, %ld compacted, span %.1f days\n", all.raw, all.compacted,
+           (all.last - all.first) / 86400.0);
+    check(all.bad == 0, "every record read back as written");
+    check(hour.raw >= 59 * CHECK_CHANNELS, "last hour still raw");
+    check(log.totalBytes() <= TS_LOG_MAX_BYTES + TS_LOG_SEGMENT_SIZE, "size retention");
+    check(stats.blocksCorrupt == 0 && stats.writeErrors == 0, "no corrupt block or write error");
+  }
+
+  // Reboot: the index is rebuilt from the directory
+  {
+    TsLog log;
+    check(log.begin(fs) == TS_LOG_OK, "reopen");
+    check_count_t reopened = readRange(log, 0, UINT32_MAX);
+    printf("reopen: %u segments, %ld raw, %ld compacted\n", log.segmentCount(), reopened.raw,
+           reopened.compacted);
+    check(reopened.raw == all.raw && reopened.compacted == all.compacted, "same records after reopen");
+  }
+
+  // Reset during a block write, and during a compaction before the rename
+  std::string newest = newestSegment(fs);
+  std::string stray  = std::string(TS_LOG_DIRECTORY "/") + newest.substr(0, 8) + ".tmp";
+  FILE       *file   = fopen((checkRoot + TS_LOG_DIRECTORY "/" + newest).c_str(), "ab");
+  fwrite("TL\x00\x05torn", 1, 8, file); // Start of a block header, cut off
+  fclose(file);
+  file = fopen((checkRoot + stray).c_str(), "wb");
+  fputs("partial compaction", file);
+  fclose(file);
+  {
+    TsLog log;
+    check(log.begin(fs) == TS_LOG_OK, "begin after a torn tail");
+    log.getStats(&stats);
+    check_count_t torn = readRange(log, 0, UINT32_MAX);
+    printf("torn tail: %u corrupt, %ld raw, %ld compacted, stray .tmp %s\n", stats.blocksCorrupt, torn.raw,
+           torn.compacted, fs.exists(stray.c_str()) ? "left" : "removed");
+    check(torn.raw == all.raw && torn.compacted == all.compacted && torn.bad == 0, "torn tail dropped alone");
+    check(!fs.exists(stray.c_str()), "stray .tmp removed");
+
+    for (uint32_t time = now + CHECK_PERIOD_S; time <= now + CHECK_TAIL_S; time += CHECK_PERIOD_S)
+    {
+      log.append(0, time, valueAt(0, time));
+    }
+    log.flush();
+    check_count_t after = readRange(log, 0, UINT32_MAX);
+    check(after.raw == all.raw + CHECK_TAIL_S / CHECK_PERIOD_S && after.bad == 0, "appends after recovery");
+    all = after;
+  }
+
+  // Flash full or failing halfway through a block: that block is lost, the log goes on
+  now += CHECK_TAIL_S;
+  {
+    TsLog log;
+    log.begin(fs);
+    for (uint32_t i = 1; i <= 170; i++)
+    {
+      log.append(1, now + i * CHECK_PERIOD_S, valueAt(1, now + i * CHECK_PERIOD_S));
+    }
+    fs.failWritesAfter(10);
+    log.flush();
+    fs.failWritesAfter(-1);
+    for (uint32_t i = 171; i <= 180; i++)
+    {
+      log.append(1, now + i * CHECK_PERIOD_S, valueAt(1, now + i * CHECK_PERIOD_S));
+    }
+    log.flush();
+    log.getStats(&stats);
+    check_count_t failed = readRange(log, 0, UINT32_MAX);
+    printf("write failure: %u write errors, %ld raw (%ld kept of the 180 appended)\n", stats.writeErrors,
+           failed.raw, failed.raw - all.raw);
+    check(stats.writeErrors >= 1 && failed.bad == 0, "failed write dropped its block only");
+    check(failed.raw - all.raw >= 10, "appends after the failed write");
+    all = failed;
+  }
+  {
+    TsLog log;
+    log.begin(fs);
+    log.getStats(&stats);
+    check_count_t rebooted = readRange(log, 0, UINT32_MAX);
+    printf("reboot after the failure: %u corrupt, %ld raw\n", stats.blocksCorrupt, rebooted.raw);
+    check(rebooted.raw == all.raw && rebooted.bad == 0, "same records after the reboot");
+  }
+
+  system(("rm -rf " + checkRoot).c_str());
+  printf("%s\n", (checkFailures == 0) ? "PASS" : "FAIL");
+
+  return (checkFailures == 0) ? 0 : 1;
+}
+
+/* Private definitions ------------------------------------------------ */
+// Changes once a minute, stays within [channel * 10, channel * 10 + 1000)
+static float valueAt(uint8_t channel, uint32_t time) { return channel * 10 + (float) ((time / 60) % 1000); }
+
+static check_count_t readRange(TsLog &log, uint32_t fromTime, uint32_t toTime)
+{
+  static ts_log_cursor_t cursor; // A block buffer, too large for the stack of a task
+  ts_log_record_t        record;
+  check_count_t          count                          = {0, 0, 0, 0, 0};
+  uint32_t               lastCompacted[TS_LOG_CHANNELS] = {0};
+
+  log.openCursor(&cursor, fromTime, toTime);
+  while (log.next(&cursor, &record) == TS_LOG_OK)
+  {
+    count.first = (count.first == 0) ? record.time : count.first;
+    count.last  = record.time;
+    if (record.compacted)
+    {
+      float low = record.channel * 10.0f;
+      count.compacted++;
+      count.bad += (record.time % TS_LOG_COMPACT_BUCKET_S != 0 ||
+                    record.time < lastCompacted[record.channel] || record.value < low ||
+                    record.value > low + 1000.0f);
+      lastCompacted[record.channel] = record.time;
+    }
+    else
+    {
+      count.raw++;
+      count.bad += (record.value != valueAt(record.channel, record.time));
+    }
+  }
+  log.closeCursor(&cursor);
+
+  return count;
+}
+
+static void check(bool condition, const char *what)
+{
+  if (!condition)
+  {
+    printf("FAILED: %s\n", what);
+    checkFailures++;
+  }
+}
+
+static std::string newestSegment(fs::FS &fs)
+{
+  fs::File    dir = fs.open(TS_LOG_DIRECTORY);
+  std::string newest;
+
+  for (fs::File entry = dir.openNextFile(); entry; entry = dir.openNextFile())
+  {
+    std::string name = entry.name();
+    if (name.size() == 12 && name.compare(8, 4, ".seg") == 0 && name > newest)
+    {
+      newest = name;
+    }
+  }
+
+  return newest;
+}
+
+/* End of file -------------------------------------------------------- */